@@ -4,14 +4,24 @@
 
 #if defined(OS_LINUX)
 
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
 #define MAX_PROC_PID_LIMITS 8192
 #define PROC_PID_LIMITS_MAX_OPEN_FILES_KEY "\nMax open files "
 
 int max_fds_cache_seconds = 60;
 kernel_uint_t system_uptime_secs;
 
+bool enable_proc_connector = false;
+int proc_connector_rescan_seconds = 60;
+
+static void proc_connector_init(void);
+
 void apps_os_init_linux(void) {
-    ;
+    if(enable_proc_connector)
+        proc_connector_init();
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -726,12 +736,217 @@ cleanup:
 // to avoid filling up all disk space
 // if debug is enabled, all errors are printed
 
+// --------------------------------------------------------------------------------------------------------------------
+// process events connector
+//
+// when enabled, a thread listens to the fork and exit events of the kernel, so that
+// instead of scanning /proc at every iteration, we read the processes we already know,
+// plus the ones forked since the previous iteration. Processes that are forked and exit
+// between two iterations are never read (their resources are accounted to their parents
+// via the children times of their parents, as with /proc scans).
+//
+// /proc is still fully scanned at the first iteration, every proc_connector_rescan_seconds,
+// and whenever the kernel drops events, to catch anything missed.
+
+typedef enum {
+    PROC_CONNECTOR_PID_FORKED = 1,
+    PROC_CONNECTOR_PID_EXITED = 2,
+} PROC_CONNECTOR_PID_STATE;
+
+static struct {
+    int fd;
+    bool running;
+    bool rescan;                    // the kernel dropped events, a /proc scan is needed
+    usec_t last_rescan_ut;
+    SPINLOCK spinlock;
+    Pvoid_t JudyL;                  // pid -> PROC_CONNECTOR_PID_STATE, since the last iteration
+} proc_connector = {
+    .fd = -1,
+    .spinlock = SPINLOCK_INITIALIZER,
+};
+
+static void proc_connector_set_pid(pid_t pid, PROC_CONNECTOR_PID_STATE state) {
+    spinlock_lock(&proc_connector.spinlock);
+    Pvoid_t *PValue = JudyLIns(&proc_connector.JudyL, (Word_t)pid, PJE0);
+    if(unlikely(!PValue || PValue == PJERR))
+        fatal("APPS: corrupted proc connector JudyL array");
+    *(Word_t *)PValue = state;
+    spinlock_unlock(&proc_connector.spinlock);
+}
+
+static void proc_connector_process_messages(const char *buf, ssize_t len) {
+    for(const struct nlmsghdr *nlh = (const struct nlmsghdr *)buf; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+        if(nlh->nlmsg_type == NLMSG_NOOP)
+            continue;
+
+        if(nlh->nlmsg_type == NLMSG_ERROR || nlh->nlmsg_type == NLMSG_OVERRUN) {
+            __atomic_store_n(&proc_connector.rescan, true, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        const struct cn_msg *cn = NLMSG_DATA(nlh);
+        if(cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC)
+            continue;
+
+        const struct proc_event *ev = (const struct proc_event *)cn->data;
+        switch(ev->what) {
+            case PROC_EVENT_FORK:
+                // threads are forked too, we want only processes
+                if(ev->event_data.fork.child_pid == ev->event_data.fork.child_tgid)
+                    proc_connector_set_pid(ev->event_data.fork.child_tgid, PROC_CONNECTOR_PID_FORKED);
+                break;
+
+            case PROC_EVENT_EXIT:
+                if(ev->event_data.exit.process_pid == ev->event_data.exit.process_tgid)
+                    proc_connector_set_pid(ev->event_data.exit.process_tgid, PROC_CONNECTOR_PID_EXITED);
+                break;
+
+            default:
+                // exec events are not needed, the comm of the processes is read at every iteration
+                break;
+        }
+    }
+}
+
+static void *proc_connector_thread(void *ptr __maybe_unused) {
+    char buf[16384] __attribute__((aligned(NLMSG_ALIGNTO)));
+
+    while(true) {
+        struct sockaddr_nl from;
+        socklen_t from_len = sizeof(from);
+        ssize_t len = recvfrom(proc_connector.fd, buf, sizeof(buf), 0, (struct sockaddr *)&from, &from_len);
+
+        if(len == -1) {
+            if(errno == EINTR)
+                continue;
+
+            if(errno == ENOBUFS) {
+                // the kernel dropped events
+                __atomic_store_n(&proc_connector.rescan, true, __ATOMIC_RELAXED);
+                continue;
+            }
+
+            nd_log(NDLS_COLLECTORS, NDLP_ERR,
+                   "APPS: cannot receive from the process events connector, falling back to scanning /proc");
+            break;
+        }
+
+        // accept messages only from the kernel
+        if(from.nl_pid != 0)
+            continue;
+
+        proc_connector_process_messages(buf, len);
+    }
+
+    __atomic_store_n(&proc_connector.running, false, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void proc_connector_init(void) {
+    int fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if(fd == -1) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR,
+               "APPS: cannot create a process events connector socket, falling back to scanning /proc");
+        return;
+    }
+
+    // a big receive buffer, to survive bursts of short-lived processes
+    int rcvbuf = 4 * 1024 * 1024;
+    if(setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) == -1)
+        (void)setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_nl sa = {
+        .nl_family = AF_NETLINK,
+        .nl_groups = CN_IDX_PROC,
+        .nl_pid = 0,
+    };
+
+    if(bind(fd, (struct sockaddr *)&sa, sizeof(sa)) == -1) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR,
+               "APPS: cannot bind to the process events connector (it requires CAP_NET_ADMIN), "
+               "falling back to scanning /proc");
+        close(fd);
+        return;
+    }
+
+    char buf[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))] __attribute__((aligned(NLMSG_ALIGNTO)));
+    memset(buf, 0, sizeof(buf));
+
+    struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op));
+    nlh->nlmsg_type = NLMSG_DONE;
+    nlh->nlmsg_pid = getpid();
+
+    struct cn_msg *cn = NLMSG_DATA(nlh);
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->len = sizeof(enum proc_cn_mcast_op);
+
+    enum proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+    memcpy(cn->data, &op, sizeof(op));
+
+    if(send(fd, buf, nlh->nlmsg_len, 0) == -1) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR,
+               "APPS: cannot subscribe to the process events connector, falling back to scanning /proc");
+        close(fd);
+        return;
+    }
+
+    proc_connector.fd = fd;
+    proc_connector.running = true;
+    nd_thread_create("APPS_PROC_CN", NETDATA_THREAD_OPTION_DONT_LOG, proc_connector_thread, NULL);
+
+    nd_log(NDLS_COLLECTORS, NDLP_INFO, "APPS: using the process events connector to discover processes");
+}
+
+// returns true when the events can be used instead of scanning /proc,
+// in which case *events has the pids forked and exited since the last call
+static bool proc_connector_get_events(Pvoid_t *events) {
+    *events = NULL;
+
+    if(!__atomic_load_n(&proc_connector.running, __ATOMIC_ACQUIRE))
+        return false;
+
+    spinlock_lock(&proc_connector.spinlock);
+    *events = proc_connector.JudyL;
+    proc_connector.JudyL = NULL;
+    spinlock_unlock(&proc_connector.spinlock);
+
+    usec_t now_ut = now_monotonic_usec();
+    if(__atomic_exchange_n(&proc_connector.rescan, false, __ATOMIC_RELAXED) ||
+        now_ut - proc_connector.last_rescan_ut >= (usec_t)proc_connector_rescan_seconds * USEC_PER_SEC) {
+        proc_connector.last_rescan_ut = now_ut;
+        JudyLFreeArray(events, PJE0);
+        return false;
+    }
+
+    return true;
+}
+
 bool apps_os_collect_all_pids_linux(void) {
 #if (PROCESSES_HAVE_STATE == 1)
     // clear process state counter
     memset(proc_state_count, 0, sizeof proc_state_count);
 #endif
 
+    Pvoid_t events = NULL;
+    bool use_events = proc_connector_get_events(&events);
+
+    if(use_events) {
+        // the processes that exited are marked as read, so that we will not
+        // try to read them - they will be found not updated, as if reading them failed
+        Word_t pid = 0;
+        Pvoid_t *PValue;
+        bool first = true;
+        while((PValue = JudyLFirstThenNext(events, &pid, &first))) {
+            if(*(Word_t *)PValue != PROC_CONNECTOR_PID_EXITED)
+                continue;
+
+            struct pid_stat *p = find_pid_entry((pid_t)pid);
+            if(p) p->read = true;
+        }
+    }
+
     // preload the parents and then their children
     collect_parents_before_children();
 
@@ -741,6 +956,24 @@ bool apps_os_collect_all_pids_linux(void) {
 
     system_uptime_secs = (kernel_uint_t)(uptime_msec(uptime_filename) / MSEC_PER_SEC);
 
+    if(use_events) {
+        // the processes we already know
+        for(struct pid_stat *p = root_of_pids(); p ; p = p->next)
+            incrementally_collect_data_for_pid_stat(p, NULL);
+
+        // and the ones forked since the last iteration, that are still running
+        Word_t pid = 0;
+        Pvoid_t *PValue;
+        bool first = true;
+        while((PValue = JudyLFirstThenNext(events, &pid, &first))) {
+            if(*(Word_t *)PValue == PROC_CONNECTOR_PID_FORKED)
+                incrementally_collect_data_for_pid((pid_t)pid, NULL);
+        }
+
+        JudyLFreeArray(&events, PJE0);
+        return true;
+    }
+
     char dirname[FILENAME_MAX + 1];
 
     snprintfz(dirname, FILENAME_MAX, "%s/proc", netdata_configured_host_prefix);
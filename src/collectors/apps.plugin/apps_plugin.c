@@ -438,6 +438,22 @@ static void parse_args(int argc, char **argv)
             if(max_fds_cache_seconds < 0) max_fds_cache_seconds = 0;
             continue;
         }
+
+        if(strcmp("with-proc-connector", argv[i]) == 0) {
+            enable_proc_connector = true;
+            continue;
+        }
+
+        if(strcmp("proc-connector-rescan-secs", argv[i]) == 0) {
+            if(argc <= i + 1) {
+                fprintf(stderr, "Parameter 'proc-connector-rescan-secs' requires a number as argument.\n");
+                exit(1);
+            }
+            i++;
+            proc_connector_rescan_seconds = str2i(argv[i]);
+            if(proc_connector_rescan_seconds < 1) proc_connector_rescan_seconds = 1;
+            continue;
+        }
 #endif
 
 #if (PROCESSES_HAVE_CPU_CHILDREN_TIME == 1) || (PROCESSES_HAVE_CHILDREN_FLTS == 1)
@@ -557,12 +573,23 @@ static void parse_args(int argc, char **argv)
                     "                        max given)\n"
                     "                        (default is %d seconds)\n"
                     "\n"
+                    " with-proc-connector    discover processes from the fork and exit\n"
+                    "                        events of the kernel (netlink process events\n"
+                    "                        connector, requires CAP_NET_ADMIN), instead of\n"
+                    "                        scanning /proc at every iteration\n"
+                    "\n"
+                    " proc-connector-rescan-secs N\n"
+                    "                        with the process events connector, scan /proc\n"
+                    "                        every N seconds to catch anything missed\n"
+                    "                        (default is %d seconds)\n"
+                    "\n"
 #endif
                     " version or -v or -V print program version and exit\n"
                     "\n"
                     , NETDATA_VERSION
 #if defined(OS_LINUX)
                     , max_fds_cache_seconds
+                    , proc_connector_rescan_seconds
 #endif
             );
             exit(0);
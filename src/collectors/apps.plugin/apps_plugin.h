@@ -146,6 +146,8 @@ struct pid_info {
 #define OS_FUNCTION(func) OS_FUNC_CONCAT(func, _linux)
 
 extern int max_fds_cache_seconds;
+extern bool enable_proc_connector;
+extern int proc_connector_rescan_seconds;
 
 #else
 #error "Unsupported operating system"
@@ -37,7 +37,7 @@ static inline void free_pressure(struct pressure *res) {
     if (res->some.total_time.st) rrdset_is_obsolete___safe_from_collector_thread(res->some.total_time.st);
     if (res->full.share_time.st) rrdset_is_obsolete___safe_from_collector_thread(res->full.share_time.st);
     if (res->full.total_time.st) rrdset_is_obsolete___safe_from_collector_thread(res->full.total_time.st);
-    freez(res->filename);
+    cgroup_filename_free(&res->filename);
 }
 
 static inline void cgroup_free_network_interfaces(struct cgroup *cg) {
@@ -91,35 +91,35 @@ static inline void cgroup_free(struct cgroup *cg) {
     if(cg->st_merged_ops) rrdset_is_obsolete___safe_from_collector_thread(cg->st_merged_ops);
     if(cg->st_pids) rrdset_is_obsolete___safe_from_collector_thread(cg->st_pids);
 
-    freez(cg->filename_cpuset_cpus);
-    freez(cg->filename_cpu_cfs_period);
-    freez(cg->filename_cpu_cfs_quota);
-    freez(cg->filename_memory_limit);
+    cgroup_filename_free(&cg->filename_cpuset_cpus);
+    cgroup_filename_free(&cg->filename_cpu_cfs_period);
+    cgroup_filename_free(&cg->filename_cpu_cfs_quota);
+    cgroup_filename_free(&cg->filename_memory_limit);
 
     cgroup_free_network_interfaces(cg);
 
     freez(cg->cpuacct_usage.cpu_percpu);
 
-    freez(cg->cpuacct_stat.filename);
-    freez(cg->cpuacct_usage.filename);
-    freez(cg->cpuacct_cpu_throttling.filename);
-    freez(cg->cpuacct_cpu_shares.filename);
+    cgroup_filename_free(&cg->cpuacct_stat.filename);
+    cgroup_filename_free(&cg->cpuacct_usage.filename);
+    cgroup_filename_free(&cg->cpuacct_cpu_throttling.filename);
+    cgroup_filename_free(&cg->cpuacct_cpu_shares.filename);
 
     arl_free(cg->memory.arl_base);
-    freez(cg->memory.filename_detailed);
-    freez(cg->memory.filename_failcnt);
-    freez(cg->memory.filename_usage_in_bytes);
-    freez(cg->memory.filename_msw_usage_in_bytes);
+    cgroup_filename_free(&cg->memory.filename_detailed);
+    cgroup_filename_free(&cg->memory.filename_failcnt);
+    cgroup_filename_free(&cg->memory.filename_usage_in_bytes);
+    cgroup_filename_free(&cg->memory.filename_msw_usage_in_bytes);
 
-    freez(cg->io_service_bytes.filename);
-    freez(cg->io_serviced.filename);
+    cgroup_filename_free(&cg->io_service_bytes.filename);
+    cgroup_filename_free(&cg->io_serviced.filename);
 
-    freez(cg->throttle_io_service_bytes.filename);
-    freez(cg->throttle_io_serviced.filename);
+    cgroup_filename_free(&cg->throttle_io_service_bytes.filename);
+    cgroup_filename_free(&cg->throttle_io_serviced.filename);
 
-    freez(cg->io_merged.filename);
-    freez(cg->io_queued.filename);
-    freez(cg->pids_current.filename);
+    cgroup_filename_free(&cg->io_merged.filename);
+    cgroup_filename_free(&cg->io_queued.filename);
+    cgroup_filename_free(&cg->pids_current.filename);
 
     free_pressure(&cg->cpu_pressure);
     free_pressure(&cg->io_pressure);
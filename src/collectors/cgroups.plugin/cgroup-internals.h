@@ -9,6 +9,17 @@
 #define CGROUP_PROCFILE_FLAG PROCFILE_FLAG_NO_ERROR_ON_FILE_IO
 #endif
 
+// per cgroup files that are read on every iteration stay open in the procfile descriptors cache
+// their filenames have to be released with cgroup_filename_free() to close them
+#define CGROUP_PROCFILE_FLAG_CACHED (CGROUP_PROCFILE_FLAG | PROCFILE_FLAG_CACHED_FD)
+
+static inline void cgroup_filename_free(char **filename) {
+    if(!*filename) return;
+    procfile_fd_cache_forget(*filename);
+    freez(*filename);
+    *filename = NULL;
+}
+
 struct blkio {
     char *filename;
     bool staterr;
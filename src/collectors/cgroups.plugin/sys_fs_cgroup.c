@@ -467,7 +467,7 @@ static inline void cgroup_read_cpuacct_stat(struct cpuacct_stat *cp) {
     static procfile *ff = NULL;
 
     if(likely(cp->filename)) {
-        ff = procfile_reopen(ff, cp->filename, NULL, CGROUP_PROCFILE_FLAG);
+        ff = procfile_reopen(ff, cp->filename, NULL, CGROUP_PROCFILE_FLAG_CACHED);
         if(unlikely(!ff)) {
             cp->updated = 0;
             cgroups_check = 1;
@@ -510,7 +510,7 @@ static inline void cgroup_read_cpuacct_cpu_stat(struct cpuacct_cpu_throttling *c
     }
 
     static procfile *ff = NULL;
-    ff = procfile_reopen(ff, cp->filename, NULL, CGROUP_PROCFILE_FLAG);
+    ff = procfile_reopen(ff, cp->filename, NULL, CGROUP_PROCFILE_FLAG_CACHED);
     if (unlikely(!ff)) {
         cp->updated = 0;
         cgroups_check = 1;
@@ -558,7 +558,7 @@ static inline void cgroup2_read_cpuacct_cpu_stat(struct cpuacct_stat *cp, struct
         return;
     }
 
-    ff = procfile_reopen(ff, cp->filename, NULL, CGROUP_PROCFILE_FLAG);
+    ff = procfile_reopen(ff, cp->filename, NULL, CGROUP_PROCFILE_FLAG_CACHED);
     if (unlikely(!ff)) {
         cp->updated = 0;
         cgroups_check = 1;
@@ -611,7 +611,7 @@ static inline void cgroup_read_cpuacct_cpu_shares(struct cpuacct_cpu_shares *cp)
         return;
     }
 
-    if (unlikely(read_single_number_file(cp->filename, &cp->shares))) {
+    if (unlikely(read_single_number_file_cached(cp->filename, &cp->shares))) {
         cp->updated = 0;
         cgroups_check = 1;
         return;
@@ -624,7 +624,7 @@ static inline void cgroup_read_cpuacct_usage(struct cpuacct_usage *ca) {
     static procfile *ff = NULL;
 
     if(likely(ca->filename)) {
-        ff = procfile_reopen(ff, ca->filename, NULL, CGROUP_PROCFILE_FLAG);
+        ff = procfile_reopen(ff, ca->filename, NULL, CGROUP_PROCFILE_FLAG_CACHED);
         if(unlikely(!ff)) {
             ca->updated = 0;
             cgroups_check = 1;
@@ -678,7 +678,7 @@ static inline void cgroup_read_blkio(struct blkio *io) {
     if (likely(io->filename)) {
         static procfile *ff = NULL;
 
-        ff = procfile_reopen(ff, io->filename, NULL, CGROUP_PROCFILE_FLAG);
+        ff = procfile_reopen(ff, io->filename, NULL, CGROUP_PROCFILE_FLAG_CACHED);
         if (unlikely(!ff)) {
             io->updated = 0;
             cgroups_check = 1;
@@ -721,7 +721,7 @@ static inline void cgroup2_read_blkio(struct blkio *io, unsigned int word_offset
     if (likely(io->filename)) {
         static procfile *ff = NULL;
 
-        ff = procfile_reopen(ff, io->filename, NULL, CGROUP_PROCFILE_FLAG);
+        ff = procfile_reopen(ff, io->filename, NULL, CGROUP_PROCFILE_FLAG_CACHED);
         if (unlikely(!ff)) {
             io->updated = 0;
             cgroups_check = 1;
@@ -759,7 +759,7 @@ static inline void cgroup2_read_pressure(struct pressure *res) {
     static procfile *ff = NULL;
 
     if (likely(res->filename)) {
-        ff = procfile_reopen(ff, res->filename, " =", CGROUP_PROCFILE_FLAG);
+        ff = procfile_reopen(ff, res->filename, " =", CGROUP_PROCFILE_FLAG_CACHED);
         if (unlikely(!ff)) {
             res->updated = 0;
             cgroups_check = 1;
@@ -810,7 +810,7 @@ static inline void cgroup_read_memory(struct memory *mem, char parent_cg_is_unif
     static procfile *ff = NULL;
 
     if(likely(mem->filename_detailed)) {
-        ff = procfile_reopen(ff, mem->filename_detailed, NULL, CGROUP_PROCFILE_FLAG);
+        ff = procfile_reopen(ff, mem->filename_detailed, NULL, CGROUP_PROCFILE_FLAG_CACHED);
         if(unlikely(!ff)) {
             mem->updated_detailed = 0;
             cgroups_check = 1;
@@ -885,7 +885,7 @@ static inline void cgroup_read_memory(struct memory *mem, char parent_cg_is_unif
 memory_next:
 
     if (likely(mem->filename_usage_in_bytes)) {
-        mem->updated_usage_in_bytes = !read_single_number_file(mem->filename_usage_in_bytes, &mem->usage_in_bytes);
+        mem->updated_usage_in_bytes = !read_single_number_file_cached(mem->filename_usage_in_bytes, &mem->usage_in_bytes);
     }
 
     if (likely(mem->updated_usage_in_bytes && mem->updated_detailed)) {
@@ -895,11 +895,11 @@ memory_next:
 
     if (likely(mem->filename_msw_usage_in_bytes)) {
         mem->updated_msw_usage_in_bytes =
-            !read_single_number_file(mem->filename_msw_usage_in_bytes, &mem->msw_usage_in_bytes);
+            !read_single_number_file_cached(mem->filename_msw_usage_in_bytes, &mem->msw_usage_in_bytes);
     }
 
     if (likely(mem->filename_failcnt)) {
-        mem->updated_failcnt = !read_single_number_file(mem->filename_failcnt, &mem->failcnt);
+        mem->updated_failcnt = !read_single_number_file_cached(mem->filename_failcnt, &mem->failcnt);
     }
 }
 
@@ -909,7 +909,7 @@ static void cgroup_read_pids_current(struct pids *pids) {
     if (unlikely(!pids->filename))
         return;
 
-    pids->updated = !read_single_number_file(pids->filename, &pids->pids_current);
+    pids->updated = !read_single_number_file_cached(pids->filename, &pids->pids_current);
 }
 
 static inline void read_cgroup(struct cgroup *cg) {
@@ -966,14 +966,13 @@ static inline void update_cpu_limits(char **filename, unsigned long long *value,
             }
         }
         else if(value == &cg->cpu_cfs_period || value == &cg->cpu_cfs_quota) {
-            ret = read_single_number_file(*filename, value);
+            ret = read_single_number_file_cached(*filename, value);
         }
         else ret = -1;
 
         if(ret) {
             collector_error("Cannot refresh cgroup %s cpu limit by reading '%s'. Will not update its limit anymore.", cg->id, *filename);
-            freez(*filename);
-            *filename = NULL;
+            cgroup_filename_free(filename);
         }
     }
 }
@@ -982,7 +981,7 @@ static inline void update_cpu_limits2(struct cgroup *cg) {
     if(cg->filename_cpu_cfs_quota){
         static procfile *ff = NULL;
 
-        ff = procfile_reopen(ff, cg->filename_cpu_cfs_quota, NULL, CGROUP_PROCFILE_FLAG);
+        ff = procfile_reopen(ff, cg->filename_cpu_cfs_quota, NULL, CGROUP_PROCFILE_FLAG_CACHED);
         if(unlikely(!ff)) {
             goto cpu_limits2_err;
         }
@@ -1013,8 +1012,7 @@ static inline void update_cpu_limits2(struct cgroup *cg) {
 
 cpu_limits2_err:
         collector_error("Cannot refresh cgroup %s cpu limit by reading '%s'. Will not update its limit anymore.", cg->id, cg->filename_cpu_cfs_quota);
-        freez(cg->filename_cpu_cfs_quota);
-        cg->filename_cpu_cfs_quota = NULL;
+        cgroup_filename_free(&cg->filename_cpu_cfs_quota);
 
     }
 }
@@ -1028,17 +1026,15 @@ static inline int update_memory_limits(struct cgroup *cg) {
             cg->chart_var_memory_limit = rrdvar_chart_variable_add_and_acquire(cg->st_mem_usage, "memory_limit");
             if(!cg->chart_var_memory_limit) {
                 collector_error("Cannot create cgroup %s chart variable '%s'. Will not update its limit anymore.", cg->id, "memory_limit");
-                freez(*filename);
-                *filename = NULL;
+                cgroup_filename_free(filename);
             }
         }
 
         if(*filename && cg->chart_var_memory_limit) {
             if(!(cg->options & CGROUP_OPTIONS_IS_UNIFIED)) {
-                if(read_single_number_file(*filename, value)) {
+                if(read_single_number_file_cached(*filename, value)) {
                     collector_error("Cannot refresh cgroup %s memory limit by reading '%s'. Will not update its limit anymore.", cg->id, *filename);
-                    freez(*filename);
-                    *filename = NULL;
+                    cgroup_filename_free(filename);
                 }
                 else {
                     rrdvar_chart_variable_set(
@@ -1047,11 +1043,10 @@ static inline int update_memory_limits(struct cgroup *cg) {
                 }
             } else {
                 char buffer[32];
-                int ret = read_txt_file(*filename, buffer, sizeof(buffer));
+                int ret = read_txt_file_cached(*filename, buffer, sizeof(buffer));
                 if(ret) {
                     collector_error("Cannot refresh cgroup %s memory limit by reading '%s'. Will not update its limit anymore.", cg->id, *filename);
-                    freez(*filename);
-                    *filename = NULL;
+                    cgroup_filename_free(filename);
                     return 0;
                 }
                 char *s = "max\n\0";
@@ -1144,15 +1139,9 @@ void update_cgroup_charts() {
                         collector_error(
                             "Cannot create cgroup %s chart variable 'cpu_limit'. Will not update its limit anymore.",
                             cg->id);
-                        if (cg->filename_cpuset_cpus)
-                            freez(cg->filename_cpuset_cpus);
-                        cg->filename_cpuset_cpus = NULL;
-                        if (cg->filename_cpu_cfs_period)
-                            freez(cg->filename_cpu_cfs_period);
-                        cg->filename_cpu_cfs_period = NULL;
-                        if (cg->filename_cpu_cfs_quota)
-                            freez(cg->filename_cpu_cfs_quota);
-                        cg->filename_cpu_cfs_quota = NULL;
+                        cgroup_filename_free(&cg->filename_cpuset_cpus);
+                        cgroup_filename_free(&cg->filename_cpu_cfs_period);
+                        cgroup_filename_free(&cg->filename_cpu_cfs_quota);
                     }
                 } else {
                     NETDATA_DOUBLE value = 0, quota = 0;
@@ -6,6 +6,7 @@
 #include "libnetdata/required_dummies.h"
 
 static SPAWN_SERVER *spawn_srv = NULL;
+static struct local_sockets_pid_cache *pid_cache = NULL;
 
 #define ENABLE_DETAILED_VIEW
 
@@ -515,6 +516,7 @@ void network_viewer_function(const char *transaction, char *function __maybe_unu
 #if defined(LOCAL_SOCKETS_USE_SETNS)
             .spawn_server = spawn_srv,
 #endif
+            .pid_cache = pid_cache,
             .stats = { 0 },
             .sockets_hashtable = { 0 },
             .local_ips_hashtable = { 0 },
@@ -974,6 +976,9 @@ int main(int argc __maybe_unused, char **argv __maybe_unused) {
     }
 #endif
 
+    // the sockets of processes are cached between calls, to avoid reading all fds of all processes every time
+    pid_cache = local_sockets_pid_cache_create();
+
     cached_usernames_init();
     update_cached_host_users();
     sc = system_servicenames_cache_init();
@@ -993,6 +998,7 @@ int main(int argc __maybe_unused, char **argv __maybe_unused) {
                                     NULL, HTTP_ACCESS_ALL, NULL, NULL);
 //        }
 
+        local_sockets_pid_cache_destroy(pid_cache);
         spawn_server_destroy(spawn_srv);
         exit(1);
     }
@@ -156,6 +156,7 @@ int do_proc_mdstat(int update_every, usec_t dt)
             struct raid *raid = &raids[raid_idx];
             freez(raid->name);
             freez(raid->level);
+            procfile_fd_cache_forget(raid->mismatch_cnt_filename);
             freez(raid->mismatch_cnt_filename);
         }
         if (raids_num) {
@@ -187,6 +188,7 @@ int do_proc_mdstat(int update_every, usec_t dt)
             raid->level = strdupz(procfile_lineword(ff, l, 2));
         } else if (unlikely(strcmp(raid->name, procfile_lineword(ff, l, 0)))) {
             freez(raid->name);
+            procfile_fd_cache_forget(raid->mismatch_cnt_filename);
             freez(raid->mismatch_cnt_filename);
             freez(raid->level);
             memset(raid, 0, sizeof(struct raid));
@@ -325,7 +327,7 @@ int do_proc_mdstat(int update_every, usec_t dt)
                     snprintfz(filename, FILENAME_MAX, mismatch_cnt_filename, raid->name);
                     raid->mismatch_cnt_filename = strdupz(filename);
                 }
-                if (unlikely(read_single_number_file(raid->mismatch_cnt_filename, &raid->mismatch_cnt))) {
+                if (unlikely(read_single_number_file_cached(raid->mismatch_cnt_filename, &raid->mismatch_cnt))) {
                     collector_error("Cannot read file '%s'", raid->mismatch_cnt_filename);
                     do_mismatch = CONFIG_BOOLEAN_NO;
                     collector_error("Monitoring for mismatch count has been disabled");
@@ -369,6 +369,12 @@ static void netdev_free(struct netdev *d) {
     cgroup_netdev_release(d->cgroup_netdev_link);
     d->cgroup_netdev_link = NULL;
 
+    procfile_fd_cache_forget(d->filename_speed);
+    procfile_fd_cache_forget(d->filename_duplex);
+    procfile_fd_cache_forget(d->filename_operstate);
+    procfile_fd_cache_forget(d->filename_carrier);
+    procfile_fd_cache_forget(d->filename_mtu);
+
     freez_and_set_to_null(d->name);
     freez_and_set_to_null(d->filename_speed);
     freez_and_set_to_null(d->filename_duplex);
@@ -1121,7 +1127,7 @@ int do_proc_net_dev(int update_every, usec_t dt) {
              d->filename_carrier &&
             (d->carrier_file_exists ||
              now_monotonic_sec() - d->carrier_file_lost_time > READ_RETRY_PERIOD)) {
-            if (read_single_number_file(d->filename_carrier, &d->carrier)) {
+            if (read_single_number_file_cached(d->filename_carrier, &d->carrier)) {
                 if (d->carrier_file_exists)
                     collector_error(
                         "Cannot refresh interface %s carrier state by reading '%s'. Next update is in %d seconds.",
@@ -1143,7 +1149,7 @@ int do_proc_net_dev(int update_every, usec_t dt) {
              now_monotonic_sec() - d->duplex_file_lost_time > READ_RETRY_PERIOD)) {
             char buffer[STATE_LENGTH_MAX + 1];
 
-            if (read_txt_file(d->filename_duplex, buffer, sizeof(buffer))) {
+            if (read_txt_file_cached(d->filename_duplex, buffer, sizeof(buffer))) {
                 if (d->duplex_file_exists)
                     collector_error("Cannot refresh interface %s duplex state by reading '%s'.", d->name, d->filename_duplex);
                 d->duplex_file_exists = 0;
@@ -1167,7 +1173,7 @@ int do_proc_net_dev(int update_every, usec_t dt) {
         if(d->do_operstate != CONFIG_BOOLEAN_NO && d->filename_operstate) {
             char buffer[STATE_LENGTH_MAX + 1], *trimmed_buffer;
 
-            if (read_txt_file(d->filename_operstate, buffer, sizeof(buffer))) {
+            if (read_txt_file_cached(d->filename_operstate, buffer, sizeof(buffer))) {
                 collector_error(
                     "Cannot refresh %s operstate by reading '%s'. Will not update its status anymore.",
                     d->name, d->filename_operstate);
@@ -1180,7 +1186,7 @@ int do_proc_net_dev(int update_every, usec_t dt) {
         }
 
         if (d->do_mtu != CONFIG_BOOLEAN_NO && d->filename_mtu) {
-            if (read_single_number_file(d->filename_mtu, &d->mtu)) {
+            if (read_single_number_file_cached(d->filename_mtu, &d->mtu)) {
                 collector_error(
                     "Cannot refresh mtu for interface %s by reading '%s'. Stop updating it.", d->name, d->filename_mtu);
                 freez(d->filename_mtu);
@@ -1259,7 +1265,7 @@ int do_proc_net_dev(int update_every, usec_t dt) {
 
                     if ((d->carrier || d->carrier_file_exists) &&
                         (d->speed_file_exists || now_monotonic_sec() - d->speed_file_lost_time > READ_RETRY_PERIOD)) {
-                        ret = read_single_number_file(d->filename_speed, (unsigned long long *) &d->speed);
+                        ret = read_single_number_file_cached(d->filename_speed, (unsigned long long *) &d->speed);
                     } else {
                         d->speed = 0; // TODO: this is wrong, shouldn't use 0 value, but NULL.
                     }
@@ -121,7 +121,7 @@ int do_proc_net_stat_conntrack(int update_every, usec_t dt) {
         }
     }
     else {
-        if(unlikely(read_single_number_file(nf_conntrack_count_filename, &aentries)))
+        if(unlikely(read_single_number_file_cached(nf_conntrack_count_filename, &aentries)))
             return 0; // we return 0, so that we will retry to open it next time
     }
 
@@ -130,7 +130,7 @@ int do_proc_net_stat_conntrack(int update_every, usec_t dt) {
         usec_since_last_max = 0;
 
         unsigned long long max;
-        if(likely(!read_single_number_file(nf_conntrack_max_filename, &max)))
+        if(likely(!read_single_number_file_cached(nf_conntrack_max_filename, &max)))
             rrdvar_host_variable_set(localhost, rrdvar_max, max);
     }
 
@@ -704,7 +704,7 @@ static void rm_do_rrd_x(struct card *const c, struct do_rrd_x *const drrd){
 }
 
 static int do_rrd_util_gpu(struct card *const c){
-    if(likely(!read_single_number_file(c->pathname_util_gpu, (unsigned long long *) &c->util_gpu))){
+    if(likely(!read_single_number_file_cached(c->pathname_util_gpu, (unsigned long long *) &c->util_gpu))){
         rrddim_set_by_pointer(c->st_util_gpu, c->rd_util_gpu, c->util_gpu);
         rrdset_done(c->st_util_gpu);
         return 0;
@@ -718,7 +718,7 @@ static int do_rrd_util_gpu(struct card *const c){
 }
 
 static int do_rrd_util_mem(struct card *const c){
-    if(likely(!read_single_number_file(c->pathname_util_mem, (unsigned long long *) &c->util_mem))){
+    if(likely(!read_single_number_file_cached(c->pathname_util_mem, (unsigned long long *) &c->util_mem))){
         rrddim_set_by_pointer(c->st_util_mem, c->rd_util_mem, c->util_mem);
         rrdset_done(c->st_util_mem);
         return 0;
@@ -760,7 +760,7 @@ static int do_rrd_clk_mem(struct card *const c){
 }
 
 static int do_rrd_vram(struct card *const c){
-    if(likely(!read_single_number_file(c->pathname_mem_used_vram, (unsigned long long *) &c->used_vram) && 
+    if(likely(!read_single_number_file_cached(c->pathname_mem_used_vram, (unsigned long long *) &c->used_vram) && 
             c->total_vram)){
         rrddim_set_by_pointer(  c->st_mem_usage_perc_vram, 
                                 c->rd_mem_used_perc_vram, 
@@ -783,7 +783,7 @@ static int do_rrd_vram(struct card *const c){
 }
 
 static int do_rrd_vis_vram(struct card *const c){
-    if(likely(!read_single_number_file(c->pathname_mem_used_vis_vram, (unsigned long long *) &c->used_vis_vram) && 
+    if(likely(!read_single_number_file_cached(c->pathname_mem_used_vis_vram, (unsigned long long *) &c->used_vis_vram) && 
             c->total_vis_vram)){
         rrddim_set_by_pointer(  c->st_mem_usage_perc_vis_vram, 
                                 c->rd_mem_used_perc_vis_vram, 
@@ -806,7 +806,7 @@ static int do_rrd_vis_vram(struct card *const c){
 }
 
 static int do_rrd_gtt(struct card *const c){
-    if(likely(!read_single_number_file(c->pathname_mem_used_gtt, (unsigned long long *) &c->used_gtt) && 
+    if(likely(!read_single_number_file_cached(c->pathname_mem_used_gtt, (unsigned long long *) &c->used_gtt) && 
             c->total_gtt)){
         rrddim_set_by_pointer(  c->st_mem_usage_perc_gtt, 
                                 c->rd_mem_used_perc_gtt, 
@@ -200,7 +200,7 @@ static struct ibport {
 
 #define GEN_DO_HWCOUNTER_READ(NAME, GRP, DESC, DIR, PORT, HW, ...)                                                     \
     if (HW->file_##NAME) {                                                                                             \
-        if (read_single_number_file(HW->file_##NAME, (unsigned long long *)&HW->NAME)) {                               \
+        if (read_single_number_file_cached(HW->file_##NAME, (unsigned long long *)&HW->NAME)) {                               \
             collector_error("cannot read iface '%s' hwcounter '" #HW "'", PORT->name);                                           \
             HW->file_##NAME = NULL;                                                                                    \
         }                                                                                                              \
@@ -524,7 +524,7 @@ int do_sys_class_infiniband(int update_every, usec_t dt)
 //  counter from file and place it in ibport struct
 #define GEN_DO_COUNTER_READ(NAME, GRP, DESC, DIR, PORT, ...)                                                           \
     if (PORT->file_##NAME) {                                                                                           \
-        if (read_single_number_file(PORT->file_##NAME, (unsigned long long *)&PORT->NAME)) {                           \
+        if (read_single_number_file_cached(PORT->file_##NAME, (unsigned long long *)&PORT->NAME)) {                           \
             collector_error("cannot read iface '%s' counter '" #NAME "'", PORT->name);                                           \
             PORT->file_##NAME = NULL;                                                                                  \
         }                                                                                                              \
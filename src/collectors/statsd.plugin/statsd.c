@@ -60,6 +60,8 @@ typedef struct statsd_histogram_extensions {
     uint32_t size;
     uint32_t used;
     NETDATA_DOUBLE *values;   // dynamic array of values collected
+
+    DDSKETCH *sketch;         // used instead of values, for metrics matching "use sketches for histograms and timers matching"
 } STATSD_METRIC_HISTOGRAM_EXTENSIONS;
 
 typedef struct statsd_metric_histogram { // histogram and timer
@@ -279,6 +281,10 @@ static struct statsd {
     double histogram_percentile;
     char *histogram_percentile_str;
 
+    SIMPLE_PATTERN *histogram_sketches_for;
+    double histogram_sketch_accuracy;
+    uint32_t histogram_sketch_max_bins;
+
     int threads;
     struct collection_thread_status *collection_threads_status;
 
@@ -352,6 +358,8 @@ static struct statsd {
         .apps = NULL,
         .histogram_percentile = 95.0,
         .histogram_increase_step = 10,
+        .histogram_sketch_accuracy = DDSKETCH_DEFAULT_RELATIVE_ACCURACY * 100.0,
+        .histogram_sketch_max_bins = DDSKETCH_DEFAULT_MAX_BINS,
         .dictionary_max_unique = 200,
         .threads = 0,
         .collection_threads_status = NULL,
@@ -383,6 +391,11 @@ static void dictionary_metric_insert_callback(const DICTIONARY_ITEM *item, void
     if (m->type == STATSD_METRIC_TYPE_HISTOGRAM || m->type == STATSD_METRIC_TYPE_TIMER) {
         m->histogram.ext = callocz(1,sizeof(STATSD_METRIC_HISTOGRAM_EXTENSIONS));
         netdata_mutex_init(&m->histogram.ext->mutex);
+
+        if(simple_pattern_matches(statsd.histogram_sketches_for, name)) {
+            m->histogram.ext->sketch = mallocz(sizeof(DDSKETCH));
+            ddsketch_init(m->histogram.ext->sketch, statsd.histogram_sketch_accuracy / 100.0, statsd.histogram_sketch_max_bins);
+        }
     }
 
     __atomic_fetch_add(&index->metrics, 1, __ATOMIC_RELAXED);
@@ -394,6 +407,10 @@ static void dictionary_metric_delete_callback(const DICTIONARY_ITEM *item, void
     STATSD_METRIC *m = (STATSD_METRIC *)value;
 
     if(m->type == STATSD_METRIC_TYPE_HISTOGRAM || m->type == STATSD_METRIC_TYPE_TIMER) {
+        if(m->histogram.ext->sketch) {
+            ddsketch_destroy(m->histogram.ext->sketch);
+            freez(m->histogram.ext->sketch);
+        }
         freez(m->histogram.ext);
         m->histogram.ext = NULL;
     }
@@ -544,13 +561,31 @@ static inline void statsd_process_histogram_or_timer(STATSD_METRIC *m, const cha
     }
 
     if(unlikely(m->reset)) {
-        m->histogram.ext->used = 0;
+        if(m->histogram.ext->sketch) {
+            netdata_mutex_lock(&m->histogram.ext->mutex);
+            ddsketch_reset(m->histogram.ext->sketch);
+            netdata_mutex_unlock(&m->histogram.ext->mutex);
+        }
+        else
+            m->histogram.ext->used = 0;
+
         statsd_reset_metric(m);
     }
 
     if(unlikely(value_is_zinit(value))) {
         // magic loading of metric, without affecting anything
     }
+    else if(m->histogram.ext->sketch) {
+        // a sampled value counts as many values as it represents
+        NETDATA_DOUBLE v = statsd_parse_float(value, 1.0);
+        NETDATA_DOUBLE sampling_rate = statsd_parse_sampling_rate(sampling);
+
+        netdata_mutex_lock(&m->histogram.ext->mutex);
+        ddsketch_add(m->histogram.ext->sketch, v, 1.0 / sampling_rate);
+        netdata_mutex_unlock(&m->histogram.ext->mutex);
+
+        metric_update_counters_and_obsoletion(m);
+    }
     else {
         NETDATA_DOUBLE v = statsd_parse_float(value, 1.0);
         NETDATA_DOUBLE sampling_rate = statsd_parse_sampling_rate(sampling);
@@ -1973,7 +2008,25 @@ static inline void statsd_flush_timer_or_histogram(STATSD_METRIC *m, const char
     netdata_log_debug(D_STATSD, "flushing %s metric '%s'", dim, m->name);
 
     int updated = 0;
-    if(unlikely(!m->reset && m->count && m->histogram.ext->used > 0)) {
+    DDSKETCH *sketch = m->histogram.ext->sketch;
+    if(unlikely(!m->reset && m->count && sketch && sketch->count > 0)) {
+        netdata_mutex_lock(&m->histogram.ext->mutex);
+
+        m->histogram.ext->last_min = (collected_number)roundndd(sketch->min * statsd.decimal_detail);
+        m->histogram.ext->last_max = (collected_number)roundndd(sketch->max * statsd.decimal_detail);
+        m->last = (collected_number)roundndd(ddsketch_average(sketch) * statsd.decimal_detail);
+        m->histogram.ext->last_stddev = (collected_number)roundndd(ddsketch_stddev(sketch) * statsd.decimal_detail);
+        m->histogram.ext->last_sum = (collected_number)roundndd(sketch->sum * statsd.decimal_detail);
+        m->histogram.ext->last_median = (collected_number)roundndd(ddsketch_quantile(sketch, 0.5) * statsd.decimal_detail);
+        m->histogram.ext->last_percentile = (collected_number)roundndd(ddsketch_quantile(sketch, statsd.histogram_percentile / 100) * statsd.decimal_detail);
+
+        netdata_mutex_unlock(&m->histogram.ext->mutex);
+
+        m->histogram.ext->zeroed = 0;
+        m->reset = 1;
+        updated = 1;
+    }
+    else if(unlikely(!m->reset && m->count && !sketch && m->histogram.ext->used > 0)) {
         netdata_mutex_lock(&m->histogram.ext->mutex);
 
         size_t len = m->histogram.ext->used;
@@ -2542,6 +2595,21 @@ void *statsd_main(void *ptr) {
         statsd.histogram_percentile_str = strdupz(buffer);
     }
 
+    statsd.histogram_sketches_for = simple_pattern_create(
+            inicfg_get(&netdata_config, CONFIG_SECTION_STATSD, "use sketches for histograms and timers matching", ""), NULL,
+            SIMPLE_PATTERN_EXACT, true);
+
+    statsd.histogram_sketch_accuracy =
+        inicfg_get_double(&netdata_config, CONFIG_SECTION_STATSD, "histograms and timers sketch accuracy percent", statsd.histogram_sketch_accuracy);
+
+    if(!isgreater(statsd.histogram_sketch_accuracy, 0) || !isless(statsd.histogram_sketch_accuracy, 100)) {
+        collector_error("STATSD: invalid histograms and timers sketch accuracy %0.5f given", statsd.histogram_sketch_accuracy);
+        statsd.histogram_sketch_accuracy = DDSKETCH_DEFAULT_RELATIVE_ACCURACY * 100.0;
+    }
+
+    statsd.histogram_sketch_max_bins = (uint32_t)
+        inicfg_get_number(&netdata_config, CONFIG_SECTION_STATSD, "histograms and timers sketch max bins", statsd.histogram_sketch_max_bins);
+
     statsd.dictionary_max_unique =
         inicfg_get_number(&netdata_config, CONFIG_SECTION_STATSD, "dictionaries max unique dimensions", statsd.dictionary_max_unique);
 
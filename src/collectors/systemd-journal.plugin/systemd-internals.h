@@ -16,6 +16,7 @@
 #define ND_SD_JOURNAL_ENABLE_ESTIMATIONS_FILE_PERCENTAGE 0.01
 #define ND_SD_JOURNAL_EXECUTE_WATCHER_PENDING_EVERY_MS 250
 #define ND_SD_JOURNAL_ALL_FILES_SCAN_EVERY_USEC (5 * 60 * USEC_PER_SEC)
+#define ND_SD_JOURNAL_INDEX_BUILD_EVERY_UT (1 * USEC_PER_SEC)
 
 #define ND_SD_UNITS_FUNCTION_DESCRIPTION "View the status of systemd units"
 #define ND_SD_UNITS_FUNCTION_NAME "systemd-list-units"
@@ -71,6 +72,9 @@ struct nd_journal_file {
     sd_id128_t last_writer_id;
 
     uint64_t messages_in_file;
+
+    struct nd_journal_file_index *index; // the sidecar index, for archived files
+    bool index_failed;
 };
 
 #define ND_SD_JF_SOURCE_ALL_NAME "all"
@@ -135,6 +139,15 @@ void function_systemd_journal(
     void *data);
 void nd_journal_file_update_header(const char *filename, struct nd_journal_file *njf);
 
+struct nd_journal_file_index;
+void nd_journal_files_index_init(void);
+void *nd_journal_files_index_main(void *arg);
+void nd_journal_file_index_free(struct nd_journal_file_index *ji);
+void nd_journal_file_index_delete(struct nd_journal_file *njf);
+struct nd_journal_file_index *nd_journal_file_index_get(struct nd_journal_file *njf);
+bool nd_journal_file_index_has_entries(struct nd_journal_file_index *ji, usec_t after_ut, usec_t before_ut);
+bool nd_journal_file_index_filter(struct nd_journal_file_index *ji, FACETS *facets, bool data_only);
+
 void nd_sd_journal_annotations_init(void);
 void nd_sd_journal_transform_message_id(FACETS *facets, BUFFER *wb, FACETS_TRANSFORMATION_SCOPE scope, void *data);
 
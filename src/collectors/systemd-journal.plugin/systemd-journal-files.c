@@ -550,6 +550,7 @@ static void files_registry_delete_cb(const DICTIONARY_ITEM *item, void *value, v
 
     internal_error(true, "removed journal file '%s'", filename);
     string_freez(njf->source);
+    nd_journal_file_index_delete(njf);
 }
 
 #define EXT_DOT_JOURNAL ".journal"
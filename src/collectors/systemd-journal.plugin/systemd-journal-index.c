@@ -0,0 +1,782 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "systemd-internals.h"
+
+// ----------------------------------------------------------------------------
+// sidecar indexes of archived journal files
+//
+// archived journal files never change, so for each one of them we keep:
+//
+//  - a bloom filter of all the KEY=value pairs of the file, so that queries
+//    with filters can skip the files that do not have any of the selected
+//    values, without opening them,
+//  - the values of the fields having just a few of them, so that the skipped
+//    files still contribute their possible values to the facets,
+//  - a coarse histogram of the number of entries over time, so that queries
+//    can skip the files that do not have any entries in their time-frame.
+//
+// the indexes are built lazily by a dedicated index thread, and they are
+// saved in the cache directory, so that they survive restarts. The on-disk
+// format is the in-memory one: a single allocation, with a header and arrays.
+// Queries use the indexes when they are available, otherwise they query the
+// files as usual.
+
+#define ND_SD_JOURNAL_INDEX_MAGIC 0x4a444e49 // "INDJ"
+#define ND_SD_JOURNAL_INDEX_VERSION 1
+#define ND_SD_JOURNAL_INDEX_DIRECTORY "systemd-journal-index"
+#define ND_SD_JOURNAL_INDEX_EXTENSION ".idx"
+
+#define ND_SD_JOURNAL_INDEX_MAX_VALUES_PER_FIELD 10000
+#define ND_SD_JOURNAL_INDEX_MAX_VALUES 100000
+#define ND_SD_JOURNAL_INDEX_MAX_LISTED_VALUES 200
+#define ND_SD_JOURNAL_INDEX_MAX_LISTED_VALUE_LENGTH 256
+#define ND_SD_JOURNAL_INDEX_BLOOM_BITS_PER_VALUE 10
+#define ND_SD_JOURNAL_INDEX_BLOOM_HASHES 4
+#define ND_SD_JOURNAL_INDEX_TIME_BUCKETS 240
+#define ND_SD_JOURNAL_INDEX_MIN_BUCKET_UT (60 * USEC_PER_SEC)
+
+typedef enum {
+    ND_SD_JOURNAL_INDEX_FIELD_INCOMPLETE = (1 << 0), // not all its values are in the bloom filter
+    ND_SD_JOURNAL_INDEX_FIELD_LISTED = (1 << 1),     // all its values are listed
+} ND_SD_JOURNAL_INDEX_FIELD_FLAGS;
+
+struct nd_journal_file_index_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t size;                 // the size of the whole index
+
+    uint64_t file_size;            // the journal file indexed
+    usec_t file_last_modified_ut;
+
+    usec_t first_ut;               // the start of the first time bucket
+    usec_t min_ut;                 // the first entry
+    usec_t max_ut;                 // the last entry
+    usec_t bucket_ut;              // the duration of each time bucket
+
+    uint32_t buckets;
+    uint32_t bloom_words;          // a power of 2
+    uint32_t fields;
+    uint32_t values;
+    uint32_t strings_size;
+    uint32_t padding;
+};
+
+struct nd_journal_file_index_field {
+    uint32_t name;                 // offset in strings
+    uint32_t flags;
+    uint32_t first_value;          // index in values, when listed
+    uint32_t values;
+};
+
+struct nd_journal_file_index_value {
+    uint32_t offset;               // offset in strings
+    uint32_t length;
+};
+
+struct nd_journal_file_index {
+    struct nd_journal_file_index_header *hdr;
+    uint32_t *counts;
+    uint64_t *bloom;
+    struct nd_journal_file_index_field *fields;
+    struct nd_journal_file_index_value *values;
+    const char *strings;
+};
+
+static char nd_journal_index_directory[FILENAME_MAX + 1] = "";
+static size_t nd_journal_index_registry_version = 0;
+static bool nd_journal_index_cleaned_up = false;
+
+static inline size_t index_align(size_t size)
+{
+    return (size + 7) & ~((size_t)7);
+}
+
+// returns the size of the index, and when ji is given, sets its pointers
+static size_t index_layout(struct nd_journal_file_index *ji, struct nd_journal_file_index_header *hdr)
+{
+    size_t pos = index_align(sizeof(*hdr));
+
+    size_t counts = pos;
+    pos += index_align((size_t)hdr->buckets * sizeof(uint32_t));
+
+    size_t bloom = pos;
+    pos += (size_t)hdr->bloom_words * sizeof(uint64_t);
+
+    size_t fields = pos;
+    pos += (size_t)hdr->fields * sizeof(struct nd_journal_file_index_field);
+
+    size_t values = pos;
+    pos += (size_t)hdr->values * sizeof(struct nd_journal_file_index_value);
+
+    size_t strings = pos;
+    pos += hdr->strings_size;
+
+    if (ji) {
+        ji->hdr = hdr;
+        ji->counts = (uint32_t *)((char *)hdr + counts);
+        ji->bloom = (uint64_t *)((char *)hdr + bloom);
+        ji->fields = (struct nd_journal_file_index_field *)((char *)hdr + fields);
+        ji->values = (struct nd_journal_file_index_value *)((char *)hdr + values);
+        ji->strings = (const char *)hdr + strings;
+    }
+
+    return pos;
+}
+
+static bool index_is_valid(struct nd_journal_file_index *ji, void *mem, size_t size)
+{
+    struct nd_journal_file_index_header *hdr = mem;
+
+    if (size < sizeof(*hdr) || hdr->magic != ND_SD_JOURNAL_INDEX_MAGIC ||
+        hdr->version != ND_SD_JOURNAL_INDEX_VERSION || hdr->size != size || !hdr->buckets || !hdr->bucket_ut ||
+        !hdr->bloom_words || (hdr->bloom_words & (hdr->bloom_words - 1)) || !hdr->strings_size)
+        return false;
+
+    if (index_layout(NULL, hdr) != size)
+        return false;
+
+    index_layout(ji, hdr);
+    if (ji->strings[hdr->strings_size - 1] != '\0')
+        return false;
+
+    for (uint32_t f = 0; f < hdr->fields; f++) {
+        struct nd_journal_file_index_field *fld = &ji->fields[f];
+        if (fld->name >= hdr->strings_size || fld->first_value > hdr->values ||
+            fld->values > hdr->values - fld->first_value)
+            return false;
+    }
+
+    for (uint32_t v = 0; v < hdr->values; v++) {
+        struct nd_journal_file_index_value *val = &ji->values[v];
+        if (val->offset >= hdr->strings_size || val->length >= hdr->strings_size - val->offset)
+            return false;
+    }
+
+    return true;
+}
+
+void nd_journal_file_index_free(struct nd_journal_file_index *ji)
+{
+    if (!ji)
+        return;
+
+    freez(ji->hdr);
+    freez(ji);
+}
+
+// ----------------------------------------------------------------------------
+// bloom filter
+
+static inline void index_bloom_add(uint64_t *bloom, uint32_t words, uint64_t hash)
+{
+    uint64_t bits = (uint64_t)words * 64;
+    uint32_t h1 = (uint32_t)hash, h2 = (uint32_t)(hash >> 32);
+
+    for (uint32_t i = 0; i < ND_SD_JOURNAL_INDEX_BLOOM_HASHES; i++) {
+        uint64_t bit = (h1 + i * h2) & (bits - 1);
+        bloom[bit / 64] |= (1ULL << (bit % 64));
+    }
+}
+
+static inline bool index_bloom_check(const uint64_t *bloom, uint32_t words, uint64_t hash)
+{
+    uint64_t bits = (uint64_t)words * 64;
+    uint32_t h1 = (uint32_t)hash, h2 = (uint32_t)(hash >> 32);
+
+    for (uint32_t i = 0; i < ND_SD_JOURNAL_INDEX_BLOOM_HASHES; i++) {
+        uint64_t bit = (h1 + i * h2) & (bits - 1);
+        if (!(bloom[bit / 64] & (1ULL << (bit % 64))))
+            return false;
+    }
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// building
+
+struct index_builder {
+    uint64_t *hashes;
+    size_t hashes_used, hashes_size;
+
+    struct nd_journal_file_index_field *fields;
+    size_t fields_used, fields_size;
+
+    struct nd_journal_file_index_value *values;
+    size_t values_used, values_size;
+
+    char *strings;
+    size_t strings_used, strings_size;
+};
+
+static uint32_t index_builder_add_string(struct index_builder *b, const char *s, size_t len)
+{
+    if (b->strings_used + len + 1 > b->strings_size) {
+        b->strings_size = (b->strings_used + len + 1) * 2;
+        b->strings = reallocz(b->strings, b->strings_size);
+    }
+
+    uint32_t offset = b->strings_used;
+    memcpy(&b->strings[offset], s, len);
+    b->strings[offset + len] = '\0';
+    b->strings_used += len + 1;
+
+    return offset;
+}
+
+static void index_builder_add_hash(struct index_builder *b, uint64_t hash)
+{
+    if (b->hashes_used == b->hashes_size) {
+        b->hashes_size = b->hashes_size ? b->hashes_size * 2 : 1024;
+        b->hashes = reallocz(b->hashes, b->hashes_size * sizeof(*b->hashes));
+    }
+
+    b->hashes[b->hashes_used++] = hash;
+}
+
+static struct nd_journal_file_index_field *index_builder_add_field(struct index_builder *b, const char *name)
+{
+    if (b->fields_used == b->fields_size) {
+        b->fields_size = b->fields_size ? b->fields_size * 2 : 64;
+        b->fields = reallocz(b->fields, b->fields_size * sizeof(*b->fields));
+    }
+
+    struct nd_journal_file_index_field *fld = &b->fields[b->fields_used++];
+    *fld = (struct nd_journal_file_index_field){
+        .name = index_builder_add_string(b, name, strlen(name)),
+        .flags = ND_SD_JOURNAL_INDEX_FIELD_LISTED,
+        .first_value = b->values_used,
+        .values = 0,
+    };
+
+    return fld;
+}
+
+static void index_builder_add_value(struct index_builder *b, struct nd_journal_file_index_field *fld, const char *value, size_t len)
+{
+    if (b->values_used == b->values_size) {
+        b->values_size = b->values_size ? b->values_size * 2 : 1024;
+        b->values = reallocz(b->values, b->values_size * sizeof(*b->values));
+    }
+
+    b->values[b->values_used++] = (struct nd_journal_file_index_value){
+        .offset = index_builder_add_string(b, value, len),
+        .length = len,
+    };
+    fld->values++;
+}
+
+static void index_builder_unlist_field(struct index_builder *b, struct nd_journal_file_index_field *fld)
+{
+    // the field has too many values to list them - drop the ones listed so far
+    if (fld->values) {
+        b->strings_used = b->values[fld->first_value].offset;
+        b->values_used = fld->first_value;
+    }
+
+    fld->values = 0;
+    fld->flags &= ~ND_SD_JOURNAL_INDEX_FIELD_LISTED;
+}
+
+static void index_builder_cleanup(struct index_builder *b)
+{
+    freez(b->hashes);
+    freez(b->fields);
+    freez(b->values);
+    freez(b->strings);
+}
+
+static void index_scan_fields(sd_journal *j __maybe_unused, struct index_builder *b __maybe_unused)
+{
+#ifdef HAVE_SD_JOURNAL_RESTART_FIELDS
+    const char *field = NULL;
+    const void *data = NULL;
+    size_t data_length;
+
+    SD_JOURNAL_FOREACH_FIELD(j, field)
+    {
+        struct nd_journal_file_index_field *fld = index_builder_add_field(b, field);
+
+        if (b->hashes_used >= ND_SD_JOURNAL_INDEX_MAX_VALUES || sd_journal_query_unique(j, field) < 0) {
+            index_builder_unlist_field(b, fld);
+            fld->flags |= ND_SD_JOURNAL_INDEX_FIELD_INCOMPLETE;
+            continue;
+        }
+
+        size_t values = 0;
+        SD_JOURNAL_FOREACH_UNIQUE(j, data, data_length)
+        {
+            if (++values > ND_SD_JOURNAL_INDEX_MAX_VALUES_PER_FIELD ||
+                b->hashes_used >= ND_SD_JOURNAL_INDEX_MAX_VALUES) {
+                fld->flags |= ND_SD_JOURNAL_INDEX_FIELD_INCOMPLETE;
+                break;
+            }
+
+            index_builder_add_hash(b, XXH3_64bits(data, data_length));
+
+            if (!(fld->flags & ND_SD_JOURNAL_INDEX_FIELD_LISTED))
+                continue;
+
+            if (values > ND_SD_JOURNAL_INDEX_MAX_LISTED_VALUES ||
+                data_length > ND_SD_JOURNAL_INDEX_MAX_LISTED_VALUE_LENGTH) {
+                index_builder_unlist_field(b, fld);
+                continue;
+            }
+
+            const char *key, *value;
+            size_t key_length, value_length;
+            if (parse_journal_field(data, data_length, &key, &key_length, &value, &value_length))
+                index_builder_add_value(b, fld, value, value_length);
+        }
+
+        if (fld->flags & ND_SD_JOURNAL_INDEX_FIELD_INCOMPLETE)
+            index_builder_unlist_field(b, fld);
+    }
+#else
+    (void)index_builder_add_field;
+    (void)index_builder_add_value;
+#endif
+}
+
+static uint32_t *index_scan_entries(sd_journal *j, usec_t first_ut, usec_t bucket_ut, uint32_t buckets, usec_t *min_ut, usec_t *max_ut)
+{
+    uint32_t *counts = callocz(buckets, sizeof(uint32_t));
+    usec_t min = UINT64_MAX, max = 0;
+
+    if (sd_journal_seek_head(j) < 0) {
+        freez(counts);
+        return NULL;
+    }
+
+    while (sd_journal_next(j) > 0) {
+        usec_t msg_ut;
+        if (sd_journal_get_realtime_usec(j, &msg_ut) < 0 || !msg_ut)
+            continue;
+
+        if (msg_ut < min)
+            min = msg_ut;
+        if (msg_ut > max)
+            max = msg_ut;
+
+        // entries out of the header timestamps are accounted at the edges
+        uint32_t slot = 0;
+        if (msg_ut > first_ut) {
+            usec_t s = (msg_ut - first_ut) / bucket_ut;
+            slot = s >= buckets ? buckets - 1 : (uint32_t)s;
+        }
+
+        if (counts[slot] < UINT32_MAX)
+            counts[slot]++;
+    }
+
+    if (min > max)
+        min = max = first_ut;
+
+    *min_ut = min;
+    *max_ut = max;
+    return counts;
+}
+
+static struct nd_journal_file_index *index_build(struct nd_journal_file *njf)
+{
+    if (!njf->msg_first_ut || njf->msg_last_ut < njf->msg_first_ut)
+        return NULL;
+
+    const char *files[2] = {
+        [0] = njf->filename,
+        [1] = NULL,
+    };
+
+    fstat_cache_enable_on_thread();
+
+    sd_journal *j = NULL;
+    if (sd_journal_open_files(&j, files, ND_SD_JOURNAL_OPEN_FLAGS) < 0 || !j) {
+        fstat_cache_disable_on_thread();
+        return NULL;
+    }
+
+    usec_t first_ut = njf->msg_first_ut;
+    usec_t span_ut = njf->msg_last_ut - first_ut;
+    usec_t bucket_ut = (span_ut + ND_SD_JOURNAL_INDEX_TIME_BUCKETS - 1) / ND_SD_JOURNAL_INDEX_TIME_BUCKETS;
+    if (bucket_ut < ND_SD_JOURNAL_INDEX_MIN_BUCKET_UT)
+        bucket_ut = ND_SD_JOURNAL_INDEX_MIN_BUCKET_UT;
+    uint32_t buckets = (uint32_t)(span_ut / bucket_ut) + 1;
+
+    usec_t min_ut, max_ut;
+    uint32_t *counts = index_scan_entries(j, first_ut, bucket_ut, buckets, &min_ut, &max_ut);
+    if (!counts) {
+        sd_journal_close(j);
+        fstat_cache_disable_on_thread();
+        return NULL;
+    }
+
+    struct index_builder b = {0};
+    index_scan_fields(j, &b);
+
+    sd_journal_close(j);
+    fstat_cache_disable_on_thread();
+
+    // make sure the strings are never empty, so that they are always terminated
+    if (!b.strings_used)
+        index_builder_add_string(&b, "", 0);
+
+    uint32_t bloom_words = 1;
+    while ((uint64_t)bloom_words * 64 < b.hashes_used * ND_SD_JOURNAL_INDEX_BLOOM_BITS_PER_VALUE)
+        bloom_words *= 2;
+
+    struct nd_journal_file_index_header hdr = {
+        .magic = ND_SD_JOURNAL_INDEX_MAGIC,
+        .version = ND_SD_JOURNAL_INDEX_VERSION,
+        .file_size = njf->size,
+        .file_last_modified_ut = njf->file_last_modified_ut,
+        .first_ut = first_ut,
+        .min_ut = min_ut,
+        .max_ut = max_ut,
+        .bucket_ut = bucket_ut,
+        .buckets = buckets,
+        .bloom_words = bloom_words,
+        .fields = b.fields_used,
+        .values = b.values_used,
+        .strings_size = b.strings_used,
+    };
+
+    hdr.size = index_layout(NULL, &hdr);
+
+    struct nd_journal_file_index *ji = callocz(1, sizeof(*ji));
+    index_layout(ji, callocz(1, hdr.size));
+    *ji->hdr = hdr;
+    memcpy(ji->counts, counts, buckets * sizeof(uint32_t));
+    for (size_t i = 0; i < b.hashes_used; i++)
+        index_bloom_add(ji->bloom, bloom_words, b.hashes[i]);
+    if (b.fields_used)
+        memcpy(ji->fields, b.fields, b.fields_used * sizeof(*b.fields));
+    if (b.values_used)
+        memcpy(ji->values, b.values, b.values_used * sizeof(*b.values));
+    memcpy((char *)ji->strings, b.strings, b.strings_used);
+
+    freez(counts);
+    index_builder_cleanup(&b);
+
+    return ji;
+}
+
+// ----------------------------------------------------------------------------
+// persistence
+
+static bool index_filename(char *dst, size_t dst_size, const char *journal_filename)
+{
+    if (!*nd_journal_index_directory)
+        return false;
+
+    snprintfz(
+        dst,
+        dst_size,
+        "%s/%016" PRIx64 ND_SD_JOURNAL_INDEX_EXTENSION,
+        nd_journal_index_directory,
+        (uint64_t)XXH3_64bits(journal_filename, strlen(journal_filename)));
+
+    return true;
+}
+
+static struct nd_journal_file_index *index_load(struct nd_journal_file *njf)
+{
+    char filename[FILENAME_MAX + 1];
+    if (!index_filename(filename, sizeof(filename), njf->filename))
+        return NULL;
+
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(struct nd_journal_file_index_header)) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = st.st_size;
+    void *mem = mallocz(size);
+    ssize_t bytes = read(fd, mem, size);
+    close(fd);
+
+    struct nd_journal_file_index *ji = callocz(1, sizeof(*ji));
+    if (bytes != (ssize_t)size || !index_is_valid(ji, mem, size) || ji->hdr->file_size != njf->size ||
+        ji->hdr->file_last_modified_ut != njf->file_last_modified_ut) {
+        freez(mem);
+        freez(ji);
+        return NULL;
+    }
+
+    return ji;
+}
+
+static void index_save(struct nd_journal_file *njf, struct nd_journal_file_index *ji)
+{
+    char filename[FILENAME_MAX + 1];
+    if (!index_filename(filename, sizeof(filename), njf->filename))
+        return;
+
+    char tmp[FILENAME_MAX + 1];
+    snprintfz(tmp, sizeof(tmp), "%s.tmp", filename);
+
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0664);
+    if (fd == -1) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR, "JOURNAL INDEX: cannot create file '%s'", tmp);
+        return;
+    }
+
+    bool ok = write(fd, ji->hdr, ji->hdr->size) == (ssize_t)ji->hdr->size;
+    close(fd);
+
+    if (!ok || rename(tmp, filename) != 0) {
+        nd_log(NDLS_COLLECTORS, NDLP_ERR, "JOURNAL INDEX: cannot save file '%s'", filename);
+        unlink(tmp);
+    }
+}
+
+void nd_journal_file_index_delete(struct nd_journal_file *njf)
+{
+    nd_journal_file_index_free(njf->index);
+    njf->index = NULL;
+
+    // keep the saved index, if the journal file is still there
+    struct stat st;
+    if (stat(njf->filename, &st) == 0)
+        return;
+
+    char filename[FILENAME_MAX + 1];
+    if (index_filename(filename, sizeof(filename), njf->filename))
+        unlink(filename);
+}
+
+// delete the saved indexes of the journal files that are no longer there
+static void index_cleanup_directory(void)
+{
+    DIR *dir = opendir(nd_journal_index_directory);
+    if (!dir)
+        return;
+
+    DICTIONARY *wanted = dictionary_create(DICT_OPTION_SINGLE_THREADED | DICT_OPTION_DONT_OVERWRITE_VALUE);
+
+    struct nd_journal_file *njf;
+    dfe_start_read(nd_journal_files_registry, njf)
+    {
+        char filename[FILENAME_MAX + 1];
+        if (index_filename(filename, sizeof(filename), njf->filename))
+            dictionary_set(wanted, strrchr(filename, '/') + 1, NULL, 0);
+    }
+    dfe_done(njf);
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_type != DT_REG || dictionary_get(wanted, entry->d_name))
+            continue;
+
+        char filename[FILENAME_MAX + 1];
+        snprintfz(filename, sizeof(filename), "%s/%s", nd_journal_index_directory, entry->d_name);
+        unlink(filename);
+    }
+
+    closedir(dir);
+    dictionary_destroy(wanted);
+}
+
+void nd_journal_files_index_init(void)
+{
+    const char *cache_dir = getenv("NETDATA_CACHE_DIR");
+    if (!cache_dir || !*cache_dir)
+        return;
+
+    char path[FILENAME_MAX + 1];
+    snprintfz(path, sizeof(path), "%s/" ND_SD_JOURNAL_INDEX_DIRECTORY, cache_dir);
+
+    if (mkdir(path, 0775) != 0 && errno != EEXIST) {
+        nd_log(
+            NDLS_COLLECTORS,
+            NDLP_ERR,
+            "JOURNAL INDEX: cannot create directory '%s', journal indexes will not be saved.",
+            path);
+        return;
+    }
+
+    strncpyz(nd_journal_index_directory, path, sizeof(nd_journal_index_directory) - 1);
+}
+
+// ----------------------------------------------------------------------------
+// maintenance, by the index thread
+
+static bool nd_journal_file_is_archived(struct nd_journal_file *njf)
+{
+    // the active journal files are named like 'system.journal' or 'user-1000.journal',
+    // while the archived ones have the writer, seqnum and timestamp after a '@'
+    const char *s = strrchr(njf->filename, '/');
+    return strchr(s ? s : njf->filename, '@') != NULL;
+}
+
+static bool nd_journal_file_wants_index(struct nd_journal_file *njf)
+{
+    return !__atomic_load_n(&njf->index, __ATOMIC_ACQUIRE) && !njf->index_failed && njf->msg_first_ut &&
+           nd_journal_file_is_archived(njf);
+}
+
+static void nd_journal_files_index_build_all(void)
+{
+    size_t version = dictionary_version(nd_journal_files_registry);
+    if (version == nd_journal_index_registry_version)
+        return;
+
+    while (!nd_thread_signaled_to_cancel()) {
+        // index the newest file first, it is the one most likely to be queried
+        char *newest = NULL;
+        usec_t newest_ut = 0;
+
+        struct nd_journal_file *njf;
+        dfe_start_read(nd_journal_files_registry, njf)
+        {
+            if (nd_journal_file_wants_index(njf) && (!newest || njf->msg_last_ut > newest_ut)) {
+                freez(newest);
+                newest = strdupz(njf_dfe.name);
+                newest_ut = njf->msg_last_ut;
+            }
+        }
+        dfe_done(njf);
+
+        const DICTIONARY_ITEM *item = NULL;
+        if (newest) {
+            item = dictionary_get_and_acquire_item(nd_journal_files_registry, newest);
+            freez(newest);
+        }
+
+        if (!item) {
+            nd_journal_index_registry_version = version;
+
+            if (!nd_journal_index_cleaned_up && *nd_journal_index_directory && nd_journal_files_completed_once()) {
+                index_cleanup_directory();
+                nd_journal_index_cleaned_up = true;
+            }
+            return;
+        }
+
+        njf = dictionary_acquired_item_value(item);
+
+        struct nd_journal_file_index *ji = index_load(njf);
+        if (!ji) {
+            ji = index_build(njf);
+            if (ji)
+                index_save(njf, ji);
+        }
+
+        if (ji)
+            __atomic_store_n(&njf->index, ji, __ATOMIC_RELEASE);
+        else
+            njf->index_failed = true;
+
+        dictionary_acquired_item_release(nd_journal_files_registry, item);
+    }
+}
+
+// indexing a file scans all its entries, which takes seconds on big archives,
+// so it runs on its own thread, away from the inotify events of the watcher
+void *nd_journal_files_index_main(void *arg __maybe_unused)
+{
+    while (!nd_thread_signaled_to_cancel()) {
+        nd_journal_files_index_build_all();
+        sleep_usec(ND_SD_JOURNAL_INDEX_BUILD_EVERY_UT);
+    }
+
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+// queries
+
+struct nd_journal_file_index *nd_journal_file_index_get(struct nd_journal_file *njf)
+{
+    struct nd_journal_file_index *ji = __atomic_load_n(&njf->index, __ATOMIC_ACQUIRE);
+
+    if (ji && (ji->hdr->file_size != njf->size || ji->hdr->file_last_modified_ut != njf->file_last_modified_ut))
+        return NULL;
+
+    return ji;
+}
+
+bool nd_journal_file_index_has_entries(struct nd_journal_file_index *ji, usec_t after_ut, usec_t before_ut)
+{
+    struct nd_journal_file_index_header *hdr = ji->hdr;
+
+    if (before_ut < hdr->min_ut || after_ut > hdr->max_ut)
+        return false;
+
+    // the edge buckets have the entries out of the header timestamps
+    uint32_t first = after_ut > hdr->first_ut ? (uint32_t)MIN((after_ut - hdr->first_ut) / hdr->bucket_ut, (usec_t)hdr->buckets - 1) : 0;
+    uint32_t last = before_ut > hdr->first_ut ? (uint32_t)MIN((before_ut - hdr->first_ut) / hdr->bucket_ut, (usec_t)hdr->buckets - 1) : 0;
+
+    for (uint32_t slot = first; slot <= last; slot++)
+        if (ji->counts[slot])
+            return true;
+
+    return false;
+}
+
+struct index_selected_value {
+    struct nd_journal_file_index *ji;
+    BUFFER *wb;
+    bool found;
+};
+
+static bool index_selected_value_cb(FACETS *facets __maybe_unused, size_t id __maybe_unused, const char *key, const char *value, void *data)
+{
+    struct index_selected_value *t = data;
+
+    buffer_flush(t->wb);
+    buffer_strcat(t->wb, key);
+    buffer_putc(t->wb, '=');
+    buffer_strcat(t->wb, value);
+
+    if (index_bloom_check(t->ji->bloom, t->ji->hdr->bloom_words, XXH3_64bits(buffer_tostring(t->wb), buffer_strlen(t->wb))))
+        t->found = true;
+
+    return !t->found;
+}
+
+// Adds the listed values of the fields of the file to the facets, the way
+// netdata_systemd_filtering_by_journal() does when it opens the file, and returns
+// false when the file certainly has none of the values selected in the filters.
+bool nd_journal_file_index_filter(struct nd_journal_file_index *ji, FACETS *facets, bool data_only)
+{
+    struct index_selected_value t = {
+        .ji = ji,
+        .wb = buffer_create(0, NULL),
+        .found = false,
+    };
+
+    for (uint32_t f = 0; f < ji->hdr->fields; f++) {
+        struct nd_journal_file_index_field *fld = &ji->fields[f];
+        const char *name = &ji->strings[fld->name];
+
+        bool interesting = data_only ? facets_key_name_is_filter(facets, name) : facets_key_name_is_facet(facets, name);
+        if (!interesting)
+            continue;
+
+        size_t name_length = strlen(name);
+        for (uint32_t v = fld->first_value; v < fld->first_value + fld->values; v++)
+            facets_add_possible_value_name_to_key(
+                facets, name, name_length, &ji->strings[ji->values[v].offset], ji->values[v].length);
+
+        if (t.found || !facets_key_name_is_filter(facets, name))
+            continue;
+
+        if (fld->flags & ND_SD_JOURNAL_INDEX_FIELD_INCOMPLETE) {
+            t.found = true;
+            continue;
+        }
+
+        // when not all the selected values can be checked, the file may match
+        if (!facets_foreach_selected_value_in_key(
+                facets, name, name_length, used_hashes_registry, index_selected_value_cb, &t))
+            t.found = true;
+    }
+
+    buffer_free(t.wb);
+    return t.found;
+}
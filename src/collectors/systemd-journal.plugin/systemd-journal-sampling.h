@@ -5,9 +5,15 @@
 
 // ----------------------------------------------------------------------------
 // sampling support
+//
+// the files of a query may be queried in parallel, each worker having its own
+// copy of the query status. The per query and per time slot counters are
+// shared by all of them (lqs->c.shared), so they are accessed atomically.
 
 static inline void sampling_query_init(LOGS_QUERY_STATUS *lqs, FACETS *facets)
 {
+    lqs->c.shared = &lqs->c;
+
     if (!lqs->rq.sampling)
         return;
 
@@ -350,11 +356,13 @@ static inline sampling_t is_row_in_sample(
     if (slot >= lqs->c.samples.slots)
         slot = lqs->c.samples.slots - 1;
 
+    struct lqs_extension *shared = lqs->c.shared;
     bool should_sample = false;
 
-    if (lqs->c.samples.sampled < lqs->c.samples.enable_after_samples ||
+    if (__atomic_load_n(&shared->samples.sampled, __ATOMIC_RELAXED) < lqs->c.samples.enable_after_samples ||
         lqs->c.samples_per_file.sampled < lqs->c.samples_per_file.enable_after_samples ||
-        lqs->c.samples_per_time_slot.sampled[slot] < lqs->c.samples_per_time_slot.enable_after_samples)
+        __atomic_load_n(&shared->samples_per_time_slot.sampled[slot], __ATOMIC_RELAXED) <
+            lqs->c.samples_per_time_slot.enable_after_samples)
         should_sample = true;
 
     else if (lqs->c.samples_per_file.recalibrate >= ND_SD_JOURNAL_SAMPLING_RECALIBRATE || !lqs->c.samples_per_file.every) {
@@ -372,18 +380,18 @@ static inline sampling_t is_row_in_sample(
     }
 
     if (should_sample) {
-        lqs->c.samples.sampled++;
+        __atomic_add_fetch(&shared->samples.sampled, 1, __ATOMIC_RELAXED);
         lqs->c.samples_per_file.sampled++;
-        lqs->c.samples_per_time_slot.sampled[slot]++;
+        __atomic_add_fetch(&shared->samples_per_time_slot.sampled[slot], 1, __ATOMIC_RELAXED);
 
         return SAMPLING_FULL;
     }
 
     lqs->c.samples_per_file.recalibrate++;
 
-    lqs->c.samples.unsampled++;
+    __atomic_add_fetch(&shared->samples.unsampled, 1, __ATOMIC_RELAXED);
     lqs->c.samples_per_file.unsampled++;
-    lqs->c.samples_per_time_slot.unsampled[slot]++;
+    __atomic_add_fetch(&shared->samples_per_time_slot.unsampled[slot], 1, __ATOMIC_RELAXED);
 
     if (lqs->c.samples_per_file.unsampled > lqs->c.samples_per_file.sampled) {
         double progress_by_time = sampling_running_file_query_progress_by_time(lqs, jf, direction, msg_ut);
@@ -408,7 +416,7 @@ static inline void sampling_update_running_query_file_estimates(
         lqs, jf, direction, msg_ut, &total_time_ut, &remaining_start_ut, &remaining_end_ut);
     size_t remaining_lines = sampling_running_file_query_estimate_remaining_lines(j, lqs, jf, direction, msg_ut);
     facets_update_estimations(facets, remaining_start_ut, remaining_end_ut, remaining_lines);
-    lqs->c.samples.estimated += remaining_lines;
+    __atomic_add_fetch(&lqs->c.shared->samples.estimated, remaining_lines, __ATOMIC_RELAXED);
     lqs->c.samples_per_file.estimated += remaining_lines;
 }
 
@@ -12,6 +12,7 @@
 #define ND_SD_JOURNAL_FUNCTION_NAME "systemd-journal"
 #define ND_SD_JOURNAL_SAMPLING_SLOTS 1000
 #define ND_SD_JOURNAL_SAMPLING_RECALIBRATE 10000
+#define ND_SD_JOURNAL_QUERY_WORKERS_MAX 8
 
 #ifdef HAVE_SD_JOURNAL_RESTART_FIELDS
 #define LQS_DEFAULT_SLICE_MODE 1
@@ -60,6 +61,9 @@ struct lqs_extension {
         uint32_t unsampled[ND_SD_JOURNAL_SAMPLING_SLOTS];
     } samples_per_time_slot;
 
+    // the counters shared by all the workers of the query
+    struct lqs_extension *shared;
+
     // per file progress info
     // size_t cached_count;
 
@@ -634,6 +638,25 @@ static ND_SD_JOURNAL_STATUS nd_sd_journal_query_one_file(
     struct nd_journal_file *njf,
     LOGS_QUERY_STATUS *fqs)
 {
+    // the sidecar index of the file may tell us there is nothing to read in it
+    struct nd_journal_file_index *ji = nd_journal_file_index_get(njf);
+    if (ji) {
+        usec_t started = now_monotonic_usec();
+        usec_t anchor_delta = JOURNAL_VS_REALTIME_DELTA_MAX_UT;
+        bool skip = !nd_journal_file_index_has_entries(
+            ji, fqs->rq.after_ut - anchor_delta, fqs->rq.before_ut + anchor_delta);
+
+#ifdef HAVE_SD_JOURNAL_RESTART_FIELDS
+        if (fqs->rq.slice && !nd_journal_file_index_filter(ji, facets, fqs->rq.data_only) && fqs->rq.filters)
+            skip = true;
+#endif // HAVE_SD_JOURNAL_RESTART_FIELDS
+
+        fqs->c.matches_setup_ut += now_monotonic_usec() - started;
+
+        if (skip)
+            return ND_SD_JOURNAL_NO_FILE_MATCHED;
+    }
+
     sd_journal *j = NULL;
     errno_clear();
 
@@ -698,6 +721,208 @@ static bool jf_is_mine(struct nd_journal_file *njf, LOGS_QUERY_STATUS *fqs)
     return false;
 }
 
+// ----------------------------------------------------------------------------
+// parallel query of journal files
+//
+// the calling thread is the first worker and queries directly into the facets
+// of the query. The other workers are threads having a private copy of the
+// query status with a shard of the facets, which is merged into the facets of
+// the query when they finish. The workers pick the next file to query from
+// the sorted list of files, so that files are still queried in the optimal order.
+
+struct nd_sd_journal_file_result {
+    bool queried;
+    ND_SD_JOURNAL_STATUS status;
+    usec_t duration_ut;
+    size_t rows_read;
+    size_t rows_useful;
+    size_t bytes_read;
+    usec_t matches_setup_ut;
+    size_t fs_calls;
+    size_t fs_cached;
+    uint32_t sampled;
+    uint32_t unsampled;
+    uint32_t estimated;
+};
+
+struct nd_sd_journal_query_workers {
+    const DICTIONARY_ITEM **file_items;
+    struct nd_sd_journal_file_result *results;
+    size_t files_used;
+
+    size_t next_file;  // the next file to be queried
+    size_t files_done; // for reporting progress
+    bool timed_out;    // a file was not queried, because the query would time out
+    bool stop;         // do not query any more files
+};
+
+struct nd_sd_journal_query_worker {
+    struct nd_sd_journal_query_workers *qw;
+    LOGS_QUERY_STATUS *lqs;
+    LOGS_QUERY_STATUS lqs_copy;
+    ND_THREAD *thread;
+    size_t fs_calls;
+    size_t fs_cached;
+};
+
+static size_t nd_sd_journal_query_workers_count(size_t files)
+{
+    size_t workers = os_get_system_cpus();
+
+    if (workers > ND_SD_JOURNAL_QUERY_WORKERS_MAX)
+        workers = ND_SD_JOURNAL_QUERY_WORKERS_MAX;
+
+    if (workers > files)
+        workers = files;
+
+    return workers ? workers : 1;
+}
+
+static void nd_sd_journal_query_worker_run(struct nd_sd_journal_query_worker *w)
+{
+    struct nd_sd_journal_query_workers *qw = w->qw;
+    LOGS_QUERY_STATUS *lqs = w->lqs;
+
+    usec_t ended_ut = now_monotonic_usec();
+    usec_t started_ut, duration_ut = 0, max_duration_ut = 0;
+    usec_t progress_duration_ut = 0;
+
+    while (!__atomic_load_n(&qw->stop, __ATOMIC_RELAXED)) {
+        size_t f = __atomic_fetch_add(&qw->next_file, 1, __ATOMIC_RELAXED);
+        if (f >= qw->files_used)
+            break;
+
+        const char *filename = dictionary_acquired_item_name(qw->file_items[f]);
+        struct nd_journal_file *njf = dictionary_acquired_item_value(qw->file_items[f]);
+
+        if (!jf_is_mine(njf, lqs))
+            continue;
+
+        started_ut = ended_ut;
+
+        // do not even try to do the query if we expect it to pass the timeout
+        if (ended_ut + max_duration_ut * 3 >= *lqs->stop_monotonic_ut) {
+            __atomic_store_n(&qw->timed_out, true, __ATOMIC_RELAXED);
+            __atomic_store_n(&qw->stop, true, __ATOMIC_RELAXED);
+            break;
+        }
+
+        lqs->c.file_working++;
+
+        struct nd_sd_journal_file_result *r = &qw->results[f];
+        size_t fs_calls = fstat_thread_calls;
+        size_t fs_cached = fstat_thread_cached_responses;
+        size_t rows_useful = lqs->c.rows_useful;
+        size_t rows_read = lqs->c.rows_read;
+        size_t bytes_read = lqs->c.bytes_read;
+        size_t matches_setup_ut = lqs->c.matches_setup_ut;
+
+        sampling_file_init(lqs, njf);
+
+        r->status = nd_sd_journal_query_one_file(filename, NULL, lqs->facets, njf, lqs);
+
+        r->rows_useful = lqs->c.rows_useful - rows_useful;
+        r->rows_read = lqs->c.rows_read - rows_read;
+        r->bytes_read = lqs->c.bytes_read - bytes_read;
+        r->matches_setup_ut = lqs->c.matches_setup_ut - matches_setup_ut;
+        r->fs_calls = fstat_thread_calls - fs_calls;
+        r->fs_cached = fstat_thread_cached_responses - fs_cached;
+        r->sampled = lqs->c.samples_per_file.sampled;
+        r->unsampled = lqs->c.samples_per_file.unsampled;
+        r->estimated = lqs->c.samples_per_file.estimated;
+
+        ended_ut = now_monotonic_usec();
+        duration_ut = ended_ut - started_ut;
+        r->duration_ut = duration_ut;
+        r->queried = true;
+
+        if (duration_ut > max_duration_ut)
+            max_duration_ut = duration_ut;
+
+        size_t files_done = __atomic_add_fetch(&qw->files_done, 1, __ATOMIC_RELAXED);
+
+        progress_duration_ut += duration_ut;
+        if (progress_duration_ut >= ND_SD_JOURNAL_PROGRESS_EVERY_UT) {
+            progress_duration_ut = 0;
+            netdata_mutex_lock(&stdout_mutex);
+            pluginsd_function_progress_to_stdout(lqs->rq.transaction, files_done, qw->files_used);
+            netdata_mutex_unlock(&stdout_mutex);
+        }
+
+        if (r->status == ND_SD_JOURNAL_CANCELLED || r->status == ND_SD_JOURNAL_TIMED_OUT)
+            __atomic_store_n(&qw->stop, true, __ATOMIC_RELAXED);
+    }
+}
+
+static void *nd_sd_journal_query_worker_thread(void *ptr)
+{
+    struct nd_sd_journal_query_worker *w = ptr;
+
+    nd_sd_journal_query_worker_run(w);
+
+    // fstat counters are per thread
+    w->fs_calls = fstat_thread_calls;
+    w->fs_cached = fstat_thread_cached_responses;
+
+    return NULL;
+}
+
+static void nd_sd_journal_query_files(LOGS_QUERY_STATUS *lqs, struct nd_sd_journal_query_workers *qw)
+{
+    FACETS *facets = lqs->facets;
+
+    size_t workers_count = nd_sd_journal_query_workers_count(qw->files_used);
+    struct nd_sd_journal_query_worker *workers = callocz(workers_count, sizeof(*workers));
+
+    for (size_t w = 0; w < workers_count; w++) {
+        workers[w].qw = qw;
+
+        if (!w) {
+            workers[w].lqs = lqs;
+            continue;
+        }
+
+        workers[w].lqs_copy = *lqs;
+        workers[w].lqs = &workers[w].lqs_copy;
+        workers[w].lqs->facets = facets_shard_create(facets);
+        workers[w].lqs->c.rows_useful = 0;
+        workers[w].lqs->c.rows_read = 0;
+        workers[w].lqs->c.bytes_read = 0;
+        workers[w].lqs->c.matches_setup_ut = 0;
+        workers[w].lqs->c.file_working = 0;
+
+        workers[w].thread =
+            nd_thread_create("SDJQUERY", NETDATA_THREAD_OPTION_JOINABLE, nd_sd_journal_query_worker_thread, &workers[w]);
+    }
+
+    nd_sd_journal_query_worker_run(&workers[0]);
+
+    for (size_t w = 1; w < workers_count; w++) {
+        LOGS_QUERY_STATUS *wlqs = workers[w].lqs;
+
+        // a worker that failed to start has not queried any files
+        if (workers[w].thread)
+            nd_thread_join(workers[w].thread);
+
+        facets_shard_merge(facets, wlqs->facets);
+        wlqs->facets = NULL;
+
+        lqs->c.rows_useful += wlqs->c.rows_useful;
+        lqs->c.rows_read += wlqs->c.rows_read;
+        lqs->c.bytes_read += wlqs->c.bytes_read;
+        lqs->c.matches_setup_ut += wlqs->c.matches_setup_ut;
+        lqs->c.file_working += wlqs->c.file_working;
+
+        if (wlqs->last_modified > lqs->last_modified)
+            lqs->last_modified = wlqs->last_modified;
+
+        fstat_thread_calls += workers[w].fs_calls;
+        fstat_thread_cached_responses += workers[w].fs_cached;
+    }
+
+    freez(workers);
+}
+
 static int nd_sd_journal_query(BUFFER *wb, LOGS_QUERY_STATUS *lqs)
 {
     FACETS *facets = lqs->facets;
@@ -748,64 +973,28 @@ static int nd_sd_journal_query(BUFFER *wb, LOGS_QUERY_STATUS *lqs)
     }
 
     bool partial = false;
-    usec_t query_started_ut = now_monotonic_usec();
-    usec_t started_ut = query_started_ut;
-    usec_t ended_ut = started_ut;
-    usec_t duration_ut = 0, max_duration_ut = 0;
-    usec_t progress_duration_ut = 0;
 
     sampling_query_init(lqs, facets);
 
+    struct nd_sd_journal_query_workers qw = {
+        .file_items = file_items,
+        .results = callocz(files_used ? files_used : 1, sizeof(struct nd_sd_journal_file_result)),
+        .files_used = files_used,
+    };
+
+    nd_sd_journal_query_files(lqs, &qw);
+
+    bool stop = false;
     buffer_json_member_add_array(wb, "_journal_files");
     for (size_t f = 0; f < files_used; f++) {
-        const char *filename = dictionary_acquired_item_name(file_items[f]);
-        njf = dictionary_acquired_item_value(file_items[f]);
-
-        if (!jf_is_mine(njf, lqs))
+        struct nd_sd_journal_file_result *r = &qw.results[f];
+        if (!r->queried)
             continue;
 
-        started_ut = ended_ut;
-
-        // do not even try to do the query if we expect it to pass the timeout
-        if (ended_ut + max_duration_ut * 3 >= *lqs->stop_monotonic_ut) {
-            partial = true;
-            status = ND_SD_JOURNAL_TIMED_OUT;
-            break;
-        }
-
-        lqs->c.file_working++;
-
-        size_t fs_calls = fstat_thread_calls;
-        size_t fs_cached = fstat_thread_cached_responses;
-        size_t rows_useful = lqs->c.rows_useful;
-        size_t rows_read = lqs->c.rows_read;
-        size_t bytes_read = lqs->c.bytes_read;
-        size_t matches_setup_ut = lqs->c.matches_setup_ut;
-
-        sampling_file_init(lqs, njf);
-
-        ND_SD_JOURNAL_STATUS tmp_status = nd_sd_journal_query_one_file(filename, wb, facets, njf, lqs);
-
-        rows_useful = lqs->c.rows_useful - rows_useful;
-        rows_read = lqs->c.rows_read - rows_read;
-        bytes_read = lqs->c.bytes_read - bytes_read;
-        matches_setup_ut = lqs->c.matches_setup_ut - matches_setup_ut;
-        fs_calls = fstat_thread_calls - fs_calls;
-        fs_cached = fstat_thread_cached_responses - fs_cached;
-
-        ended_ut = now_monotonic_usec();
-        duration_ut = ended_ut - started_ut;
-
-        if (duration_ut > max_duration_ut)
-            max_duration_ut = duration_ut;
+        const char *filename = dictionary_acquired_item_name(file_items[f]);
+        njf = dictionary_acquired_item_value(file_items[f]);
 
-        progress_duration_ut += duration_ut;
-        if (progress_duration_ut >= ND_SD_JOURNAL_PROGRESS_EVERY_UT) {
-            progress_duration_ut = 0;
-            netdata_mutex_lock(&stdout_mutex);
-            pluginsd_function_progress_to_stdout(lqs->rq.transaction, f + 1, files_used);
-            netdata_mutex_unlock(&stdout_mutex);
-        }
+        usec_t duration_ut = r->duration_ut ? r->duration_ut : 1;
 
         buffer_json_add_array_item_object(wb); // journal file
         {
@@ -819,61 +1008,69 @@ static int nd_sd_journal_query(BUFFER *wb, LOGS_QUERY_STATUS *lqs)
             buffer_json_member_add_uint64(wb, "_journal_vs_realtime_delta_ut", njf->max_journal_vs_realtime_delta_ut);
 
             // information about the current use of the file
-            buffer_json_member_add_uint64(wb, "duration_ut", ended_ut - started_ut);
-            buffer_json_member_add_uint64(wb, "rows_read", rows_read);
-            buffer_json_member_add_uint64(wb, "rows_useful", rows_useful);
+            buffer_json_member_add_uint64(wb, "duration_ut", r->duration_ut);
+            buffer_json_member_add_uint64(wb, "rows_read", r->rows_read);
+            buffer_json_member_add_uint64(wb, "rows_useful", r->rows_useful);
             buffer_json_member_add_double(
-                wb, "rows_per_second", (double)rows_read / (double)duration_ut * (double)USEC_PER_SEC);
-            buffer_json_member_add_uint64(wb, "bytes_read", bytes_read);
+                wb, "rows_per_second", (double)r->rows_read / (double)duration_ut * (double)USEC_PER_SEC);
+            buffer_json_member_add_uint64(wb, "bytes_read", r->bytes_read);
             buffer_json_member_add_double(
-                wb, "bytes_per_second", (double)bytes_read / (double)duration_ut * (double)USEC_PER_SEC);
-            buffer_json_member_add_uint64(wb, "duration_matches_ut", matches_setup_ut);
-            buffer_json_member_add_uint64(wb, "fstat_query_calls", fs_calls);
-            buffer_json_member_add_uint64(wb, "fstat_query_cached_responses", fs_cached);
+                wb, "bytes_per_second", (double)r->bytes_read / (double)duration_ut * (double)USEC_PER_SEC);
+            buffer_json_member_add_uint64(wb, "duration_matches_ut", r->matches_setup_ut);
+            buffer_json_member_add_uint64(wb, "fstat_query_calls", r->fs_calls);
+            buffer_json_member_add_uint64(wb, "fstat_query_cached_responses", r->fs_cached);
 
             if (lqs->rq.sampling) {
                 buffer_json_member_add_object(wb, "_sampling");
                 {
-                    buffer_json_member_add_uint64(wb, "sampled", lqs->c.samples_per_file.sampled);
-                    buffer_json_member_add_uint64(wb, "unsampled", lqs->c.samples_per_file.unsampled);
-                    buffer_json_member_add_uint64(wb, "estimated", lqs->c.samples_per_file.estimated);
+                    buffer_json_member_add_uint64(wb, "sampled", r->sampled);
+                    buffer_json_member_add_uint64(wb, "unsampled", r->unsampled);
+                    buffer_json_member_add_uint64(wb, "estimated", r->estimated);
                 }
                 buffer_json_object_close(wb); // _sampling
             }
         }
         buffer_json_object_close(wb); // journal file
 
-        bool stop = false;
-        switch (tmp_status) {
+        // files queried in parallel after the one that stopped the query
+        // are reported, but they do not affect its status
+        if (stop)
+            continue;
+
+        switch (r->status) {
             case ND_SD_JOURNAL_OK:
             case ND_SD_JOURNAL_NO_FILE_MATCHED:
-                status = (status == ND_SD_JOURNAL_OK) ? ND_SD_JOURNAL_OK : tmp_status;
+                status = (status == ND_SD_JOURNAL_OK) ? ND_SD_JOURNAL_OK : r->status;
                 break;
 
             case ND_SD_JOURNAL_FAILED_TO_OPEN:
             case ND_SD_JOURNAL_FAILED_TO_SEEK:
                 partial = true;
                 if (status == ND_SD_JOURNAL_NO_FILE_MATCHED)
-                    status = tmp_status;
+                    status = r->status;
                 break;
 
             case ND_SD_JOURNAL_CANCELLED:
             case ND_SD_JOURNAL_TIMED_OUT:
                 partial = true;
                 stop = true;
-                status = tmp_status;
+                status = r->status;
                 break;
 
             case ND_SD_JOURNAL_NOT_MODIFIED:
                 internal_fatal(true, "this should never be returned here");
                 break;
         }
-
-        if (stop)
-            break;
     }
     buffer_json_array_close(wb); // _journal_files
 
+    if (qw.timed_out && !stop) {
+        partial = true;
+        status = ND_SD_JOURNAL_TIMED_OUT;
+    }
+
+    freez(qw.results);
+
     // release the files
     for (size_t f = 0; f < files_used; f++)
         dictionary_acquired_item_release(nd_journal_files_registry, file_items[f]);
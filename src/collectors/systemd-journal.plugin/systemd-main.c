@@ -33,6 +33,7 @@ int main(int argc __maybe_unused, char **argv __maybe_unused)
 
     nd_sd_journal_annotations_init();
     nd_journal_init_files_and_directories();
+    nd_journal_files_index_init();
 
     if (!journal_data_directories_exist()) {
         nd_log_collector(NDLP_INFO, "unable to locate journal data directories. Exiting...");
@@ -69,6 +70,12 @@ int main(int argc __maybe_unused, char **argv __maybe_unused)
 
     nd_thread_create("SDWATCH", NETDATA_THREAD_OPTION_DONT_LOG, nd_journal_watcher_main, NULL);
 
+    // ------------------------------------------------------------------------
+    // index thread
+
+    ND_THREAD *index_thread = nd_thread_create(
+        "SDJINDEX", NETDATA_THREAD_OPTION_JOINABLE | NETDATA_THREAD_OPTION_DONT_LOG, nd_journal_files_index_main, NULL);
+
     // ------------------------------------------------------------------------
     // the event loop for functions
 
@@ -138,5 +145,9 @@ int main(int argc __maybe_unused, char **argv __maybe_unused)
         }
     }
 
+    // let the index thread finish the file it is indexing
+    nd_thread_signal_cancel(index_thread);
+    nd_thread_join(index_thread);
+
     exit(0);
 }
@@ -322,6 +322,13 @@ int main(int argc, char **argv) {
         fprintf(stderr, "Sockets       [ found: %zu ]\n",
                 ls.stats.sockets_added);
 
+        fprintf(stderr, "\n");
+        fprintf(stderr, "PIDs          [ new: %zu, cached: %zu ]\n"
+                        "  \\_      fds [ processed: %zu, cached: %zu, revalidated: %zu, opendir failed: %zu, readlink failed: %zu ]\n",
+                ls.stats.pids_new, ls.stats.pids_cached,
+                ls.stats.pid_fds_processed, ls.stats.pid_fds_cached, ls.stats.pid_fds_revalidated,
+                ls.stats.pid_fds_opendir_failed, ls.stats.pid_fds_readlink_failed);
+
         fprintf(stderr, "\n");
         fprintf(stderr, "Main Procfile [ opens: %zu, reads: %zu, resizes: %zu, memory: %zu ]\n"
                         "  \\_    reads [ total bytes read: %zu, average read size: %zu, max read size: %zu ]\n"
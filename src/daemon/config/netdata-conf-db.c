@@ -3,6 +3,10 @@
 #include "netdata-conf-db.h"
 #include "daemon/common.h"
 
+#ifdef ENABLE_DBENGINE
+#include "database/engine/dbengine-uring.h"
+#endif
+
 #define DAYS 86400
 int default_rrd_history_entries = RRD_DEFAULT_HISTORY_ENTRIES;
 
@@ -50,6 +54,39 @@ static void netdata_conf_dbengine_pre_logs(void) {
         netdata_log_error("Invalid dbengine page type ''%s' given. Defaulting to 'raw'.", page_type);
     }
 
+    // ------------------------------------------------------------------------
+    // get default Database Engine page type for the higher tiers
+
+    const char *tiers_page_type = inicfg_get(&netdata_config, CONFIG_SECTION_DB, "dbengine tiers page type", "raw");
+    uint8_t higher_tiers_page_type = RRDENG_PAGE_TYPE_ARRAY_TIER1;
+    if (strcmp(tiers_page_type, "xor") == 0)
+        higher_tiers_page_type = RRDENG_PAGE_TYPE_XOR_TIER1;
+    else if (strcmp(tiers_page_type, "raw") != 0)
+        netdata_log_error("Invalid dbengine tiers page type '%s' given. Defaulting to 'raw'.", tiers_page_type);
+
+    for (size_t tier = 1; tier < RRD_STORAGE_TIERS; tier++)
+        tier_page_type[tier] = higher_tiers_page_type;
+
+    // ------------------------------------------------------------------------
+    // get the Database Engine caches eviction policies
+
+    struct {
+        const char *option;
+        PGC_EVICTION_POLICY *policy;
+    } eviction_policies[] = {
+        { "dbengine page cache eviction policy", &main_cache_eviction_policy },
+        { "dbengine open cache eviction policy", &open_cache_eviction_policy },
+        { "dbengine extent cache eviction policy", &extent_cache_eviction_policy },
+    };
+
+    for (size_t i = 0; i < sizeof(eviction_policies) / sizeof(eviction_policies[0]); i++) {
+        const char *def = pgc_eviction_policy_to_string(*eviction_policies[i].policy);
+        const char *policy = inicfg_get(&netdata_config, CONFIG_SECTION_DB, eviction_policies[i].option, def);
+        if (strcasecmp(policy, "lru") != 0 && strcasecmp(policy, "tinylfu") != 0)
+            netdata_log_error("Invalid %s '%s' given. Defaulting to '%s'.", eviction_policies[i].option, policy, def);
+        *eviction_policies[i].policy = pgc_eviction_policy_from_string(policy, *eviction_policies[i].policy);
+    }
+
     // ------------------------------------------------------------------------
     // get default Database Engine page cache size in MiB
 
@@ -179,6 +216,7 @@ void netdata_conf_dbengine_init(const char *hostname) {
     // ----------------------------------------------------------------------------------------------------------------
 
     dbengine_use_direct_io = inicfg_get_boolean(&netdata_config, CONFIG_SECTION_DB, "dbengine use direct io", dbengine_use_direct_io);
+    dbengine_uring_init(inicfg_get_boolean(&netdata_config, CONFIG_SECTION_DB, "dbengine use io_uring", CONFIG_BOOLEAN_NO));
     dbengine_journal_v2_unmount_time = inicfg_get_duration_seconds(&netdata_config, CONFIG_SECTION_DB, "dbengine journal v2 unmount time", nd_profile.dbengine_journal_v2_unmount_time);
 
     unsigned read_num = (unsigned)inicfg_get_number(&netdata_config, CONFIG_SECTION_DB, "dbengine pages per extent", DEFAULT_PAGES_PER_EXTENT);
@@ -139,6 +139,17 @@ void netdata_conf_section_web(void) {
         netdata_log_error("Invalid compression level %d. Valid levels are 1 (fastest) to 9 (best ratio). Proceeding with level 9 (best compression).", web_gzip_level);
         web_gzip_level = 9;
     }
+
+    web_enable_brotli = inicfg_get_boolean(&netdata_config, CONFIG_SECTION_WEB, "enable brotli compression", web_enable_brotli);
+    web_brotli_level = (int)inicfg_get_number(&netdata_config, CONFIG_SECTION_WEB, "brotli compression level", web_brotli_level);
+    web_enable_zstd = inicfg_get_boolean(&netdata_config, CONFIG_SECTION_WEB, "enable zstd compression", web_enable_zstd);
+    web_zstd_level = (int)inicfg_get_number(&netdata_config, CONFIG_SECTION_WEB, "zstd compression level", web_zstd_level);
+
+    long long static_cache_mb = inicfg_get_number(&netdata_config, CONFIG_SECTION_WEB, "static files cache size MB",
+                                                  (long long)(web_static_cache_max_bytes / 1024 / 1024));
+    if(static_cache_mb < 0)
+        static_cache_mb = 0;
+    web_static_cache_max_bytes = (size_t)static_cache_mb * 1024 * 1024;
 }
 
 void netdata_conf_web_security_init(void) {
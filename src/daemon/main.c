@@ -8,6 +8,7 @@
 #include "web/api/queries/backfill.h"
 
 #include "database/engine/page_test.h"
+#include "database/engine/page_bench.h"
 #include <curl/curl.h>
 
 #ifdef OS_WINDOWS
@@ -348,8 +349,20 @@ int netdata_main(int argc, char **argv) {
                         if(strcmp(optarg, "pgd-tests") == 0) {
                             return pgd_test(argc, argv);
                         }
+
+                        if(strcmp(optarg, "pgd-bench") == 0) {
+                            return pgd_bench(argc, argv);
+                        }
 #endif
 
+                        if(strcmp(optarg, "ml-bench") == 0) {
+                            return ml_bench(argc, argv);
+                        }
+
+                        if(strcmp(optarg, "print-bench") == 0) {
+                            return benchmark_number_printing();
+                        }
+
                         if(strcmp(optarg, "sqlite-meta-recover") == 0) {
                             sql_init_meta_database(DB_CHECK_RECOVER, 0);
                             return 0;
@@ -407,6 +420,7 @@ int netdata_main(int argc, char **argv) {
                             if (unittest_waiting_queue()) return 1;
                             if (uuidmap_unittest()) return 1;
                             if (stacktrace_unittest()) return 1;
+                            if (ddsketch_unittest()) return 1;
 #ifdef OS_WINDOWS
                             if (perflibnamestest_main()) return 1;
 #endif
@@ -10,6 +10,9 @@ struct aral_info {
 
     RRDSET *st_utilization;
     RRDDIM *rd_utilization;
+
+    RRDSET *st_magazines;
+    RRDDIM *rd_magazine_hits, *rd_magazine_refills, *rd_magazine_flushes;
 };
 
 DEFINE_JUDYL_TYPED(ARAL_STATS, struct aral_info *);
@@ -174,6 +177,45 @@ void pulse_aral_do(bool extended) {
             rrddim_set_by_pointer(ai->st_utilization, ai->rd_utilization, (collected_number)(utilization * 1000.0));
             rrdset_done(ai->st_utilization);
         }
+
+        size_t magazine_hits = __atomic_load_n(&stats->magazines.hits, __ATOMIC_RELAXED);
+        size_t magazine_refills = __atomic_load_n(&stats->magazines.refills, __ATOMIC_RELAXED);
+        size_t magazine_flushes = __atomic_load_n(&stats->magazines.flushes, __ATOMIC_RELAXED);
+
+        // only the ARALs using per-thread magazines get this chart
+        if(ai->st_magazines || magazine_hits || magazine_refills || magazine_flushes) {
+            if (unlikely(!ai->st_magazines)) {
+                char id[256];
+
+                snprintfz(id, sizeof(id), "aral_%s_magazines", ai->name);
+                netdata_fix_chart_id(id);
+
+                ai->st_magazines = rrdset_create_localhost(
+                    "netdata",
+                    id,
+                    NULL,
+                    "ARAL",
+                    "netdata.aral_magazines",
+                    "Array Allocator Per-Thread Magazines",
+                    "operations/s",
+                    "netdata",
+                    "pulse",
+                    910002,
+                    localhost->rrd_update_every,
+                    RRDSET_TYPE_LINE);
+
+                rrdlabels_add(ai->st_magazines->rrdlabels, "ARAL", ai->name, RRDLABEL_SRC_AUTO);
+
+                ai->rd_magazine_hits    = rrddim_add(ai->st_magazines, "hits", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+                ai->rd_magazine_refills = rrddim_add(ai->st_magazines, "refills", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+                ai->rd_magazine_flushes = rrddim_add(ai->st_magazines, "flushes", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            }
+
+            rrddim_set_by_pointer(ai->st_magazines, ai->rd_magazine_hits, (collected_number)magazine_hits);
+            rrddim_set_by_pointer(ai->st_magazines, ai->rd_magazine_refills, (collected_number)magazine_refills);
+            rrddim_set_by_pointer(ai->st_magazines, ai->rd_magazine_flushes, (collected_number)magazine_flushes);
+            rrdset_done(ai->st_magazines);
+        }
     }
 
     spinlock_unlock(&globals.spinlock);
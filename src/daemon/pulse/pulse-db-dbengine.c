@@ -91,9 +91,14 @@ struct dbengine2_cache_pointers {
     RRDDIM *rd_pgc_waste_flushes_cancelled;
     RRDDIM *rd_pgc_waste_insert_spins;
     RRDDIM *rd_pgc_waste_evict_spins;
+
+    RRDSET *st_pgc_admission;
+    RRDDIM *rd_pgc_admission_protected;
+    RRDDIM *rd_pgc_admission_probation;
+    RRDDIM *rd_pgc_admission_sketch_resets;
 };
 
-static void dbengine2_cache_statistics_charts(struct dbengine2_cache_pointers *ptrs, struct pgc_statistics *pgc_stats, struct pgc_statistics *pgc_stats_old __maybe_unused, const char *name, int priority) {
+static void dbengine2_cache_statistics_charts(struct dbengine2_cache_pointers *ptrs, struct pgc_statistics *pgc_stats, struct pgc_statistics *pgc_stats_old __maybe_unused, const char *name, const char *policy, int priority) {
 
     {
         if (unlikely(!ptrs->st_cache_hit_ratio)) {
@@ -123,6 +128,8 @@ static void dbengine2_cache_statistics_charts(struct dbengine2_cache_pointers *p
             ptrs->rd_hit_ratio_closest = rrddim_add(ptrs->st_cache_hit_ratio, "closest", NULL, 1, 10000, RRD_ALGORITHM_ABSOLUTE);
             ptrs->rd_hit_ratio_exact = rrddim_add(ptrs->st_cache_hit_ratio, "exact", NULL, 1, 10000, RRD_ALGORITHM_ABSOLUTE);
 
+            rrdlabels_add(ptrs->st_cache_hit_ratio->rrdlabels, "policy", policy, RRDLABEL_SRC_AUTO);
+
             buffer_free(id);
             buffer_free(family);
             buffer_free(title);
@@ -587,6 +594,50 @@ static void dbengine2_cache_statistics_charts(struct dbengine2_cache_pointers *p
         rrdset_done(ptrs->st_pgc_waste);
     }
 
+    {
+        if (unlikely(!ptrs->st_pgc_admission)) {
+            BUFFER *id = buffer_create(100, NULL);
+            buffer_sprintf(id, "dbengine_%s_cache_admission", name);
+
+            BUFFER *family = buffer_create(100, NULL);
+            buffer_sprintf(family, "dbengine %s cache", name);
+
+            BUFFER *title = buffer_create(100, NULL);
+            buffer_sprintf(title, "Netdata %s Cache Clean Pages Admission", name);
+
+            ptrs->st_pgc_admission = rrdset_create_localhost(
+                "netdata",
+                buffer_tostring(id),
+                NULL,
+                buffer_tostring(family),
+                NULL,
+                buffer_tostring(title),
+                "pages/s",
+                "netdata",
+                "pulse",
+                priority,
+                localhost->rrd_update_every,
+                RRDSET_TYPE_LINE);
+
+            ptrs->rd_pgc_admission_protected      = rrddim_add(ptrs->st_pgc_admission, "protected", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            ptrs->rd_pgc_admission_probation      = rrddim_add(ptrs->st_pgc_admission, "probation", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+            ptrs->rd_pgc_admission_sketch_resets  = rrddim_add(ptrs->st_pgc_admission, "sketch resets", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+
+            rrdlabels_add(ptrs->st_pgc_admission->rrdlabels, "policy", policy, RRDLABEL_SRC_AUTO);
+
+            buffer_free(id);
+            buffer_free(family);
+            buffer_free(title);
+            priority++;
+        }
+
+        rrddim_set_by_pointer(ptrs->st_pgc_admission, ptrs->rd_pgc_admission_protected, (collected_number)pgc_stats->admissions_protected);
+        rrddim_set_by_pointer(ptrs->st_pgc_admission, ptrs->rd_pgc_admission_probation, (collected_number)pgc_stats->admissions_probation);
+        rrddim_set_by_pointer(ptrs->st_pgc_admission, ptrs->rd_pgc_admission_sketch_resets, (collected_number)pgc_stats->frequency_sketch_resets);
+
+        rrdset_done(ptrs->st_pgc_admission);
+    }
+
     {
         if (unlikely(!ptrs->st_pgc_workers)) {
             BUFFER *id = buffer_create(100, NULL);
@@ -680,9 +731,9 @@ void pulse_dbengine_do(bool extended) {
     if(!main_cache || !main_mrg || !extended)
         return;
 
-    dbengine2_cache_statistics_charts(&main_cache_ptrs, &pgc_main_stats, &pgc_main_stats_old, "main", 135100);
-    dbengine2_cache_statistics_charts(&open_cache_ptrs, &pgc_open_stats, &pgc_open_stats_old, "open", 135200);
-    dbengine2_cache_statistics_charts(&extent_cache_ptrs, &pgc_extent_stats, &pgc_extent_stats_old, "extent", 135300);
+    dbengine2_cache_statistics_charts(&main_cache_ptrs, &pgc_main_stats, &pgc_main_stats_old, "main", pgc_eviction_policy_to_string(pgc_get_eviction_policy(main_cache)), 135100);
+    dbengine2_cache_statistics_charts(&open_cache_ptrs, &pgc_open_stats, &pgc_open_stats_old, "open", pgc_eviction_policy_to_string(pgc_get_eviction_policy(open_cache)), 135200);
+    dbengine2_cache_statistics_charts(&extent_cache_ptrs, &pgc_extent_stats, &pgc_extent_stats_old, "extent", pgc_eviction_policy_to_string(pgc_get_eviction_policy(extent_cache)), 135300);
     mrg_get_statistics(main_mrg, &mrg_stats);
 
     int priority = 135000;
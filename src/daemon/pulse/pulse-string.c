@@ -101,4 +101,83 @@ void pulse_string_do(bool extended) {
     rrddim_set_by_pointer(st_mem, rd_mem, (collected_number)memory);
     rrddim_set_by_pointer(st_mem, rd_mem_idx, (collected_number)memory_index);
     rrdset_done(st_mem);
+
+    // partitions
+    // the totals show how often writers wait, the busiest partition shows if
+    // the waiting is concentrated on a few partitions
+
+    static STRING_PARTITION_STATISTICS stats[STRING_PARTITIONS], last[STRING_PARTITIONS];
+    static RRDSET *st_contention = NULL, *st_partitions = NULL;
+    static RRDDIM *rd_contention_writers = NULL, *rd_contention_readers = NULL, *rd_contention_busiest = NULL;
+    static RRDDIM *rd_partitions_min = NULL, *rd_partitions_avg = NULL, *rd_partitions_max = NULL;
+
+    string_partitions_statistics(stats);
+
+    size_t writers = 0, readers = 0, busiest = 0;
+    size_t entries_min = SIZE_MAX, entries_max = 0, entries_total = 0;
+    for(size_t i = 0; i < STRING_PARTITIONS ;i++) {
+        size_t waits = (stats[i].contention - last[i].contention) + (stats[i].grace_waits - last[i].grace_waits);
+        if(waits > busiest)
+            busiest = waits;
+
+        writers += stats[i].contention;
+        readers += stats[i].grace_waits;
+
+        entries_total += stats[i].entries;
+        if(stats[i].entries < entries_min)
+            entries_min = stats[i].entries;
+        if(stats[i].entries > entries_max)
+            entries_max = stats[i].entries;
+    }
+    memcpy(last, stats, sizeof(last));
+
+    if (unlikely(!st_contention)) {
+        st_contention = rrdset_create_localhost(
+            "netdata"
+            , "strings_contention"
+            , NULL
+            , "strings"
+            , NULL
+            , "Strings index contention"
+            , "waits/s"
+            , "netdata"
+            , "pulse"
+            , 910002
+            , localhost->rrd_update_every
+            , RRDSET_TYPE_LINE);
+
+        rd_contention_writers = rrddim_add(st_contention, "writers", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+        rd_contention_readers = rrddim_add(st_contention, "readers", NULL, 1, 1, RRD_ALGORITHM_INCREMENTAL);
+        rd_contention_busiest = rrddim_add(st_contention, "busiest partition", NULL, 1, localhost->rrd_update_every, RRD_ALGORITHM_ABSOLUTE);
+    }
+
+    rrddim_set_by_pointer(st_contention, rd_contention_writers, (collected_number)writers);
+    rrddim_set_by_pointer(st_contention, rd_contention_readers, (collected_number)readers);
+    rrddim_set_by_pointer(st_contention, rd_contention_busiest, (collected_number)busiest);
+    rrdset_done(st_contention);
+
+    if (unlikely(!st_partitions)) {
+        st_partitions = rrdset_create_localhost(
+            "netdata"
+            , "strings_partitions"
+            , NULL
+            , "strings"
+            , NULL
+            , "Strings entries per partition"
+            , "entries"
+            , "netdata"
+            , "pulse"
+            , 910003
+            , localhost->rrd_update_every
+            , RRDSET_TYPE_LINE);
+
+        rd_partitions_min = rrddim_add(st_partitions, "min", NULL, 1, 1, RRD_ALGORITHM_ABSOLUTE);
+        rd_partitions_avg = rrddim_add(st_partitions, "average", NULL, 1, STRING_PARTITIONS, RRD_ALGORITHM_ABSOLUTE);
+        rd_partitions_max = rrddim_add(st_partitions, "max", NULL, 1, 1, RRD_ALGORITHM_ABSOLUTE);
+    }
+
+    rrddim_set_by_pointer(st_partitions, rd_partitions_min, (collected_number)entries_min);
+    rrddim_set_by_pointer(st_partitions, rd_partitions_avg, (collected_number)entries_total);
+    rrddim_set_by_pointer(st_partitions, rd_partitions_max, (collected_number)entries_max);
+    rrdset_done(st_partitions);
 }
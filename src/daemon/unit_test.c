@@ -90,6 +90,12 @@ static int check_number_printing(void) {
             { .n = -16777214999999997337621690403742592008192.0, .correct = "-1.677721499999999616e+40" },
             { .n = 9999.9999999, .correct = "9999.9999999" },
             { .n = -9999.9999999, .correct = "-9999.9999999" },
+            { .n = 1.05, .correct = "1.05" },
+            { .n = 0.0012345, .correct = "0.0012345" },
+            { .n = 100, .correct = "100" },
+            { .n = 1234567890123.0, .correct = "1234567890123" },
+            { .n = 18446744073709552.0, .correct = "18446744073709552" },
+            { .n = 0.99999999, .correct = "1" },
             { .n = 0, .correct = NULL },
     };
 
@@ -393,6 +399,88 @@ static int check_storage_number_exists() {
     return 0;
 }
 
+// values following the distributions found in query results
+static NETDATA_DOUBLE number_printing_value(size_t i, uint64_t *rng) {
+    *rng ^= *rng << 13;
+    *rng ^= *rng >> 7;
+    *rng ^= *rng << 17;
+    uint64_t r = *rng;
+
+    switch(i % 8) {
+        case 0: return 0;                                                   // idle dimensions
+        case 1: return (NETDATA_DOUBLE)(r % 10000000) / 100000.0;           // percentages
+        case 2: return (NETDATA_DOUBLE)(r % 100000);                        // gauges, integer rates
+        case 3: return (NETDATA_DOUBLE)(r % 100000000) * 8.0 / 1000.0;      // kilobits
+        case 4: return -(NETDATA_DOUBLE)(r % 100000000) * 8.0 / 1000.0;     // negative kilobits
+        case 5: return (NETDATA_DOUBLE)(r % 1000000) / 1024.0;              // KiB, MiB
+        case 6: return (NETDATA_DOUBLE)(r % 1000) / 3.0;                    // averages
+        default: return (NETDATA_DOUBLE)(r % 10000000000000ULL);            // bytes
+    }
+}
+
+int benchmark_number_printing(void) {
+    const size_t entries = 1000000, loops = 10;
+    NETDATA_DOUBLE *values = mallocz(entries * sizeof(NETDATA_DOUBLE));
+
+    uint64_t rng = 0x2545F4914F6CDD1DULL;
+    for(size_t i = 0; i < entries ; i++)
+        values[i] = number_printing_value(i, &rng);
+
+    char buffer[DOUBLE_MAX_LENGTH];
+    size_t bytes = 0, errors = 0;
+
+    usec_t started_ut = now_monotonic_usec();
+    for(size_t l = 0; l < loops ; l++)
+        for(size_t i = 0; i < entries ; i++)
+            bytes += print_netdata_double(buffer, values[i]);
+    usec_t netdata_ut = now_monotonic_usec() - started_ut;
+
+    started_ut = now_monotonic_usec();
+    for(size_t l = 0; l < loops ; l++)
+        for(size_t i = 0; i < entries ; i++)
+            bytes += snprintfz(buffer, sizeof(buffer) - 1, NETDATA_DOUBLE_FORMAT, values[i]);
+    usec_t system_ut = now_monotonic_usec() - started_ut;
+
+    BUFFER *wb = buffer_create(entries * 16, NULL);
+    started_ut = now_monotonic_usec();
+    for(size_t l = 0; l < loops ; l++) {
+        buffer_flush(wb);
+        for(size_t i = 0; i < entries ; i++) {
+            buffer_print_netdata_double(wb, values[i]);
+            buffer_putc(wb, ',');
+        }
+    }
+    usec_t buffer_ut = now_monotonic_usec() - started_ut;
+    buffer_free(wb);
+
+    // the printed values have to be parsed back within the last of the 7 fractional digits
+    for(size_t i = 0; i < entries ; i++) {
+        print_netdata_double(buffer, values[i]);
+        NETDATA_DOUBLE parsed = str2ndd(buffer, NULL);
+        NETDATA_DOUBLE diff = fabsndd(parsed - values[i]);
+        if(diff > 0.0000001 && diff > fabsndd(values[i]) * 0.0000001) {
+            if(errors++ < 10)
+                fprintf(stderr, "number " NETDATA_DOUBLE_FORMAT_G " printed as '%s', parsed as " NETDATA_DOUBLE_FORMAT_G "\n",
+                        values[i], buffer, parsed);
+        }
+    }
+
+    size_t n = entries * loops;
+    fprintf(stderr, "\nNUMBER PRINTING of %zu values (%zu bytes):\n"
+                    "   print_netdata_double(): %0.2f ns per value\n"
+                    "   buffer_print_netdata_double(): %0.2f ns per value\n"
+                    "   snprintf(\"%s\"): %0.2f ns per value\n"
+                    "   parsing errors: %zu\n",
+            n, bytes,
+            (double)netdata_ut * 1000.0 / (double)n,
+            (double)buffer_ut * 1000.0 / (double)n,
+            NETDATA_DOUBLE_FORMAT, (double)system_ut * 1000.0 / (double)n,
+            errors);
+
+    freez(values);
+    return errors ? 1 : 0;
+}
+
 int unit_test_storage() {
     if(check_storage_number_exists()) return 0;
 
@@ -1414,6 +1502,220 @@ static int test_variable_renames(void) {
     return 1;
 }
 
+static int columnar_unittest_query(RRDSET *st, DATASOURCE_FORMAT format, BUFFER *wb) {
+    QUERY_TARGET_REQUEST qtr = {
+            .version = 2,
+            .st = st,
+            .after = rrdset_first_entry_s(st),
+            .before = rrdset_last_entry_s(st),
+            .points = 5,
+            .format = format,
+            .options = RRDR_OPTION_NOT_ALIGNED,
+            .time_group_method = RRDR_GROUPING_AVERAGE,
+            .query_source = QUERY_SOURCE_UNITTEST,
+            .priority = STORAGE_PRIORITY_NORMAL,
+    };
+
+    ONEWAYALLOC *owa = onewayalloc_create(0);
+    QUERY_TARGET *qt = query_target_create(&qtr);
+    int ret = data_query_execute(owa, wb, qt, NULL);
+    query_target_release(qt);
+    onewayalloc_destroy(owa);
+
+    return ret;
+}
+
+static struct json_object *columnar_unittest_member(struct json_object *obj, const char *key, enum json_type type) {
+    struct json_object *member = NULL;
+    if(!obj || !json_object_object_get_ex(obj, key, &member) || !json_object_is_type(member, type))
+        return NULL;
+
+    return member;
+}
+
+static struct json_object *columnar_unittest_column(struct json_object *columns, const char *name) {
+    size_t count = json_object_array_length(columns);
+    for(size_t i = 0; i < count ; i++) {
+        struct json_object *column = json_object_array_get_idx(columns, i);
+        struct json_object *n = columnar_unittest_member(column, "name", json_type_string);
+        if(n && strcmp(json_object_get_string(n), name) == 0)
+            return column;
+    }
+
+    return NULL;
+}
+
+// decode the columnar response and compare its labels (strings), its time and value columns (numbers)
+// and its number of rows, with the json2 response of the same query
+static int check_columnar_decode(BUFFER *columnar, BUFFER *json2) {
+    const uint8_t *buf = (const uint8_t *)buffer_tostring(columnar);
+    size_t len = buffer_strlen(columnar);
+
+    if(len < COLUMNAR_MAGIC_LEN + 4 || memcmp(buf, COLUMNAR_MAGIC, COLUMNAR_MAGIC_LEN) != 0) {
+        fprintf(stderr, "columnar query response does not start with the magic\n");
+        return 1;
+    }
+
+    const uint8_t *hl = &buf[COLUMNAR_MAGIC_LEN];
+    size_t header_length = (size_t)hl[0] | ((size_t)hl[1] << 8) | ((size_t)hl[2] << 16) | ((size_t)hl[3] << 24);
+    size_t header_pos = COLUMNAR_MAGIC_LEN + 4;
+    if(header_pos + header_length > len) {
+        fprintf(stderr, "columnar header length %zu exceeds the response length %zu\n", header_length, len);
+        return 1;
+    }
+
+    char *header = strndupz((const char *)&buf[header_pos], header_length);
+    CLEAN_JSON_OBJECT *cjson = json_tokener_parse(header);
+    freez(header);
+    CLEAN_JSON_OBJECT *jjson = json_tokener_parse(buffer_tostring(json2));
+
+    struct json_object *cresult = columnar_unittest_member(cjson, "result", json_type_object);
+    struct json_object *jresult = columnar_unittest_member(jjson, "result", json_type_object);
+    struct json_object *clabels = columnar_unittest_member(cresult, "labels", json_type_array);
+    struct json_object *jlabels = columnar_unittest_member(jresult, "labels", json_type_array);
+    struct json_object *crows = columnar_unittest_member(cresult, "rows", json_type_int);
+    struct json_object *columns = columnar_unittest_member(cresult, "columns", json_type_array);
+    struct json_object *jdata = columnar_unittest_member(jresult, "data", json_type_array);
+    if(!clabels || !jlabels || !crows || !columns || !jdata) {
+        fprintf(stderr, "columnar or json2 response does not have the expected result members\n");
+        return 1;
+    }
+
+    int errors = 0;
+
+    // the string column: the labels
+    size_t labels = json_object_array_length(clabels);
+    if(labels != 2 || labels != json_object_array_length(jlabels)) {
+        fprintf(stderr, "columnar response has %zu labels, json2 has %zu, expected 2\n",
+                labels, json_object_array_length(jlabels));
+        return 1;
+    }
+
+    for(size_t i = 0; i < labels ; i++) {
+        const char *c = json_object_get_string(json_object_array_get_idx(clabels, i));
+        const char *j = json_object_get_string(json_object_array_get_idx(jlabels, i));
+        if(!c || !j || strcmp(c, j) != 0) {
+            fprintf(stderr, "columnar label %zu is '%s', json2 has '%s'\n", i, c ? c : "(null)", j ? j : "(null)");
+            errors++;
+        }
+    }
+
+    // the number of rows
+    size_t rows = (size_t)json_object_get_int64(crows);
+    if(!rows || rows != json_object_array_length(jdata)) {
+        fprintf(stderr, "columnar response has %zu rows, json2 has %zu\n", rows, json_object_array_length(jdata));
+        return errors + 1;
+    }
+
+    // the offsets of the columns
+    size_t data_pos = header_pos + header_length;
+    data_pos += (COLUMNAR_ALIGNMENT - (data_pos % COLUMNAR_ALIGNMENT)) % COLUMNAR_ALIGNMENT;
+    size_t data_len = len > data_pos ? len - data_pos : 0;
+
+    const uint8_t *time_col = NULL, *value_col = NULL;
+    const char *names[] = { "time", "value" };
+    const uint8_t **cols[] = { &time_col, &value_col };
+    for(size_t c = 0; c < _countof(names) ; c++) {
+        struct json_object *column = columnar_unittest_column(columns, names[c]);
+        struct json_object *offset = columnar_unittest_member(column, "offset", json_type_int);
+        struct json_object *length = columnar_unittest_member(column, "length", json_type_int);
+        if(!offset || !length) {
+            fprintf(stderr, "columnar response does not have a '%s' column\n", names[c]);
+            return errors + 1;
+        }
+
+        // both columns have 8 byte values, and the chart has a single dimension
+        size_t o = (size_t)json_object_get_int64(offset);
+        size_t l = (size_t)json_object_get_int64(length);
+        if(o % COLUMNAR_ALIGNMENT || l != rows * sizeof(int64_t) || o + l > data_len) {
+            fprintf(stderr, "columnar column '%s' has offset %zu and length %zu, in a data section of %zu bytes with %zu rows\n",
+                    names[c], o, l, data_len, rows);
+            return errors + 1;
+        }
+
+        *cols[c] = &buf[data_pos + o];
+    }
+
+    // the numeric columns: time and value
+    for(size_t i = 0; i < rows ; i++) {
+        struct json_object *row = json_object_array_get_idx(jdata, i);
+        struct json_object *point = json_object_array_get_idx(row, 1);
+        struct json_object *jvalue = json_object_array_get_idx(point, 0);
+
+        int64_t t;
+        double v;
+        memcpy(&t, &time_col[i * sizeof(t)], sizeof(t));
+        memcpy(&v, &value_col[i * sizeof(v)], sizeof(v));
+
+        int64_t jt = json_object_get_int64(json_object_array_get_idx(row, 0));
+        if(t != jt) {
+            fprintf(stderr, "columnar row %zu has time %"PRId64", json2 has %"PRId64"\n", i, t, jt);
+            errors++;
+        }
+
+        if(!jvalue || json_object_is_type(jvalue, json_type_null)) {
+            if(!isnan(v)) {
+                fprintf(stderr, "columnar row %zu has value %f, json2 has null\n", i, v);
+                errors++;
+            }
+        }
+        else if(isnan(v) || fabs(v - json_object_get_double(jvalue)) > 0.0001) {
+            fprintf(stderr, "columnar row %zu has value %f, json2 has %f\n", i, v, json_object_get_double(jvalue));
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+static int check_columnar_content_type(void) {
+    fprintf(stderr, "%s() running...\n", __FUNCTION__ );
+
+    default_rrd_memory_mode = RRD_DB_MODE_ALLOC;
+    nd_profile.update_every = 1;
+
+    RRDSET *st = rrdset_create_localhost("netdata", "unittest-columnar", "unittest-columnar", "netdata", NULL, "Unit Testing", "a value", "unittest", NULL, 1, 1
+                                         , RRDSET_TYPE_LINE);
+    rrddim_add(st, "dim1", NULL, 1, 1, RRD_ALGORITHM_ABSOLUTE);
+
+    for(collected_number c = 0; c < 10 ; c++) {
+        if(c)
+            st->usec_since_last_update = USEC_PER_SEC;
+
+        rrddim_set(st, "dim1", c);
+
+        struct timeval now;
+        now_realtime_timeval(&now);
+        rrdset_timed_done(st, now, false);
+    }
+
+    BUFFER *wb = buffer_create(0, NULL);
+    BUFFER *json2 = buffer_create(0, NULL);
+    int ret = columnar_unittest_query(st, DATASOURCE_COLUMNAR, wb);
+    int ret_json2 = columnar_unittest_query(st, DATASOURCE_JSON2, json2);
+
+    int errors = 0;
+    if(ret != HTTP_RESP_OK || ret_json2 != HTTP_RESP_OK) {
+        fprintf(stderr, "columnar query failed with response code %d (json2 %d)\n", ret, ret_json2);
+        errors++;
+    }
+    else {
+        if(wb->content_type != CT_APPLICATION_NETDATA_COLUMNAR) {
+            fprintf(stderr, "columnar query returned content type '%s', expected '%s'\n",
+                    content_type_id2string(wb->content_type), COLUMNAR_MEDIA_TYPE);
+            errors++;
+        }
+
+        errors += check_columnar_decode(wb, json2);
+    }
+
+    buffer_free(json2);
+    buffer_free(wb);
+
+    fprintf(stderr, "columnar content type and decoding: %s\n", errors ? "FAILED" : "OK");
+    return errors;
+}
+
 int check_strdupz_path_subpath() {
 
     struct strdupz_path_subpath_checks {
@@ -1522,6 +1824,9 @@ int run_all_mockup_tests(void)
     if(run_test(&test15))
         return 1;
 
+    if(check_columnar_content_type())
+        return 1;
+
 
 
     return 0;
@@ -9,6 +9,7 @@ int unit_test_storage(void);
 int unit_test(long delay, long shift);
 int run_all_mockup_tests(void);
 int unit_test_str2ld(void);
+int benchmark_number_printing(void);
 int unit_test_buffer(void);
 int unit_test_static_threads(void);
 int test_sqlite(void);
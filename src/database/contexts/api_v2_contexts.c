@@ -90,6 +90,11 @@ static FTS_MATCH rrdcontext_to_json_v2_full_text_search(struct rrdcontext_to_jso
     if(unlikely(full_text_search_string(&ctl->q.fts, q, rc->units)))
         return FTS_MATCHED_UNITS;
 
+    // on contexts with many instances, the labels are matched once, using the labels index of the context
+    bool labels_indexed = false;
+    bool labels_use_index = dictionary_entries(rc->rrdinstances) >= RRDCONTEXT_LABELS_INDEX_MIN_INSTANCES;
+    Pvoid_t labels_matched = NULL;
+
     FTS_MATCH matched = FTS_MATCHED_NONE;
     RRDINSTANCE *ri;
     dfe_start_read(rc->rrdinstances, ri) {
@@ -118,17 +123,29 @@ static FTS_MATCH rrdcontext_to_json_v2_full_text_search(struct rrdcontext_to_jso
         dfe_done(rm);
 
         size_t label_searches = 0;
-        RRDLABELS *labels = rrdinstance_labels(ri);
-        if(unlikely(rrdlabels_entries(labels) &&
-                    rrdlabels_match_simple_pattern_parsed(labels, q, ':', &label_searches) == SP_MATCHED_POSITIVE)) {
-            ctl->q.fts.searches += label_searches;
-            ctl->q.fts.char_searches += label_searches;
-            matched = FTS_MATCHED_LABEL;
-            break;
+        bool label_matched;
+        if(labels_use_index) {
+            if(!labels_indexed) {
+                rrdcontext_labels_index_full_text_search(rc, q, &labels_matched, &label_searches);
+                labels_indexed = true;
+            }
+
+            label_matched = JudyLGet(labels_matched, (Word_t)ri, PJE0) != NULL;
+        }
+        else {
+            RRDLABELS *labels = rrdinstance_labels(ri);
+            label_matched = rrdlabels_entries(labels) &&
+                            rrdlabels_match_simple_pattern_parsed(labels, q, ':', &label_searches) == SP_MATCHED_POSITIVE;
         }
+
         ctl->q.fts.searches += label_searches;
         ctl->q.fts.char_searches += label_searches;
 
+        if(unlikely(label_matched)) {
+            matched = FTS_MATCHED_LABEL;
+            break;
+        }
+
         if(ri->rrdset) {
             RRDSET *st = ri->rrdset;
             rw_spinlock_read_lock(&st->alerts.spinlock);
@@ -147,6 +164,8 @@ static FTS_MATCH rrdcontext_to_json_v2_full_text_search(struct rrdcontext_to_jso
         }
     }
     dfe_done(ri);
+
+    JudyLFreeArray(&labels_matched, PJE0);
     return matched;
 }
 
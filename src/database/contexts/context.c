@@ -96,6 +96,7 @@ static void rrdcontext_delete_callback(const DICTIONARY_ITEM *item __maybe_unuse
     // update the count of contexts
     __atomic_sub_fetch(&rc->rrdhost->rrdctx.contexts_count, 1, __ATOMIC_RELAXED);
 
+    rrdcontext_labels_index_free(rc);
     rrdinstances_destroy_from_rrdcontext(rc);
     rrdcontext_freez(rc);
 }
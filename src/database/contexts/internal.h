@@ -257,6 +257,8 @@ typedef struct rrdinstance {
     } internal;
 } RRDINSTANCE;
 
+typedef struct rrdcontext_labels_index RRDCONTEXT_LABELS_INDEX;
+
 typedef struct rrdcontext {
     uint64_t version;
 
@@ -278,6 +280,8 @@ typedef struct rrdcontext {
     DICTIONARY *rrdinstances;
     RRDHOST *rrdhost;
 
+    RRDCONTEXT_LABELS_INDEX *labels_index;  // built on demand by queries filtering instances by label
+
     struct {
         RRD_FLAGS queued_flags;         // the last flags that triggered the post-processing
         size_t executions;              // how many times this context has been processed
@@ -457,6 +461,11 @@ void rrdcontext_trigger_updates(RRDCONTEXT *rc, const char *function);
 void rrdinstances_create_in_rrdcontext(RRDCONTEXT *rc);
 void rrdinstances_destroy_from_rrdcontext(RRDCONTEXT *rc);
 
+#define RRDCONTEXT_LABELS_INDEX_MIN_INSTANCES 64
+void rrdcontext_labels_index_match(RRDCONTEXT *rc, SIMPLE_PATTERN *chart_label_key_sp, struct pattern_array *pa, Pvoid_t *matched);
+void rrdcontext_labels_index_full_text_search(RRDCONTEXT *rc, SIMPLE_PATTERN *q, Pvoid_t *matched, size_t *searches);
+void rrdcontext_labels_index_free(RRDCONTEXT *rc);
+
 void rrdmetrics_destroy_from_rrdinstance(RRDINSTANCE *ri);
 void rrdmetrics_create_in_rrdinstance(RRDINSTANCE *ri);
 
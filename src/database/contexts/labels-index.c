@@ -0,0 +1,398 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "internal.h"
+
+// ----------------------------------------------------------------------------
+// inverted index of the labels of the instances of a context
+//
+// labels are interned by rrdlabels: the same key and value pair has the same
+// id everywhere, so the index maps each label id to the list of the instances
+// having it (a posting list).
+//
+// the index is built on demand, the first time a query with label filters,
+// a query grouping by label, or a full text search runs on the context, and
+// it is rebuilt when instances are added or removed
+// from the context, or when the labels of any of its instances change. To
+// find the latter, the index keeps the labels and their membership version
+// it has seen for each instance.
+//
+// the instance pointers kept in the index are never dereferenced. They are only
+// compared with the instances the queries have acquired.
+
+struct rrdcontext_labels_index_label {
+    STRING *key;
+    STRING *value;
+    uint32_t used;
+    uint32_t size;
+    RRDINSTANCE **instances;
+};
+
+struct rrdcontext_labels_index_instance {
+    RRDLABELS *labels;
+    size_t membership_version;
+};
+
+struct rrdcontext_labels_index {
+    int32_t refcount;
+    size_t instances_version;
+    Pvoid_t JudyL;                          // label id -> struct rrdcontext_labels_index_label
+    Pvoid_t instances;                      // RRDINSTANCE * -> struct rrdcontext_labels_index_instance
+};
+
+static void rrdcontext_labels_index_destroy(RRDCONTEXT_LABELS_INDEX *li) {
+    Word_t id = 0;
+    Pvoid_t *PValue;
+    bool first = true;
+    while((PValue = JudyLFirstThenNext(li->JudyL, &id, &first))) {
+        struct rrdcontext_labels_index_label *lbl = *PValue;
+        string_freez(lbl->key);
+        string_freez(lbl->value);
+        freez(lbl->instances);
+        freez(lbl);
+    }
+
+    JudyLFreeArray(&li->JudyL, PJE0);
+
+    Word_t ri = 0;
+    first = true;
+    while((PValue = JudyLFirstThenNext(li->instances, &ri, &first)))
+        freez(*PValue);
+
+    JudyLFreeArray(&li->instances, PJE0);
+    freez(li);
+}
+
+static void rrdcontext_labels_index_release(RRDCONTEXT_LABELS_INDEX *li) {
+    if(li && __atomic_sub_fetch(&li->refcount, 1, __ATOMIC_ACQ_REL) == 0)
+        rrdcontext_labels_index_destroy(li);
+}
+
+struct rrdcontext_labels_index_add {
+    RRDCONTEXT_LABELS_INDEX *li;
+    RRDINSTANCE *ri;
+};
+
+static int rrdcontext_labels_index_add_label(uintptr_t id, STRING *key, STRING *value, void *data) {
+    struct rrdcontext_labels_index_add *t = data;
+
+    Pvoid_t *PValue = JudyLIns(&t->li->JudyL, (Word_t)id, PJE0);
+    if(unlikely(!PValue || PValue == PJERR))
+        fatal("RRDCONTEXT: corrupted labels index JudyL array");
+
+    struct rrdcontext_labels_index_label *lbl = *PValue;
+    if(!lbl) {
+        lbl = callocz(1, sizeof(*lbl));
+        lbl->key = string_dup(key);
+        lbl->value = string_dup(value);
+        *PValue = lbl;
+    }
+
+    if(lbl->used == lbl->size) {
+        lbl->size = lbl->size ? lbl->size * 2 : 4;
+        lbl->instances = reallocz(lbl->instances, lbl->size * sizeof(*lbl->instances));
+    }
+
+    lbl->instances[lbl->used++] = t->ri;
+
+    return 0;
+}
+
+static RRDCONTEXT_LABELS_INDEX *rrdcontext_labels_index_create(RRDCONTEXT *rc) {
+    RRDCONTEXT_LABELS_INDEX *li = callocz(1, sizeof(*li));
+    li->refcount = 1;
+
+    // get the versions before looking at the labels, so that changes
+    // happening while we build the index will invalidate it
+    li->instances_version = dictionary_version(rc->rrdinstances);
+
+    struct rrdcontext_labels_index_add t = {
+        .li = li,
+    };
+
+    RRDINSTANCE *ri;
+    dfe_start_read(rc->rrdinstances, ri) {
+        // this may load the labels of archived instances from the database
+        RRDLABELS *labels = rrdinstance_labels(ri);
+
+        struct rrdcontext_labels_index_instance *lii = mallocz(sizeof(*lii));
+        lii->labels = labels;
+        lii->membership_version = rrdlabels_membership_version(labels);
+
+        Pvoid_t *PValue = JudyLIns(&li->instances, (Word_t)ri, PJE0);
+        if(unlikely(!PValue || PValue == PJERR))
+            fatal("RRDCONTEXT: corrupted labels index instances JudyL array");
+
+        freez(*PValue);
+        *PValue = lii;
+
+        t.ri = ri;
+        rrdlabels_walkthrough_read_with_id(labels, rrdcontext_labels_index_add_label, &t);
+    }
+    dfe_done(ri);
+
+    return li;
+}
+
+static bool rrdcontext_labels_index_is_current(RRDCONTEXT_LABELS_INDEX *li, RRDCONTEXT *rc) {
+    if(li->instances_version != dictionary_version(rc->rrdinstances))
+        return false;
+
+    bool current = true;
+    RRDINSTANCE *ri;
+    dfe_start_read(rc->rrdinstances, ri) {
+        Pvoid_t *PValue = JudyLGet(li->instances, (Word_t)ri, PJE0);
+        struct rrdcontext_labels_index_instance *lii = PValue ? *PValue : NULL;
+        RRDLABELS *labels = rrdinstance_labels(ri);
+
+        if(!lii || lii->labels != labels || lii->membership_version != rrdlabels_membership_version(labels)) {
+            current = false;
+            break;
+        }
+    }
+    dfe_done(ri);
+
+    return current;
+}
+
+static RRDCONTEXT_LABELS_INDEX *rrdcontext_labels_index_acquire(RRDCONTEXT *rc) {
+    rrdcontext_lock(rc);
+    RRDCONTEXT_LABELS_INDEX *li = rc->labels_index;
+    if(li)
+        __atomic_add_fetch(&li->refcount, 1, __ATOMIC_ACQUIRE);
+    rrdcontext_unlock(rc);
+
+    if(li && rrdcontext_labels_index_is_current(li, rc))
+        return li;
+
+    rrdcontext_labels_index_release(li);
+
+    li = rrdcontext_labels_index_create(rc);
+
+    // one reference for the context, one for the caller
+    __atomic_add_fetch(&li->refcount, 1, __ATOMIC_ACQUIRE);
+
+    rrdcontext_lock(rc);
+    RRDCONTEXT_LABELS_INDEX *old = rc->labels_index;
+    rc->labels_index = li;
+    rrdcontext_unlock(rc);
+
+    rrdcontext_labels_index_release(old);
+
+    return li;
+}
+
+void rrdcontext_labels_index_free(RRDCONTEXT *rc) {
+    rrdcontext_lock(rc);
+    RRDCONTEXT_LABELS_INDEX *li = rc->labels_index;
+    rc->labels_index = NULL;
+    rrdcontext_unlock(rc);
+
+    rrdcontext_labels_index_release(li);
+}
+
+// ----------------------------------------------------------------------------
+// matching
+//
+// rrdlabels_match_simple_pattern_parsed() walks the labels of an instance in
+// ascending order of their ids and stops at the first label that does not
+// return SP_NOT_MATCHED. Walking the index in the same order, and assigning
+// each instance the result of the first label found having it, gives exactly
+// the same result, while each pattern is evaluated once per distinct label.
+
+static void rrdcontext_labels_index_match_pattern(RRDCONTEXT_LABELS_INDEX *li, SIMPLE_PATTERN *sp, char equal, Pvoid_t *results, size_t *searches) {
+    Word_t id = 0;
+    Pvoid_t *PValue;
+    bool first = true;
+    while((PValue = JudyLFirstThenNext(li->JudyL, &id, &first))) {
+        struct rrdcontext_labels_index_label *lbl = *PValue;
+
+        if(searches)
+            (*searches)++;
+
+        SIMPLE_PATTERN_RESULT ret = rrdlabel_match_simple_pattern_parsed(
+            string2str(lbl->key), string2str(lbl->value), sp, equal);
+
+        if(ret == SP_NOT_MATCHED)
+            continue;
+
+        for(uint32_t i = 0; i < lbl->used; i++) {
+            Pvoid_t *PResult = JudyLIns(results, (Word_t)lbl->instances[i], PJE0);
+            if(unlikely(!PResult || PResult == PJERR))
+                fatal("RRDCONTEXT: corrupted labels index results JudyL array");
+
+            if(!*PResult)
+                *(Word_t *)PResult = (Word_t)ret + 1;
+        }
+    }
+}
+
+// keep in matched only the instances that have SP_MATCHED_POSITIVE in results
+static void rrdcontext_labels_index_intersect(Pvoid_t *matched, bool *initialized, Pvoid_t results) {
+    Word_t ri = 0;
+    Pvoid_t *PValue;
+    bool first = true;
+
+    if(!*initialized) {
+        while((PValue = JudyLFirstThenNext(results, &ri, &first))) {
+            if(*(Word_t *)PValue == (Word_t)SP_MATCHED_POSITIVE + 1) {
+                PValue = JudyLIns(matched, ri, PJE0);
+                *(Word_t *)PValue = 1;
+            }
+        }
+        *initialized = true;
+        return;
+    }
+
+    while((PValue = JudyLFirstThenNext(*matched, &ri, &first))) {
+        Pvoid_t *PResult = JudyLGet(results, ri, PJE0);
+        if(!PResult || *(Word_t *)PResult != (Word_t)SP_MATCHED_POSITIVE + 1)
+            (void)JudyLDel(matched, ri, PJE0);
+    }
+}
+
+// fills matched with the instances of the context matching both filters, the way
+// rrdlabels_match_simple_pattern_parsed() and pattern_array_label_match() would match them
+void rrdcontext_labels_index_match(RRDCONTEXT *rc, SIMPLE_PATTERN *chart_label_key_sp, struct pattern_array *pa, Pvoid_t *matched) {
+    RRDCONTEXT_LABELS_INDEX *li = rrdcontext_labels_index_acquire(rc);
+    bool initialized = false;
+
+    if(chart_label_key_sp) {
+        Pvoid_t results = NULL;
+        rrdcontext_labels_index_match_pattern(li, chart_label_key_sp, '\0', &results, NULL);
+        rrdcontext_labels_index_intersect(matched, &initialized, results);
+        JudyLFreeArray(&results, PJE0);
+    }
+
+    Word_t key = 0;
+    Pvoid_t *PValue;
+    bool first = true;
+    while(pa && (PValue = JudyLFirstThenNext(pa->JudyL, &key, &first))) {
+        // all the label keys of the pattern array have to match (AND)
+        struct pattern_array *pai = *PValue;
+
+        // the first pattern of the key that is not SP_NOT_MATCHED decides (OR)
+        Pvoid_t key_results = NULL;
+
+        Word_t idx = 0;
+        bool first2 = true;
+        while((PValue = JudyLFirstThenNext(pai->JudyL, &idx, &first2))) {
+            if(!*PValue)
+                continue;
+
+            Pvoid_t results = NULL;
+            rrdcontext_labels_index_match_pattern(li, (SIMPLE_PATTERN *)*PValue, ':', &results, NULL);
+
+            Word_t ri = 0;
+            bool first3 = true;
+            Pvoid_t *PResult;
+            while((PResult = JudyLFirstThenNext(results, &ri, &first3))) {
+                Pvoid_t *PKey = JudyLIns(&key_results, ri, PJE0);
+                if(!*PKey)
+                    *(Word_t *)PKey = *(Word_t *)PResult;
+            }
+            JudyLFreeArray(&results, PJE0);
+        }
+
+        rrdcontext_labels_index_intersect(matched, &initialized, key_results);
+        JudyLFreeArray(&key_results, PJE0);
+
+        if(!*matched)
+            break;
+    }
+
+    rrdcontext_labels_index_release(li);
+}
+
+// fills matched with the instances of the context having labels matching the full text search
+// pattern, the way rrdlabels_match_simple_pattern_parsed() would match them
+void rrdcontext_labels_index_full_text_search(RRDCONTEXT *rc, SIMPLE_PATTERN *q, Pvoid_t *matched, size_t *searches) {
+    RRDCONTEXT_LABELS_INDEX *li = rrdcontext_labels_index_acquire(rc);
+
+    Pvoid_t results = NULL;
+    rrdcontext_labels_index_match_pattern(li, q, ':', &results, searches);
+
+    bool initialized = false;
+    rrdcontext_labels_index_intersect(matched, &initialized, results);
+    JudyLFreeArray(&results, PJE0);
+
+    rrdcontext_labels_index_release(li);
+}
+
+// ----------------------------------------------------------------------------
+// label values of the instances
+//
+// group-by-label needs the values a few label keys have on each instance.
+// Instead of walking the labels of every instance once per key, the labels
+// of the index having these keys give the values of all the instances at once.
+
+// adds to values (RRDINSTANCE * -> STRING *[keys_count]) all the instances of a context
+// having at least RRDCONTEXT_LABELS_INDEX_MIN_INSTANCES instances, with the values of
+// the given label keys (NULL when unset) - returns false when the context is not indexed
+bool rrdcontext_acquired_labels_values(RRDCONTEXT_ACQUIRED *rca, char **keys, size_t keys_count, Pvoid_t *values) {
+    RRDCONTEXT *rc = rrdcontext_acquired_value(rca);
+
+    if(!keys_count || dictionary_entries(rc->rrdinstances) < RRDCONTEXT_LABELS_INDEX_MIN_INSTANCES)
+        return false;
+
+    RRDCONTEXT_LABELS_INDEX *li = rrdcontext_labels_index_acquire(rc);
+
+    STRING *keys_str[keys_count];
+    for(size_t k = 0; k < keys_count; k++)
+        keys_str[k] = string_strdupz(keys[k]);
+
+    Word_t ri = 0;
+    Pvoid_t *PValue;
+    bool first = true;
+    while((PValue = JudyLFirstThenNext(li->instances, &ri, &first))) {
+        Pvoid_t *PInstance = JudyLIns(values, ri, PJE0);
+        if(unlikely(!PInstance || PInstance == PJERR))
+            fatal("RRDCONTEXT: corrupted labels values JudyL array");
+
+        if(!*PInstance)
+            *PInstance = callocz(keys_count, sizeof(STRING *));
+    }
+
+    Word_t id = 0;
+    first = true;
+    while((PValue = JudyLFirstThenNext(li->JudyL, &id, &first))) {
+        struct rrdcontext_labels_index_label *lbl = *PValue;
+
+        for(size_t k = 0; k < keys_count; k++) {
+            if(lbl->key != keys_str[k])
+                continue;
+
+            for(uint32_t i = 0; i < lbl->used; i++) {
+                Pvoid_t *PInstance = JudyLGet(*values, (Word_t)lbl->instances[i], PJE0);
+                STRING **v = PInstance ? *PInstance : NULL;
+                if(v && !v[k])
+                    v[k] = string_dup(lbl->value);
+            }
+        }
+    }
+
+    for(size_t k = 0; k < keys_count; k++)
+        string_freez(keys_str[k]);
+
+    rrdcontext_labels_index_release(li);
+    return true;
+}
+
+// the values of the label keys of an instance, or NULL when its context is not in values
+STRING **rrdinstance_acquired_labels_values(RRDINSTANCE_ACQUIRED *ria, Pvoid_t values) {
+    Pvoid_t *PValue = JudyLGet(values, (Word_t)rrdinstance_acquired_value(ria), PJE0);
+    return PValue ? *PValue : NULL;
+}
+
+void rrdcontext_labels_values_free(Pvoid_t *values, size_t keys_count) {
+    Word_t ri = 0;
+    Pvoid_t *PValue;
+    bool first = true;
+    while((PValue = JudyLFirstThenNext(*values, &ri, &first))) {
+        STRING **v = *PValue;
+        for(size_t k = 0; k < keys_count; k++)
+            string_freez(v[k]);
+        freez(v);
+    }
+
+    JudyLFreeArray(values, PJE0);
+}
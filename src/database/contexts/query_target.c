@@ -181,6 +181,14 @@ void query_target_free(void) {
 // ----------------------------------------------------------------------------
 // query API
 
+typedef struct query_instance_labels_filter {
+    SIMPLE_PATTERN *chart_label_key_sp;
+    struct pattern_array *pa;           // the labels pattern, split per label key
+
+    bool indexed;                       // the instances of the current context have been matched via its labels index
+    Pvoid_t matched;                    // JudyL of the RRDINSTANCE pointers matched, when indexed
+} QUERY_INSTANCE_LABELS_FILTER;
+
 typedef struct query_target_locals {
     time_t start_s;
 
@@ -208,6 +216,8 @@ typedef struct query_target_locals {
 
     char host_node_id_str[UUID_STR_LEN];
     QUERY_NODE *qn; // temp to pass on callbacks, ignore otherwise - no need to free
+
+    QUERY_INSTANCE_LABELS_FILTER labels_filter;
 } QUERY_TARGET_LOCALS;
 
 struct storage *query_metric_storage_engine(QUERY_TARGET *qt, QUERY_METRIC *qm, size_t tier) {
@@ -726,22 +736,55 @@ static inline SIMPLE_PATTERN_RESULT query_instance_matches(QUERY_INSTANCE *qi,
     return ret;
 }
 
-static inline bool query_instance_matches_labels(
-    RRDINSTANCE *ri,
-    SIMPLE_PATTERN *chart_label_key_sp,
-    SIMPLE_PATTERN *labels_sp)
-{
+// ----------------------------------------------------------------------------
+// label filters on instances
+
+static void query_instance_labels_filter_init(QUERY_INSTANCE_LABELS_FILTER *lf, SIMPLE_PATTERN *chart_label_key_sp, SIMPLE_PATTERN *labels_sp) {
+    memset(lf, 0, sizeof(*lf));
+    lf->chart_label_key_sp = chart_label_key_sp;
+
+    if(labels_sp)
+        lf->pa = pattern_array_add_simple_pattern(NULL, labels_sp, ':');
+}
+
+static void query_instance_labels_filter_cleanup(QUERY_INSTANCE_LABELS_FILTER *lf) {
+    JudyLFreeArray(&lf->matched, PJE0);
+    lf->indexed = false;
+
+    pattern_array_free(lf->pa);
+    lf->pa = NULL;
+}
+
+// on contexts with many instances, match all of them at once, using the labels index of the context
+static void query_instance_labels_filter_context_start(QUERY_INSTANCE_LABELS_FILTER *lf, RRDCONTEXT *rc) {
+    if(!lf->chart_label_key_sp && !(lf->pa && lf->pa->JudyL))
+        return;
+
+    if(dictionary_entries(rc->rrdinstances) < RRDCONTEXT_LABELS_INDEX_MIN_INSTANCES)
+        return;
+
+    rrdcontext_labels_index_match(rc, lf->chart_label_key_sp, lf->pa, &lf->matched);
+    lf->indexed = true;
+}
+
+static void query_instance_labels_filter_context_done(QUERY_INSTANCE_LABELS_FILTER *lf) {
+    JudyLFreeArray(&lf->matched, PJE0);
+    lf->indexed = false;
+}
+
+static inline bool query_instance_labels_filter_matches(QUERY_INSTANCE_LABELS_FILTER *lf, RRDINSTANCE *ri) {
+    if(lf->indexed)
+        return JudyLGet(lf->matched, (Word_t)ri, PJE0) != NULL;
+
+    if(!lf->chart_label_key_sp && !lf->pa)
+        return true;
 
     RRDLABELS *labels = rrdinstance_labels(ri);
-    if (chart_label_key_sp && rrdlabels_match_simple_pattern_parsed(labels, chart_label_key_sp, '\0', NULL) != SP_MATCHED_POSITIVE)
+    if (lf->chart_label_key_sp && rrdlabels_match_simple_pattern_parsed(labels, lf->chart_label_key_sp, '\0', NULL) != SP_MATCHED_POSITIVE)
         return false;
 
-    if (labels_sp) {
-        struct pattern_array *pa = pattern_array_add_simple_pattern(NULL, labels_sp, ':');
-        bool found = pattern_array_label_match(pa, labels, ':', NULL);
-        pattern_array_free(pa);
-        return found;
-    }
+    if (lf->pa)
+        return pattern_array_label_match(lf->pa, labels, ':', NULL);
 
     return true;
 }
@@ -763,10 +806,7 @@ static bool query_instance_add(QUERY_TARGET_LOCALS *qtl, QUERY_NODE *qn, QUERY_C
                 qi, ri, qt->instances.pattern, qtl->match_ids, qtl->match_names, qt->request.version, qtl->host_node_id_str));
 
     if(queryable_instance)
-        queryable_instance = query_instance_matches_labels(
-            ri,
-            qt->instances.chart_label_key_pattern,
-            qt->instances.labels_pattern);
+        queryable_instance = query_instance_labels_filter_matches(&qtl->labels_filter, ri);
 
     if(queryable_instance) {
         if(qt->instances.alerts_pattern && !query_target_match_alert_pattern(ria, qt->instances.alerts_pattern))
@@ -854,12 +894,17 @@ static ssize_t query_context_add(void *data, RRDCONTEXT_ACQUIRED *rca, bool quer
             added++;
     }
     else {
+        if(queryable_context)
+            query_instance_labels_filter_context_start(&qtl->labels_filter, rc);
+
         RRDINSTANCE *ri;
         dfe_start_read(rc->rrdinstances, ri) {
                     if(query_instance_add(qtl, qn, qc, (RRDINSTANCE_ACQUIRED *) ri_dfe.item, queryable_context, true))
                         added++;
                 }
         dfe_done(ri);
+
+        query_instance_labels_filter_context_done(&qtl->labels_filter);
     }
 
     if(!added) {
@@ -1101,6 +1146,10 @@ QUERY_TARGET *query_target_create(QUERY_TARGET_REQUEST *qtr) {
     qt->instances.labels_pattern = string_to_simple_pattern(qtl.labels);
     qt->instances.alerts_pattern = string_to_simple_pattern(qtl.alerts);
 
+    query_instance_labels_filter_init(&qtl.labels_filter,
+                                      qt->instances.chart_label_key_pattern,
+                                      qt->instances.labels_pattern);
+
     qtl.match_ids = qt->request.options & RRDR_OPTION_MATCH_IDS;
     qtl.match_names = qt->request.options & RRDR_OPTION_MATCH_NAMES;
     if(likely(!qtl.match_ids && !qtl.match_names))
@@ -1140,6 +1189,8 @@ QUERY_TARGET *query_target_create(QUERY_TARGET_REQUEST *qtr) {
                                  &qt->versions,
                                  qtl.host_node_id_str);
 
+    query_instance_labels_filter_cleanup(&qtl.labels_filter);
+
     // we need the available db retention for this call
     // so it has to be done last
     query_target_calculate_window(qt);
@@ -1166,6 +1217,10 @@ ssize_t weights_foreach_rrdmetric_in_context(RRDCONTEXT_ACQUIRED *rca,
 
     char host_node_id_str[UUID_STR_LEN] = "";
 
+    QUERY_INSTANCE_LABELS_FILTER labels_filter;
+    query_instance_labels_filter_init(&labels_filter, chart_label_key_sp, labels_sp);
+    query_instance_labels_filter_context_start(&labels_filter, rc);
+
     bool proceed = true;
 
     ssize_t count = 0;
@@ -1186,7 +1241,7 @@ ssize_t weights_foreach_rrdmetric_in_context(RRDCONTEXT_ACQUIRED *rca,
                         continue;
                 }
 
-                if(!query_instance_matches_labels(ri, chart_label_key_sp, labels_sp))
+                if(!query_instance_labels_filter_matches(&labels_filter, ri))
                     continue;
 
                 if(alerts_sp && !query_target_match_alert_pattern(ria, alerts_sp))
@@ -1230,5 +1285,8 @@ ssize_t weights_foreach_rrdmetric_in_context(RRDCONTEXT_ACQUIRED *rca,
                     break;
             }
     dfe_done(ri);
+
+    query_instance_labels_filter_cleanup(&labels_filter);
+
     return count;
 }
@@ -89,6 +89,10 @@ int rrdcontexts_to_json(RRDHOST *host, BUFFER *wb, time_t after, time_t before,
 const char *rrdcontext_acquired_id(RRDCONTEXT_ACQUIRED *rca);
 bool rrdcontext_acquired_belongs_to_host(RRDCONTEXT_ACQUIRED *rca, RRDHOST *host);
 
+bool rrdcontext_acquired_labels_values(RRDCONTEXT_ACQUIRED *rca, char **keys, size_t keys_count, Pvoid_t *values);
+STRING **rrdinstance_acquired_labels_values(RRDINSTANCE_ACQUIRED *ria, Pvoid_t values);
+void rrdcontext_labels_values_free(Pvoid_t *values, size_t keys_count);
+
 // ----------------------------------------------------------------------------
 // public API for rrddims
 
@@ -402,6 +406,7 @@ typedef struct query_target {
     struct {
         size_t used;
         char *label_keys[GROUP_BY_MAX_LABEL_KEYS * MAX_QUERY_GROUP_BY_PASSES];
+        Pvoid_t label_values;               // RRDINSTANCE * -> STRING *[used], for the indexed contexts
     } group_by[MAX_QUERY_GROUP_BY_PASSES];
 
     STORAGE_POINT query_points;
@@ -69,6 +69,19 @@ struct pgc_page {
     // THIS STRUCTURE NEEDS TO BE INITIALIZED BY HAND!
 };
 
+// a count-min sketch of page accesses, used by PGC_EVICTION_POLICY_TINYLFU
+#define PGC_SKETCH_DEPTH 4
+#define PGC_SKETCH_WIDTH_BITS 16
+#define PGC_SKETCH_WIDTH (1 << PGC_SKETCH_WIDTH_BITS)
+#define PGC_SKETCH_MAX_FREQUENCY 15
+#define PGC_SKETCH_SAMPLE_SIZE (PGC_SKETCH_WIDTH * 8) // age the counters after this many increments
+
+struct pgc_frequency_sketch {
+    SPINLOCK spinlock;              // held only while aging the counters
+    size_t increments;
+    uint8_t counters[PGC_SKETCH_DEPTH][PGC_SKETCH_WIDTH];
+};
+
 struct pgc_queue {
 #if defined(PGC_QUEUE_LOCK_AS_WAITING_QUEUE)
     WAITQ wq;
@@ -113,8 +126,12 @@ struct pgc {
 
         dynamic_target_cache_size_callback dynamic_target_size_cb;
         nominal_page_size_callback nominal_page_size_cb;
+
+        PGC_EVICTION_POLICY eviction_policy;
     } config;
 
+    struct pgc_frequency_sketch *sketch; // allocated when the TINYLFU policy is enabled
+
     struct {
         ND_THREAD *thread;              // the thread
         struct completion completion;   // signal the thread to wake up
@@ -622,6 +639,105 @@ static ALWAYS_INLINE void pgc_stats_index_judy_change(PGC *cache, int64_t delta)
     __atomic_add_fetch(&cache->stats.size, delta, __ATOMIC_RELAXED);
 }
 
+// ----------------------------------------------------------------------------
+// frequency sketch - approximate access counts of pages, including evicted ones
+// counters are updated without locks; a lost update now and then does not matter
+
+static ALWAYS_INLINE uint64_t pgc_sketch_hash(PGC_PAGE *page) {
+    uint64_t h = (uint64_t)page->section * 0x9E3779B97F4A7C15ULL;
+    h ^= (uint64_t)page->metric_id + 0x632BE59BD9B4E019ULL + (h << 6) + (h >> 2);
+    h ^= (uint64_t)page->start_time_s + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+
+    // splitmix64 finalizer
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+#define pgc_sketch_slot(hash, row) (((hash) >> ((row) * PGC_SKETCH_WIDTH_BITS)) & (PGC_SKETCH_WIDTH - 1))
+
+static ALWAYS_INLINE uint8_t pgc_sketch_estimate(struct pgc_frequency_sketch *sketch, uint64_t hash) {
+    uint8_t min = PGC_SKETCH_MAX_FREQUENCY;
+
+    for(size_t row = 0; row < PGC_SKETCH_DEPTH; row++) {
+        uint8_t v = __atomic_load_n(&sketch->counters[row][pgc_sketch_slot(hash, row)], __ATOMIC_RELAXED);
+        if(v < min)
+            min = v;
+    }
+
+    return min;
+}
+
+static void pgc_sketch_age(PGC *cache, struct pgc_frequency_sketch *sketch) {
+    if(!spinlock_trylock(&sketch->spinlock))
+        return;
+
+    if(__atomic_load_n(&sketch->increments, __ATOMIC_RELAXED) >= PGC_SKETCH_SAMPLE_SIZE) {
+        for(size_t row = 0; row < PGC_SKETCH_DEPTH; row++) {
+            for(size_t i = 0; i < PGC_SKETCH_WIDTH; i++) {
+                uint8_t v = __atomic_load_n(&sketch->counters[row][i], __ATOMIC_RELAXED);
+                if(v)
+                    __atomic_store_n(&sketch->counters[row][i], v >> 1, __ATOMIC_RELAXED);
+            }
+        }
+
+        __atomic_store_n(&sketch->increments, 0, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&cache->stats.frequency_sketch_resets, 1, __ATOMIC_RELAXED);
+    }
+
+    spinlock_unlock(&sketch->spinlock);
+}
+
+static ALWAYS_INLINE void pgc_sketch_increment(PGC *cache, PGC_PAGE *page) {
+    struct pgc_frequency_sketch *sketch = __atomic_load_n(&cache->sketch, __ATOMIC_ACQUIRE);
+    if(!sketch)
+        return;
+
+    uint64_t hash = pgc_sketch_hash(page);
+    uint8_t min = pgc_sketch_estimate(sketch, hash);
+    if(min >= PGC_SKETCH_MAX_FREQUENCY)
+        return;
+
+    // conservative update - increment only the counters that hold the minimum
+    for(size_t row = 0; row < PGC_SKETCH_DEPTH; row++) {
+        uint8_t *counter = &sketch->counters[row][pgc_sketch_slot(hash, row)];
+        if(__atomic_load_n(counter, __ATOMIC_RELAXED) == min)
+            __atomic_store_n(counter, min + 1, __ATOMIC_RELAXED);
+    }
+
+    if(unlikely(__atomic_add_fetch(&sketch->increments, 1, __ATOMIC_RELAXED) >= PGC_SKETCH_SAMPLE_SIZE))
+        pgc_sketch_age(cache, sketch);
+}
+
+// decide where a page enters the clean queue - it must be called with the clean queue locked
+// returns true when the page should be appended (most recently used end)
+static ALWAYS_INLINE bool pgc_clean_page_admission(PGC *cache, struct pgc_queue *q, PGC_PAGE *page) {
+    bool protected;
+    struct pgc_frequency_sketch *sketch = __atomic_load_n(&cache->sketch, __ATOMIC_ACQUIRE);
+
+    if(__atomic_load_n(&cache->config.eviction_policy, __ATOMIC_RELAXED) == PGC_EVICTION_POLICY_TINYLFU && sketch) {
+        if(page_flag_check(page, PGC_PAGE_HAS_NO_DATA_IGNORE_ACCESSES))
+            protected = false;
+        else {
+            // admit the page to the protected end only if it is accessed more frequently
+            // than the page that would be evicted next
+            uint8_t page_frequency = pgc_sketch_estimate(sketch, pgc_sketch_hash(page));
+            uint8_t victim_frequency = q->base ? pgc_sketch_estimate(sketch, pgc_sketch_hash(q->base)) : 0;
+            protected = page_frequency > 1 && page_frequency >= victim_frequency;
+        }
+    }
+    else
+        protected = page->accesses ||
+                    page_flag_check(page, PGC_PAGE_HAS_BEEN_ACCESSED | PGC_PAGE_HAS_NO_DATA_IGNORE_ACCESSES) == PGC_PAGE_HAS_BEEN_ACCESSED;
+
+    if(protected)
+        __atomic_add_fetch(&cache->stats.admissions_protected, 1, __ATOMIC_RELAXED);
+    else
+        __atomic_add_fetch(&cache->stats.admissions_probation, 1, __ATOMIC_RELAXED);
+
+    return protected;
+}
+
 static ALWAYS_INLINE void pgc_queue_add(PGC *cache __maybe_unused, struct pgc_queue *q, PGC_PAGE *page, bool having_lock, WAITQ_PRIORITY prio __maybe_unused) {
     if(!having_lock)
         pgc_queue_lock(cache, q, prio);
@@ -664,8 +780,9 @@ static ALWAYS_INLINE void pgc_queue_add(PGC *cache __maybe_unused, struct pgc_qu
         // CLEAN pages end up here.
         // - New pages created as CLEAN, always have 1 access.
         // - DIRTY pages made CLEAN, depending on their accesses may be appended (accesses > 0) or prepended (accesses = 0).
+        // - With the TINYLFU policy, the frequency sketch decides instead of the accesses.
 
-        if(page->accesses || page_flag_check(page, PGC_PAGE_HAS_BEEN_ACCESSED | PGC_PAGE_HAS_NO_DATA_IGNORE_ACCESSES) == PGC_PAGE_HAS_BEEN_ACCESSED) {
+        if(pgc_clean_page_admission(cache, q, page)) {
             DOUBLE_LINKED_LIST_APPEND_ITEM_UNSAFE(q->base, page, link.prev, link.next);
             page_flag_clear(page, PGC_PAGE_HAS_BEEN_ACCESSED);
         }
@@ -753,6 +870,7 @@ static ALWAYS_INLINE void page_has_been_accessed(PGC *cache, PGC_PAGE *page) {
 
     if (!(flags & PGC_PAGE_HAS_NO_DATA_IGNORE_ACCESSES)) {
         __atomic_add_fetch(&page->accesses, 1, __ATOMIC_RELAXED);
+        pgc_sketch_increment(cache, page);
 
         if (flags & PGC_PAGE_CLEAN) {
             if(pgc_queue_trylock(cache, &cache->clean, PGC_QUEUE_LOCK_PRIO_EVICTORS)) {
@@ -1444,8 +1562,10 @@ static PGC_PAGE *pgc_page_add(PGC *cache, PGC_ENTRY *entry, bool *added) {
 
             if (entry->hot)
                 page_set_hot(cache, page, PGC_QUEUE_LOCK_PRIO_COLLECTORS);
-            else
+            else {
+                pgc_sketch_increment(cache, page);
                 page_set_clean(cache, page, false, false, PGC_QUEUE_LOCK_PRIO_EVICTORS);
+            }
 
             PGC_REFERENCED_PAGES_PLUS1(cache, page);
 
@@ -2042,6 +2162,8 @@ PGC *pgc_create(const char *name,
                 &pgc_aral_statistics,
                 NULL, NULL,
                 false, false, false);
+
+            aral_enable_magazines(cache->index[part].aral);
         }
 #endif
     }
@@ -2140,6 +2262,12 @@ void pgc_destroy(PGC *cache, bool flush) {
         waitq_destroy(&cache->clean.wq);
 #endif
         freez(cache->index);
+
+        if(cache->sketch) {
+            __atomic_sub_fetch(&cache->stats.size, (int64_t)sizeof(*cache->sketch), __ATOMIC_RELAXED);
+            freez(cache->sketch);
+        }
+
         freez(cache);
     }
 }
@@ -2293,6 +2421,51 @@ void pgc_set_nominal_page_size_callback(PGC *cache, nominal_page_size_callback c
     cache->config.nominal_page_size_cb = callback;
 }
 
+void pgc_set_eviction_policy(PGC *cache, PGC_EVICTION_POLICY policy) {
+    if(policy == PGC_EVICTION_POLICY_TINYLFU && !__atomic_load_n(&cache->sketch, __ATOMIC_ACQUIRE)) {
+        struct pgc_frequency_sketch *sketch = callocz(1, sizeof(*sketch));
+        spinlock_init(&sketch->spinlock);
+
+        struct pgc_frequency_sketch *expected = NULL;
+        if(!__atomic_compare_exchange_n(&cache->sketch, &expected, sketch, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            freez(sketch);
+        else
+            __atomic_add_fetch(&cache->stats.size, (int64_t)sizeof(*sketch), __ATOMIC_RELAXED);
+    }
+
+    // the sketch is kept (and accounted in the cache size) even if the policy is changed back,
+    // pages may still be using it - it is freed when the cache is destroyed
+    __atomic_store_n(&cache->config.eviction_policy, policy, __ATOMIC_RELEASE);
+}
+
+PGC_EVICTION_POLICY pgc_get_eviction_policy(PGC *cache) {
+    return __atomic_load_n(&cache->config.eviction_policy, __ATOMIC_RELAXED);
+}
+
+const char *pgc_eviction_policy_to_string(PGC_EVICTION_POLICY policy) {
+    switch(policy) {
+        case PGC_EVICTION_POLICY_TINYLFU:
+            return "tinylfu";
+
+        default:
+        case PGC_EVICTION_POLICY_LRU:
+            return "lru";
+    }
+}
+
+PGC_EVICTION_POLICY pgc_eviction_policy_from_string(const char *str, PGC_EVICTION_POLICY def) {
+    if(!str || !*str)
+        return def;
+
+    if(strcasecmp(str, "tinylfu") == 0)
+        return PGC_EVICTION_POLICY_TINYLFU;
+
+    if(strcasecmp(str, "lru") == 0)
+        return PGC_EVICTION_POLICY_LRU;
+
+    return def;
+}
+
 int64_t pgc_get_current_cache_size(PGC *cache) {
     return __atomic_load_n(&cache->stats.current_cache_size, __ATOMIC_RELAXED);
 }
@@ -21,6 +21,18 @@ typedef enum __attribute__ ((__packed__)) {
 
 #define PGC_OPTIONS_DEFAULT (PGC_OPTIONS_EVICT_PAGES_NO_INLINE | PGC_OPTIONS_AUTOSCALE)
 
+typedef enum __attribute__ ((__packed__)) {
+    // new clean pages go to the most recently used end of the clean queue
+    PGC_EVICTION_POLICY_LRU = 0,
+
+    // new clean pages go to the most recently used end of the clean queue only when a
+    // frequency sketch says they are accessed more often than the next eviction candidate,
+    // otherwise they are the first to be evicted - large scans do not flush the working set
+    PGC_EVICTION_POLICY_TINYLFU,
+} PGC_EVICTION_POLICY;
+
+#define PGC_EVICTION_POLICY_DEFAULT PGC_EVICTION_POLICY_LRU
+
 typedef struct pgc_entry {
     Word_t section;             // the section this belongs to
     Word_t metric_id;           // the metric this belongs to
@@ -121,6 +133,13 @@ struct pgc_statistics {
     PAD64(int64_t) flushes_completed_size;
     PAD64(int64_t) flushes_cancelled_size;
 
+    // ----------------------------------------------------------------------------------------------------------------
+    // admission of clean pages
+
+    PAD64(size_t) admissions_protected;    // clean pages added at the most recently used end of the clean queue
+    PAD64(size_t) admissions_probation;    // clean pages added at the eviction end of the clean queue
+    PAD64(size_t) frequency_sketch_resets; // how many times the frequency sketch has been aged
+
     // ----------------------------------------------------------------------------------------------------------------
     // critical events
 
@@ -239,6 +258,16 @@ void pgc_set_dynamic_target_cache_size_callback(PGC *cache, dynamic_target_cache
 typedef size_t (*nominal_page_size_callback)(void *);
 void pgc_set_nominal_page_size_callback(PGC *cache, nominal_page_size_callback callback);
 
+void pgc_set_eviction_policy(PGC *cache, PGC_EVICTION_POLICY policy);
+PGC_EVICTION_POLICY pgc_get_eviction_policy(PGC *cache);
+const char *pgc_eviction_policy_to_string(PGC_EVICTION_POLICY policy);
+PGC_EVICTION_POLICY pgc_eviction_policy_from_string(const char *str, PGC_EVICTION_POLICY def);
+
+// the eviction policies of the dbengine caches, applied when they are created
+extern PGC_EVICTION_POLICY main_cache_eviction_policy;
+extern PGC_EVICTION_POLICY open_cache_eviction_policy;
+extern PGC_EVICTION_POLICY extent_cache_eviction_policy;
+
 // return true when there is more work to do
 bool pgc_evict_pages(PGC *cache, size_t max_skip, size_t max_evict);
 bool pgc_flush_pages(PGC *cache);
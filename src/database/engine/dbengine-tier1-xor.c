@@ -0,0 +1,345 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dbengine-tier1-xor.h"
+
+typedef enum __attribute__((packed)) {
+    TIER1_XOR_ENCODING_RAW  = 0,
+    TIER1_XOR_ENCODING_XOR  = 1,
+} TIER1_XOR_ENCODING;
+
+// ----------------------------------------------------------------------------
+// bit streams - bits are written LSB first, so the stream is endian neutral
+
+typedef struct {
+    uint8_t *dst;           // NULL when we only count the bits
+    uint32_t dst_size;
+    uint32_t pos;
+    uint64_t acc;
+    uint32_t acc_bits;
+    uint64_t total_bits;
+} TIER1_XOR_WRITER;
+
+static ALWAYS_INLINE void bw_write(TIER1_XOR_WRITER *bw, uint32_t value, uint32_t bits) {
+    internal_fatal(bits == 0 || bits > 32, "DBENGINE: invalid number of bits %u", bits);
+
+    bw->total_bits += bits;
+    if(!bw->dst)
+        return;
+
+    if(bits < 32)
+        value &= (1U << bits) - 1;
+
+    bw->acc |= (uint64_t)value << bw->acc_bits;
+    bw->acc_bits += bits;
+
+    while(bw->acc_bits >= 8) {
+        if(likely(bw->pos < bw->dst_size))
+            bw->dst[bw->pos] = (uint8_t)bw->acc;
+        bw->pos++;
+        bw->acc >>= 8;
+        bw->acc_bits -= 8;
+    }
+}
+
+static ALWAYS_INLINE void bw_flush(TIER1_XOR_WRITER *bw) {
+    if(bw->dst && bw->acc_bits) {
+        if(likely(bw->pos < bw->dst_size))
+            bw->dst[bw->pos] = (uint8_t)bw->acc;
+        bw->pos++;
+        bw->acc = 0;
+        bw->acc_bits = 0;
+    }
+}
+
+typedef struct {
+    const uint8_t *src;
+    uint32_t src_size;
+    uint32_t pos;
+    uint64_t acc;
+    uint32_t acc_bits;
+    bool overflow;
+} TIER1_XOR_READER;
+
+static ALWAYS_INLINE uint32_t br_read(TIER1_XOR_READER *br, uint32_t bits) {
+    while(br->acc_bits < bits) {
+        if(unlikely(br->pos >= br->src_size)) {
+            br->overflow = true;
+            return 0;
+        }
+
+        br->acc |= (uint64_t)br->src[br->pos++] << br->acc_bits;
+        br->acc_bits += 8;
+    }
+
+    uint32_t value = (uint32_t)(bits < 32 ? (br->acc & ((1ULL << bits) - 1)) : (br->acc & 0xFFFFFFFFULL));
+    br->acc >>= bits;
+    br->acc_bits -= bits;
+    return value;
+}
+
+// ----------------------------------------------------------------------------
+// float columns - XOR against the previous value
+
+static ALWAYS_INLINE uint32_t column_get_u32(const storage_number_tier1_t *array, uint32_t i, size_t offset) {
+    uint32_t v;
+    memcpy(&v, (const uint8_t *)&array[i] + offset, sizeof(v));
+    return v;
+}
+
+static ALWAYS_INLINE void column_set_u32(storage_number_tier1_t *array, uint32_t i, size_t offset, uint32_t v) {
+    memcpy((uint8_t *)&array[i] + offset, &v, sizeof(v));
+}
+
+static ALWAYS_INLINE uint16_t column_get_u16(const storage_number_tier1_t *array, uint32_t i, size_t offset) {
+    uint16_t v;
+    memcpy(&v, (const uint8_t *)&array[i] + offset, sizeof(v));
+    return v;
+}
+
+static ALWAYS_INLINE void column_set_u16(storage_number_tier1_t *array, uint32_t i, size_t offset, uint16_t v) {
+    memcpy((uint8_t *)&array[i] + offset, &v, sizeof(v));
+}
+
+static void encode_float_column(TIER1_XOR_WRITER *bw, const storage_number_tier1_t *array, uint32_t entries, size_t offset) {
+    uint32_t prev = column_get_u32(array, 0, offset);
+    bw_write(bw, prev, 32);
+
+    uint32_t window_lead = 0, window_trail = 0;
+    bool window_set = false;
+
+    for(uint32_t i = 1; i < entries; i++) {
+        uint32_t value = column_get_u32(array, i, offset);
+        uint32_t x = value ^ prev;
+        prev = value;
+
+        if(!x) {
+            bw_write(bw, 0, 1);
+            continue;
+        }
+
+        bw_write(bw, 1, 1);
+
+        uint32_t lead = (uint32_t)__builtin_clz(x);
+        uint32_t trail = (uint32_t)__builtin_ctz(x);
+
+        if(window_set && lead >= window_lead && trail >= window_trail) {
+            // the meaningful bits fit in the previous window
+            bw_write(bw, 0, 1);
+            bw_write(bw, x >> window_trail, 32 - window_lead - window_trail);
+        }
+        else {
+            uint32_t len = 32 - lead - trail;
+            bw_write(bw, 1, 1);
+            bw_write(bw, lead, 5);
+            bw_write(bw, len - 1, 5);
+            bw_write(bw, x >> trail, len);
+
+            window_lead = lead;
+            window_trail = trail;
+            window_set = true;
+        }
+    }
+}
+
+static void decode_float_column(TIER1_XOR_READER *br, storage_number_tier1_t *array, uint32_t entries, size_t offset) {
+    uint32_t prev = br_read(br, 32);
+    column_set_u32(array, 0, offset, prev);
+
+    uint32_t window_lead = 0, window_trail = 0;
+
+    for(uint32_t i = 1; i < entries && !br->overflow; i++) {
+        if(br_read(br, 1)) {
+            if(br_read(br, 1)) {
+                window_lead = br_read(br, 5);
+                uint32_t len = br_read(br, 5) + 1;
+
+                if(unlikely(window_lead + len > 32)) {
+                    br->overflow = true;
+                    break;
+                }
+
+                window_trail = 32 - window_lead - len;
+            }
+
+            uint32_t x = br_read(br, 32 - window_lead - window_trail);
+            prev ^= x << window_trail;
+        }
+
+        column_set_u32(array, i, offset, prev);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// integer columns - delta against the previous value
+
+static ALWAYS_INLINE uint32_t zigzag_encode(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static ALWAYS_INLINE int32_t zigzag_decode(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static void encode_u16_column(TIER1_XOR_WRITER *bw, const storage_number_tier1_t *array, uint32_t entries, size_t offset) {
+    uint16_t prev = column_get_u16(array, 0, offset);
+    bw_write(bw, prev, 16);
+
+    for(uint32_t i = 1; i < entries; i++) {
+        uint16_t value = column_get_u16(array, i, offset);
+        uint32_t zz = zigzag_encode((int32_t)value - (int32_t)prev);
+        prev = value;
+
+        if(!zz)
+            bw_write(bw, 0, 1);
+        else if(zz < (1 << 7)) {
+            bw_write(bw, 1, 1);
+            bw_write(bw, 0, 1);
+            bw_write(bw, zz, 7);
+        }
+        else {
+            bw_write(bw, 1, 1);
+            bw_write(bw, 1, 1);
+            bw_write(bw, zz, 17);
+        }
+    }
+}
+
+static void decode_u16_column(TIER1_XOR_READER *br, storage_number_tier1_t *array, uint32_t entries, size_t offset) {
+    int32_t prev = (int32_t)br_read(br, 16);
+    column_set_u16(array, 0, offset, (uint16_t)prev);
+
+    for(uint32_t i = 1; i < entries && !br->overflow; i++) {
+        if(br_read(br, 1)) {
+            uint32_t zz = br_read(br, 1) ? br_read(br, 17) : br_read(br, 7);
+            prev += zigzag_decode(zz);
+
+            if(unlikely(prev < 0 || prev > UINT16_MAX)) {
+                br->overflow = true;
+                break;
+            }
+        }
+
+        column_set_u16(array, i, offset, (uint16_t)prev);
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+static uint32_t tier1_xor_encode_columns(TIER1_XOR_WRITER *bw, const storage_number_tier1_t *array, uint32_t entries) {
+    encode_float_column(bw, array, entries, offsetof(storage_number_tier1_t, sum_value));
+    encode_float_column(bw, array, entries, offsetof(storage_number_tier1_t, min_value));
+    encode_float_column(bw, array, entries, offsetof(storage_number_tier1_t, max_value));
+    encode_u16_column(bw, array, entries, offsetof(storage_number_tier1_t, count));
+    encode_u16_column(bw, array, entries, offsetof(storage_number_tier1_t, anomaly_count));
+    bw_flush(bw);
+
+    return (uint32_t)((bw->total_bits + 7) / 8);
+}
+
+static ALWAYS_INLINE uint32_t tier1_xor_raw_size(uint32_t entries) {
+    return entries * sizeof(storage_number_tier1_t);
+}
+
+static ALWAYS_INLINE TIER1_XOR_ENCODING tier1_xor_best_encoding(const storage_number_tier1_t *array, uint32_t entries, uint32_t *payload_size) {
+    TIER1_XOR_WRITER bw = { 0 };
+    uint32_t xor_size = tier1_xor_encode_columns(&bw, array, entries);
+
+    if(xor_size < tier1_xor_raw_size(entries)) {
+        *payload_size = xor_size;
+        return TIER1_XOR_ENCODING_XOR;
+    }
+
+    *payload_size = tier1_xor_raw_size(entries);
+    return TIER1_XOR_ENCODING_RAW;
+}
+
+uint32_t tier1_xor_encoded_size(const storage_number_tier1_t *array, uint32_t entries) {
+    if(!entries || entries > UINT16_MAX)
+        return 0;
+
+    uint32_t payload_size;
+    tier1_xor_best_encoding(array, entries, &payload_size);
+    return TIER1_XOR_HEADER_SIZE + payload_size;
+}
+
+// returns the bytes written, or 0 when dst is not big enough
+uint32_t tier1_xor_encode(const storage_number_tier1_t *array, uint32_t entries, uint32_t encoded_size, uint8_t *dst, uint32_t dst_size) {
+    if(!entries || entries > UINT16_MAX || encoded_size <= TIER1_XOR_HEADER_SIZE)
+        return 0;
+
+    // the xor encoding is selected only when it is smaller than the raw points
+    uint32_t payload_size = encoded_size - TIER1_XOR_HEADER_SIZE;
+    TIER1_XOR_ENCODING encoding = payload_size < tier1_xor_raw_size(entries) ? TIER1_XOR_ENCODING_XOR : TIER1_XOR_ENCODING_RAW;
+
+    internal_fatal(encoding == TIER1_XOR_ENCODING_RAW && payload_size != tier1_xor_raw_size(entries),
+                   "DBENGINE: tier1 xor encoded size %u does not match %u points", encoded_size, entries);
+
+    if(dst_size < encoded_size)
+        return 0;
+
+    dst[0] = encoding;
+    dst[1] = 0;
+    dst[2] = (uint8_t)(entries & 0xFF);
+    dst[3] = (uint8_t)(entries >> 8);
+
+    if(encoding == TIER1_XOR_ENCODING_RAW)
+        memcpy(&dst[TIER1_XOR_HEADER_SIZE], array, payload_size);
+    else {
+        TIER1_XOR_WRITER bw = {
+            .dst = &dst[TIER1_XOR_HEADER_SIZE],
+            .dst_size = payload_size,
+        };
+        tier1_xor_encode_columns(&bw, array, entries);
+        internal_fatal(bw.pos != payload_size, "DBENGINE: tier1 xor encoder wrote %u bytes, expected %u", bw.pos, payload_size);
+    }
+
+    return TIER1_XOR_HEADER_SIZE + payload_size;
+}
+
+// returns the number of points in the encoded page, or 0 if the header is invalid
+uint32_t tier1_xor_entries(const uint8_t *src, uint32_t src_size) {
+    if(src_size < TIER1_XOR_HEADER_SIZE || src[1] != 0)
+        return 0;
+
+    uint32_t entries = (uint32_t)src[2] | ((uint32_t)src[3] << 8);
+
+    switch(src[0]) {
+        case TIER1_XOR_ENCODING_RAW:
+            if(src_size - TIER1_XOR_HEADER_SIZE != tier1_xor_raw_size(entries))
+                return 0;
+            break;
+
+        case TIER1_XOR_ENCODING_XOR:
+            break;
+
+        default:
+            return 0;
+    }
+
+    return entries;
+}
+
+// returns the number of points decoded, or 0 if the page is corrupted
+uint32_t tier1_xor_decode(const uint8_t *src, uint32_t src_size, storage_number_tier1_t *array, uint32_t max_entries) {
+    uint32_t entries = tier1_xor_entries(src, src_size);
+    if(!entries || entries > max_entries)
+        return 0;
+
+    if(src[0] == TIER1_XOR_ENCODING_RAW) {
+        memcpy(array, &src[TIER1_XOR_HEADER_SIZE], tier1_xor_raw_size(entries));
+        return entries;
+    }
+
+    TIER1_XOR_READER br = {
+        .src = &src[TIER1_XOR_HEADER_SIZE],
+        .src_size = src_size - TIER1_XOR_HEADER_SIZE,
+    };
+
+    decode_float_column(&br, array, entries, offsetof(storage_number_tier1_t, sum_value));
+    decode_float_column(&br, array, entries, offsetof(storage_number_tier1_t, min_value));
+    decode_float_column(&br, array, entries, offsetof(storage_number_tier1_t, max_value));
+    decode_u16_column(&br, array, entries, offsetof(storage_number_tier1_t, count));
+    decode_u16_column(&br, array, entries, offsetof(storage_number_tier1_t, anomaly_count));
+
+    return br.overflow ? 0 : entries;
+}
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_DBENGINE_TIER1_XOR_H
+#define NETDATA_DBENGINE_TIER1_XOR_H
+
+#include "libnetdata/libnetdata.h"
+
+// On-disk encoding of RRDENG_PAGE_TYPE_XOR_TIER1 pages.
+//
+// The page starts with a 4 byte header (encoding, reserved, entries as little endian uint16),
+// followed by the points, column by column: sum, min, max, count, anomaly_count.
+// Float columns are XOR encoded against the previous value of the same column (gorilla style),
+// integer columns are delta encoded. When this does not save space, the points are stored
+// as a plain storage_number_tier1_t array, so the page is never bigger than the raw one
+// plus the header.
+
+#define TIER1_XOR_HEADER_SIZE 4
+
+// tier1_xor_encode() needs the size returned by tier1_xor_encoded_size() for the same points,
+// so that the encoding is selected without scanning the points again.
+uint32_t tier1_xor_encoded_size(const storage_number_tier1_t *array, uint32_t entries);
+uint32_t tier1_xor_encode(const storage_number_tier1_t *array, uint32_t entries, uint32_t encoded_size, uint8_t *dst, uint32_t dst_size);
+
+uint32_t tier1_xor_entries(const uint8_t *src, uint32_t src_size);
+uint32_t tier1_xor_decode(const uint8_t *src, uint32_t src_size, storage_number_tier1_t *array, uint32_t max_entries);
+
+#endif //NETDATA_DBENGINE_TIER1_XOR_H
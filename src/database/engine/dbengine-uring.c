@@ -0,0 +1,320 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dbengine-uring.h"
+
+static bool uring_enabled = false;
+
+#if defined(HAVE_LINUX_IO_URING_H)
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+
+#define DBENGINE_URING_ENTRIES DBENGINE_URING_MAX_BATCH
+
+struct dbengine_uring {
+    int fd;
+
+    struct {
+        unsigned *head;
+        unsigned *tail;
+        unsigned *mask;
+        unsigned *array;
+        struct io_uring_sqe *sqes;
+    } sq;
+
+    struct {
+        unsigned *head;
+        unsigned *tail;
+        unsigned *mask;
+        struct io_uring_cqe *cqes;
+    } cq;
+
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+
+    struct iovec iov[DBENGINE_URING_ENTRIES];
+};
+
+// libuv workers and flushers live as long as netdata does,
+// so their rings are never destroyed
+static __thread struct dbengine_uring *thread_ring = NULL;
+static __thread bool thread_ring_failed = false;
+
+static inline int uring_setup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static inline int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static void uring_destroy(struct dbengine_uring *ring) {
+    if(ring->sq.sqes && ring->sq.sqes != MAP_FAILED)
+        munmap(ring->sq.sqes, ring->sqes_size);
+
+    if(ring->cq_ring && ring->cq_ring != MAP_FAILED && ring->cq_ring != ring->sq_ring)
+        munmap(ring->cq_ring, ring->cq_ring_size);
+
+    if(ring->sq_ring && ring->sq_ring != MAP_FAILED)
+        munmap(ring->sq_ring, ring->sq_ring_size);
+
+    if(ring->fd != -1)
+        close(ring->fd);
+
+    freez(ring);
+}
+
+static struct dbengine_uring *uring_create(void) {
+    struct io_uring_params p = { 0 };
+
+    int fd = uring_setup(DBENGINE_URING_ENTRIES, &p);
+    if(fd < 0) {
+        int err = errno;
+        if(err == ENOSYS || err == EPERM || err == EACCES) {
+            // the kernel does not have it, or a seccomp policy / sysctl blocks it
+            __atomic_store_n(&uring_enabled, false, __ATOMIC_RELAXED);
+            nd_log(NDLS_DAEMON, NDLP_WARNING,
+                   "DBENGINE: io_uring is not available (%s), using synchronous extent I/O",
+                   strerror(err));
+        }
+        else
+            nd_log(NDLS_DAEMON, NDLP_ERR,
+                   "DBENGINE: cannot create io_uring for this thread (%s), using synchronous extent I/O",
+                   strerror(err));
+        return NULL;
+    }
+
+    struct dbengine_uring *ring = callocz(1, sizeof(*ring));
+    ring->fd = fd;
+
+    ring->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if(p.features & IORING_FEAT_SINGLE_MMAP) {
+        if(ring->cq_ring_size > ring->sq_ring_size)
+            ring->sq_ring_size = ring->cq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if(ring->sq_ring == MAP_FAILED)
+        goto failed;
+
+    if(p.features & IORING_FEAT_SINGLE_MMAP)
+        ring->cq_ring = ring->sq_ring;
+    else {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if(ring->cq_ring == MAP_FAILED)
+            goto failed;
+    }
+
+    ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sq.sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if(ring->sq.sqes == MAP_FAILED)
+        goto failed;
+
+    ring->sq.head  = (unsigned *)((uint8_t *)ring->sq_ring + p.sq_off.head);
+    ring->sq.tail  = (unsigned *)((uint8_t *)ring->sq_ring + p.sq_off.tail);
+    ring->sq.mask  = (unsigned *)((uint8_t *)ring->sq_ring + p.sq_off.ring_mask);
+    ring->sq.array = (unsigned *)((uint8_t *)ring->sq_ring + p.sq_off.array);
+
+    ring->cq.head  = (unsigned *)((uint8_t *)ring->cq_ring + p.cq_off.head);
+    ring->cq.tail  = (unsigned *)((uint8_t *)ring->cq_ring + p.cq_off.tail);
+    ring->cq.mask  = (unsigned *)((uint8_t *)ring->cq_ring + p.cq_off.ring_mask);
+    ring->cq.cqes  = (struct io_uring_cqe *)((uint8_t *)ring->cq_ring + p.cq_off.cqes);
+
+    return ring;
+
+failed:
+    nd_log(NDLS_DAEMON, NDLP_ERR,
+           "DBENGINE: cannot map io_uring rings (%s), using synchronous extent I/O",
+           strerror(errno));
+    uring_destroy(ring);
+    return NULL;
+}
+
+static inline struct dbengine_uring *uring_get_thread_ring(void) {
+    if(likely(thread_ring))
+        return thread_ring;
+
+    if(thread_ring_failed)
+        return NULL;
+
+    thread_ring = uring_create();
+    if(!thread_ring)
+        thread_ring_failed = true;
+
+    return thread_ring;
+}
+
+static size_t uring_reap_completions(struct dbengine_uring *ring, DBENGINE_URING_REQUEST *reqs, size_t count) {
+    size_t completed = 0;
+
+    unsigned head = *ring->cq.head;
+    unsigned cq_tail = __atomic_load_n(ring->cq.tail, __ATOMIC_ACQUIRE);
+    while(head != cq_tail) {
+        struct io_uring_cqe *cqe = &ring->cq.cqes[head & *ring->cq.mask];
+        if(likely(cqe->user_data < count)) {
+            reqs[cqe->user_data].result = cqe->res;
+            reqs[cqe->user_data].in_flight = false;
+        }
+
+        completed++;
+        head++;
+    }
+    __atomic_store_n(ring->cq.head, head, __ATOMIC_RELEASE);
+
+    return completed;
+}
+
+// the kernel may still be doing I/O on the buffers of the requests in flight,
+// so give them the chance to complete before the callers reuse their buffers
+#define DBENGINE_URING_DRAIN_TIMEOUT_UT (10 * USEC_PER_SEC)
+
+static bool uring_drain(struct dbengine_uring *ring, DBENGINE_URING_REQUEST *reqs, size_t count, size_t in_flight) {
+    usec_t started_ut = now_monotonic_usec();
+
+    while(in_flight) {
+        size_t completed = uring_reap_completions(ring, reqs, count);
+        in_flight = (completed < in_flight) ? in_flight - completed : 0;
+        if(!in_flight)
+            break;
+
+        if(now_monotonic_usec() - started_ut > DBENGINE_URING_DRAIN_TIMEOUT_UT)
+            return false;
+
+        // entering the kernel lets it post the completions
+        sleep_usec(1 * USEC_PER_MS);
+    }
+
+    return true;
+}
+
+// returns false when the ring failed - the requests that have not completed have a negative result,
+// or they are still in flight, when the ring has been abandoned
+static bool uring_submit_and_wait_batch(struct dbengine_uring *ring, DBENGINE_URING_REQUEST *reqs, size_t count) {
+    unsigned tail = *ring->sq.tail;
+    unsigned mask = *ring->sq.mask;
+
+    for(size_t i = 0; i < count; i++) {
+        unsigned idx = tail & mask;
+        struct io_uring_sqe *sqe = &ring->sq.sqes[idx];
+        memset(sqe, 0, sizeof(*sqe));
+
+        ring->iov[i].iov_base = reqs[i].buf;
+        ring->iov[i].iov_len = reqs[i].size;
+
+        sqe->opcode = (reqs[i].op == DBENGINE_URING_WRITE) ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe->fd = reqs[i].fd;
+        sqe->addr = (uint64_t)(uintptr_t)&ring->iov[i];
+        sqe->len = 1;
+        sqe->off = reqs[i].offset;
+        sqe->user_data = i;
+
+        // a link cannot cross the end of the batch
+        if(reqs[i].linked && i + 1 < count)
+            sqe->flags |= IOSQE_IO_LINK;
+
+        ring->sq.array[idx] = idx;
+        reqs[i].result = -ECANCELED;
+        reqs[i].in_flight = true;
+        tail++;
+    }
+
+    __atomic_store_n(ring->sq.tail, tail, __ATOMIC_RELEASE);
+
+    size_t submitted = 0, completed = 0;
+    while(completed < count) {
+        int ret = uring_enter(ring->fd, (unsigned)(count - submitted), 1, IORING_ENTER_GETEVENTS);
+        if(ret < 0) {
+            int err = errno;
+            if(err == EINTR || err == EAGAIN || err == EBUSY)
+                continue;
+
+            nd_log(NDLS_DAEMON, NDLP_ERR,
+                   "DBENGINE: io_uring_enter() failed (%s) with %zu requests submitted and %zu completed, "
+                   "disabling io_uring for this thread",
+                   strerror(err), submitted, completed);
+
+            // the requests the kernel has not consumed will never run
+            for(size_t i = submitted; i < count; i++)
+                reqs[i].in_flight = false;
+
+            if(!uring_drain(ring, reqs, count, submitted - completed)) {
+                // the kernel still owns some buffers - keep the ring mapped and never use it again
+                nd_log(NDLS_DAEMON, NDLP_ERR,
+                       "DBENGINE: io_uring requests did not complete after io_uring_enter() failed, "
+                       "abandoning the ring with their buffers");
+                thread_ring = NULL;
+            }
+
+            // the requests not completed by the ring are failed, so that the callers retry them,
+            // except the ones still in the kernel, which the callers must not touch
+            for(size_t i = 0; i < count; i++) {
+                if(reqs[i].in_flight)
+                    reqs[i].result = -EINPROGRESS;
+                else if(reqs[i].result == -ECANCELED)
+                    reqs[i].result = -err;
+            }
+
+            return false;
+        }
+        submitted += (size_t)ret;
+        completed += uring_reap_completions(ring, reqs, count);
+    }
+
+    return true;
+}
+
+#endif // HAVE_LINUX_IO_URING_H
+
+void dbengine_uring_init(bool enable) {
+#if defined(HAVE_LINUX_IO_URING_H)
+    __atomic_store_n(&uring_enabled, enable, __ATOMIC_RELAXED);
+#else
+    if(enable)
+        nd_log(NDLS_DAEMON, NDLP_WARNING,
+               "DBENGINE: io_uring support is not compiled in, using synchronous extent I/O");
+#endif
+}
+
+bool dbengine_uring_enabled(void) {
+    return __atomic_load_n(&uring_enabled, __ATOMIC_RELAXED);
+}
+
+bool dbengine_uring_submit_and_wait(DBENGINE_URING_REQUEST *reqs __maybe_unused, size_t count __maybe_unused) {
+#if defined(HAVE_LINUX_IO_URING_H)
+    if(!dbengine_uring_enabled())
+        return false;
+
+    struct dbengine_uring *ring = uring_get_thread_ring();
+    if(!ring)
+        return false;
+
+    for(size_t done = 0; done < count; ) {
+        size_t batch = MIN(count - done, DBENGINE_URING_ENTRIES);
+        if(!uring_submit_and_wait_batch(ring, &reqs[done], batch)) {
+            // disable the ring of this thread - the callers retry the failed requests with libuv
+            if(thread_ring)
+                uring_destroy(thread_ring);
+            thread_ring = NULL;
+            thread_ring_failed = true;
+
+            for(size_t i = done + batch; i < count; i++) {
+                reqs[i].result = -ECANCELED;
+                reqs[i].in_flight = false;
+            }
+
+            break;
+        }
+        done += batch;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_DBENGINE_URING_H
+#define NETDATA_DBENGINE_URING_H
+
+#include "libnetdata/libnetdata.h"
+
+// Batched extent I/O using io_uring.
+//
+// Each thread gets its own ring, created the first time it submits I/O.
+// When io_uring is not compiled in, disabled, or not permitted by the kernel,
+// dbengine_uring_enabled() returns false and callers use the libuv path.
+// Requests that fail (or are short) in the ring report a negative or partial
+// result, so that the callers can retry them synchronously. When the ring
+// itself fails, it is disabled for the thread and the requests it did not
+// complete report a negative result.
+//
+// If the requests submitted to a failed ring do not complete in time, the ring
+// is abandoned. Its requests that are still in the kernel have in_flight set:
+// the kernel may still read or write their buffers, so the callers must leak
+// these buffers, and they must not reuse or modify them.
+
+#define DBENGINE_URING_MAX_BATCH 32
+#define DBENGINE_URING_BATCH_MAX_WAIT_UT (1 * USEC_PER_MS)  // the longest the first request of a batch may wait for more
+
+typedef enum __attribute__((packed)) {
+    DBENGINE_URING_READ = 0,
+    DBENGINE_URING_WRITE,
+} DBENGINE_URING_OP;
+
+typedef struct dbengine_uring_request {
+    int fd;
+    DBENGINE_URING_OP op;
+    bool linked;                // the next request starts only if this one completes successfully
+    void *buf;
+    size_t size;
+    uint64_t offset;
+
+    ssize_t result;             // bytes transferred, or -errno
+    bool in_flight;             // the kernel may still be using buf - it must be leaked
+} DBENGINE_URING_REQUEST;
+
+void dbengine_uring_init(bool enable);
+bool dbengine_uring_enabled(void);
+
+// submits all requests and waits for all of them to complete
+// returns false when the ring is not available - nothing has been submitted then
+bool dbengine_uring_submit_and_wait(DBENGINE_URING_REQUEST *reqs, size_t count);
+
+#endif //NETDATA_DBENGINE_URING_H
@@ -5,13 +5,10 @@
 // the default value is set in ND_PROFILE, not here
 time_t dbengine_journal_v2_unmount_time = 120;
 
-/* Careful to always call this before creating a new journal file */
-int journalfile_v1_extent_write(struct rrdengine_instance *ctx, struct rrdengine_datafile *datafile, WAL *wal)
+// reserve the space of a transaction in the journal file
+// a reserved space that is never written reads as padding during replay
+uint64_t journalfile_v1_extent_reserve(struct rrdengine_journalfile *journalfile, WAL *wal)
 {
-    uv_fs_t request;
-    struct rrdengine_journalfile *journalfile = datafile->journalfile;
-    uv_buf_t iov;
-
     if (wal->size < wal->buf_size) {
         /* simulate an empty transaction to skip the rest of the block */
         *(uint8_t *) (wal->buf + wal->size) = STORE_PADDING;
@@ -23,6 +20,27 @@ int journalfile_v1_extent_write(struct rrdengine_instance *ctx, struct rrdengine
     journalfile->unsafe.pos += wal->buf_size;
     spinlock_unlock(&journalfile->unsafe.spinlock);
 
+    return journalfile_position;
+}
+
+// the transaction has been written by the caller (i.e. io_uring)
+int journalfile_v1_extent_written(struct rrdengine_instance *ctx, WAL *wal)
+{
+    ctx_current_disk_space_increase(ctx, wal->buf_size);
+    ctx_io_write_op_bytes(ctx, wal->buf_size);
+
+    int ret = (int)wal->buf_size;
+    wal_release(wal);
+    worker_is_idle();
+    return ret;
+}
+
+int journalfile_v1_extent_write_at(struct rrdengine_instance *ctx, struct rrdengine_datafile *datafile, WAL *wal, uint64_t journalfile_position)
+{
+    uv_fs_t request;
+    struct rrdengine_journalfile *journalfile = datafile->journalfile;
+    uv_buf_t iov;
+
     iov = uv_buf_init(wal->buf, wal->buf_size);
 
     int retries = 10;
@@ -51,6 +69,13 @@ done:
     return ret;
 }
 
+/* Careful to always call this before creating a new journal file */
+int journalfile_v1_extent_write(struct rrdengine_instance *ctx, struct rrdengine_datafile *datafile, WAL *wal)
+{
+    uint64_t journalfile_position = journalfile_v1_extent_reserve(datafile->journalfile, wal);
+    return journalfile_v1_extent_write_at(ctx, datafile, wal, journalfile_position);
+}
+
 void journalfile_v2_generate_path(struct rrdengine_datafile *datafile, char *str, size_t maxlen)
 {
     (void) snprintfz(str, maxlen, "%s/" WALFILE_PREFIX RRDENG_FILE_NUMBER_PRINT_TMPL WALFILE_EXTENSION_V2,
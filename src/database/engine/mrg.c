@@ -18,6 +18,7 @@ inline MRG *mrg_create(void) {
 
         mrg->index[i].aral = aral_create(buf, sizeof(METRIC), 0, 16384, &mrg_aral_statistics, NULL, NULL,
                                          false, false, true);
+        aral_enable_magazines(mrg->index[i].aral);
     }
     pulse_aral_register_statistics(&mrg_aral_statistics, "mrg");
 
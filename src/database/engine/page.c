@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "page.h"
+#include "dbengine-tier1-xor.h"
 
 #include "libnetdata/libnetdata.h"
 
@@ -20,6 +21,9 @@ typedef enum __attribute__((packed)) {
 typedef struct {
     uint8_t *data;
     uint16_t size;
+
+    // the size of the xor tier1 encoding, once the page is scheduled for flushing
+    uint32_t encoded_size;
 } page_raw_t;
 
 typedef struct {
@@ -80,6 +84,11 @@ static PRINTFLIKE(2, 3) void pgd_fatal(const PGD *pg, const char *fmt, ...) {
             added = true;
         }
 
+        if (pg->type == RRDENG_PAGE_TYPE_XOR_TIER1) {
+            buffer_sprintf(wb, added ? "|%s" : "%s", "XOR_TIER1");
+            added = true;
+        }
+
         if (!added) {
             int type = pg->type;
             buffer_sprintf(wb, "%d", type);
@@ -311,6 +320,11 @@ void pgd_init_arals(void) {
                 0,
                 &pgd_aral_statistics,
                 NULL, NULL, false, false, true);
+
+            // the partitions already spread the small sizes across threads,
+            // so only the first partition of each size gets per-thread magazines
+            if(partition == 0)
+                aral_enable_magazines(arals[arals_slot(slot, partition)]);
         }
     }
 
@@ -472,7 +486,8 @@ ALWAYS_INLINE PGD *pgd_create(uint8_t type, uint32_t slots) {
         }
 
         case RRDENG_PAGE_TYPE_ARRAY_32BIT:
-        case RRDENG_PAGE_TYPE_ARRAY_TIER1: {
+        case RRDENG_PAGE_TYPE_ARRAY_TIER1:
+        case RRDENG_PAGE_TYPE_XOR_TIER1: {
             uint32_t size = slots * page_type_size[type];
 
             internal_fatal(!size || slots == 1,
@@ -480,6 +495,7 @@ ALWAYS_INLINE PGD *pgd_create(uint8_t type, uint32_t slots) {
 
             pg->raw.size = size;
             pg->raw.data = pgd_data_alloc(size, pg->partition, true);
+            pg->raw.encoded_size = 0;
             break;
         }
 
@@ -531,6 +547,33 @@ ALWAYS_INLINE PGD *pgd_create_from_disk_data(uint8_t type, void *base, uint32_t
             memcpy(pg->raw.data, base, size);
             break;
 
+        case RRDENG_PAGE_TYPE_XOR_TIER1: {
+            // expand the page once, so that all queries read it as a plain tier1 array
+            uint32_t entries = tier1_xor_entries(base, size);
+            if (!entries) {
+                netdata_log_error("%s() - Invalid xor tier1 page header", __FUNCTION__);
+                aral_freez(pgd_alloc_globals.aral_pgd[pg->partition], pg);
+                pg = PGD_EMPTY;
+                break;
+            }
+
+            pg->raw.size = entries * page_type_size[type];
+            pg->raw.data = pgd_data_alloc(pg->raw.size, pg->partition, false);
+
+            if (tier1_xor_decode(base, size, (storage_number_tier1_t *)pg->raw.data, entries) != entries) {
+                netdata_log_error("%s() - Corrupted xor tier1 page", __FUNCTION__);
+                pgd_data_free(pg->raw.data, pg->raw.size, pg->partition);
+                aral_freez(pgd_alloc_globals.aral_pgd[pg->partition], pg);
+                pg = PGD_EMPTY;
+                break;
+            }
+
+            pg->used = entries;
+            pg->slots = pg->used;
+            pg->raw.encoded_size = 0;
+            break;
+        }
+
         default:
             netdata_log_error("%s() - Unknown page type: %uc", __FUNCTION__, type);
             aral_freez(pgd_alloc_globals.aral_pgd[pg->partition], pg);
@@ -600,6 +643,7 @@ void pgd_free(PGD *pg) {
 
         case RRDENG_PAGE_TYPE_ARRAY_32BIT:
         case RRDENG_PAGE_TYPE_ARRAY_TIER1:
+        case RRDENG_PAGE_TYPE_XOR_TIER1:
             pgd_data_free(pg->raw.data, pg->raw.size, pg->partition);
             break;
 
@@ -653,6 +697,7 @@ static void pgd_aral_unmark(PGD *pg) {
 
         case RRDENG_PAGE_TYPE_ARRAY_32BIT:
         case RRDENG_PAGE_TYPE_ARRAY_TIER1:
+        case RRDENG_PAGE_TYPE_XOR_TIER1:
             pgd_data_unmark(pg->raw.data, pg->raw.size, pg->partition);
             break;
 
@@ -738,6 +783,7 @@ ALWAYS_INLINE uint32_t pgd_memory_footprint(PGD *pg)
 
         case RRDENG_PAGE_TYPE_ARRAY_32BIT:
         case RRDENG_PAGE_TYPE_ARRAY_TIER1:
+        case RRDENG_PAGE_TYPE_XOR_TIER1:
             footprint += pgd_data_footprint(pg->raw.size, pg->partition);
             break;
 
@@ -772,6 +818,7 @@ uint32_t pgd_buffer_memory_footprint(PGD *pg)
 
         case RRDENG_PAGE_TYPE_ARRAY_32BIT:
         case RRDENG_PAGE_TYPE_ARRAY_TIER1:
+        case RRDENG_PAGE_TYPE_XOR_TIER1:
             footprint = pg->raw.size;
             break;
 
@@ -831,6 +878,15 @@ uint32_t pgd_disk_footprint(PGD *pg)
             break;
         }
 
+        case RRDENG_PAGE_TYPE_XOR_TIER1:
+            // the page cannot be appended once it is scheduled for flushing,
+            // so the encoded size is computed once and reused when copying to the extent
+            if (!pg->raw.encoded_size)
+                pg->raw.encoded_size = tier1_xor_encoded_size((storage_number_tier1_t *)pg->raw.data, pg->used);
+
+            size = pg->raw.encoded_size;
+            break;
+
         default:
             netdata_log_error("%s() - Unknown page type: %uc", __FUNCTION__, pg->type);
             break;
@@ -845,8 +901,11 @@ uint32_t pgd_disk_footprint(PGD *pg)
 
 void pgd_copy_to_extent(PGD *pg, uint8_t *dst, uint32_t dst_size)
 {
-    internal_fatal(pgd_disk_footprint(pg) != dst_size, "Wrong disk footprint size requested (need %u, available %u)",
-                   pgd_disk_footprint(pg), dst_size);
+#ifdef NETDATA_INTERNAL_CHECKS
+    uint32_t footprint = pgd_disk_footprint(pg);
+    internal_fatal(footprint != dst_size, "Wrong disk footprint size requested (need %u, available %u)",
+                   footprint, dst_size);
+#endif
 
     switch (pg->type) {
         case RRDENG_PAGE_TYPE_GORILLA_32BIT: {
@@ -872,6 +931,17 @@ void pgd_copy_to_extent(PGD *pg, uint8_t *dst, uint32_t dst_size)
             memcpy(dst, pg->raw.data, dst_size);
             break;
 
+        case RRDENG_PAGE_TYPE_XOR_TIER1: {
+            internal_fatal(!pg->raw.encoded_size,
+                           "pgd_copy_to_extent() xor tier1 page was not sized before copying");
+
+            uint32_t bytes = tier1_xor_encode((storage_number_tier1_t *)pg->raw.data, pg->used, pg->raw.encoded_size, dst, dst_size);
+            UNUSED(bytes);
+            internal_fatal(bytes != dst_size,
+                           "pgd_copy_to_extent() xor tier1 encoder wrote %u bytes, expected %u", bytes, dst_size);
+            break;
+        }
+
         default:
             netdata_log_error("%s() - Unknown page type: %uc", __FUNCTION__, pg->type);
             break;
@@ -943,7 +1013,8 @@ size_t pgd_append_point(
 
             break;
         }
-        case RRDENG_PAGE_TYPE_ARRAY_TIER1: {
+        case RRDENG_PAGE_TYPE_ARRAY_TIER1:
+        case RRDENG_PAGE_TYPE_XOR_TIER1: {
             storage_number_tier1_t *tier12_metric_data = (storage_number_tier1_t *)pg->raw.data;
             storage_number_tier1_t t;
             t.sum_value = (float) n;
@@ -1019,6 +1090,7 @@ static void pgdc_seek(PGDC *pgdc, uint32_t position)
 
         case RRDENG_PAGE_TYPE_ARRAY_32BIT:
         case RRDENG_PAGE_TYPE_ARRAY_TIER1:
+        case RRDENG_PAGE_TYPE_XOR_TIER1:
             pgdc->slots = pgdc->pgd->used;
             break;
 
@@ -1077,7 +1149,8 @@ bool pgdc_get_next_point(PGDC *pgdc, uint32_t expected_position __maybe_unused,
 
             return ok;
         }
-        case RRDENG_PAGE_TYPE_ARRAY_TIER1: {
+        case RRDENG_PAGE_TYPE_ARRAY_TIER1:
+        case RRDENG_PAGE_TYPE_XOR_TIER1: {
             storage_number_tier1_t *array = (storage_number_tier1_t *) pgdc->pgd->raw.data;
             storage_number_tier1_t n = array[pgdc->position++];
 
@@ -1115,3 +1188,82 @@ bool pgdc_get_next_point(PGDC *pgdc, uint32_t expected_position __maybe_unused,
         }
     }
 }
+
+static ALWAYS_INLINE_HOT void pgdc_unpack_tier0_points(STORAGE_POINTS_BATCH *batch, uint32_t offset, const storage_number *array, uint32_t entries) {
+    storage_number_unpack_array(array, entries, &batch->sum[offset], &batch->flags[offset], &batch->anomaly_count[offset]);
+
+    memcpy(&batch->min[offset], &batch->sum[offset], entries * sizeof(NETDATA_DOUBLE));
+    memcpy(&batch->max[offset], &batch->sum[offset], entries * sizeof(NETDATA_DOUBLE));
+
+    for (uint32_t i = offset; i < offset + entries; i++)
+        batch->count[i] = 1;
+}
+
+// decode up to 'entries' consecutive points of the page into batch slots [offset, offset + entries)
+// slots beyond the end of the page (or not decodable) are filled with empty points
+// returns the number of points actually decoded from the page
+ALWAYS_INLINE_HOT_FLATTEN
+uint32_t pgdc_get_next_points(PGDC *pgdc, uint32_t expected_position __maybe_unused, STORAGE_POINTS_BATCH *batch, uint32_t offset, uint32_t entries)
+{
+    internal_fatal(offset + entries > STORAGE_POINTS_BATCH_SIZE, "DBENGINE: batch overflow");
+
+    uint32_t decoded = 0;
+
+    if (!pgdc->pgd || pgdc->pgd == PGD_EMPTY || pgdc->position >= pgdc->slots)
+        goto fill_empty;
+
+    internal_fatal(pgdc->position != expected_position, "Wrong expected cursor position");
+
+    uint32_t available = pgdc->slots - pgdc->position;
+    uint32_t wanted = (entries < available) ? entries : available;
+
+    switch (pgdc->pgd->type)
+    {
+        case RRDENG_PAGE_TYPE_GORILLA_32BIT: {
+            // the gorilla stream can only be read sequentially,
+            // so we first extract the storage numbers and then unpack them in bulk
+            storage_number array[STORAGE_POINTS_BATCH_SIZE];
+            for (; decoded < wanted; decoded++) {
+                if (!gorilla_reader_read(&pgdc->gr, &array[decoded]))
+                    break;
+            }
+
+            pgdc_unpack_tier0_points(batch, offset, array, decoded);
+            break;
+        }
+        case RRDENG_PAGE_TYPE_ARRAY_TIER1:
+        case RRDENG_PAGE_TYPE_XOR_TIER1: {
+            storage_number_tier1_t *array = &((storage_number_tier1_t *) pgdc->pgd->raw.data)[pgdc->position];
+            decoded = wanted;
+
+            storage_number_tier1_unpack_array(array, decoded,
+                                              &batch->min[offset], &batch->max[offset], &batch->sum[offset],
+                                              &batch->count[offset], &batch->anomaly_count[offset],
+                                              &batch->flags[offset]);
+            break;
+        }
+        case RRDENG_PAGE_TYPE_ARRAY_32BIT: {
+            storage_number *array = &((storage_number *) pgdc->pgd->raw.data)[pgdc->position];
+            decoded = wanted;
+
+            pgdc_unpack_tier0_points(batch, offset, array, decoded);
+            break;
+        }
+        default: {
+            // let the single point decoder log the error
+            STORAGE_POINT sp = { 0 };
+            pgdc_get_next_point(pgdc, expected_position, &sp);
+            break;
+        }
+    }
+
+    // the cursor advances even for points that could not be decoded,
+    // exactly like consecutive calls to pgdc_get_next_point() do
+    pgdc->position += wanted;
+
+fill_empty:
+    for (uint32_t d = decoded; d < entries; d++)
+        storage_points_batch_set_empty(batch, offset + d);
+
+    return decoded;
+}
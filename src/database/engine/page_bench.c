@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "page.h"
+#include "page_bench.h"
+
+// Compares decoding pages one point at a time (pgdc_get_next_point())
+// against decoding them in columnar batches (pgdc_get_next_points()).
+// It also verifies that both decoders return identical points, and that
+// pages survive the round trip to their on-disk format.
+
+#define PGD_BENCH_ITERATIONS 20000
+
+struct pgd_bench_page {
+    const char *name;
+    uint8_t type;
+    uint32_t slots;
+};
+
+static NETDATA_DOUBLE pgd_bench_value(uint32_t slot) {
+    // a noisy random walk, similar to what collectors store
+    static NETDATA_DOUBLE value = 1000.0;
+    value += (NETDATA_DOUBLE)((int)(os_random32() % 2001) - 1000) / 100.0;
+
+    if(slot % 97 == 0)
+        return NAN;
+
+    return value;
+}
+
+static PGD *pgd_bench_page_create(struct pgd_bench_page *p) {
+    PGD *pg = pgd_create(p->type, p->slots);
+
+    for (uint32_t slot = 0; slot < p->slots; slot++) {
+        NETDATA_DOUBLE n = pgd_bench_value(slot);
+        SN_FLAGS flags = (slot % 13) ? SN_FLAG_NOT_ANOMALOUS : SN_FLAG_NONE;
+
+        if(p->type == RRDENG_PAGE_TYPE_ARRAY_TIER1 || p->type == RRDENG_PAGE_TYPE_XOR_TIER1)
+            pgd_append_point(pg, slot, n * 60.0, n - 1.0, n + 1.0, 60, (slot % 13) ? 0 : 3, flags, slot);
+        else
+            pgd_append_point(pg, slot, n, n, n, 1, 0, flags, slot);
+    }
+
+    return pg;
+}
+
+static bool pgd_bench_points_equal(STORAGE_POINT *sp, STORAGE_POINTS_BATCH *batch, uint32_t i) {
+#define pgd_bench_double_equal(a, b) (((a) == (b)) || (isnan(a) && isnan(b)))
+
+    return pgd_bench_double_equal(sp->min, batch->min[i]) &&
+           pgd_bench_double_equal(sp->max, batch->max[i]) &&
+           pgd_bench_double_equal(sp->sum, batch->sum[i]) &&
+           sp->count == batch->count[i] &&
+           sp->anomaly_count == batch->anomaly_count[i] &&
+           sp->flags == batch->flags[i];
+}
+
+static bool pgd_bench_verify(PGD *pg, uint32_t slots) {
+    PGDC cursor_point, cursor_batch;
+    pgdc_reset(&cursor_point, pg, 0);
+    pgdc_reset(&cursor_batch, pg, 0);
+
+    STORAGE_POINTS_BATCH batch;
+    for (uint32_t position = 0; position < slots; ) {
+        uint32_t entries = MIN(STORAGE_POINTS_BATCH_SIZE, slots - position);
+        pgdc_get_next_points(&cursor_batch, position, &batch, 0, entries);
+
+        for (uint32_t i = 0; i < entries; i++, position++) {
+            STORAGE_POINT sp = { 0 };
+            pgdc_get_next_point(&cursor_point, position, &sp);
+
+            if(!pgd_bench_points_equal(&sp, &batch, i)) {
+                fprintf(stderr, "PGD BENCH: point %u decoded differently by the batch decoder\n", position);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// flush the page to its disk format and load it back - returns the disk page, or NULL on mismatch
+static PGD *pgd_bench_disk_roundtrip(PGD *pg, struct pgd_bench_page *p, uint32_t *disk_bytes) {
+    *disk_bytes = pgd_disk_footprint(pg);
+
+    uint8_t *buffer = mallocz(*disk_bytes);
+    pgd_copy_to_extent(pg, buffer, *disk_bytes);
+    PGD *pg_disk = pgd_create_from_disk_data(p->type, buffer, *disk_bytes);
+    freez(buffer);
+
+    if(pg_disk == PGD_EMPTY || pgd_slots_used(pg_disk) != p->slots) {
+        pgd_free(pg_disk);
+        return NULL;
+    }
+
+    PGDC cursor_collector, cursor_disk;
+    pgdc_reset(&cursor_collector, pg, 0);
+    pgdc_reset(&cursor_disk, pg_disk, 0);
+
+    STORAGE_POINTS_BATCH batch;
+    for (uint32_t position = 0; position < p->slots; ) {
+        uint32_t entries = MIN(STORAGE_POINTS_BATCH_SIZE, p->slots - position);
+        pgdc_get_next_points(&cursor_disk, position, &batch, 0, entries);
+
+        for (uint32_t i = 0; i < entries; i++, position++) {
+            STORAGE_POINT sp = { 0 };
+            pgdc_get_next_point(&cursor_collector, position, &sp);
+
+            if(!pgd_bench_points_equal(&sp, &batch, i)) {
+                fprintf(stderr, "PGD BENCH: point %u differs after the disk round trip\n", position);
+                pgd_free(pg_disk);
+                return NULL;
+            }
+        }
+    }
+
+    return pg_disk;
+}
+
+static NETDATA_DOUBLE pgd_bench_per_point(PGD *pg, uint32_t slots, usec_t *duration_ut) {
+    NETDATA_DOUBLE total = 0;
+    usec_t started_ut = now_monotonic_usec();
+
+    for (size_t it = 0; it < PGD_BENCH_ITERATIONS; it++) {
+        PGDC cursor;
+        pgdc_reset(&cursor, pg, 0);
+
+        STORAGE_POINT sp = { 0 };
+        for (uint32_t position = 0; position < slots; position++) {
+            pgdc_get_next_point(&cursor, position, &sp);
+            if(netdata_double_isnumber(sp.sum))
+                total += sp.sum;
+        }
+    }
+
+    *duration_ut = now_monotonic_usec() - started_ut;
+    return total;
+}
+
+static NETDATA_DOUBLE pgd_bench_batch(PGD *pg, uint32_t slots, usec_t *duration_ut) {
+    NETDATA_DOUBLE total = 0;
+    usec_t started_ut = now_monotonic_usec();
+
+    STORAGE_POINTS_BATCH batch;
+    for (size_t it = 0; it < PGD_BENCH_ITERATIONS; it++) {
+        PGDC cursor;
+        pgdc_reset(&cursor, pg, 0);
+
+        for (uint32_t position = 0; position < slots; ) {
+            uint32_t entries = MIN(STORAGE_POINTS_BATCH_SIZE, slots - position);
+            pgdc_get_next_points(&cursor, position, &batch, 0, entries);
+            position += entries;
+
+            for (uint32_t i = 0; i < entries; i++) {
+                if(netdata_double_isnumber(batch.sum[i]))
+                    total += batch.sum[i];
+            }
+        }
+    }
+
+    *duration_ut = now_monotonic_usec() - started_ut;
+    return total;
+}
+
+int pgd_bench(int argc __maybe_unused, char *argv[] __maybe_unused) {
+    // Dummy/necessary initialization stuff
+    PGC *dummy_cache = pgc_create("pgd-bench-cache", 32 * 1024 * 1024, NULL, 64, NULL, NULL,
+                                  10, 10, 1000, 10, PGC_OPTIONS_NONE, 1, 11);
+    pgd_init_arals();
+
+    struct pgd_bench_page pages[] = {
+        { .name = "ARRAY_32BIT",   .type = RRDENG_PAGE_TYPE_ARRAY_32BIT,   .slots = 1024 },
+        { .name = "GORILLA_32BIT", .type = RRDENG_PAGE_TYPE_GORILLA_32BIT, .slots = 1024 },
+        { .name = "ARRAY_TIER1",   .type = RRDENG_PAGE_TYPE_ARRAY_TIER1,   .slots = 256  },
+        { .name = "XOR_TIER1",     .type = RRDENG_PAGE_TYPE_XOR_TIER1,     .slots = 256  },
+    };
+
+    fprintf(stderr, "PGD BENCH: storage number unpacking implementation: %s\n",
+            storage_number_unpack_implementation());
+
+    int errors = 0;
+    for (size_t i = 0; i < _countof(pages); i++) {
+        struct pgd_bench_page *p = &pages[i];
+        PGD *pg = pgd_bench_page_create(p);
+
+        if(!pgd_bench_verify(pg, p->slots)) {
+            fprintf(stderr, "PGD BENCH: %s: FAILED\n", p->name);
+            errors++;
+            pgd_free(pg);
+            continue;
+        }
+
+        uint32_t disk_bytes = 0;
+        PGD *pg_disk = pgd_bench_disk_roundtrip(pg, p, &disk_bytes);
+        if(!pg_disk) {
+            fprintf(stderr, "PGD BENCH: %s: disk round trip FAILED\n", p->name);
+            errors++;
+            pgd_free(pg);
+            continue;
+        }
+
+        fprintf(stderr, "PGD BENCH: %-14s on disk: %u bytes for %u points, %.2f bytes/point\n",
+                p->name, disk_bytes, p->slots, (double)disk_bytes / (double)p->slots);
+
+        // the collected page is now scheduled for flushing, so benchmark the one loaded from disk
+        pgd_free(pg);
+        pg = pg_disk;
+
+        usec_t point_ut, batch_ut;
+        NETDATA_DOUBLE total_point = pgd_bench_per_point(pg, p->slots, &point_ut);
+        NETDATA_DOUBLE total_batch = pgd_bench_batch(pg, p->slots, &batch_ut);
+
+        if(total_point != total_batch) {
+            fprintf(stderr, "PGD BENCH: %s: the totals of the two decoders do not match\n", p->name);
+            errors++;
+        }
+
+        double points = (double)p->slots * PGD_BENCH_ITERATIONS;
+        fprintf(stderr, "PGD BENCH: %-14s per point: %6.2f ns/point, batch: %6.2f ns/point, speedup: %.2fx\n",
+                p->name,
+                (double)point_ut * 1000.0 / points,
+                (double)batch_ut * 1000.0 / points,
+                batch_ut ? (double)point_ut / (double)batch_ut : 0.0);
+
+        pgd_free(pg);
+    }
+
+    pgc_destroy(dummy_cache, false);
+    return errors;
+}
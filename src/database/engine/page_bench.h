@@ -0,0 +1,14 @@
+#ifndef PAGE_BENCH_H
+#define PAGE_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int pgd_bench(int argc, char *argv[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PAGE_BENCH_H */
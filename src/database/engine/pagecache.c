@@ -6,6 +6,9 @@ MRG *main_mrg = NULL;
 PGC *main_cache = NULL;
 PGC *open_cache = NULL;
 PGC *extent_cache = NULL;
+PGC_EVICTION_POLICY main_cache_eviction_policy = PGC_EVICTION_POLICY_DEFAULT;
+PGC_EVICTION_POLICY open_cache_eviction_policy = PGC_EVICTION_POLICY_DEFAULT;
+PGC_EVICTION_POLICY extent_cache_eviction_policy = PGC_EVICTION_POLICY_DEFAULT;
 struct rrdeng_cache_efficiency_stats rrdeng_cache_efficiency_stats = {};
 
 static void main_cache_free_clean_page_callback(PGC *cache __maybe_unused, PGC_ENTRY entry __maybe_unused)
@@ -1155,6 +1158,7 @@ void pgc_and_mrg_initialize(void)
             0
     );
     pgc_set_nominal_page_size_callback(main_cache, pgc_main_nominal_page_size);
+    pgc_set_eviction_policy(main_cache, main_cache_eviction_policy);
 
     open_cache = pgc_create(
             "OPEN_PGC",
@@ -1172,6 +1176,7 @@ void pgc_and_mrg_initialize(void)
             sizeof(struct extent_io_data)
     );
     pgc_set_dynamic_target_cache_size_callback(open_cache, dynamic_open_cache_size);
+    pgc_set_eviction_policy(open_cache, open_cache_eviction_policy);
 
     extent_cache = pgc_create(
             "EXTENT_PGC",
@@ -1189,4 +1194,5 @@ void pgc_and_mrg_initialize(void)
             0
     );
     pgc_set_dynamic_target_cache_size_callback(extent_cache, dynamic_extent_cache_size);
+    pgc_set_eviction_policy(extent_cache, extent_cache_eviction_policy);
 }
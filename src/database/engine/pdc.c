@@ -2,6 +2,7 @@
 
 #include "pdc.h"
 #include "dbengine-compression.h"
+#include "dbengine-uring.h"
 
 struct extent_page_details_list {
     uv_file file;
@@ -707,6 +708,7 @@ ALWAYS_INLINE VALIDATED_PAGE_DESCRIPTOR validate_extent_page_descr(const struct
             entries = 0;
             break;
         case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_XOR_TIER1:
             end_time_s = start_time_s + descr->gorilla.delta_time_s;
             entries = descr->gorilla.entries;
             break;
@@ -853,6 +855,11 @@ VALIDATED_PAGE_DESCRIPTOR validate_page(
             internal_fatal(entries == 0, "0 number of entries found on gorilla page");
             vd.entries = entries;
             break;
+        case RRDENG_PAGE_TYPE_XOR_TIER1:
+            // the page length is the encoded one, so the entries cannot be calculated by size
+            internal_fatal(entries == 0, "0 number of entries found on xor tier1 page");
+            vd.entries = entries;
+            break;
         default:
             known_page_type = false;
             break;
@@ -977,6 +984,7 @@ static void epdl_extent_loading_error_log(struct rrdengine_instance *ctx, EPDL *
                 end_time_s = (time_t)(descr->end_time_ut / USEC_PER_SEC);
                 break;
             case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+            case RRDENG_PAGE_TYPE_XOR_TIER1:
                 end_time_s = (time_t) start_time_s + (descr->gorilla.delta_time_s);
                 break;
         }
@@ -1304,13 +1312,13 @@ static inline void datafile_extent_read_free(void *buffer) {
     posix_memalign_freez(buffer);
 }
 
-NOT_INLINE_HOT void epdl_find_extent_and_populate_pages(struct rrdengine_instance *ctx, EPDL *epdl, bool worker) {
-    if(worker)
-        worker_is_busy(UV_EVENT_DBENGINE_EXTENT_CACHE_LOOKUP);
-
-    size_t *statistics_counter = NULL;
-    PDC_PAGE_STATUS not_loaded_pages_tag = 0, loaded_pages_tag = 0;
+// the extent of an EPDL, when it has already been looked up / read by a batch
+struct epdl_extent_prefetch {
+    PGC_PAGE *extent_cache_page;    // acquired from the extent cache
+    void *extent_data;              // read from disk (aligned buffer)
+};
 
+static inline bool epdl_all_queries_should_stop(EPDL *epdl) {
     bool should_stop = __atomic_load_n(&epdl->pdc->workers_should_stop, __ATOMIC_RELAXED);
     for(EPDL *ep = epdl->query.next; ep ;ep = ep->query.next) {
         internal_fatal(ep->datafile != epdl->datafile, "DBENGINE: datafiles do not match");
@@ -1324,6 +1332,18 @@ NOT_INLINE_HOT void epdl_find_extent_and_populate_pages(struct rrdengine_instanc
         }
     }
 
+    return should_stop;
+}
+
+static void epdl_find_extent_and_populate_pages_prefetched(struct rrdengine_instance *ctx, EPDL *epdl, bool worker, struct epdl_extent_prefetch *pf) {
+    if(worker)
+        worker_is_busy(UV_EVENT_DBENGINE_EXTENT_CACHE_LOOKUP);
+
+    size_t *statistics_counter = NULL;
+    PDC_PAGE_STATUS not_loaded_pages_tag = 0, loaded_pages_tag = 0;
+
+    bool should_stop = epdl_all_queries_should_stop(epdl);
+
     if(unlikely(should_stop)) {
         statistics_counter = &rrdeng_cache_efficiency_stats.pages_load_fail_cancelled;
         not_loaded_pages_tag = PDC_PAGE_CANCELLED;
@@ -1333,7 +1353,13 @@ NOT_INLINE_HOT void epdl_find_extent_and_populate_pages(struct rrdengine_instanc
     bool extent_found_in_cache = false;
 
     void *extent_compressed_data = NULL;
-    PGC_PAGE *extent_cache_page = pgc_page_get_and_acquire(
+    PGC_PAGE *extent_cache_page = NULL;
+    if(pf && pf->extent_cache_page) {
+        extent_cache_page = pf->extent_cache_page;
+        pf->extent_cache_page = NULL;
+    }
+    else
+        extent_cache_page = pgc_page_get_and_acquire(
             extent_cache, (Word_t)ctx,
             (Word_t)epdl->datafile->fileno, (time_t)epdl->extent_offset,
             PGC_SEARCH_EXACT);
@@ -1351,7 +1377,14 @@ NOT_INLINE_HOT void epdl_find_extent_and_populate_pages(struct rrdengine_instanc
         if(worker)
             worker_is_busy(UV_EVENT_DBENGINE_EXTENT_MMAP);
 
-        void *extent_data = datafile_extent_read(ctx, epdl->file, epdl->extent_offset, epdl->extent_size);
+        void *extent_data = NULL;
+        if(pf && pf->extent_data) {
+            extent_data = pf->extent_data;
+            pf->extent_data = NULL;
+        }
+        else
+            extent_data = datafile_extent_read(ctx, epdl->file, epdl->extent_offset, epdl->extent_size);
+
         if(extent_data != NULL) {
 
             void *tmp = dbengine_extent_alloc(epdl->extent_size);
@@ -1413,6 +1446,19 @@ NOT_INLINE_HOT void epdl_find_extent_and_populate_pages(struct rrdengine_instanc
         pgc_page_release(extent_cache, extent_cache_page);
 
 cleanup:
+    if(pf) {
+        // the query was cancelled, or the extent was found in the cache meanwhile
+        if(pf->extent_cache_page) {
+            pgc_page_release(extent_cache, pf->extent_cache_page);
+            pf->extent_cache_page = NULL;
+        }
+
+        if(pf->extent_data) {
+            datafile_extent_read_free(pf->extent_data);
+            pf->extent_data = NULL;
+        }
+    }
+
     // remove it from the datafile extent_queries
     // this can be called multiple times safely
     epdl_pending_del(epdl);
@@ -1436,3 +1482,73 @@ cleanup:
     if(worker)
         worker_is_idle();
 }
+
+NOT_INLINE_HOT void epdl_find_extent_and_populate_pages(struct rrdengine_instance *ctx, EPDL *epdl, bool worker) {
+    epdl_find_extent_and_populate_pages_prefetched(ctx, epdl, worker, NULL);
+}
+
+// process a batch of EPDLs (from a worker), reading all the extents
+// that are not in the extent cache with a single io_uring submission
+NOT_INLINE_HOT void epdl_find_extents_and_populate_pages_batch(EPDL **epdls, size_t count) {
+    struct epdl_extent_prefetch pf[DBENGINE_URING_MAX_BATCH] = { 0 };
+    DBENGINE_URING_REQUEST reqs[DBENGINE_URING_MAX_BATCH];
+    size_t reqs_epdl[DBENGINE_URING_MAX_BATCH];
+    size_t requests = 0;
+
+    internal_fatal(count > DBENGINE_URING_MAX_BATCH, "DBENGINE: too many extents in a batch");
+
+    worker_is_busy(UV_EVENT_DBENGINE_EXTENT_CACHE_LOOKUP);
+
+    for(size_t i = 0; i < count ; i++) {
+        EPDL *epdl = epdls[i];
+
+        if(epdl_all_queries_should_stop(epdl))
+            continue;
+
+        pf[i].extent_cache_page = pgc_page_get_and_acquire(
+            extent_cache, (Word_t)epdl->pdc->ctx,
+            (Word_t)epdl->datafile->fileno, (time_t)epdl->extent_offset,
+            PGC_SEARCH_EXACT);
+
+        if(pf[i].extent_cache_page)
+            continue;
+
+        unsigned real_io_size = ALIGN_BYTES_CEILING(epdl->extent_size);
+        (void)posix_memalignz(&pf[i].extent_data, RRDFILE_ALIGNMENT, real_io_size);
+
+        reqs[requests] = (DBENGINE_URING_REQUEST) {
+            .fd = epdl->file,
+            .op = DBENGINE_URING_READ,
+            .buf = pf[i].extent_data,
+            .size = real_io_size,
+            .offset = epdl->extent_offset,
+        };
+        reqs_epdl[requests] = i;
+        requests++;
+    }
+
+    if(requests) {
+        worker_is_busy(UV_EVENT_DBENGINE_EXTENT_MMAP);
+
+        bool submitted = dbengine_uring_submit_and_wait(reqs, requests);
+
+        for(size_t r = 0; r < requests ; r++) {
+            size_t i = reqs_epdl[r];
+
+            if(submitted && reqs[r].result >= (ssize_t)epdls[i]->extent_size)
+                ctx_io_read_op_bytes(epdls[i]->pdc->ctx, reqs[r].size);
+            else if(submitted && reqs[r].in_flight) {
+                // the kernel may still write to it - leak it and let the synchronous path read the extent
+                pf[i].extent_data = NULL;
+            }
+            else {
+                // let the synchronous path read it, and report any errors
+                datafile_extent_read_free(pf[i].extent_data);
+                pf[i].extent_data = NULL;
+            }
+        }
+    }
+
+    for(size_t i = 0; i < count ; i++)
+        epdl_find_extent_and_populate_pages_prefetched(epdls[i]->pdc->ctx, epdls[i], true, &pf[i]);
+}
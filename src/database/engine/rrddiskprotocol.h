@@ -43,7 +43,8 @@ struct rrdeng_df_sb {
 #define RRDENG_PAGE_TYPE_ARRAY_32BIT    (0)
 #define RRDENG_PAGE_TYPE_ARRAY_TIER1    (1)
 #define RRDENG_PAGE_TYPE_GORILLA_32BIT  (2)
-#define RRDENG_PAGE_TYPE_MAX            (2) // Maximum page type (inclusive)
+#define RRDENG_PAGE_TYPE_XOR_TIER1      (3) // tier1 points, column encoded (see dbengine-tier1-xor.h)
+#define RRDENG_PAGE_TYPE_MAX            (3) // Maximum page type (inclusive)
 
 /*
  * Data file page descriptor
@@ -55,6 +56,7 @@ struct rrdeng_extent_page_descr {
     uint32_t page_length;
     uint64_t start_time_ut;
     union {
+        // used by all variable length page types (gorilla and xor tier1)
         struct {
             uint32_t entries;
             uint32_t delta_time_s;
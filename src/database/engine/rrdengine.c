@@ -3,6 +3,7 @@
 #include "rrdengine.h"
 #include "pdc.h"
 #include "dbengine-compression.h"
+#include "dbengine-uring.h"
 
 struct rrdeng_global_stats global_stats = { 0 };
 
@@ -183,11 +184,39 @@ static void work_standard_worker(uv_work_t *req) {
     if(work_request->opcode == RRDENG_OPCODE_EXTENT_READ || work_request->opcode == RRDENG_OPCODE_QUERY) {
         internal_fatal(work_request->after_work_cb != NULL, "DBENGINE: opcodes with a callback should not boosted");
 
+        EPDL *batch[DBENGINE_URING_MAX_BATCH];
+        size_t batched = 0;
+        usec_t batch_started_ut = 0;
+        bool batching = dbengine_uring_enabled();
+
         while(1) {
             struct rrdeng_cmd cmd = rrdeng_deq_cmd(true);
+
+            if(batching && cmd.opcode == RRDENG_OPCODE_EXTENT_READ) {
+                // collect the extent reads already queued, to read them from disk with a single submission;
+                // the batch is submitted as soon as the queue has nothing else for us, it is full, or
+                // collecting it takes too long, so that the first reads do not wait for reads still arriving
+                usec_t now_ut = now_monotonic_usec();
+                if(!batched)
+                    batch_started_ut = now_ut;
+
+                batch[batched++] = cmd.data;
+                if(batched < DBENGINE_URING_MAX_BATCH && now_ut - batch_started_ut < DBENGINE_URING_BATCH_MAX_WAIT_UT)
+                    continue;
+            }
+
+            if(batched) {
+                epdl_find_extents_and_populate_pages_batch(batch, batched);
+                batched = 0;
+                worker_is_idle();
+            }
+
             if (cmd.opcode == RRDENG_OPCODE_NOOP)
                 break;
 
+            if(batching && cmd.opcode == RRDENG_OPCODE_EXTENT_READ)
+                continue;
+
             worker_is_busy(UV_EVENT_WORKER_INIT);
             switch (cmd.opcode) {
                 case RRDENG_OPCODE_EXTENT_READ:
@@ -784,6 +813,7 @@ datafile_extent_build(struct rrdengine_instance *ctx, struct page_descr_with_dat
                 header->descr[i].end_time_ut = descr->end_time_ut;
                 break;
             case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+            case RRDENG_PAGE_TYPE_XOR_TIER1:
                 header->descr[i].gorilla.delta_time_s = (uint32_t) ((descr->end_time_ut - descr->start_time_ut) / USEC_PER_SEC);
                 header->descr[i].gorilla.entries = pgd_slots_used(descr->pgd);
                 break;
@@ -879,6 +909,61 @@ static void *extent_write_tp_worker(
 
     int retries = 10;
     int ret = -1;
+
+    uint64_t journalfile_position = 0;
+    bool journalfile_position_reserved = false;
+    bool journalfile_written = false;
+
+    if(dbengine_uring_enabled()) {
+        // submit the extent and its journal transaction together;
+        // the journal is written only after the extent has been written successfully
+        journalfile_position = journalfile_v1_extent_reserve(datafile->journalfile, xt_io_descr->wal);
+        journalfile_position_reserved = true;
+
+        DBENGINE_URING_REQUEST reqs[2] = {
+            {
+                .fd = datafile->file,
+                .op = DBENGINE_URING_WRITE,
+                .linked = true,
+                .buf = iov.base,
+                .size = iov.len,
+                .offset = xt_io_descr->pos,
+            },
+            {
+                .fd = datafile->journalfile->file,
+                .op = DBENGINE_URING_WRITE,
+                .buf = xt_io_descr->wal->buf,
+                .size = xt_io_descr->wal->buf_size,
+                .offset = journalfile_position,
+            },
+        };
+
+        // when any of them fails, the synchronous path below retries it
+        if(dbengine_uring_submit_and_wait(reqs, 2)) {
+            // the kernel may still be writing from the buffers of an abandoned ring,
+            // so leave them to it, and continue with copies of them
+            if(unlikely(reqs[0].in_flight)) {
+                void *buf;
+                (void)posix_memalignz(&buf, RRDFILE_ALIGNMENT, iov.len);
+                memcpy(buf, iov.base, iov.len);
+                xt_io_descr->buf = buf;
+                iov.base = buf;
+            }
+
+            if(unlikely(reqs[1].in_flight)) {
+                void *buf;
+                (void)posix_memalignz(&buf, RRDFILE_ALIGNMENT, xt_io_descr->wal->buf_size);
+                memcpy(buf, xt_io_descr->wal->buf, xt_io_descr->wal->buf_size);
+                xt_io_descr->wal->buf = buf;
+            }
+
+            if(reqs[0].result == (ssize_t)iov.len) {
+                ret = (int)reqs[0].result;
+                journalfile_written = (reqs[1].result == (ssize_t)xt_io_descr->wal->buf_size);
+            }
+        }
+    }
+
     while (ret < 0 && --retries) {
         ret = uv_fs_write(NULL, &request, datafile->file, &iov, 1, (int64_t)xt_io_descr->pos, NULL);
         uv_fs_req_cleanup(&request);
@@ -894,7 +979,13 @@ static void *extent_write_tp_worker(
     else {
         ctx_current_disk_space_increase(ctx, xt_io_descr->real_io_size);
         ctx_io_write_op_bytes(ctx, xt_io_descr->real_io_size);
-        ret = journalfile_v1_extent_write(ctx, datafile, xt_io_descr->wal);
+
+        if(journalfile_written)
+            ret = journalfile_v1_extent_written(ctx, xt_io_descr->wal);
+        else if(journalfile_position_reserved)
+            ret = journalfile_v1_extent_write_at(ctx, datafile, xt_io_descr->wal, journalfile_position);
+        else
+            ret = journalfile_v1_extent_write(ctx, datafile, xt_io_descr->wal);
     }
 
     if (ret < 0) {
@@ -32,14 +32,15 @@ size_t tier_page_size[RRD_STORAGE_TIERS] = {4096, 2048, 384, 384, 384};
 size_t tier_quota_mb[RRD_STORAGE_TIERS] = {1024, 1024, 1024, 128, 64};
 #endif
 
-#if RRDENG_PAGE_TYPE_MAX != 2
-#error PAGE_TYPE_MAX is not 2 - you need to add allocations here
+#if RRDENG_PAGE_TYPE_MAX != 3
+#error PAGE_TYPE_MAX is not 3 - you need to add allocations here
 #endif
 
 size_t page_type_size[256] = {
         [RRDENG_PAGE_TYPE_ARRAY_32BIT] = sizeof(storage_number),
         [RRDENG_PAGE_TYPE_ARRAY_TIER1] = sizeof(storage_number_tier1_t),
-        [RRDENG_PAGE_TYPE_GORILLA_32BIT] = sizeof(storage_number)
+        [RRDENG_PAGE_TYPE_GORILLA_32BIT] = sizeof(storage_number),
+        [RRDENG_PAGE_TYPE_XOR_TIER1] = sizeof(storage_number_tier1_t),
 };
 
 static inline void initialize_single_ctx(struct rrdengine_instance *ctx) {
@@ -475,6 +476,7 @@ static PGD *rrdeng_alloc_new_page_data(struct rrdeng_collect_handle *handle, use
         case RRDENG_PAGE_TYPE_ARRAY_32BIT:
         case RRDENG_PAGE_TYPE_ARRAY_TIER1:
         case RRDENG_PAGE_TYPE_GORILLA_32BIT:
+        case RRDENG_PAGE_TYPE_XOR_TIER1:
             d = pgd_create(ctx->config.page_type, slots);
             break;
         default:
@@ -908,6 +910,52 @@ prepare_for_next_iteration:
     return sp;
 }
 
+static ALWAYS_INLINE bool rrdeng_batch_needs_single_point(struct storage_engine_query_handle *seqh, struct rrdeng_query_handle *handle) {
+    return handle->now_s > seqh->end_time_s || !handle->page || handle->position >= handle->entries || !handle->dt_s;
+}
+
+// Fills the batch with the points the next consecutive calls to rrdeng_load_metric_next() would return.
+// It stops at the end of the current page, at the end of the query, or when the batch is full,
+// so that each call costs at most one page lookup.
+ALWAYS_INLINE_HOT size_t rrdeng_load_metric_next_batch(struct storage_engine_query_handle *seqh, STORAGE_POINTS_BATCH *batch) {
+    struct rrdeng_query_handle *handle = (struct rrdeng_query_handle *)seqh->handle;
+
+    storage_points_batch_reset(batch);
+
+    if (unlikely(rrdeng_batch_needs_single_point(seqh, handle))) {
+        // past the end of the query, or we need a new page - let the single point path handle it
+        STORAGE_POINT sp = rrdeng_load_metric_next(seqh);
+        storage_points_batch_set(batch, 0, sp);
+        batch->used = 1;
+
+        if (unlikely(rrdeng_batch_needs_single_point(seqh, handle)))
+            return batch->used;
+    }
+
+    // points remaining in this page, until the end of the query
+    size_t entries = handle->entries - handle->position;
+    size_t till_end = (size_t)((seqh->end_time_s - handle->now_s) / handle->dt_s) + 1;
+    if (entries > till_end)
+        entries = till_end;
+
+    if (entries > STORAGE_POINTS_BATCH_SIZE - batch->used)
+        entries = STORAGE_POINTS_BATCH_SIZE - batch->used;
+
+    pgdc_get_next_points(&handle->pgdc, handle->position, batch, batch->used, entries);
+
+    time_t end_time_s = handle->now_s;
+    for (size_t i = batch->used; i < batch->used + entries; i++, end_time_s += handle->dt_s) {
+        batch->start_time_s[i] = end_time_s - handle->dt_s;
+        batch->end_time_s[i] = end_time_s;
+    }
+
+    handle->now_s = end_time_s;
+    handle->position += entries;
+    batch->used += entries;
+
+    return batch->used;
+}
+
 ALWAYS_INLINE int rrdeng_load_metric_is_finished(struct storage_engine_query_handle *seqh) {
     struct rrdeng_query_handle *handle = (struct rrdeng_query_handle *)seqh->handle;
     return (handle->now_s > seqh->end_time_s);
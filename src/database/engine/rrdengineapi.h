@@ -53,6 +53,7 @@ int rrdeng_store_metric_finalize(STORAGE_COLLECT_HANDLE *sch);
 void rrdeng_load_metric_init(STORAGE_METRIC_HANDLE *smh, struct storage_engine_query_handle *seqh,
                                     time_t start_time_s, time_t end_time_s, STORAGE_PRIORITY priority);
 STORAGE_POINT rrdeng_load_metric_next(struct storage_engine_query_handle *seqh);
+size_t rrdeng_load_metric_next_batch(struct storage_engine_query_handle *seqh, STORAGE_POINTS_BATCH *batch);
 
 
 int rrdeng_load_metric_is_finished(struct storage_engine_query_handle *seqh);
@@ -440,6 +440,22 @@ ALWAYS_INLINE STORAGE_POINT rrddim_query_next_metric(struct storage_engine_query
     return sp;
 }
 
+// Fills the batch with the points the next consecutive calls to rrddim_query_next_metric() would return,
+// until the end of the query or until the batch is full.
+size_t rrddim_query_next_metric_batch(struct storage_engine_query_handle *seqh, STORAGE_POINTS_BATCH *batch) {
+    struct mem_query_handle* h = (struct mem_query_handle*)seqh->handle;
+
+    storage_points_batch_reset(batch);
+
+    do {
+        STORAGE_POINT sp = rrddim_query_next_metric(seqh);
+        storage_points_batch_set(batch, batch->used, sp);
+        batch->used++;
+    } while(batch->used < STORAGE_POINTS_BATCH_SIZE && h->next_timestamp <= seqh->end_time_s);
+
+    return batch->used;
+}
+
 int rrddim_query_is_finished(struct storage_engine_query_handle *seqh) {
     struct mem_query_handle *h = (struct mem_query_handle*)seqh->handle;
     return (h->next_timestamp > seqh->end_time_s);
@@ -153,6 +153,11 @@ void rrddim_store_metric(RRDDIM *rd, usec_t point_end_time_ut, NETDATA_DOUBLE n,
 
     rrdset_done_statistics_points_stored_per_tier[0]++;
 
+    // feed the exporting connector instances that export this dimension
+    struct exporting_accumulators *acc = __atomic_load_n(&rd->exporting_accumulators, __ATOMIC_ACQUIRE);
+    if(unlikely(acc))
+        exporting_accumulate(acc, point_end_time_ut, n);
+
     time_t now_s = (time_t)(point_end_time_ut / USEC_PER_SEC);
 
     STORAGE_POINT sp = {
@@ -224,6 +224,7 @@ static void rrddim_delete_callback(const DICTIONARY_ITEM *item __maybe_unused, v
     rrdcontext_removed_rrddim(rd);
 
     ml_dimension_delete(rd);
+    exporting_accumulators_free(rd);
 
     netdata_log_debug(D_RRD_CALLS, "rrddim_free() %s.%s", rrdset_name(st), rrddim_name(rd));
 
@@ -10,6 +10,7 @@ typedef struct rrddim RRDDIM;
 typedef struct rrddim_acquired RRDDIM_ACQUIRED;
 typedef struct ml_dimension rrd_ml_dimension_t;
 typedef struct rrdmetric_acquired RRDMETRIC_ACQUIRED;
+struct exporting_accumulators;
 
 #include "rrdset.h"
 
@@ -72,6 +73,7 @@ struct rrddim {
 
     struct rrdset *rrdset;
     rrd_ml_dimension_t *ml_dimension;               // machine learning data about this dimension
+    struct exporting_accumulators *exporting_accumulators; // running sums for exporting connector instances
 
     struct {
         RRDMETRIC_ACQUIRED *rrdmetric;              // the rrdmetric of this dimension
@@ -29,9 +29,20 @@ typedef struct labels_registry_idx_entry {
 typedef struct rrdlabels {
     SPINLOCK spinlock;
     size_t version;
+    size_t membership_version;
     Pvoid_t JudyL;
 } RRDLABELS;
 
+// the membership versions of all RRDLABELS are taken from this counter, so that
+// a membership version identifies the labels of one RRDLABELS at one point in time
+static size_t rrdlabels_membership_versions = 0;
+
+// called when a label is added to or removed from labels
+static inline void rrdlabels_membership_changed(RRDLABELS *labels) {
+    size_t version = __atomic_add_fetch(&rrdlabels_membership_versions, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&labels->membership_version, version, __ATOMIC_RELEASE);
+}
+
 #define lfe_start_nolock(label_list, label, ls)                                                                        \
     do {                                                                                                               \
         bool _first_then_next = true;                                                                                  \
@@ -82,6 +93,7 @@ RRDLABELS *rrdlabels_create(void)
 {
     RRDLABELS *labels = callocz(1, sizeof(*labels));
     RRDLABELS_MEMORY_DELTA(&dictionary_stats_category_rrdlabels, 0, sizeof(RRDLABELS));
+    rrdlabels_membership_changed(labels);
     return labels;
 }
 
@@ -175,6 +187,8 @@ void rrdlabels_flush(RRDLABELS *labels) {
     while ((PValue = JudyLFirstThenNext(labels->JudyL, &Index, &first_then_next))) {
         delete_label((RRDLABEL *)Index);
     }
+    if(labels->JudyL)
+        rrdlabels_membership_changed(labels);
     JudyAllocThreadPulseReset();
     JudyLFreeArray(&labels->JudyL, PJE0);
     int64_t judy_mem = JudyAllocThreadPulseGetAndReset();
@@ -240,6 +254,7 @@ static void labels_add_already_sanitized(RRDLABELS *labels, const char *key, con
     else {
         new_ls |= RRDLABEL_FLAG_NEW;
         *((RRDLABEL_SRC *)PValue) = new_ls;
+        rrdlabels_membership_changed(labels);
 
         RRDLABEL *old_label_with_same_key = rrdlabels_find_label_with_key_unsafe(labels, new_label, false);
         if (old_label_with_same_key) {
@@ -493,6 +508,7 @@ static void rrdlabels_remove_all_unmarked_unsafe(RRDLABELS *labels)
             RRDLABELS_MEMORY_DELTA(&dictionary_stats_category_rrdlabels, judy_mem, 0);
 
             delete_label((RRDLABEL *)Index);
+            rrdlabels_membership_changed(labels);
             if (labels->JudyL != (Pvoid_t) NULL) {
                 Index = 0;
                 first_then_next = true;
@@ -530,6 +546,34 @@ int rrdlabels_walkthrough_read(RRDLABELS *labels, int (*callback)(const char *na
     return ret;
 }
 
+// the id of a label is the same for all RRDLABELS having the same key and value,
+// and labels are always traversed in ascending order of their ids
+int rrdlabels_walkthrough_read_with_id(RRDLABELS *labels, int (*callback)(uintptr_t id, STRING *name, STRING *value, void *data), void *data)
+{
+    int ret = 0;
+
+    if(unlikely(!labels || !callback)) return 0;
+
+    RRDLABEL *lb;
+    RRDLABEL_SRC ls;
+    lfe_start_read(labels, lb, ls)
+    {
+        ret = callback((uintptr_t)lb, lb->index.key, lb->index.value, data);
+        if (ret < 0)
+            break;
+    }
+    lfe_done(labels);
+
+    return ret;
+}
+
+size_t rrdlabels_membership_version(RRDLABELS *labels) {
+    if(unlikely(!labels))
+        return 0;
+
+    return __atomic_load_n(&labels->membership_version, __ATOMIC_ACQUIRE);
+}
+
 static SIMPLE_PATTERN_RESULT rrdlabels_walkthrough_read_sp(RRDLABELS *labels, SIMPLE_PATTERN_RESULT (*callback)(const char *name, const char *value, RRDLABEL_SRC ls, void *data), void *data)
 {
     SIMPLE_PATTERN_RESULT ret = SP_NOT_MATCHED;
@@ -578,6 +622,7 @@ void rrdlabels_migrate_to_these(RRDLABELS *dst, RRDLABELS *src) {
         if (!*PValue) {
             flag = (ls & ~(RRDLABEL_FLAG_OLD | RRDLABEL_FLAG_NEW)) | RRDLABEL_FLAG_NEW;
             dup_label(label);
+            rrdlabels_membership_changed(dst);
             int64_t judy_mem = JudyAllocThreadPulseGetAndReset();
             RRDLABELS_MEMORY_DELTA(&dictionary_stats_category_rrdlabels, judy_mem, 0);
         }
@@ -653,6 +698,7 @@ void rrdlabels_copy(RRDLABELS *dst, RRDLABELS *src)
             dup_label(label);
             ls = (ls & ~(RRDLABEL_FLAG_OLD)) | RRDLABEL_FLAG_NEW;
             dst->version++;
+            rrdlabels_membership_changed(dst);
             update_statistics = true;
             if (old_label_with_key) {
                 (void)JudyLDel(&dst->JudyL, (Word_t)old_label_with_key, PJE0);
@@ -741,6 +787,21 @@ SIMPLE_PATTERN_RESULT rrdlabels_match_simple_pattern_parsed(RRDLABELS *labels, S
     return ret;
 }
 
+// the result rrdlabels_match_simple_pattern_parsed() gets for a single label
+// the first label (in ascending order of ids) not returning SP_NOT_MATCHED gives the result for all the labels
+SIMPLE_PATTERN_RESULT rrdlabel_match_simple_pattern_parsed(const char *name, const char *value, SIMPLE_PATTERN *pattern, char equal) {
+    struct simple_pattern_match_name_value t = {
+        .searches = 0,
+        .pattern = pattern,
+        .equal = equal
+    };
+
+    if(equal)
+        return simple_pattern_match_name_and_value_callback(name, value, 0, &t);
+
+    return simple_pattern_match_name_only_callback(name, value, 0, &t);
+}
+
 bool rrdlabels_match_simple_pattern(RRDLABELS *labels, const char *simple_pattern_txt) {
     if (!labels) return false;
 
@@ -1435,6 +1496,95 @@ int rrdlabels_unittest_sanitization() {
     return errors;
 }
 
+struct rrdlabels_unittest_first_label {
+    SIMPLE_PATTERN *pattern;
+    char equal;
+    SIMPLE_PATTERN_RESULT ret;
+    uintptr_t last_id;
+    int errors;
+};
+
+static int rrdlabels_unittest_first_label_callback(uintptr_t id, STRING *name, STRING *value, void *data) {
+    struct rrdlabels_unittest_first_label *t = data;
+
+    if(id <= t->last_id)
+        t->errors++;
+    t->last_id = id;
+
+    t->ret = rrdlabel_match_simple_pattern_parsed(string2str(name), string2str(value), t->pattern, t->equal);
+    return (t->ret == SP_NOT_MATCHED) ? 0 : -1;
+}
+
+static int rrdlabels_unittest_check_label_match(RRDLABELS *labels, const char *pattern, char equal) {
+    SIMPLE_PATTERN *sp = simple_pattern_create(pattern, SIMPLE_PATTERN_DEFAULT_WEB_SEPARATORS, SIMPLE_PATTERN_EXACT, true);
+
+    struct rrdlabels_unittest_first_label t = {
+        .pattern = sp,
+        .equal = equal,
+        .ret = SP_NOT_MATCHED,
+    };
+    rrdlabels_walkthrough_read_with_id(labels, rrdlabels_unittest_first_label_callback, &t);
+
+    SIMPLE_PATTERN_RESULT expected = rrdlabels_match_simple_pattern_parsed(labels, sp, equal, NULL);
+    simple_pattern_free(sp);
+
+    bool ok = !t.errors && t.ret == expected;
+    fprintf(stderr, "rrdlabel_match_simple_pattern_parsed(\"%s\") per label ... %s\n", pattern, ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+static int rrdlabels_unittest_membership() {
+    fprintf(stderr, "\n%s() tests\n", __FUNCTION__);
+
+    int errors = 0;
+    RRDLABELS *labels = rrdlabels_create();
+
+    RRDLABELS *other = rrdlabels_create();
+    size_t other_version = rrdlabels_membership_version(other);
+
+    size_t v1 = rrdlabels_membership_version(labels);
+    rrdlabels_add(labels, "key1", "value1", RRDLABEL_SRC_CONFIG);
+    rrdlabels_add(labels, "key2", "value2", RRDLABEL_SRC_CONFIG);
+    size_t v2 = rrdlabels_membership_version(labels);
+    if(v2 == v1) {
+        fprintf(stderr, "membership version did not change when labels were added\n");
+        errors++;
+    }
+
+    if(rrdlabels_membership_version(other) != other_version) {
+        fprintf(stderr, "membership version changed when labels were added to another set\n");
+        errors++;
+    }
+
+    rrdlabels_unmark_all(labels);
+    rrdlabels_add(labels, "key1", "value1", RRDLABEL_SRC_CONFIG);
+    rrdlabels_add(labels, "key2", "value2", RRDLABEL_SRC_CONFIG);
+    rrdlabels_remove_all_unmarked(labels);
+    if(rrdlabels_membership_version(labels) != v2) {
+        fprintf(stderr, "membership version changed when the same labels were added again\n");
+        errors++;
+    }
+
+    rrdlabels_add(labels, "key2", "other", RRDLABEL_SRC_CONFIG);
+    if(rrdlabels_membership_version(labels) == v2) {
+        fprintf(stderr, "membership version did not change when a label value changed\n");
+        errors++;
+    }
+
+    rrdlabels_destroy(other);
+
+    rrdlabels_add(labels, "key3", "elephant", RRDLABEL_SRC_CONFIG);
+    errors += rrdlabels_unittest_check_label_match(labels, "key2:other", ':');
+    errors += rrdlabels_unittest_check_label_match(labels, "key2:value2", ':');
+    errors += rrdlabels_unittest_check_label_match(labels, "!key3:*phant key*:*", ':');
+    errors += rrdlabels_unittest_check_label_match(labels, "*:value1", ':');
+    errors += rrdlabels_unittest_check_label_match(labels, "key3", '\0');
+    errors += rrdlabels_unittest_check_label_match(labels, "!key3 *", '\0');
+
+    rrdlabels_destroy(labels);
+    return errors;
+}
+
 int rrdlabels_unittest(void) {
     int errors = 0;
 
@@ -1445,6 +1595,7 @@ int rrdlabels_unittest(void) {
     errors += rrdlabels_unittest_double_check();
     errors += rrdlabels_unittest_migrate_check();
     errors += rrdlabels_unittest_pattern_check();
+    errors += rrdlabels_unittest_membership();
 
     fprintf(stderr, "%d errors found\n", errors);
     return errors;
@@ -273,37 +273,55 @@ static inline void rrdset_init_last_updated_time(RRDSET *st) {
 
 __thread size_t rrdset_done_statistics_points_stored_per_tier[RRD_STORAGE_TIERS];
 
+typedef enum __attribute__((packed)) {
+    RDA_STORE_NOTHING = 0,                  // this iteration is not stored
+    RDA_STORE_VALUE,                        // the dimension has a value to store
+    RDA_STORE_NON_EXISTING,                 // the dimension has not been collected
+} RDA_STORE;
+
 // caching of dimensions rrdset_done() and rrdset_done_interpolate() loop through
 struct rda_item {
     const DICTIONARY_ITEM *item;
     RRDDIM *rd;
     bool reset_or_overflow;
+
+    // the current interpolation point
+    RDA_STORE store;
+    NETDATA_DOUBLE new_value;
 };
 
+#define RDA_ENTRY_SIZE (sizeof(struct rda_item) + sizeof(ML_DIMENSION_PREDICTION))
+
 static __thread struct rda_item *thread_rda = NULL;
+static __thread ML_DIMENSION_PREDICTION *thread_rda_ml = NULL;
 static __thread size_t thread_rda_entries = 0;
 
-static struct rda_item *rrdset_thread_rda_get(size_t *dimensions) {
+static struct rda_item *rrdset_thread_rda_get(size_t *dimensions, ML_DIMENSION_PREDICTION **predictions) {
 
     if(unlikely(!thread_rda || (*dimensions) > thread_rda_entries)) {
-        size_t old_mem = thread_rda_entries * sizeof(struct rda_item);
+        size_t old_mem = thread_rda_entries * RDA_ENTRY_SIZE;
         freez(thread_rda);
+        freez(thread_rda_ml);
         thread_rda_entries = *dimensions;
-        size_t new_mem = thread_rda_entries * sizeof(struct rda_item);
-        thread_rda = mallocz(new_mem);
+        size_t new_mem = thread_rda_entries * RDA_ENTRY_SIZE;
+        thread_rda = mallocz(thread_rda_entries * sizeof(struct rda_item));
+        thread_rda_ml = mallocz(thread_rda_entries * sizeof(ML_DIMENSION_PREDICTION));
 
         __atomic_add_fetch(&netdata_buffers_statistics.rrdset_done_rda_size, new_mem - old_mem, __ATOMIC_RELAXED);
     }
 
     *dimensions = thread_rda_entries;
+    *predictions = thread_rda_ml;
     return thread_rda;
 }
 
 void rrdset_thread_rda_free(void) {
-    __atomic_sub_fetch(&netdata_buffers_statistics.rrdset_done_rda_size, thread_rda_entries * sizeof(struct rda_item), __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&netdata_buffers_statistics.rrdset_done_rda_size, thread_rda_entries * RDA_ENTRY_SIZE, __ATOMIC_RELAXED);
 
     freez(thread_rda);
+    freez(thread_rda_ml);
     thread_rda = NULL;
+    thread_rda_ml = NULL;
     thread_rda_entries = 0;
 }
 
@@ -311,6 +329,7 @@ static inline size_t rrdset_done_interpolate(
     RRDSET_STREAM_BUFFER *rsb
     , RRDSET *st
     , struct rda_item *rda_base
+    , ML_DIMENSION_PREDICTION *ml_base
     , size_t rda_slots
     , usec_t update_every_ut
     , usec_t last_stored_ut
@@ -351,17 +370,14 @@ static inline size_t rrdset_done_interpolate(
 
         ml_chart_update_begin(st);
 
+        // first pass: calculate the values of this interpolation point
         struct rda_item *rda;
         size_t dim_id;
+        size_t ml_entries = 0;
         for(dim_id = 0, rda = rda_base ; dim_id < rda_slots ; ++dim_id, ++rda) {
             rd = rda->rd;
             if(unlikely(!rd)) continue;
 
-            SN_FLAGS storage_flags = SN_DEFAULT_FLAGS;
-
-            if (rda->reset_or_overflow)
-                storage_flags |= SN_FLAG_RESET;
-
             NETDATA_DOUBLE new_value;
 
             switch(rd->algorithm) {
@@ -435,11 +451,35 @@ static inline size_t rrdset_done_interpolate(
                     break;
             }
 
-            time_t current_time_s = (time_t) (next_store_ut / USEC_PER_SEC);
+            if(unlikely(!store_this_entry))
+                rda->store = RDA_STORE_NOTHING;
+            else if(likely(rrddim_check_updated(rd) && rd->collector.counter > 1 && iterations < gap_when_lost_iterations_above))
+                rda->store = RDA_STORE_VALUE;
+            else
+                rda->store = RDA_STORE_NON_EXISTING;
+
+            rda->new_value = new_value;
+
+            ML_DIMENSION_PREDICTION *ml = &ml_base[ml_entries++];
+            ml->rd = rd;
+            ml->exists = (rda->store == RDA_STORE_VALUE);
+            ml->value = ml->exists ? new_value : 0;
+        }
+
+        // anomaly detection needs all the values of the chart,
+        // so that it can score all its dimensions together
+        ml_dimensions_are_anomalous(st, ml_base, ml_entries);
+
+        // second pass: stream and store the interpolation point
+        ML_DIMENSION_PREDICTION *ml = ml_base;
+        for(dim_id = 0, rda = rda_base ; dim_id < rda_slots ; ++dim_id, ++rda) {
+            rd = rda->rd;
+            if(unlikely(!rd)) continue;
 
-            if(unlikely(!store_this_entry)) {
-                (void) ml_dimension_is_anomalous(rd, current_time_s, 0, false);
+            bool is_anomalous = (ml++)->anomalous;
+            NETDATA_DOUBLE new_value = rda->new_value;
 
+            if(unlikely(rda->store == RDA_STORE_NOTHING)) {
                 if(rsb->wb && rsb->v2)
                     stream_send_rrddim_metrics_v2(rsb, rd, next_store_ut, NAN, SN_FLAG_NONE);
 
@@ -447,10 +487,15 @@ static inline size_t rrdset_done_interpolate(
                 continue;
             }
 
-            if(likely(rrddim_check_updated(rd) && rd->collector.counter > 1 && iterations < gap_when_lost_iterations_above)) {
+            if(likely(rda->store == RDA_STORE_VALUE)) {
+                SN_FLAGS storage_flags = SN_DEFAULT_FLAGS;
+
+                if (rda->reset_or_overflow)
+                    storage_flags |= SN_FLAG_RESET;
+
                 uint32_t dim_storage_flags = storage_flags;
 
-                if (ml_dimension_is_anomalous(rd, current_time_s, new_value, true)) {
+                if (is_anomalous) {
                     // clear anomaly bit: 0 -> is anomalous, 1 -> not anomalous
                     dim_storage_flags &= ~((storage_number)SN_FLAG_NOT_ANOMALOUS);
                 }
@@ -462,8 +507,6 @@ static inline size_t rrdset_done_interpolate(
                 rd->collector.last_stored_value = new_value;
             }
             else {
-                (void) ml_dimension_is_anomalous(rd, current_time_s, 0, false);
-
                 rrdset_debug(st, "%s: STORE[%ld] = NON EXISTING ", rrddim_name(rd), current_entry);
 
                 if(rsb->wb && rsb->v2)
@@ -640,7 +683,8 @@ void rrdset_timed_done(RRDSET *st, struct timeval now, bool pending_rrdset_next)
         stream_send_rrdset_metrics_v1(&stream_buffer, st);
 
     size_t rda_slots = dictionary_entries(st->rrddim_root_index);
-    struct rda_item *rda_base = rrdset_thread_rda_get(&rda_slots);
+    ML_DIMENSION_PREDICTION *ml_base;
+    struct rda_item *rda_base = rrdset_thread_rda_get(&rda_slots, &ml_base);
 
     size_t dim_id;
     size_t dimensions = 0;
@@ -898,6 +942,7 @@ void rrdset_timed_done(RRDSET *st, struct timeval now, bool pending_rrdset_next)
         &stream_buffer
         , st
         , rda_base
+        , ml_base
         , rda_slots
         , update_every_ut
         , last_stored_ut
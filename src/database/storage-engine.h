@@ -388,6 +388,25 @@ static STORAGE_POINT storage_engine_query_next_metric(struct storage_engine_quer
     return rrddim_query_next_metric(seqh);
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// fill a columnar batch with the points the next consecutive storage_engine_query_next_metric() calls would return
+// the batch ends at a page boundary, at the end of the query or when it is full - it always gets at least 1 point
+// the caller must check storage_engine_query_is_finished() before calling it, like for single points
+
+size_t rrdeng_load_metric_next_batch(struct storage_engine_query_handle *seqh, STORAGE_POINTS_BATCH *batch);
+size_t rrddim_query_next_metric_batch(struct storage_engine_query_handle *seqh, STORAGE_POINTS_BATCH *batch);
+
+ALWAYS_INLINE_HOT_FLATTEN
+static size_t storage_engine_query_next_metric_batch(struct storage_engine_query_handle *seqh, STORAGE_POINTS_BATCH *batch) {
+    internal_fatal(!is_valid_backend(seqh->seb), "STORAGE: invalid backend");
+
+#ifdef ENABLE_DBENGINE
+    if(likely(seqh->seb == STORAGE_ENGINE_BACKEND_DBENGINE))
+        return rrdeng_load_metric_next_batch(seqh, batch);
+#endif
+    return rrddim_query_next_metric_batch(seqh, batch);
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 int rrdeng_load_metric_is_finished(struct storage_engine_query_handle *seqh);
@@ -101,6 +101,8 @@ static void exporting_clean_engine()
     //Cleanup web api
     prometheus_clean_server_root();
 
+    exporting_accumulators_release();
+
     for (struct instance *instance = engine->instance_root; instance;) {
         struct instance *current_instance = instance;
         instance = instance->next;
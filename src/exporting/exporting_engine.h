@@ -251,9 +251,24 @@ struct engine {
 
 extern struct instance *prometheus_exporter_instance;
 
+// running sums of the points collected for a dimension, one per instance,
+// so that the instances do not need to query the database on every export
+struct exporting_accumulator {
+    NETDATA_DOUBLE sum;
+    size_t count;
+};
+
+struct exporting_accumulators {
+    SPINLOCK spinlock;
+    time_t last_t;                                  // the timestamp of the latest point accumulated
+    size_t instances;
+    struct exporting_accumulator *instance[];       // allocated the first time an instance exports the dimension
+};
+
 void *exporting_main(void *ptr);
 
 struct engine *read_exporting_config();
+void exporting_accumulators_release(void);
 EXPORTING_CONNECTOR_TYPE exporting_select_type(const char *type);
 
 int init_connectors(struct engine *engine);
@@ -170,19 +170,22 @@ int format_dimension_stored_graphite_plaintext(struct instance *instance, RRDDIM
     time_t last_t;
     NETDATA_DOUBLE value = exporting_calculate_value_from_stored_data(instance, rd, &last_t);
 
-    if(isnan(value))
+    if(isnan(value) || isinf(value))
         return 0;
 
     buffer_sprintf(
         instance->buffer,
-        "%s.%s.%s.%s%s " NETDATA_DOUBLE_FORMAT " %llu\n",
+        "%s.%s.%s.%s%s ",
         instance->config.prefix,
         (host == localhost) ? instance->config.hostname : rrdhost_hostname(host),
         chart_name,
         dimension_name,
-        (instance->labels_buffer) ? buffer_tostring(instance->labels_buffer) : "",
-        value,
-        (unsigned long long)last_t);
+        (instance->labels_buffer) ? buffer_tostring(instance->labels_buffer) : "");
+
+    buffer_print_netdata_double(instance->buffer, value);
+    buffer_putc(instance->buffer, ' ');
+    buffer_print_uint64(instance->buffer, (uint64_t)last_t);
+    buffer_putc(instance->buffer, '\n');
 
     return 0;
 }
@@ -230,9 +230,7 @@ int format_dimension_stored_json_plaintext(struct instance *instance, RRDDIM *rd
 
         "\"id\":\"%s\","
         "\"name\":\"%s\","
-        "\"value\":" NETDATA_DOUBLE_FORMAT ","
-
-        "\"timestamp\": %llu}",
+        "\"value\":",
 
         instance->config.prefix,
         (host == localhost) ? instance->config.hostname : rrdhost_hostname(host),
@@ -245,10 +243,11 @@ int format_dimension_stored_json_plaintext(struct instance *instance, RRDDIM *rd
         rrdset_parts_type(st),
         rrdset_units(st),
         rrddim_id(rd),
-        rrddim_name(rd),
-        value,
+        rrddim_name(rd));
+
+    buffer_print_netdata_double(instance->buffer, value);
 
-        (unsigned long long)last_t);
+    buffer_sprintf(instance->buffer, ",\"timestamp\": %llu}", (unsigned long long)last_t);
 
     if (instance->config.type != EXPORTING_CONNECTOR_TYPE_JSON_HTTP) {
         buffer_strcat(instance->buffer, "\n");
@@ -221,17 +221,22 @@ int format_dimension_stored_opentsdb_telnet(struct instance *instance, RRDDIM *r
     time_t last_t;
     NETDATA_DOUBLE value = exporting_calculate_value_from_stored_data(instance, rd, &last_t);
 
-    if(isnan(value))
+    if(isnan(value) || isinf(value))
         return 0;
 
     buffer_sprintf(
         instance->buffer,
-        "put %s.%s.%s %llu " NETDATA_DOUBLE_FORMAT " host=%s%s\n",
+        "put %s.%s.%s %llu ",
         instance->config.prefix,
         chart_name,
         dimension_name,
-        (unsigned long long)last_t,
-        value,
+        (unsigned long long)last_t);
+
+    buffer_print_netdata_double(instance->buffer, value);
+
+    buffer_sprintf(
+        instance->buffer,
+        " host=%s%s\n",
         (host == localhost) ? instance->config.hostname : rrdhost_hostname(host),
         (instance->labels_buffer) ? buffer_tostring(instance->labels_buffer) : "");
 
@@ -359,7 +364,7 @@ int format_dimension_stored_opentsdb_http(struct instance *instance, RRDDIM *rd)
     time_t last_t;
     NETDATA_DOUBLE value = exporting_calculate_value_from_stored_data(instance, rd, &last_t);
 
-    if(isnan(value))
+    if(isnan(value) || isinf(value))
         return 0;
 
     if (buffer_strlen((BUFFER *)instance->buffer) > 2)
@@ -370,16 +375,21 @@ int format_dimension_stored_opentsdb_http(struct instance *instance, RRDDIM *rd)
         "{"
         "\"metric\":\"%s.%s.%s\","
         "\"timestamp\":%llu,"
-        "\"value\":" NETDATA_DOUBLE_FORMAT ","
+        "\"value\":",
+        instance->config.prefix,
+        chart_name,
+        dimension_name,
+        (unsigned long long)last_t);
+
+    buffer_print_netdata_double(instance->buffer, value);
+
+    buffer_sprintf(
+        instance->buffer,
+        ","
         "\"tags\":{"
         "\"host\":\"%s\"%s"
         "}"
         "}",
-        instance->config.prefix,
-        chart_name,
-        dimension_name,
-        (unsigned long long)last_t,
-        value,
         (host == localhost) ? instance->config.hostname : rrdhost_hostname(host),
         instance->labels_buffer ? buffer_tostring(instance->labels_buffer) : "");
 
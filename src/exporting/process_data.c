@@ -54,9 +54,199 @@ int mark_scheduled_instances(struct engine *engine)
     return instances_were_scheduled;
 }
 
+/**
+ * Add a collected point to the accumulators of a dimension
+ *
+ * Called by data collection, right after the point is stored on tier 0. Points that are not newer
+ * than the latest accumulated one (e.g. replicated points that were already exported) are ignored.
+ *
+ * @param acc the accumulators of the dimension.
+ * @param point_end_time_ut the end time of the point.
+ * @param n the value of the point.
+ */
+void exporting_accumulate(struct exporting_accumulators *acc, usec_t point_end_time_ut, NETDATA_DOUBLE n)
+{
+    if (unlikely(!netdata_double_isnumber(n)))
+        return;
+
+    time_t point_end_time_s = (time_t)(point_end_time_ut / USEC_PER_SEC);
+
+    spinlock_lock(&acc->spinlock);
+    if (likely(point_end_time_s > acc->last_t)) {
+        acc->last_t = point_end_time_s;
+
+        for (size_t i = 0; i < acc->instances; i++) {
+            struct exporting_accumulator *a = acc->instance[i];
+            if (a) {
+                a->sum += n;
+                a->count++;
+            }
+        }
+    }
+    spinlock_unlock(&acc->spinlock);
+}
+
+/**
+ * Free the accumulators of a dimension
+ *
+ * @param rd a dimension(metric) in the Netdata database.
+ */
+void exporting_accumulators_free(RRDDIM *rd)
+{
+    struct exporting_accumulators *acc = rd->exporting_accumulators;
+    if (!acc)
+        return;
+
+    for (size_t i = 0; i < acc->instances; i++)
+        freez(acc->instance[i]);
+
+    freez(acc);
+    rd->exporting_accumulators = NULL;
+}
+
+/**
+ * Free the accumulators of all instances
+ *
+ * Called when the instances are destroyed. Data collection may still be feeding the accumulators of the
+ * dimensions, so they are kept, without any instances, until their dimensions are deleted.
+ */
+void exporting_accumulators_release(void)
+{
+    rrd_rdlock();
+    RRDHOST *host;
+    rrdhost_foreach_read(host) {
+        RRDSET *st;
+        rrdset_foreach_read(st, host) {
+            RRDDIM *rd;
+            rrddim_foreach_read(rd, st) {
+                struct exporting_accumulators *acc = __atomic_load_n(&rd->exporting_accumulators, __ATOMIC_ACQUIRE);
+                if (!acc)
+                    continue;
+
+                spinlock_lock(&acc->spinlock);
+                for (size_t i = 0; i < acc->instances; i++) {
+                    freez(acc->instance[i]);
+                    acc->instance[i] = NULL;
+                }
+                spinlock_unlock(&acc->spinlock);
+            }
+            rrddim_foreach_done(rd);
+        }
+        rrdset_foreach_done(st);
+    }
+    rrd_rdunlock();
+}
+
+/**
+ * Create the accumulators of a dimension
+ *
+ * Only the exporting engine thread creates accumulators. Data collection starts feeding them
+ * as soon as they are published. Only the instance creating them gets a slot, since it reads
+ * the database up to the latest point stored.
+ *
+ * The accumulators are published before the latest point stored is found, under their lock,
+ * so every point is either in the database up to that point, or it is accumulated after it.
+ *
+ * @param instance an instance data structure.
+ * @param rd a dimension(metric) in the Netdata database.
+ * @return Returns the timestamp of the latest point stored, which the accumulators continue from.
+ */
+static time_t exporting_accumulators_create(struct instance *instance, RRDDIM *rd)
+{
+    struct engine *engine = instance->engine;
+    struct exporting_accumulators *acc = callocz(
+        1, sizeof(struct exporting_accumulators) + engine->instance_num * sizeof(struct exporting_accumulator *));
+
+    struct exporting_accumulator *a = callocz(1, sizeof(struct exporting_accumulator));
+
+    spinlock_init(&acc->spinlock);
+    acc->instances = engine->instance_num;
+    acc->instance[instance->index] = a;
+
+    __atomic_store_n(&rd->exporting_accumulators, acc, __ATOMIC_RELEASE);
+
+    spinlock_lock(&acc->spinlock);
+
+    // points are accumulated after they are stored, so the ones accumulated so far are in the database,
+    // and the ones stored but not accumulated yet will be ignored, as not newer than the latest point stored
+    time_t last_t = storage_engine_latest_time_s(rd->tiers[0].seb, rd->tiers[0].smh);
+    if (last_t > acc->last_t)
+        acc->last_t = last_t;
+
+    a->sum = 0;
+    a->count = 0;
+    last_t = acc->last_t;
+
+    spinlock_unlock(&acc->spinlock);
+
+    return last_t;
+}
+
+/**
+ * Calculate the SUM or AVERAGE of a dimension, since the last time an instance exported it
+ *
+ * May return NAN if no points have been collected since then.
+ *
+ * @param instance an instance data structure.
+ * @param rd a dimension(metric) in the Netdata database.
+ * @param acc the accumulators of the dimension.
+ * @param last_timestamp the timestamp that should be reported to the exporting connector instance.
+ * @return Returns the value, calculated over the accumulated points.
+ */
+static NETDATA_DOUBLE exporting_calculate_value_from_accumulator(
+    struct instance *instance,
+    RRDDIM *rd,
+    struct exporting_accumulators *acc,
+    time_t *last_timestamp)
+{
+    spinlock_lock(&acc->spinlock);
+
+    struct exporting_accumulator *a = acc->instance[instance->index];
+    if (unlikely(!a)) {
+        // the first time the instance exports the dimension, start from the latest value stored
+        a = callocz(1, sizeof(struct exporting_accumulator));
+        NETDATA_DOUBLE last_stored_value = rd->collector.last_stored_value;
+        if (netdata_double_isnumber(last_stored_value)) {
+            a->sum = last_stored_value;
+            a->count = 1;
+        }
+        acc->instance[instance->index] = a;
+    }
+
+    NETDATA_DOUBLE sum = a->sum;
+    size_t counter = a->count;
+    time_t last_t = acc->last_t;
+    a->sum = 0;
+    a->count = 0;
+    spinlock_unlock(&acc->spinlock);
+
+    if (unlikely(!counter)) {
+        netdata_log_debug(
+            D_EXPORTING,
+            "EXPORTING: %s.%s.%s: no values collected since the last export",
+            rrdhost_hostname(rd->rrdset->rrdhost),
+            rrdset_id(rd->rrdset),
+            rrddim_id(rd));
+        return NAN;
+    }
+
+    *last_timestamp = last_t;
+
+    if (unlikely(EXPORTING_OPTIONS_DATA_SOURCE(instance->config.options) == EXPORTING_SOURCE_DATA_SUM))
+        return sum;
+
+    return sum / (NETDATA_DOUBLE)counter;
+}
+
 /**
  * Calculate the SUM or AVERAGE of a dimension, for any timeframe
  *
+ * Instances of the exporting engine are served from the accumulators of the dimension, fed by data collection.
+ * The first time a dimension is exported, its accumulators are created and the database is queried up to the
+ * latest point stored, so that the accumulators continue from there. The first export of the dimension by any
+ * other instance starts from the latest value stored. The prometheus web API instance always
+ * queries the database, since every prometheus server scraping it has its own timeframe.
+ *
  * May return NAN if the database does not have any value in the give timeframe.
  *
  * @param instance an instance data structure.
@@ -69,6 +259,13 @@ NETDATA_DOUBLE exporting_calculate_value_from_stored_data(
     RRDDIM *rd,
     time_t *last_timestamp)
 {
+    bool accumulate = instance->engine != NULL;
+    if (likely(accumulate)) {
+        struct exporting_accumulators *acc = __atomic_load_n(&rd->exporting_accumulators, __ATOMIC_ACQUIRE);
+        if (likely(acc))
+            return exporting_calculate_value_from_accumulator(instance, rd, acc, last_timestamp);
+    }
+
     RRDSET *st = rd->rrdset;
 #ifdef NETDATA_INTERNAL_CHECKS
     RRDHOST *host = st->rrdhost;
@@ -78,7 +275,8 @@ NETDATA_DOUBLE exporting_calculate_value_from_stored_data(
 
     // find the edges of the rrd database for this chart
     time_t first_t = storage_engine_oldest_time_s(rd->tiers[0].seb, rd->tiers[0].smh);
-    time_t last_t = storage_engine_latest_time_s(rd->tiers[0].seb, rd->tiers[0].smh);
+    time_t last_t = accumulate ? exporting_accumulators_create(instance, rd) :
+                                 storage_engine_latest_time_s(rd->tiers[0].seb, rd->tiers[0].smh);
     time_t update_every = st->update_every;
     struct storage_engine_query_handle handle;
 
@@ -95,6 +293,10 @@ NETDATA_DOUBLE exporting_calculate_value_from_stored_data(
     // the latest point will be reported the next time
     before -= update_every;
 
+    // the accumulators continue after the latest point stored
+    if (accumulate)
+        before = last_t;
+
     if (unlikely(after > before))
         // this can happen when update_every > before - after
         after = before;
@@ -126,17 +328,20 @@ NETDATA_DOUBLE exporting_calculate_value_from_stored_data(
     size_t counter = 0;
     NETDATA_DOUBLE sum = 0;
 
+    STORAGE_POINTS_BATCH batch;
     for (storage_engine_query_init(rd->tiers[0].seb, rd->tiers[0].smh, &handle, after, before, STORAGE_PRIORITY_SYNCHRONOUS); !storage_engine_query_is_finished(&handle);) {
-        STORAGE_POINT sp = storage_engine_query_next_metric(&handle);
-        points_read++;
+        size_t points = storage_engine_query_next_metric_batch(&handle, &batch);
+        points_read += points;
 
-        if (unlikely(storage_point_is_gap(sp))) {
-            // not collected
-            continue;
-        }
+        for (size_t i = 0; i < points; i++) {
+            if (unlikely(!netdata_double_isnumber(batch.sum[i]))) {
+                // not collected
+                continue;
+            }
 
-        sum += sp.sum;
-        counter += sp.count;
+            sum += batch.sum[i];
+            counter += batch.count[i];
+        }
     }
     storage_engine_query_finalize(&handle);
     pulse_queries_exporters_query_completed(points_read);
@@ -375,27 +375,23 @@ static int print_host_variables_callback(const DICTIONARY_ITEM *item __maybe_unu
 
     prometheus_name_copy(opts->name, rrdvar_name(rv), sizeof(opts->name));
 
-    if (opts->output_options & PROMETHEUS_OUTPUT_TIMESTAMPS)
-        buffer_sprintf(
-            opts->wb,
-            "%s_%s%s%s%s " NETDATA_DOUBLE_FORMAT " %llu\n",
-            opts->prefix,
-            opts->name,
-            label_pre,
-            (opts->labels[0] == ',') ? &opts->labels[1] : opts->labels,
-            label_post,
-            value,
-            opts->now * 1000ULL);
-    else
-        buffer_sprintf(
-            opts->wb,
-            "%s_%s%s%s%s " NETDATA_DOUBLE_FORMAT "\n",
-            opts->prefix,
-            opts->name,
-            label_pre,
-            (opts->labels[0] == ',') ? &opts->labels[1] : opts->labels,
-            label_post,
-            value);
+    buffer_sprintf(
+        opts->wb,
+        "%s_%s%s%s%s ",
+        opts->prefix,
+        opts->name,
+        label_pre,
+        (opts->labels[0] == ',') ? &opts->labels[1] : opts->labels,
+        label_post);
+
+    buffer_print_netdata_double(opts->wb, value);
+
+    if (opts->output_options & PROMETHEUS_OUTPUT_TIMESTAMPS) {
+        buffer_putc(opts->wb, ' ');
+        buffer_print_uint64(opts->wb, opts->now * 1000ULL);
+    }
+
+    buffer_putc(opts->wb, '\n');
 
     return 1;
 }
@@ -757,26 +753,22 @@ static int prometheus_rrdset_to_json(RRDSET *st, void *data)
                                                    format_prometheus_chart_label_callback,
                                                    plabels_buffer);
 
-                        if (output_options & PROMETHEUS_OUTPUT_TIMESTAMPS)
-                            buffer_sprintf(wb,
-                                           "%s_%s%s%s{%s%s} " NETDATA_DOUBLE_FORMAT " %llu\n",
-                                           prefix,
-                                           context,
-                                           units,
-                                           suffix,
-                                           buffer_tostring(plabels_buffer),
-                                           opts->labels,
-                                           value,
-                                           last_time * MSEC_PER_SEC);
-                        else
-                            buffer_sprintf(wb, "%s_%s%s%s{%s%s} " NETDATA_DOUBLE_FORMAT "\n",
-                                           prefix,
-                                           context,
-                                           units,
-                                           suffix,
-                                           buffer_tostring(plabels_buffer),
-                                           opts->labels,
-                                           value);
+                        buffer_sprintf(wb, "%s_%s%s%s{%s%s} ",
+                                       prefix,
+                                       context,
+                                       units,
+                                       suffix,
+                                       buffer_tostring(plabels_buffer),
+                                       opts->labels);
+
+                        buffer_print_netdata_double(wb, value);
+
+                        if (output_options & PROMETHEUS_OUTPUT_TIMESTAMPS) {
+                            buffer_putc(wb, ' ');
+                            buffer_print_uint64(wb, (uint64_t)last_time * MSEC_PER_SEC);
+                        }
+
+                        buffer_putc(wb, '\n');
                     }
                 }
             }
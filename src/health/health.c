@@ -19,6 +19,9 @@ struct health_plugin_globals health_globals = {
         .default_warn_repeat_every = 0,
         .default_crit_repeat_every = 0,
 
+        .incremental_lookups = true,
+        .threads = 0,
+
         .run_at_least_every_seconds = 10,
         .postpone_alarms_during_hibernation_for_seconds = 60,
     },
@@ -79,6 +82,17 @@ void health_load_config_defaults(void) {
         simple_pattern_create(inicfg_get(&netdata_config, CONFIG_SECTION_HEALTH, "enabled alarms", "*"),
                               NULL, SIMPLE_PATTERN_EXACT, true);
 
+    health_globals.config.incremental_lookups =
+        inicfg_get_boolean(&netdata_config, CONFIG_SECTION_HEALTH,
+                           "incremental database lookups",
+                           health_globals.config.incremental_lookups);
+
+    size_t threads = netdata_conf_cpus() / 2;
+    if(threads < 1) threads = 1;
+    if(threads > HEALTH_THREADS_MAX) threads = HEALTH_THREADS_MAX;
+    health_globals.config.threads =
+        inicfg_get_number(&netdata_config, CONFIG_SECTION_HEALTH, "evaluation threads", (long long)threads);
+
     health_globals.config.run_at_least_every_seconds =
         (int)inicfg_get_duration_seconds(&netdata_config, CONFIG_SECTION_HEALTH, "run at least every",
                                          health_globals.config.run_at_least_every_seconds);
@@ -97,6 +111,15 @@ void health_load_config_defaults(void) {
     if(health_globals.config.run_at_least_every_seconds < 1)
         health_globals.config.run_at_least_every_seconds = 1;
 
+    if(health_globals.config.threads < 1 || health_globals.config.threads > HEALTH_THREADS_MAX) {
+        nd_log(NDLS_DAEMON, NDLP_WARNING,
+               "Health configuration has invalid evaluation threads %zu, using %zu",
+               health_globals.config.threads, threads);
+
+        health_globals.config.threads = threads;
+        inicfg_set_number(&netdata_config, CONFIG_SECTION_HEALTH, "evaluation threads", (long long)threads);
+    }
+
     if(health_globals.config.health_log_entries_max < HEALTH_LOG_ENTRIES_MIN) {
         nd_log(NDLS_DAEMON, NDLP_WARNING,
                "Health configuration has invalid max log entries %u, using minimum of %u",
@@ -227,12 +227,11 @@ static void do_eval_expression(
         *result = expression_result(expression);
 }
 
-// returns the number of runnable alerts
-static void health_event_loop_for_host(RRDHOST *host, bool apply_hibernation_delay, time_t now, time_t *next_run) {
-    size_t runnable = 0;
-
+// decide if the alerts of the host have to be evaluated in this iteration
+// runs on the health thread, host by host
+static bool health_event_loop_host_prepare(RRDHOST *host, bool apply_hibernation_delay, time_t now) {
     if(unlikely(!rrdhost_should_run_health(host)))
-        return;
+        return false;
 
     rrdhost_set_health_evloop_iteration(host);
 
@@ -242,7 +241,7 @@ static void health_event_loop_for_host(RRDHOST *host, bool apply_hibernation_del
         nd_log(NDLS_DAEMON, NDLP_DEBUG,
                "Host \"%s\" has pending alert transitions to save, postponing health checks",
                rrdhost_hostname(host));
-        return;
+        return false;
     }
 
     if (unlikely(!rrdhost_flag_check(host, RRDHOST_FLAG_INITIALIZED_HEALTH)))
@@ -262,7 +261,7 @@ static void health_event_loop_for_host(RRDHOST *host, bool apply_hibernation_del
 
     if (unlikely(host->health.delay_up_to)) {
         if (unlikely(now < host->health.delay_up_to))
-            return;
+            return false;
 
         nd_log(NDLS_DAEMON, NDLP_DEBUG,
                "[%s]: Resuming health checks after delay.",
@@ -277,7 +276,7 @@ static void health_event_loop_for_host(RRDHOST *host, bool apply_hibernation_del
             nd_log(NDLS_DAEMON, NDLP_DEBUG,
                    "[%s]: Waiting for chart obsoletion check.",
                    rrdhost_hostname(host));
-            return;
+            return false;
         }
     }
 
@@ -285,9 +284,18 @@ static void health_event_loop_for_host(RRDHOST *host, bool apply_hibernation_del
     {
         struct aclk_sync_cfg_t *aclk_host_config = __atomic_load_n(&host->aclk_host_config, __ATOMIC_RELAXED);
         if (aclk_host_config && aclk_host_config->send_snapshot == 2)
-            return;
+            return false;
     }
 
+    return true;
+}
+
+// lookup the values of the alerts from the db and run their calculations
+// runs on the health workers, in parallel for different hosts
+// returns the number of runnable alerts
+static size_t health_event_loop_host_lookups(RRDHOST *host, time_t now, time_t *next_run) {
+    size_t runnable = 0;
+
     // the first loop is to lookup values from the db
     RRDCALC *rc;
     foreach_rrdcalc_in_rrdhost_read(host, rc) {
@@ -299,42 +307,6 @@ static void health_event_loop_for_host(RRDHOST *host, bool apply_hibernation_del
         if (health_silencers_update_disabled_silenced(host, rc))
             continue;
 
-        // create an alert removed event if the chart is obsolete and
-        // has stopped being collected for 60 seconds
-        if (unlikely(rc->rrdset && rc->status != RRDCALC_STATUS_REMOVED &&
-                     rrdset_flag_check(rc->rrdset, RRDSET_FLAG_OBSOLETE) &&
-                     now > (rc->rrdset->last_collected_time.tv_sec + 60))) {
-
-            if (!rrdcalc_isrepeating(rc)) {
-                worker_is_busy(WORKER_HEALTH_JOB_ALARM_LOG_ENTRY);
-                time_t now_tmp = now_realtime_sec();
-
-                ALARM_ENTRY *ae =
-                    health_create_alarm_entry(
-                        host,
-                        rc,
-                        now_tmp,
-                        now_tmp - rc->last_status_change,
-                        rc->value,
-                        NAN,
-                        rc->status,
-                        RRDCALC_STATUS_REMOVED,
-                        0,
-                        rrdcalc_isrepeating(rc)?HEALTH_ENTRY_FLAG_IS_REPEATING:0);
-
-                if (ae) {
-                    health_log_alert(host, ae);
-                    health_alarm_log_add_entry(host, ae, false);
-                    rc->old_status = rc->status;
-                    rc->status = RRDCALC_STATUS_REMOVED;
-                    rc->last_status_change = now_tmp;
-                    rc->last_status_change_value = rc->value;
-                    rc->last_updated = now_tmp;
-                    rc->value = NAN;
-                }
-            }
-        }
-
         if (unlikely(!rrdcalc_isrunnable(rc, now, next_run))) {
             if (unlikely(rc->run_flags & RRDCALC_FLAG_RUNNABLE))
                 rc->run_flags &= ~RRDCALC_FLAG_RUNNABLE;
@@ -353,37 +325,40 @@ static void health_event_loop_for_host(RRDHOST *host, bool apply_hibernation_del
 
             /* time_t old_db_timestamp = rc->db_before; */
             int value_is_null = 0;
+            int ret = 200;
+
+            if(!health_lookup_incremental(rc, &value_is_null)) {
+                char group_options_buf[100];
+                const char *group_options = group_options_buf;
+                switch(rc->config.time_group) {
+                    default:
+                        group_options = NULL;
+                        break;
+
+                    case RRDR_GROUPING_PERCENTILE:
+                    case RRDR_GROUPING_TRIMMED_MEAN:
+                    case RRDR_GROUPING_TRIMMED_MEDIAN:
+                        snprintfz(group_options_buf, sizeof(group_options_buf),
+                                  NETDATA_DOUBLE_FORMAT_AUTO,
+                                  rc->config.time_group_value);
+                        break;
+
+                    case RRDR_GROUPING_COUNTIF:
+                        snprintfz(group_options_buf, sizeof(group_options_buf),
+                                  "%s" NETDATA_DOUBLE_FORMAT_AUTO,
+                                  alerts_group_conditions_id2txt(rc->config.time_group_condition),
+                                  rc->config.time_group_value);
+                        break;
+                }
 
-            char group_options_buf[100];
-            const char *group_options = group_options_buf;
-            switch(rc->config.time_group) {
-                default:
-                    group_options = NULL;
-                    break;
-
-                case RRDR_GROUPING_PERCENTILE:
-                case RRDR_GROUPING_TRIMMED_MEAN:
-                case RRDR_GROUPING_TRIMMED_MEDIAN:
-                    snprintfz(group_options_buf, sizeof(group_options_buf),
-                              NETDATA_DOUBLE_FORMAT_AUTO,
-                              rc->config.time_group_value);
-                    break;
-
-                case RRDR_GROUPING_COUNTIF:
-                    snprintfz(group_options_buf, sizeof(group_options_buf),
-                              "%s" NETDATA_DOUBLE_FORMAT_AUTO,
-                              alerts_group_conditions_id2txt(rc->config.time_group_condition),
-                              rc->config.time_group_value);
-                    break;
-            }
-
-            int ret = rrdset2value_api_v1(rc->rrdset, NULL, &rc->value, rrdcalc_dimensions(rc), 1,
+                ret = rrdset2value_api_v1(rc->rrdset, NULL, &rc->value, rrdcalc_dimensions(rc), 1,
                                           rc->config.after, rc->config.before, rc->config.time_group, group_options,
                                           0, rc->config.options | RRDR_OPTION_SELECTED_TIER,
                                           &rc->db_after,&rc->db_before,
                                           NULL, NULL, NULL,
                                           &value_is_null, NULL, 0, 0,
                                           QUERY_SOURCE_HEALTH, STORAGE_PRIORITY_SYNCHRONOUS);
+            }
 
             if (unlikely(ret != 200)) {
                 // database lookup failed
@@ -420,6 +395,59 @@ static void health_event_loop_for_host(RRDHOST *host, bool apply_hibernation_del
     }
     foreach_rrdcalc_in_rrdhost_done(rc);
 
+    return runnable;
+}
+
+// process the alert transitions, the health log and the notifications of the host
+// runs on the health thread, host by host, in the order the hosts have been prepared
+static void health_event_loop_host_transitions(RRDHOST *host, size_t runnable, time_t now, time_t *next_run) {
+    RRDCALC *rc;
+    foreach_rrdcalc_in_rrdhost_read(host, rc) {
+        if(unlikely(!service_running(SERVICE_HEALTH) || !rrdhost_should_run_health(host)))
+            break;
+
+        if (rc->run_flags & RRDCALC_FLAG_DISABLED)
+            continue;
+
+        // create an alert removed event if the chart is obsolete and
+        // has stopped being collected for 60 seconds
+        if (unlikely(rc->rrdset && rc->status != RRDCALC_STATUS_REMOVED &&
+                     rrdset_flag_check(rc->rrdset, RRDSET_FLAG_OBSOLETE) &&
+                     now > (rc->rrdset->last_collected_time.tv_sec + 60))) {
+
+            if (!rrdcalc_isrepeating(rc)) {
+                worker_is_busy(WORKER_HEALTH_JOB_ALARM_LOG_ENTRY);
+                time_t now_tmp = now_realtime_sec();
+
+                ALARM_ENTRY *ae =
+                    health_create_alarm_entry(
+                        host,
+                        rc,
+                        now_tmp,
+                        now_tmp - rc->last_status_change,
+                        rc->value,
+                        NAN,
+                        rc->status,
+                        RRDCALC_STATUS_REMOVED,
+                        0,
+                        rrdcalc_isrepeating(rc)?HEALTH_ENTRY_FLAG_IS_REPEATING:0);
+
+                if (ae) {
+                    health_log_alert(host, ae);
+                    health_alarm_log_add_entry(host, ae, false);
+                    rc->old_status = rc->status;
+                    rc->status = RRDCALC_STATUS_REMOVED;
+                    rc->last_status_change = now_tmp;
+                    rc->last_status_change_value = rc->value;
+                    rc->last_updated = now_tmp;
+                    rc->value = NAN;
+                    rc->run_flags &= ~RRDCALC_FLAG_RUNNABLE;
+                }
+            }
+        }
+    }
+    foreach_rrdcalc_in_rrdhost_done(rc);
+
     struct health_raised_summary *hrm = alerts_raised_summary_create(host);
 
     if (unlikely(runnable && service_running(SERVICE_HEALTH))) {
@@ -647,6 +675,160 @@ static void health_event_loop_for_host(RRDHOST *host, bool apply_hibernation_del
     worker_is_idle();
 }
 
+// ----------------------------------------------------------------------------
+// health workers
+//
+// The database lookups and the calculations of the alerts are distributed to
+// a pool of workers, each one evaluating whole hosts. Everything that has to
+// stay ordered (alert transitions, the health log, notifications and the ACLK
+// alert queues) runs afterwards on the health thread, host by host, in the
+// order the hosts have been prepared.
+//
+// The workers are started the first time there is more than one host to
+// evaluate, so standalone agents run everything on the health thread.
+
+struct health_pass_host {
+    RRDHOST_ACQUIRED *rha;
+    RRDHOST *host;
+    size_t runnable;
+    time_t next_run;
+};
+
+static struct {
+    size_t threads;                     // the number of threads evaluating hosts, including the health thread
+
+    size_t started;                     // the number of worker threads running
+    ND_THREAD **th;
+
+    struct completion pass_started;     // every job is a new pass
+    struct completion pass_finished;    // every job is a worker finishing a pass
+    unsigned pass_finished_jobs;
+
+    // the current pass
+    struct health_pass_host *hosts;
+    size_t used;
+    size_t size;
+    size_t next;                        // the next host to be claimed by a thread
+    time_t now;
+} health_workers = { 0 };
+
+static void health_worker_register(void) {
+    worker_register("HEALTH");
+    worker_register_job_name(WORKER_HEALTH_JOB_RRD_LOCK, "rrd lock");
+    worker_register_job_name(WORKER_HEALTH_JOB_HOST_LOCK, "host lock");
+    worker_register_job_name(WORKER_HEALTH_JOB_DB_QUERY, "db lookup");
+    worker_register_job_name(WORKER_HEALTH_JOB_CALC_EVAL, "calc eval");
+    worker_register_job_name(WORKER_HEALTH_JOB_WARNING_EVAL, "warning eval");
+    worker_register_job_name(WORKER_HEALTH_JOB_CRITICAL_EVAL, "critical eval");
+    worker_register_job_name(WORKER_HEALTH_JOB_ALARM_LOG_ENTRY, "alert log entry");
+    worker_register_job_name(WORKER_HEALTH_JOB_ALARM_LOG_PROCESS, "alert log process");
+    worker_register_job_name(WORKER_HEALTH_JOB_ALARM_LOG_QUEUE, "alert log queue");
+    worker_register_job_name(WORKER_HEALTH_JOB_WAIT_EXEC, "alert wait exec");
+    worker_register_job_name(WORKER_HEALTH_JOB_DELAYED_INIT_RRDSET, "rrdset init");
+    worker_register_job_name(WORKER_HEALTH_JOB_DELAYED_INIT_RRDDIM, "rrddim init");
+}
+
+static void health_workers_run_pass(void) {
+    size_t idx;
+    while((idx = __atomic_fetch_add(&health_workers.next, 1, __ATOMIC_RELAXED)) < health_workers.used) {
+        struct health_pass_host *ph = &health_workers.hosts[idx];
+        ph->runnable = health_event_loop_host_lookups(ph->host, health_workers.now, &ph->next_run);
+    }
+    worker_is_idle();
+}
+
+static void *health_worker_thread(void *ptr __maybe_unused) {
+    health_worker_register();
+
+    unsigned job_id = 0;
+    while(service_running(SERVICE_HEALTH)) {
+        worker_is_idle();
+        unsigned new_job_id = completion_wait_for_a_job_with_timeout(&health_workers.pass_started, job_id, 1000);
+        if(new_job_id == job_id)
+            continue;
+
+        job_id = new_job_id;
+        health_workers_run_pass();
+        completion_mark_complete_a_job(&health_workers.pass_finished);
+    }
+
+    worker_unregister();
+    return NULL;
+}
+
+static void health_workers_start(void) {
+    if(health_workers.started || health_workers.threads < 2)
+        return;
+
+    health_workers.th = callocz(health_workers.threads - 1, sizeof(ND_THREAD *));
+
+    for(size_t t = 0; t < health_workers.threads - 1; t++) {
+        char tag[NETDATA_THREAD_TAG_MAX + 1];
+        snprintfz(tag, sizeof(tag), "HEALTH[%zu]", t + 1);
+        health_workers.th[health_workers.started] =
+            nd_thread_create(tag, NETDATA_THREAD_OPTION_JOINABLE, health_worker_thread, NULL);
+
+        if(health_workers.th[health_workers.started])
+            health_workers.started++;
+    }
+}
+
+// on exit, wake up all the workers, for good, and wait for them to finish
+static void health_workers_join(void) {
+    completion_mark_complete(&health_workers.pass_started);
+
+    for(size_t t = 0; t < health_workers.started; t++)
+        nd_thread_join(health_workers.th[t]);
+
+    freez(health_workers.th);
+    health_workers.th = NULL;
+    health_workers.started = 0;
+}
+
+static void health_workers_stop(void) {
+    health_workers_join();
+
+    for(size_t i = 0; i < health_workers.used; i++)
+        rrdhost_acquired_release(health_workers.hosts[i].rha);
+
+    freez(health_workers.hosts);
+    health_workers.hosts = NULL;
+    health_workers.used = health_workers.size = 0;
+
+    completion_destroy(&health_workers.pass_started);
+    completion_destroy(&health_workers.pass_finished);
+}
+
+// run the lookups of all the hosts of the pass, using all the workers
+static void health_workers_lookups(time_t now) {
+    health_workers.now = now;
+    __atomic_store_n(&health_workers.next, 0, __ATOMIC_RELAXED);
+
+    if(health_workers.used > 1)
+        health_workers_start();
+
+    size_t started = (health_workers.used > 1) ? health_workers.started : 0;
+    if(started)
+        completion_mark_complete_a_job(&health_workers.pass_started);
+
+    // the health thread evaluates hosts too
+    health_workers_run_pass();
+
+    if(started) {
+        unsigned target = health_workers.pass_finished_jobs + started;
+        while(health_workers.pass_finished_jobs < target && service_running(SERVICE_HEALTH))
+            health_workers.pass_finished_jobs = completion_wait_for_a_job_with_timeout(
+                &health_workers.pass_finished, health_workers.pass_finished_jobs, 1000);
+
+        // on exit, workers may still be looking up hosts of this pass,
+        // so they have to finish before the hosts are released
+        if(health_workers.pass_finished_jobs < target)
+            health_workers_join();
+
+        health_workers.pass_finished_jobs = target;
+    }
+}
+
 __thread bool is_health_thread = false;
 static void health_event_loop(void) {
 
@@ -684,15 +866,48 @@ static void health_event_loop(void) {
         worker_is_busy(WORKER_HEALTH_JOB_RRD_LOCK);
         uint64_t loop = __atomic_add_fetch(&health_evloop_iteration, 1, __ATOMIC_RELAXED);
 
+        // prepare the hosts, in order
         RRDHOST *host;
         dfe_start_reentrant(rrdhost_root_index, host) {
             if(unlikely(!service_running(SERVICE_HEALTH)))
                 break;
 
-            health_event_loop_for_host(host, apply_hibernation_delay, now, &next_run);
+            if(!health_event_loop_host_prepare(host, apply_hibernation_delay, now))
+                continue;
+
+            if(health_workers.used == health_workers.size) {
+                health_workers.size = health_workers.size ? health_workers.size * 2 : 16;
+                health_workers.hosts = reallocz(health_workers.hosts, health_workers.size * sizeof(*health_workers.hosts));
+            }
+
+            health_workers.hosts[health_workers.used++] = (struct health_pass_host) {
+                .rha = (RRDHOST_ACQUIRED *)dictionary_acquired_item_dup(rrdhost_root_index, host_dfe.item),
+                .host = host,
+                .runnable = 0,
+                .next_run = next_run,
+            };
         }
         dfe_done(host);
 
+        // lookup the values of the alerts, in parallel
+        if(likely(service_running(SERVICE_HEALTH)))
+            health_workers_lookups(now);
+
+        // process the transitions of the alerts, in order
+        for(size_t i = 0; i < health_workers.used; i++) {
+            struct health_pass_host *ph = &health_workers.hosts[i];
+
+            if(likely(service_running(SERVICE_HEALTH))) {
+                health_event_loop_host_transitions(ph->host, ph->runnable, now, &ph->next_run);
+
+                if(ph->next_run < next_run)
+                    next_run = ph->next_run;
+            }
+
+            rrdhost_acquired_release(ph->rha);
+        }
+        health_workers.used = 0;
+
         if(unlikely(!service_running(SERVICE_HEALTH)))
             break;
 
@@ -712,25 +927,20 @@ static void health_main_cleanup(void *pptr) {
 
     worker_unregister();
     static_thread->enabled = NETDATA_MAIN_THREAD_EXITING;
+
+    health_workers_stop();
+
     static_thread->enabled = NETDATA_MAIN_THREAD_EXITED;
 
     nd_log(NDLS_DAEMON, NDLP_DEBUG, "Health thread ended.");
 }
 
 void *health_main(void *ptr) {
-    worker_register("HEALTH");
-    worker_register_job_name(WORKER_HEALTH_JOB_RRD_LOCK, "rrd lock");
-    worker_register_job_name(WORKER_HEALTH_JOB_HOST_LOCK, "host lock");
-    worker_register_job_name(WORKER_HEALTH_JOB_DB_QUERY, "db lookup");
-    worker_register_job_name(WORKER_HEALTH_JOB_CALC_EVAL, "calc eval");
-    worker_register_job_name(WORKER_HEALTH_JOB_WARNING_EVAL, "warning eval");
-    worker_register_job_name(WORKER_HEALTH_JOB_CRITICAL_EVAL, "critical eval");
-    worker_register_job_name(WORKER_HEALTH_JOB_ALARM_LOG_ENTRY, "alert log entry");
-    worker_register_job_name(WORKER_HEALTH_JOB_ALARM_LOG_PROCESS, "alert log process");
-    worker_register_job_name(WORKER_HEALTH_JOB_ALARM_LOG_QUEUE, "alert log queue");
-    worker_register_job_name(WORKER_HEALTH_JOB_WAIT_EXEC, "alert wait exec");
-    worker_register_job_name(WORKER_HEALTH_JOB_DELAYED_INIT_RRDSET, "rrdset init");
-    worker_register_job_name(WORKER_HEALTH_JOB_DELAYED_INIT_RRDDIM, "rrddim init");
+    health_worker_register();
+
+    health_workers.threads = health_globals.config.threads;
+    completion_init(&health_workers.pass_started);
+    completion_init(&health_workers.pass_finished);
 
     CLEANUP_FUNCTION_REGISTER(health_main_cleanup) cleanup_ptr = ptr;
     health_event_loop();
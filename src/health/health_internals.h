@@ -11,6 +11,8 @@
 
 #define HEALTH_LOG_RETENTION_DEFAULT (5 * 86400)
 
+#define HEALTH_THREADS_MAX 16U
+
 #define HEALTH_CONF_MAX_LINE 4096
 
 #define HEALTH_ALARM_KEY "alarm"
@@ -86,6 +88,9 @@ struct health_plugin_globals {
         uint32_t default_warn_repeat_every;     // the default value for the interval between repeating warning notifications
         uint32_t default_crit_repeat_every;     // the default value for the interval between repeating critical notifications
 
+        bool incremental_lookups;
+        size_t threads;                         // the threads evaluating the alerts of different hosts in parallel
+
         int32_t run_at_least_every_seconds;
         int32_t postpone_alarms_during_hibernation_for_seconds;
     } config;
@@ -122,6 +127,9 @@ void alerts_raised_summary_free(struct health_raised_summary *hrm);
 void health_send_notification(RRDHOST *host, ALARM_ENTRY *ae, struct health_raised_summary *hrm);
 void health_alarm_log_process_to_send_notifications(RRDHOST *host, struct health_raised_summary *hrm);
 
+bool health_lookup_incremental(RRDCALC *rc, int *value_is_null);
+void health_lookup_free(RRDCALC *rc);
+
 void health_apply_prototype_to_host(RRDHOST *host, RRD_ALERT_PROTOTYPE *ap);
 void health_prototype_apply_to_all_hosts(RRD_ALERT_PROTOTYPE *ap);
 
@@ -0,0 +1,493 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "health_internals.h"
+
+// ----------------------------------------------------------------------------
+// incremental database lookups
+//
+// Unaligned lookups that end at the latest collected point slide their window
+// by a few points on every evaluation. Instead of running a full query every
+// time, we keep a ring with the points of the window for each dimension,
+// together with rolling aggregates, and on every evaluation we read from the
+// storage engine only the points collected since the previous one.
+//
+// The window is read in full again when the alert, the chart or its dimensions
+// change, when the alert did not run for longer than its window, and every time
+// the window has been fully replaced, to refresh the rolling sums and pick up
+// points that have been back-filled by replication.
+//
+// The result is the same as the one of rrdset2value_api_v1() on tier 0.
+
+// the maximum number of points (window points x dimensions) we keep for an alert
+#define HEALTH_LOOKUP_MAX_POINTS (64 * 1024)
+
+#define HEALTH_LOOKUP_OPTIONS (RRDR_OPTION_NOT_ALIGNED | RRDR_OPTION_ABSOLUTE | RRDR_OPTION_PERCENTAGE |    \
+                               RRDR_OPTION_MATCH_IDS | RRDR_OPTION_MATCH_NAMES | RRDR_OPTION_NULL2ZERO |    \
+                               RRDR_OPTIONS_DIMS_AGGREGATION)
+
+struct health_lookup_dimension {
+    STRING *id;                     // the id of the dimension - strings are unique, so we compare pointers
+    bool selected;                  // false when the dimension is needed only for the total of percentages
+
+    NETDATA_DOUBLE *values;         // one value per slot of the window, NAN for gaps
+    NETDATA_DOUBLE sum;             // the sum of the values in the window
+    uint32_t count;                 // the number of values in the window
+    NETDATA_DOUBLE min;             // the value with the smallest absolute value in the window
+    NETDATA_DOUBLE max;             // the value with the biggest absolute value in the window
+    bool min_max_dirty;             // min or max left the window, they have to be found again
+
+    bool has_value;                 // the result of the time grouping for this evaluation
+    NETDATA_DOUBLE value;
+};
+
+struct health_lookup {
+    // the settings the window has been built for
+    RRDSET *st;
+    STRING *dimensions;
+    RRDR_OPTIONS options;
+    RRDR_TIME_GROUPING time_group;
+    int after;
+    time_t update_every;
+
+    SIMPLE_PATTERN *pattern;        // the dimensions pattern of the alert
+    bool match_ids;
+    bool match_names;
+
+    size_t slots;                   // the number of points in the window
+    time_t last_slot;               // the slot (end time / update every) of the newest point in the window
+    size_t slots_since_rebuild;     // the slots the window slided since it was last read in full
+
+    size_t used;
+    struct health_lookup_dimension *dims;
+    NETDATA_DOUBLE *values;         // the rings of all dimensions, in one allocation
+};
+
+static bool health_lookup_is_incremental(RRDCALC *rc) {
+    if(!health_globals.config.incremental_lookups)
+        return false;
+
+    // aligned windows jump from one duration boundary to the next, they do not slide
+    if(!(rc->config.options & RRDR_OPTION_NOT_ALIGNED) || (rc->config.options & ~HEALTH_LOOKUP_OPTIONS))
+        return false;
+
+    // the window has to end at the latest collected point
+    if(rc->config.before != 0 || !rc->config.after || ABS(rc->config.after) > API_RELATIVE_TIME_MAX)
+        return false;
+
+    switch(rc->config.time_group) {
+        case RRDR_GROUPING_AVERAGE:
+        case RRDR_GROUPING_SUM:
+        case RRDR_GROUPING_MIN:
+        case RRDR_GROUPING_MAX:
+        case RRDR_GROUPING_INCREMENTAL_SUM:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+static void health_lookup_cleanup(struct health_lookup *hl) {
+    for(size_t d = 0; d < hl->used; d++)
+        string_freez(hl->dims[d].id);
+
+    freez(hl->dims);
+    freez(hl->values);
+    simple_pattern_free(hl->pattern);
+    string_freez(hl->dimensions);
+
+    memset(hl, 0, sizeof(*hl));
+}
+
+void health_lookup_free(RRDCALC *rc) {
+    if(!rc->lookup)
+        return;
+
+    health_lookup_cleanup(rc->lookup);
+    freez(rc->lookup);
+    rc->lookup = NULL;
+}
+
+static bool health_lookup_dimension_is_needed(struct health_lookup *hl, RRDDIM *rd, bool *selected) {
+    // select the dimensions the same way the query target does
+
+    if(hl->pattern) {
+        SIMPLE_PATTERN_RESULT ret = SP_NOT_MATCHED;
+
+        if(hl->match_ids)
+            ret = simple_pattern_matches_string_extract(hl->pattern, rd->id, NULL, 0);
+
+        if(ret == SP_NOT_MATCHED && hl->match_names && (rd->name != rd->id || !hl->match_ids))
+            ret = simple_pattern_matches_string_extract(hl->pattern, rd->name, NULL, 0);
+
+        *selected = (ret == SP_MATCHED_POSITIVE);
+    }
+    else
+        *selected = !rrddim_option_check(rd, RRDDIM_OPTION_HIDDEN);
+
+    // percentages need all the dimensions for the total
+    return *selected || (hl->options & RRDR_OPTION_PERCENTAGE);
+}
+
+// check that the chart still has the dimensions of the window and find its latest point
+static bool health_lookup_dimensions_match(struct health_lookup *hl, RRDSET *st, time_t *before) {
+    bool match = true;
+    size_t d = 0;
+
+    RRDDIM *rd;
+    rrddim_foreach_read(rd, st) {
+        bool selected;
+        if(!health_lookup_dimension_is_needed(hl, rd, &selected))
+            continue;
+
+        if(d >= hl->used || hl->dims[d].id != rd->id || hl->dims[d].selected != selected) {
+            match = false;
+            break;
+        }
+        d++;
+
+        time_t t = rrddim_last_entry_s_of_tier(rd, 0);
+        if(t > *before)
+            *before = t;
+    }
+    rrddim_foreach_done(rd);
+
+    return match && d == hl->used;
+}
+
+static void health_lookup_clear_window(struct health_lookup *hl) {
+    for(size_t i = 0; i < hl->used * hl->slots; i++)
+        hl->values[i] = NAN;
+
+    for(size_t d = 0; d < hl->used; d++) {
+        struct health_lookup_dimension *hd = &hl->dims[d];
+        hd->sum = 0.0;
+        hd->count = 0;
+        hd->min = hd->max = NAN;
+        hd->min_max_dirty = false;
+    }
+
+    hl->slots_since_rebuild = 0;
+}
+
+// set up the window for the current settings of the alert
+static bool health_lookup_rebuild(struct health_lookup *hl, RRDCALC *rc, RRDSET *st, time_t update_every, size_t slots, time_t *before) {
+    health_lookup_cleanup(hl);
+
+    hl->st = st;
+    hl->dimensions = string_dup(rc->config.dimensions);
+    hl->options = rc->config.options;
+    hl->time_group = rc->config.time_group;
+    hl->after = rc->config.after;
+    hl->update_every = update_every;
+    hl->slots = slots;
+
+    hl->pattern = string_to_simple_pattern(rrdcalc_dimensions(rc));
+    hl->match_ids = hl->options & RRDR_OPTION_MATCH_IDS;
+    hl->match_names = hl->options & RRDR_OPTION_MATCH_NAMES;
+    if(!hl->match_ids && !hl->match_names)
+        hl->match_ids = hl->match_names = true;
+
+    size_t size = 0, selected_dims = 0;
+
+    RRDDIM *rd;
+    rrddim_foreach_read(rd, st) {
+        bool selected;
+        if(!health_lookup_dimension_is_needed(hl, rd, &selected))
+            continue;
+
+        if(hl->used == size) {
+            size = size ? size * 2 : 4;
+            hl->dims = reallocz(hl->dims, size * sizeof(*hl->dims));
+        }
+
+        struct health_lookup_dimension *hd = &hl->dims[hl->used++];
+        memset(hd, 0, sizeof(*hd));
+        hd->id = string_dup(rd->id);
+        hd->selected = selected;
+
+        if(selected)
+            selected_dims++;
+
+        time_t t = rrddim_last_entry_s_of_tier(rd, 0);
+        if(t > *before)
+            *before = t;
+    }
+    rrddim_foreach_done(rd);
+
+    if(!selected_dims || hl->used * slots > HEALTH_LOOKUP_MAX_POINTS)
+        return false;
+
+    hl->values = mallocz(hl->used * slots * sizeof(*hl->values));
+    for(size_t d = 0; d < hl->used; d++)
+        hl->dims[d].values = &hl->values[d * slots];
+
+    health_lookup_clear_window(hl);
+    return true;
+}
+
+static inline void health_lookup_slot_set(struct health_lookup *hl, struct health_lookup_dimension *hd, time_t slot, NETDATA_DOUBLE value) {
+    NETDATA_DOUBLE *v = &hd->values[(size_t)slot % hl->slots];
+
+    if(!isnan(*v)) {
+        // evict the old value
+        hd->sum -= *v;
+        hd->count--;
+
+        if(*v == hd->min || *v == hd->max)
+            hd->min_max_dirty = true;
+    }
+
+    *v = value;
+
+    if(!isnan(value)) {
+        hd->sum += value;
+        hd->count++;
+
+        if(!hd->min_max_dirty) {
+            if(hd->count == 1 || fabsndd(value) < fabsndd(hd->min))
+                hd->min = value;
+
+            if(hd->count == 1 || fabsndd(value) > fabsndd(hd->max))
+                hd->max = value;
+        }
+    }
+}
+
+// slide the window of a dimension up to before_slot, reading only the new points
+static size_t health_lookup_dimension_feed(struct health_lookup *hl, struct health_lookup_dimension *hd, RRDDIM *rd, time_t before_slot) {
+    for(time_t slot = hl->last_slot + 1; slot <= before_slot; slot++)
+        health_lookup_slot_set(hl, hd, slot, NAN);
+
+    bool absolute = hl->options & RRDR_OPTION_ABSOLUTE;
+    size_t points_read = 0;
+
+    struct storage_engine_query_handle seqh;
+    STORAGE_POINTS_BATCH batch;
+    for(storage_engine_query_init(rd->tiers[0].seb, rd->tiers[0].smh, &seqh,
+                                  hl->last_slot * hl->update_every + 1, (before_slot + 1) * hl->update_every - 1,
+                                  STORAGE_PRIORITY_SYNCHRONOUS);
+         !storage_engine_query_is_finished(&seqh) ;) {
+        size_t points = storage_engine_query_next_metric_batch(&seqh, &batch);
+        points_read += points;
+
+        for(size_t i = 0; i < points; i++) {
+            time_t slot = batch.end_time_s[i] / hl->update_every;
+            if(slot <= hl->last_slot || slot > before_slot)
+                continue;
+
+            if(!batch.count[i] || !netdata_double_isnumber(batch.sum[i]))
+                // not collected
+                continue;
+
+            NETDATA_DOUBLE value = batch.sum[i] / (NETDATA_DOUBLE)batch.count[i];
+            if(absolute)
+                value = fabsndd(value);
+
+            health_lookup_slot_set(hl, hd, slot, value);
+        }
+    }
+    storage_engine_query_finalize(&seqh);
+
+    return points_read;
+}
+
+// find the oldest or the newest value in the window of a dimension
+static NETDATA_DOUBLE health_lookup_dimension_edge(struct health_lookup *hl, struct health_lookup_dimension *hd, bool newest) {
+    for(size_t i = 0; i < hl->slots; i++) {
+        time_t slot = newest ? hl->last_slot - (time_t)i : hl->last_slot - (time_t)hl->slots + 1 + (time_t)i;
+        NETDATA_DOUBLE v = hd->values[(size_t)slot % hl->slots];
+        if(!isnan(v))
+            return v;
+    }
+
+    return NAN;
+}
+
+// apply the time grouping of the alert to the window of a dimension
+static bool health_lookup_dimension_value(struct health_lookup *hl, struct health_lookup_dimension *hd, NETDATA_DOUBLE *value) {
+    if(!hd->count)
+        return false;
+
+    if(hd->min_max_dirty && (hl->time_group == RRDR_GROUPING_MIN || hl->time_group == RRDR_GROUPING_MAX)) {
+        size_t found = 0;
+        for(size_t i = 0; i < hl->slots; i++) {
+            NETDATA_DOUBLE v = hd->values[i];
+            if(isnan(v))
+                continue;
+
+            if(!found++)
+                hd->min = hd->max = v;
+            else {
+                if(fabsndd(v) < fabsndd(hd->min)) hd->min = v;
+                if(fabsndd(v) > fabsndd(hd->max)) hd->max = v;
+            }
+        }
+        hd->min_max_dirty = false;
+    }
+
+    switch(hl->time_group) {
+        default:
+        case RRDR_GROUPING_AVERAGE:
+            *value = hd->sum / (NETDATA_DOUBLE)hd->count;
+            break;
+
+        case RRDR_GROUPING_SUM:
+            *value = hd->sum;
+            break;
+
+        case RRDR_GROUPING_MIN:
+            *value = hd->min;
+            break;
+
+        case RRDR_GROUPING_MAX:
+            *value = hd->max;
+            break;
+
+        case RRDR_GROUPING_INCREMENTAL_SUM:
+            if(hd->count < 2)
+                return false;
+
+            *value = health_lookup_dimension_edge(hl, hd, true) - health_lookup_dimension_edge(hl, hd, false);
+            break;
+    }
+
+    return true;
+}
+
+// combine the dimensions the way rrdr2value() does
+static NETDATA_DOUBLE health_lookup_value(struct health_lookup *hl, int *value_is_null) {
+    bool percentage = hl->options & RRDR_OPTION_PERCENTAGE;
+    NETDATA_DOUBLE total = 0.0;
+
+    for(size_t d = 0; d < hl->used; d++) {
+        struct health_lookup_dimension *hd = &hl->dims[d];
+        hd->has_value = health_lookup_dimension_value(hl, hd, &hd->value);
+        if(hd->has_value)
+            total += hd->value;
+    }
+
+    if(total == 0.0)
+        total = 1.0;
+
+    NETDATA_DOUBLE sum = 0, min = NAN, max = NAN, v;
+    size_t dims = 0;
+
+    for(size_t d = 0; d < hl->used; d++) {
+        struct health_lookup_dimension *hd = &hl->dims[d];
+        if(!hd->selected || !hd->has_value)
+            continue;
+
+        NETDATA_DOUBLE n = percentage ? hd->value * 100.0 / total : hd->value;
+
+        if(!dims)
+            min = max = n;
+
+        sum += n;
+        if(n < min) min = n;
+        if(n > max) max = n;
+
+        dims++;
+    }
+
+    if(!dims) {
+        *value_is_null = 1;
+        return (hl->options & RRDR_OPTION_NULL2ZERO) ? 0 : NAN;
+    }
+
+    *value_is_null = 0;
+
+    if(hl->options & RRDR_OPTION_DIMS_MIN2MAX)
+        v = max - min;
+    else if(hl->options & RRDR_OPTION_DIMS_AVERAGE)
+        v = sum / (NETDATA_DOUBLE)dims;
+    else if(hl->options & RRDR_OPTION_DIMS_MIN)
+        v = min;
+    else if(hl->options & RRDR_OPTION_DIMS_MAX)
+        v = max;
+    else
+        v = sum;
+
+    if((hl->options & RRDR_OPTION_NULL2ZERO) && (isnan(v) || isinf(v)))
+        v = 0;
+
+    return v;
+}
+
+// evaluate the database lookup of the alert incrementally
+// returns false when the lookup cannot be evaluated incrementally (the caller has to run the query)
+bool health_lookup_incremental(RRDCALC *rc, int *value_is_null) {
+    RRDSET *st = rc->rrdset;
+
+    if(!st || !health_lookup_is_incremental(rc)) {
+        health_lookup_free(rc);
+        return false;
+    }
+
+    time_t update_every = st->update_every;
+    if(update_every <= 0)
+        return false;
+
+    size_t slots = (size_t)ABS(rc->config.after) / (size_t)update_every;
+    if(!slots)
+        slots = 1;
+
+    if(!rc->lookup)
+        rc->lookup = callocz(1, sizeof(*rc->lookup));
+
+    struct health_lookup *hl = rc->lookup;
+    time_t before = 0;
+
+    if(hl->st != st || hl->update_every != update_every || hl->slots != slots ||
+        hl->after != rc->config.after || hl->options != rc->config.options ||
+        hl->time_group != rc->config.time_group || hl->dimensions != rc->config.dimensions ||
+        !health_lookup_dimensions_match(hl, st, &before)) {
+
+        before = 0;
+        if(!health_lookup_rebuild(hl, rc, st, update_every, slots, &before)) {
+            health_lookup_free(rc);
+            return false;
+        }
+
+        hl->last_slot = 0;
+    }
+
+    if(!before) {
+        // no data yet, let the query report it
+        hl->st = NULL;
+        return false;
+    }
+
+    time_t before_slot = before / update_every;
+
+    if(before_slot < hl->last_slot || before_slot - hl->last_slot >= (time_t)slots ||
+        hl->slots_since_rebuild >= slots) {
+        // read the whole window again
+        health_lookup_clear_window(hl);
+        hl->last_slot = before_slot - (time_t)slots;
+    }
+
+    if(before_slot > hl->last_slot) {
+        size_t points_read = 0, d = 0;
+
+        RRDDIM *rd;
+        rrddim_foreach_read(rd, st) {
+            if(d < hl->used && hl->dims[d].id == rd->id) {
+                points_read += health_lookup_dimension_feed(hl, &hl->dims[d], rd, before_slot);
+                d++;
+            }
+        }
+        rrddim_foreach_done(rd);
+
+        hl->slots_since_rebuild += (size_t)(before_slot - hl->last_slot);
+        hl->last_slot = before_slot;
+
+        pulse_queries_rrdr_query_completed(1, points_read, 1, QUERY_SOURCE_HEALTH);
+    }
+
+    rc->value = health_lookup_value(hl, value_is_null);
+    rc->db_after = before - (time_t)(slots - 1) * update_every;
+    rc->db_before = before;
+
+    return true;
+}
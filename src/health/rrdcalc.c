@@ -375,6 +375,7 @@ static void rrdcalc_rrdhost_delete_callback(const DICTIONARY_ITEM *item __maybe_
     // have to be placed in rrdcalc_del(), because the object is actually locked for deletion
 
     rrd_alert_config_cleanup(&rc->config);
+    health_lookup_free(rc);
 
     string_freez(rc->key);
     string_freez(rc->chart);
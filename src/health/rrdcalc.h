@@ -86,6 +86,8 @@ struct rrdcalc {
     size_t labels_version;
     struct rrdset *rrdset;
 
+    struct health_lookup *lookup;   // the window of incremental database lookups
+
     struct rrdcalc *next;
     struct rrdcalc *prev;
 };
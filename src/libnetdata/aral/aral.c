@@ -6,9 +6,11 @@
 #ifdef NETDATA_TRACE_ALLOCATIONS
 #define TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS , const char *file, const char *function, size_t line
 #define TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS , file, function, line
+#define TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS_FOR_THREAD_EXIT , __FILE__, __FUNCTION__, __LINE__
 #else
 #define TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS
 #define TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS
+#define TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS_FOR_THREAD_EXIT
 #endif
 
 // max mapped file size
@@ -137,6 +139,12 @@ struct aral {
 
     struct aral_ops ops[2];
 
+    struct {
+        int32_t slot;                   // the index of the per-thread magazines, -1 when disabled
+        uint32_t generation;            // unique for every ARAL that gets a slot
+        uint32_t size;                  // the max elements of each magazine
+    } magazines;
+
     struct aral_statistics *stats;
 };
 
@@ -714,7 +722,9 @@ static bool aral_page_release(ARAL_PAGE *page) {
     return false;
 }
 
-static ALWAYS_INLINE ARAL_PAGE *aral_get_first_page_with_a_free_slot(ARAL *ar, bool marked TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS) {
+// returns an acquired page, with a free slot reserved for each of the *elements requested
+// *elements is updated to the number of slots actually reserved (at least 1)
+static ALWAYS_INLINE ARAL_PAGE *aral_get_first_page_with_a_free_slot(ARAL *ar, bool marked, size_t *elements TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS) {
     size_t idx = mark_to_idx(marked);
     __atomic_add_fetch(&ar->ops[idx].atomic.allocators, 1, __ATOMIC_RELAXED);
 
@@ -790,10 +800,17 @@ static ALWAYS_INLINE ARAL_PAGE *aral_get_first_page_with_a_free_slot(ARAL *ar, b
                    "ARAL: '%s' failed to find a page with a free element",
                    ar->config.name);
 
+    // acquire the page once for every additional element needed
+    // the page refcount guarantees that there are free slots for all of them
+    size_t reserved = 1;
+    while(reserved < *elements && aral_page_acquire(page))
+        reserved++;
+    *elements = reserved;
+
     aral_page_lock(ar, page);
 
-    internal_fatal(!page->page_lock.free_elements,
-                   "ARAL: '%s' selected page does not have a free slot in it",
+    internal_fatal(page->page_lock.free_elements < reserved,
+                   "ARAL: '%s' selected page does not have enough free slots in it",
                    ar->config.name);
 
     internal_fatal(page->max_elements != page->page_lock.used_elements + page->page_lock.free_elements,
@@ -809,11 +826,11 @@ static ALWAYS_INLINE ARAL_PAGE *aral_get_first_page_with_a_free_slot(ARAL *ar, b
     internal_fatal(page->page_lock.marked_elements > page->page_lock.used_elements,
                    "page has more marked elements than the used ones");
 
-    page->page_lock.used_elements++;
-    page->page_lock.free_elements--;
+    page->page_lock.used_elements += reserved;
+    page->page_lock.free_elements -= reserved;
 
     if(marked)
-        page->page_lock.marked_elements++;
+        page->page_lock.marked_elements += reserved;
 
     if(unlikely(page->page_lock.used_elements == page->max_elements)) {
         aral_lock(ar);
@@ -828,7 +845,7 @@ static ALWAYS_INLINE ARAL_PAGE *aral_get_first_page_with_a_free_slot(ARAL *ar, b
     aral_page_unlock(ar, page);
 
     __atomic_sub_fetch(&ar->ops[idx].atomic.allocators, 1, __ATOMIC_RELAXED);
-    __atomic_add_fetch(&ar->atomic.user_malloc_operations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&ar->atomic.user_malloc_operations, reserved, __ATOMIC_RELAXED);
 
     return page;
 }
@@ -919,6 +936,186 @@ ALWAYS_INLINE void *aral_callocz_internal(ARAL *ar, bool marked TRACE_ALLOCATION
     return r;
 }
 
+static ALWAYS_INLINE void *aral_mallocz_from_pages(ARAL *ar, bool marked TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS) {
+    // reserve a slot on a free page
+    size_t elements = 1;
+    ARAL_PAGE *page = aral_get_first_page_with_a_free_slot(ar, marked, &elements TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
+    // the page returned has reserved a slot for us
+
+    void *data = aral_get_free_slot___no_lock_required(ar, page, marked);
+
+    internal_fatal((uintptr_t)data % SYSTEM_REQUIRED_ALIGNMENT != 0, "Pointer is not aligned properly");
+
+    return data;
+}
+
+static void aral_freez_to_pages(ARAL *ar, void *ptr TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS);
+
+// --------------------------------------------------------------------------------------------------------------------
+// per-thread magazines
+
+#define ARAL_MAGAZINES_MAX 1024
+#define ARAL_MAGAZINE_BYTES (16 * 1024)
+#define ARAL_MAGAZINE_MIN_ELEMENTS 4
+#define ARAL_MAGAZINE_MAX_ELEMENTS 64
+
+typedef struct aral_magazine {
+    uint32_t generation;                // the generation of the ARAL this magazine belongs to
+    uint32_t size;                      // the max number of elements
+    uint32_t entries;                   // the number of elements in the magazine
+    uint32_t hits;                      // allocations served, not yet added to the statistics
+    void *elements[];                   // a LIFO of free elements
+} ARAL_MAGAZINE;
+
+static struct {
+    SPINLOCK spinlock;
+    uint32_t generation;
+
+    struct {
+        ARAL *ar;
+        uint32_t generation;
+    } slots[ARAL_MAGAZINES_MAX];
+} aral_magazines_globals = {
+    .spinlock = SPINLOCK_INITIALIZER,
+};
+
+static __thread ARAL_MAGAZINE **aral_thread_magazines = NULL;
+
+void aral_enable_magazines(ARAL *ar) {
+#if defined(FSANITIZE_ADDRESS)
+    return;
+#endif
+
+    if(!ar || ar->magazines.slot >= 0 || (ar->config.options & ARAL_LOCKLESS))
+        return;
+
+    size_t size = ARAL_MAGAZINE_BYTES / ar->config.element_size;
+    if(size < ARAL_MAGAZINE_MIN_ELEMENTS) size = ARAL_MAGAZINE_MIN_ELEMENTS;
+    if(size > ARAL_MAGAZINE_MAX_ELEMENTS) size = ARAL_MAGAZINE_MAX_ELEMENTS;
+
+    spinlock_lock(&aral_magazines_globals.spinlock);
+
+    for(int32_t slot = 0; slot < ARAL_MAGAZINES_MAX; slot++) {
+        if(aral_magazines_globals.slots[slot].ar)
+            continue;
+
+        aral_magazines_globals.slots[slot].ar = ar;
+        aral_magazines_globals.slots[slot].generation = ++aral_magazines_globals.generation;
+
+        ar->magazines.size = size;
+        ar->magazines.generation = aral_magazines_globals.slots[slot].generation;
+        __atomic_store_n(&ar->magazines.slot, slot, __ATOMIC_RELEASE);
+        break;
+    }
+
+    spinlock_unlock(&aral_magazines_globals.spinlock);
+
+    if(ar->magazines.slot < 0) {
+        nd_log_limit_static_global_var(erl, 60, 0);
+        nd_log_limit(&erl, NDLS_DAEMON, NDLP_WARNING,
+                     "ARAL: '%s' cannot use magazines, all %d magazine slots are used",
+                     ar->config.name, ARAL_MAGAZINES_MAX);
+    }
+}
+
+static void aral_magazines_disable(ARAL *ar) {
+    if(ar->magazines.slot < 0)
+        return;
+
+    // the magazines of other threads become stale - their elements are freed with the pages
+    spinlock_lock(&aral_magazines_globals.spinlock);
+    aral_magazines_globals.slots[ar->magazines.slot].ar = NULL;
+    aral_magazines_globals.slots[ar->magazines.slot].generation = 0;
+    spinlock_unlock(&aral_magazines_globals.spinlock);
+
+    ar->magazines.slot = -1;
+}
+
+static ALWAYS_INLINE ARAL_MAGAZINE *aral_thread_magazine(ARAL *ar, int32_t slot) {
+    if(unlikely(!aral_thread_magazines))
+        aral_thread_magazines = callocz(ARAL_MAGAZINES_MAX, sizeof(ARAL_MAGAZINE *));
+
+    ARAL_MAGAZINE *m = aral_thread_magazines[slot];
+    if(unlikely(!m || m->generation != ar->magazines.generation)) {
+        // a magazine of an ARAL that has been destroyed
+        // its elements have been freed with the pages of that ARAL
+        freez(m);
+
+        m = callocz(1, sizeof(ARAL_MAGAZINE) + ar->magazines.size * sizeof(void *));
+        m->generation = ar->magazines.generation;
+        m->size = ar->magazines.size;
+        aral_thread_magazines[slot] = m;
+    }
+
+    return m;
+}
+
+static ALWAYS_INLINE void aral_magazine_statistics(ARAL *ar, ARAL_MAGAZINE *m) {
+    if(m->hits) {
+        __atomic_add_fetch(&ar->stats->magazines.hits, m->hits, __ATOMIC_RELAXED);
+        m->hits = 0;
+    }
+}
+
+static void *aral_magazine_refill(ARAL *ar, ARAL_MAGAZINE *m TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS) {
+    // one element for the caller, and half of the magazine
+    size_t elements = m->size / 2 + 1;
+    ARAL_PAGE *page = aral_get_first_page_with_a_free_slot(ar, false, &elements TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
+
+    for(size_t i = 1; i < elements; i++)
+        m->elements[m->entries++] = aral_get_free_slot___no_lock_required(ar, page, false);
+
+    void *data = aral_get_free_slot___no_lock_required(ar, page, false);
+
+    internal_fatal((uintptr_t)data % SYSTEM_REQUIRED_ALIGNMENT != 0, "Pointer is not aligned properly");
+
+    __atomic_add_fetch(&ar->stats->magazines.refills, 1, __ATOMIC_RELAXED);
+    aral_magazine_statistics(ar, m);
+
+    return data;
+}
+
+// return the oldest elements of a magazine to the pages
+static void aral_magazine_flush(ARAL *ar, ARAL_MAGAZINE *m, uint32_t elements TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS) {
+    if(elements > m->entries)
+        elements = m->entries;
+
+    for(uint32_t i = 0; i < elements; i++)
+        aral_freez_to_pages(ar, m->elements[i] TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
+
+    m->entries -= elements;
+    memmove(&m->elements[0], &m->elements[elements], m->entries * sizeof(void *));
+
+    __atomic_add_fetch(&ar->stats->magazines.flushes, 1, __ATOMIC_RELAXED);
+    aral_magazine_statistics(ar, m);
+}
+
+void aral_thread_magazines_free(void) {
+    if(!aral_thread_magazines)
+        return;
+
+    spinlock_lock(&aral_magazines_globals.spinlock);
+
+    for(size_t slot = 0; slot < ARAL_MAGAZINES_MAX; slot++) {
+        ARAL_MAGAZINE *m = aral_thread_magazines[slot];
+        if(!m)
+            continue;
+
+        ARAL *ar = aral_magazines_globals.slots[slot].ar;
+        if(ar && aral_magazines_globals.slots[slot].generation == m->generation)
+            aral_magazine_flush(ar, m, m->entries TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS_FOR_THREAD_EXIT);
+
+        freez(m);
+    }
+
+    spinlock_unlock(&aral_magazines_globals.spinlock);
+
+    freez(aral_thread_magazines);
+    aral_thread_magazines = NULL;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
 void *aral_mallocz_internal(ARAL *ar, bool marked TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS) {
 #if defined(FSANITIZE_ADDRESS)
     if(ar->stats) {
@@ -929,15 +1126,18 @@ void *aral_mallocz_internal(ARAL *ar, bool marked TRACE_ALLOCATIONS_FUNCTION_DEF
     return mallocz(ar->config.requested_element_size);
 #endif
 
-    // reserve a slot on a free page
-    ARAL_PAGE *page = aral_get_first_page_with_a_free_slot(ar, marked TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
-    // the page returned has reserved a slot for us
+    int32_t slot = __atomic_load_n(&ar->magazines.slot, __ATOMIC_RELAXED);
+    if(slot >= 0 && !marked) {
+        ARAL_MAGAZINE *m = aral_thread_magazine(ar, slot);
 
-    void *data = aral_get_free_slot___no_lock_required(ar, page, marked);
+        if(unlikely(!m->entries))
+            return aral_magazine_refill(ar, m TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
 
-    internal_fatal((uintptr_t)data % SYSTEM_REQUIRED_ALIGNMENT != 0, "Pointer is not aligned properly");
+        m->hits++;
+        return m->elements[--m->entries];
+    }
 
-    return data;
+    return aral_mallocz_from_pages(ar, marked TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
 }
 
 void aral_unmark_allocation(ARAL *ar, void *ptr) {
@@ -994,6 +1194,26 @@ void aral_freez_internal(ARAL *ar, void *ptr TRACE_ALLOCATIONS_FUNCTION_DEFINITI
 
     if(unlikely(!ptr)) return;
 
+    int32_t slot = __atomic_load_n(&ar->magazines.slot, __ATOMIC_RELAXED);
+    if(slot >= 0) {
+        bool marked;
+        aral_get_page_pointer_after_element___do_NOT_have_aral_lock(ar, ptr, &marked);
+
+        if(!marked) {
+            ARAL_MAGAZINE *m = aral_thread_magazine(ar, slot);
+
+            if(unlikely(m->entries == m->size))
+                aral_magazine_flush(ar, m, m->size / 2 TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
+
+            m->elements[m->entries++] = ptr;
+            return;
+        }
+    }
+
+    aral_freez_to_pages(ar, ptr TRACE_ALLOCATIONS_FUNCTION_CALL_PARAMS);
+}
+
+static void aral_freez_to_pages(ARAL *ar, void *ptr TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS) {
     // get the page pointer
     bool marked;
     ARAL_PAGE *page = aral_get_page_pointer_after_element___do_NOT_have_aral_lock(ar, ptr, &marked);
@@ -1101,6 +1321,8 @@ void aral_freez_internal(ARAL *ar, void *ptr TRACE_ALLOCATIONS_FUNCTION_DEFINITI
 }
 
 void aral_destroy_internal(ARAL *ar TRACE_ALLOCATIONS_FUNCTION_DEFINITION_PARAMS) {
+    aral_magazines_disable(ar);
+
     aral_lock(ar);
 
     ARAL_PAGE **head_ptr = aral_pages_head_free(ar, false);
@@ -1179,6 +1401,7 @@ ARAL *aral_create(const char *name, size_t element_size, size_t initial_page_ele
     ar->config.mmap.filename = filename;
     ar->config.mmap.cache_dir = cache_dir;
     ar->config.mmap.enabled = mmap;
+    ar->magazines.slot = -1;
     strncpyz(ar->config.name, name, ARAL_MAX_NAME);
     spinlock_init(&ar->aral_lock.spinlock);
     spinlock_init(&ar->ops[0].adders.spinlock);
@@ -1508,9 +1731,9 @@ static void *aral_test_thread(void *ptr) {
     return ptr;
 }
 
-int aral_stress_test(size_t threads, size_t elements, size_t seconds) {
-    fprintf(stderr, "Running stress test of %zu threads, with %zu elements each, for %zu seconds...\n",
-            threads, elements, seconds);
+int aral_stress_test(size_t threads, size_t elements, size_t seconds, bool magazines) {
+    fprintf(stderr, "Running stress test of %zu threads, with %zu elements each, for %zu seconds%s...\n",
+            threads, elements, seconds, magazines ? ", using per-thread magazines" : "");
 
     struct aral_unittest_config auc = {
             .single_threaded = false,
@@ -1526,6 +1749,9 @@ int aral_stress_test(size_t threads, size_t elements, size_t seconds) {
             .errors = 0,
     };
 
+    if(magazines)
+        aral_enable_magazines(auc.ar);
+
     usec_t started_ut = now_monotonic_usec();
     ND_THREAD *thread_ptrs[threads];
 
@@ -1541,15 +1767,20 @@ int aral_stress_test(size_t threads, size_t elements, size_t seconds) {
 
     size_t malloc_done = 0;
     size_t free_done = 0;
+    size_t hits_done = 0;
     size_t countdown = seconds;
     while(countdown-- > 0) {
         sleep_usec(1 * USEC_PER_SEC);
         size_t m = __atomic_load_n(&auc.ar->atomic.user_malloc_operations, __ATOMIC_RELAXED);
         size_t f = __atomic_load_n(&auc.ar->atomic.user_free_operations, __ATOMIC_RELAXED);
-        fprintf(stderr, "ARAL executes %0.2f M malloc and %0.2f M free operations/s\n",
-                (double)(m - malloc_done) / 1000000.0, (double)(f - free_done) / 1000000.0);
+        size_t h = __atomic_load_n(&auc.ar->stats->magazines.hits, __ATOMIC_RELAXED);
+        fprintf(stderr, "ARAL executes %0.2f M malloc and %0.2f M free operations/s on its pages, "
+                        "%0.2f M allocations/s are served by the magazines\n",
+                (double)(m - malloc_done) / 1000000.0, (double)(f - free_done) / 1000000.0,
+                (double)(h - hits_done) / 1000000.0);
         malloc_done = m;
         free_done = f;
+        hits_done = h;
     }
 
     __atomic_store_n(&auc.stop, true, __ATOMIC_RELAXED);
@@ -1605,7 +1836,8 @@ int aral_unittest(size_t elements) {
 
     aral_destroy(auc.ar);
 
-    int errors = aral_stress_test(2, elements, 10);
+    int errors = aral_stress_test(2, elements, 10, false);
+    errors += aral_stress_test(2, elements, 10, true);
 
     return auc.errors + errors;
 }
@@ -23,6 +23,12 @@ struct aral_statistics {
 
     struct aral_page_type_stats malloc;
     struct aral_page_type_stats mmap;
+
+    struct {
+        PAD64(size_t) hits;         // allocations served by the per-thread magazines
+        PAD64(size_t) refills;      // batches allocated from the pages to refill a magazine
+        PAD64(size_t) flushes;      // batches returned to the pages from a full magazine
+    } magazines;
 };
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -81,6 +87,21 @@ size_t aral_free_bytes_from_stats(struct aral_statistics *stats);
 size_t aral_used_bytes_from_stats(struct aral_statistics *stats);
 size_t aral_padding_bytes_from_stats(struct aral_statistics *stats);
 
+// --------------------------------------------------------------------------------------------------------------------
+// per-thread magazines
+//
+// Each thread keeps a bounded stack of the elements it frees, and it allocates from it,
+// without any locks. Empty magazines are refilled from the pages, and full magazines
+// return half of their elements to the pages, in batches.
+// Elements in magazines are accounted as used. Marked allocations bypass the magazines.
+// The ARAL must be shared by threads that allocate and free at high rates, and it
+// must not be lockless.
+
+void aral_enable_magazines(ARAL *ar);
+
+// return the elements of the magazines of the calling thread to their ARALs
+void aral_thread_magazines_free(void);
+
 // --------------------------------------------------------------------------------------------------------------------
 
 ARAL *aral_by_size_acquire(size_t size);
@@ -335,9 +335,62 @@ void buffer_json_finalize(BUFFER *wb) {
 
 // ----------------------------------------------------------------------------
 
+char *print_netdata_double_exponential(char *dst, NETDATA_DOUBLE value) {
+    // the number is too big to print using 64bit numbers
+    // so, let's convert it to exponential notation
+    int exponent = (int)(floorndd(log10ndd(value)));
+    value /= powndd(10, exponent);
+
+    // the max precision we can support is 18 digits
+    // (UINT64_MAX is 20, but the first is 1)
+    const uint64_t fractional_precision = 1000000000000000000ULL; // fractional part 18 digits
+    const int fractional_wanted_digits = 18;
+
+    NETDATA_DOUBLE integral_d, fractional_d;
+    fractional_d = modfndd(value, &integral_d);
+
+    uint64_t integral = (uint64_t)integral_d;
+    uint64_t fractional = (uint64_t)llrintndd(fractional_d * (NETDATA_DOUBLE)fractional_precision);
+    if(unlikely(fractional >= fractional_precision)) {
+        integral++;
+        fractional -= fractional_precision;
+    }
+
+    char *d = print_uint64_forward(dst, integral);
+
+    if(likely(fractional != 0)) {
+        *d++ = '.';
+
+        int digits = fractional_wanted_digits;
+        while(fractional % 10 == 0) {
+            fractional /= 10;
+            digits--;
+        }
+
+        d = print_uint64_fixed_digits(d, fractional, digits);
+    }
+
+    if(unlikely(exponent != 0)) {
+        *d++ = 'e';
+        *d++ = '+';
+        d = print_uint64_forward(d, (uint64_t)exponent);
+    }
+
+    *d = '\0';
+    return d;
+}
+
+// ----------------------------------------------------------------------------
+
 const char hex_digits[16] = "0123456789ABCDEF";
 const char hex_digits_lower[16] = "0123456789abcdef";
 const char base64_digits[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const char decimal_digit_pairs[200] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
 unsigned char hex_value_from_ascii[256];
 unsigned char base64_value_from_ascii[256];
 
@@ -13,6 +13,7 @@
 extern const char hex_digits[16];
 extern const char hex_digits_lower[16];
 extern const char base64_digits[64];
+extern const char decimal_digit_pairs[200];
 extern unsigned char hex_value_from_ascii[256];
 extern unsigned char base64_value_from_ascii[256];
 
@@ -469,6 +470,50 @@ static void char_array_reverse(char *from, char *to) {
     while (end > begin) aux = *end, *end-- = *begin, *begin++ = aux;
 }
 
+// the number of decimal digits of value (at least 1)
+ALWAYS_INLINE
+static int print_uint64_digits(uint64_t value) {
+    int digits = 1;
+    for(;;) {
+        if(value < 10ULL) return digits;
+        if(value < 100ULL) return digits + 1;
+        if(value < 1000ULL) return digits + 2;
+        if(value < 10000ULL) return digits + 3;
+        value /= 10000ULL;
+        digits += 4;
+    }
+}
+
+// print exactly `digits` digits of value (zero padded), two digits at a time
+ALWAYS_INLINE
+static char *print_uint64_fixed_digits(char *dst, uint64_t value, int digits) {
+    char *d = dst + digits;
+
+    while(d - dst >= 2) {
+        const char *pair = &decimal_digit_pairs[(value % 100) * 2];
+        value /= 100;
+        *--d = pair[1];
+        *--d = pair[0];
+    }
+
+    if(d > dst)
+        *--d = (char)('0' + (value % 10));
+
+    return dst + digits;
+}
+
+ALWAYS_INLINE
+static char *print_uint64_forward(char *dst, uint64_t value) {
+    return print_uint64_fixed_digits(dst, value, print_uint64_digits(value));
+}
+
+// numbers too big for 64-bit integers are printed in exponential notation
+char *print_netdata_double_exponential(char *dst, NETDATA_DOUBLE value);
+
+#define NETDATA_DOUBLE_FRACTIONAL_DIGITS 7
+#define NETDATA_DOUBLE_FRACTIONAL_PRECISION 10000000ULL
+
+// print a number with up to 7 fractional digits, without trailing zeros
 ALWAYS_INLINE
 static int print_netdata_double(char *dst, NETDATA_DOUBLE value) {
     char *s = dst;
@@ -478,55 +523,36 @@ static int print_netdata_double(char *dst, NETDATA_DOUBLE value) {
         value = fabsndd(value);
     }
 
-    uint64_t fractional_precision = 10000000ULL; // fractional part 7 digits
-    int fractional_wanted_digits = 7;
-    int exponent = 0;
-    if(unlikely(value >= (NETDATA_DOUBLE)(UINT64_MAX / 10))) {
-        // the number is too big to print using 64bit numbers
-        // so, let's convert it to exponential notation
-        exponent = (int)(floorndd(log10ndd(value)));
-        value /= powndd(10, exponent);
-
-        // the max precision we can support is 18 digits
-        // (UINT64_MAX is 20, but the first is 1)
-        fractional_precision = 1000000000000000000ULL; // fractional part 18 digits
-        fractional_wanted_digits = 18;
-    }
+    if(unlikely(value >= (NETDATA_DOUBLE)(UINT64_MAX / 10)))
+        return (int)(print_netdata_double_exponential(s, value) - dst);
 
-    char *d = s;
-    NETDATA_DOUBLE integral_d, fractional_d;
-    fractional_d = modfndd(value, &integral_d);
+    // value is positive and fits in 64 bits, so the cast truncates it like modf() does
+    // and the subtraction is exact
+    uint64_t integral = (uint64_t)value;
+    NETDATA_DOUBLE fractional_d = value - (NETDATA_DOUBLE)integral;
 
-    // get the integral and the fractional parts as 64-bit integers
-    uint64_t integral = (uint64_t)integral_d;
-    uint64_t fractional = (uint64_t)llrintndd(fractional_d * (NETDATA_DOUBLE)fractional_precision);
-    if(unlikely(fractional >= fractional_precision)) {
-        integral++;
-        fractional -= fractional_precision;
+    uint64_t fractional = 0;
+    if(fractional_d != 0) {
+        fractional = (uint64_t)llrintndd(fractional_d * (NETDATA_DOUBLE)NETDATA_DOUBLE_FRACTIONAL_PRECISION);
+        if(unlikely(fractional >= NETDATA_DOUBLE_FRACTIONAL_PRECISION)) {
+            integral++;
+            fractional -= NETDATA_DOUBLE_FRACTIONAL_PRECISION;
+        }
     }
 
-    // convert the integral part to string (reversed)
-    d = print_uint64_reversed(d, integral);
-    char_array_reverse(s, d - 1);      // copy reversed the integral string
-
-    if(likely(fractional != 0)) {
-        *d++ = '.'; // add the dot
-
-        // convert the fractional part to string (reversed)
-        d = print_uint64_reversed(s = d, fractional);
+    char *d = print_uint64_forward(s, integral);
 
-        while(d - s < fractional_wanted_digits) *d++ = '0'; // prepend zeros to reach precision
-        char_array_reverse(s, d - 1);   // copy reversed the fractional string
+    if(fractional) {
+        *d++ = '.';
 
-        // remove trailing zeros from the fractional part
-        while(*(d - 1) == '0') d--;
-    }
+        // drop the trailing zeros before printing
+        int digits = NETDATA_DOUBLE_FRACTIONAL_DIGITS;
+        while(fractional % 10 == 0) {
+            fractional /= 10;
+            digits--;
+        }
 
-    if(unlikely(exponent != 0)) {
-        *d++ = 'e';
-        *d++ = '+';
-        d = print_uint32_reversed(s = d, exponent);
-        char_array_reverse(s, d - 1);
+        d = print_uint64_fixed_digits(d, fractional, digits);
     }
 
     *d = '\0';
@@ -374,7 +374,8 @@ static inline void dict_item_release_and_check_if_it_is_deleted_and_can_be_remov
     }
 }
 
-static inline bool dict_item_del(DICTIONARY *dict, const char *name, ssize_t name_len) {
+// when only_item is given, the item indexed under name is deleted only if it is that item
+static inline bool dict_item_del(DICTIONARY *dict, const char *name, ssize_t name_len, const DICTIONARY_ITEM *only_item) {
     if(name_len == -1)
         name_len = (ssize_t)strlen(name);
 
@@ -388,7 +389,7 @@ static inline bool dict_item_del(DICTIONARY *dict, const char *name, ssize_t nam
 
     int ret;
     DICTIONARY_ITEM *item = hashtable_get_unsafe(dict, name, name_len);
-    if(unlikely(!item)) {
+    if(unlikely(!item || (only_item && item != only_item))) {
         dictionary_index_wrlock_unlock(dict);
         ret = false;
     }
@@ -135,6 +135,24 @@ static size_t dictionary_unittest_del_existing(DICTIONARY *dict, char **names, c
     return errors;
 }
 
+static size_t dictionary_unittest_del_acquired_replaced(DICTIONARY *dict, char **names, char **values, size_t entries) {
+    size_t errors = 0;
+    for(size_t i = 0; i < entries ;i++) {
+        // an acquired item that has been deleted and replaced, must not delete its replacement
+        DICT_ITEM_CONST DICTIONARY_ITEM *old = dictionary_get_and_acquire_item(dict, names[i]);
+        dictionary_del(dict, names[i]);
+        DICT_ITEM_CONST DICTIONARY_ITEM *new = dictionary_set_and_acquire_item(dict, names[i], values[i], strlen(values[i]) + 1);
+
+        if(dictionary_acquired_item_del(dict, old)) { fprintf(stderr, ">>> %s() deleted the replacement of a deleted item\n", __FUNCTION__); errors++; }
+        if(!dictionary_get(dict, names[i])) { fprintf(stderr, ">>> %s() the replacement of a deleted item is missing\n", __FUNCTION__); errors++; }
+        if(!dictionary_acquired_item_del(dict, new)) { fprintf(stderr, ">>> %s() didn't delete an acquired item\n", __FUNCTION__); errors++; }
+
+        dictionary_acquired_item_release(dict, old);
+        dictionary_acquired_item_release(dict, new);
+    }
+    return errors;
+}
+
 static size_t dictionary_unittest_reset_clone(DICTIONARY *dict, char **names, char **values, size_t entries) {
     (void)values;
     // set the name as value too
@@ -1072,6 +1090,12 @@ int dictionary_unittest(size_t entries) {
     dictionary_unittest_run_and_measure_time(dict, "walkthrough read callback stop", names, values, entries, &errors, dictionary_unittest_walkthrough_stop);
     dictionary_unittest_run_and_measure_time(dict, "destroying full dictionary", names, values, entries, &errors, dictionary_unittest_destroy);
 
+    fprintf(stderr, "\nCreating dictionary multi threaded, clone, %zu items\n", entries);
+    dict = dictionary_create(DICT_OPTION_NONE);
+    dictionary_unittest_run_and_measure_time(dict, "adding entries", names, values, entries, &errors, dictionary_unittest_set_clone);
+    dictionary_unittest_run_and_measure_time(dict, "deleting replaced acquired entries", names, values, entries, &errors, dictionary_unittest_del_acquired_replaced);
+    dictionary_unittest_run_and_measure_time(dict, "destroying empty dictionary", names, values, entries, &errors, dictionary_unittest_destroy);
+
     fprintf(stderr, "\nCreating dictionary multi-threaded, non-clone, don't overwrite options, %zu items\n", entries);
     dict = dictionary_create(
         DICT_OPTION_NAME_LINK_DONT_CLONE | DICT_OPTION_VALUE_LINK_DONT_CLONE | DICT_OPTION_DONT_OVERWRITE_VALUE);
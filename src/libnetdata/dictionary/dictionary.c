@@ -235,11 +235,15 @@ void dictionary_static_items_aral_init(void) {
     if(unlikely(!dict_items_aral || !dict_shared_items_aral)) {
         spinlock_lock(&spinlock);
 
-        if(!dict_items_aral)
+        if(!dict_items_aral) {
             dict_items_aral = aral_by_size_acquire(sizeof(DICTIONARY_ITEM));
+            aral_enable_magazines(dict_items_aral);
+        }
 
-        if(!dict_shared_items_aral)
+        if(!dict_shared_items_aral) {
             dict_shared_items_aral = aral_by_size_acquire(sizeof(DICTIONARY_ITEM_SHARED));
+            aral_enable_magazines(dict_shared_items_aral);
+        }
 
         spinlock_unlock(&spinlock);
     }
@@ -624,7 +628,7 @@ void dictionary_flush(DICTIONARY *dict) {
     DICTIONARY_ITEM *item, *next = NULL;
     for(item = dict->items.list; item ;item = next) {
         next = item->next;
-        dict_item_del(dict, item_get_name(item), (ssize_t)item_get_name_len(item));
+        dict_item_del(dict, item_get_name(item), (ssize_t)item_get_name_len(item), NULL);
     }
 
     ll_recursive_unlock(dict, DICTIONARY_LOCK_WRITE);
@@ -817,5 +821,19 @@ bool dictionary_del_advanced(DICTIONARY *dict, const char *name, ssize_t name_le
         return false;
     }
 
-    return dict_item_del(dict, name, name_len);
+    return dict_item_del(dict, name, name_len, NULL);
+}
+
+bool dictionary_acquired_item_del(DICTIONARY *dict, DICT_ITEM_CONST DICTIONARY_ITEM *item) {
+    if(unlikely(!dict || !item))
+        return false;
+
+    api_internal_check(dict, item, false, false);
+
+    if(unlikely(is_dictionary_destroyed(dict))) {
+        internal_error(true, "DICTIONARY: attempted to delete item on a destroyed dictionary");
+        return false;
+    }
+
+    return dict_item_del(dict, item_get_name(item), (ssize_t)item_get_name_len(item), item);
 }
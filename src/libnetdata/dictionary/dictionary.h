@@ -209,6 +209,10 @@ DICT_ITEM_CONST DICTIONARY_ITEM *dictionary_get_and_acquire_item_advanced(DICTIO
 #define dictionary_del(dict, name) dictionary_del_advanced(dict, name, -1)
 bool dictionary_del_advanced(DICTIONARY *dict, const char *name, ssize_t name_len);
 
+// Delete an acquired item, only if it is still the item indexed under its name
+// returns false if it has already been deleted (and maybe replaced by another item with the same name)
+bool dictionary_acquired_item_del(DICTIONARY *dict, DICT_ITEM_CONST DICTIONARY_ITEM *item);
+
 // ----------------------------------------------------------------------------
 // reference counters management
 
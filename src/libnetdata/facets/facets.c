@@ -219,6 +219,8 @@ struct facet_key {
 };
 
 struct facets {
+    FACETS *parent;                 // set on shards, which borrow the patterns of their parent
+
     SIMPLE_PATTERN *visible_keys;
     SIMPLE_PATTERN *excluded_keys;
     SIMPLE_PATTERN *included_keys;
@@ -1725,9 +1727,12 @@ void facets_destroy(FACETS *facets) {
 
     dictionary_destroy(facets->accepted_params);
     FACETS_KEYS_INDEX_DESTROY(facets);
-    simple_pattern_free(facets->visible_keys);
-    simple_pattern_free(facets->included_keys);
-    simple_pattern_free(facets->excluded_keys);
+
+    if(!facets->parent) {
+        simple_pattern_free(facets->visible_keys);
+        simple_pattern_free(facets->included_keys);
+        simple_pattern_free(facets->excluded_keys);
+    }
 
     while(facets->base) {
         FACET_ROW *r = facets->base;
@@ -2120,8 +2125,8 @@ static inline FACET_ROW *facets_row_keep_seek_to_position(FACETS *facets, usec_t
     return last;
 }
 
-static void facets_row_keep_first_entry(FACETS *facets, usec_t usec) {
-    facets->operations.last_added = facets_row_create(facets, usec, NULL);
+static void facets_row_keep_first_entry(FACETS *facets, usec_t usec, FACET_ROW *row) {
+    facets->operations.last_added = row ? row : facets_row_create(facets, usec, NULL);
     DOUBLE_LINKED_LIST_APPEND_ITEM_UNSAFE(facets->base, facets->operations.last_added, prev, next);
     facets->items_to_return++;
     facets->operations.first++;
@@ -2169,12 +2174,12 @@ bool facets_row_candidate_to_keep(FACETS *facets, usec_t usec) {
             facets->items_to_return < facets->max_items_to_return;
 }
 
-static void facets_row_keep(FACETS *facets, usec_t usec) {
-    facets->operations.rows.matched++;
-
+// when row is given, it is an already created row (of a shard) to be kept,
+// otherwise a new row is created from the current values of the keys
+static void facets_row_keep(FACETS *facets, usec_t usec, FACET_ROW *row) {
     if(unlikely(!facets->base)) {
         // the first row to keep
-        facets_row_keep_first_entry(facets, usec);
+        facets_row_keep_first_entry(facets, usec, row);
         return;
     }
 
@@ -2190,6 +2195,7 @@ static void facets_row_keep(FACETS *facets, usec_t usec) {
                 if(closest == facets->base->prev && usec < closest->usec) {
                     // this is to the end of the list, belonging to the next page
                     facets->operations.skips_after++;
+                    if(row) facets_row_free(facets, row);
                     return;
                 }
 
@@ -2204,6 +2210,7 @@ static void facets_row_keep(FACETS *facets, usec_t usec) {
                 if(closest == facets->base && usec > closest->usec) {
                     // this is to the beginning of the list, belonging to the next page
                     facets->operations.skips_before++;
+                    if(row) facets_row_free(facets, row);
                     return;
                 }
 
@@ -2223,7 +2230,14 @@ static void facets_row_keep(FACETS *facets, usec_t usec) {
     internal_fatal(!closest, "FACETS: closest cannot be NULL");
     internal_fatal(closest == to_replace, "FACETS: closest cannot be the same as to_replace");
 
-    facets->operations.last_added = facets_row_create(facets, usec, to_replace);
+    if(row) {
+        if(to_replace)
+            facets_row_free(facets, to_replace);
+
+        facets->operations.last_added = row;
+    }
+    else
+        facets->operations.last_added = facets_row_create(facets, usec, to_replace);
 
     if(usec < closest->usec) {
         DOUBLE_LINKED_LIST_INSERT_ITEM_AFTER_UNSAFE(facets->base, closest, facets->operations.last_added, prev, next);
@@ -2340,8 +2354,10 @@ bool facets_row_finished(FACETS *facets, usec_t usec) {
         // we need to keep this row
         facets_histogram_update_value(facets, usec);
 
-        if(within_anchor)
-            facets_row_keep(facets, usec);
+        if(within_anchor) {
+            facets->operations.rows.matched++;
+            facets_row_keep(facets, usec, NULL);
+        }
     }
 
     facets_reset_keys_with_value_and_row(facets);
@@ -2349,6 +2365,211 @@ bool facets_row_finished(FACETS *facets, usec_t usec) {
     return selected_keys == total_keys;
 }
 
+// ----------------------------------------------------------------------------
+// shards
+//
+// a shard is a FACETS configured exactly like its parent (keys, filters, full
+// text search, anchor, timeframe and histogram), so that another thread can
+// process a part of the data. facets_shard_merge() adds everything the shard
+// collected to its parent, which can then report it as if it had processed
+// all the data itself.
+
+FACETS *facets_shard_create(FACETS *parent) {
+    FACETS *facets = callocz(1, sizeof(FACETS));
+    facets->parent = parent;
+    facets->all_keys_included_by_default = parent->all_keys_included_by_default;
+    facets->options = parent->options;
+    FACETS_KEYS_INDEX_CREATE(facets);
+
+    facets->included_keys = parent->included_keys;
+    facets->excluded_keys = parent->excluded_keys;
+    facets->visible_keys = parent->visible_keys;
+    facets->query = parent->query;
+
+    facets->max_items_to_return = parent->max_items_to_return;
+    facets->anchor = parent->anchor;
+    facets->timeframe = parent->timeframe;
+    facets->severity = parent->severity;
+
+    facets->histogram = parent->histogram;
+    facets->histogram.key = NULL;
+    if(parent->histogram.chart)
+        facets->histogram.chart = strdupz(parent->histogram.chart);
+
+    FACET_KEY *pk;
+    foreach_key_in_facets(parent, pk) {
+        FACET_KEY *k = FACETS_KEY_ADD_TO_INDEX(facets, pk->hash, pk->name, pk->name ? strlen(pk->name) : 0, pk->options);
+        k->options = pk->options;
+        k->order = pk->order;
+        k->default_selected_for_values = pk->default_selected_for_values;
+        k->transform = pk->transform;
+        k->dynamic = pk->dynamic;
+
+        if(!pk->values.enabled)
+            continue;
+
+        facet_key_late_init(facets, k);
+
+        FACET_VALUE *pv;
+        foreach_value_in_key(pk, pv) {
+            FACET_VALUE tv = {
+                    .hash = pv->hash,
+                    .name = pv->name,
+                    .name_len = pv->name_len,
+                    .color = pv->color,
+                    .selected = pv->selected,
+                    .empty = pv->empty,
+                    .unsampled = pv->unsampled,
+                    .estimated = pv->estimated,
+            };
+            FACET_VALUE *v = FACET_VALUE_ADD_TO_INDEX(k, &tv);
+
+            if(v->empty)
+                k->empty_value.v = v;
+            else if(v->unsampled)
+                k->unsampled_value.v = v;
+            else if(v->estimated)
+                k->estimated_value.v = v;
+        }
+        foreach_value_in_key_done(pv);
+
+        facets_reset_key(k);
+    }
+    foreach_key_in_facets_done(pk);
+
+    facets->order = parent->order;
+
+    // the shard accounts only the work it does
+    memset(&facets->operations, 0, sizeof(facets->operations));
+
+    return facets;
+}
+
+static void facets_shard_merge_key(FACETS *facets, FACET_KEY *sk) {
+    FACET_KEY *k = FACETS_KEY_ADD_TO_INDEX(facets, sk->hash, sk->name, sk->name ? strlen(sk->name) : 0, sk->options);
+
+    if(!k->transform.cb)
+        k->transform = sk->transform;
+
+    if(!k->dynamic.cb)
+        k->dynamic = sk->dynamic;
+
+    if(!sk->values.enabled)
+        return;
+
+    facet_key_late_init(facets, k);
+    if(!k->values.enabled)
+        return;
+
+    FACET_VALUE *sv;
+    foreach_value_in_key(sk, sv) {
+        FACET_VALUE *v = FACET_VALUE_GET_FROM_INDEX(k, sv->hash);
+        if(!v) {
+            FACET_VALUE tv = {
+                    .hash = sv->hash,
+                    .name = sv->name,
+                    .name_len = sv->name_len,
+                    .color = sv->color,
+                    .selected = sv->selected,
+                    .empty = sv->empty,
+                    .unsampled = sv->unsampled,
+                    .estimated = sv->estimated,
+            };
+            v = FACET_VALUE_ADD_TO_INDEX(k, &tv);
+
+            if(v->empty)
+                k->empty_value.v = v;
+            else if(v->unsampled)
+                k->unsampled_value.v = v;
+            else if(v->estimated)
+                k->estimated_value.v = v;
+        }
+        else if(!v->name && sv->name && sv->name_len) {
+            // the parent has it as a filter, the shard found the actual value
+            v->name = facets_value_dup(sv->name, sv->name_len);
+            v->name_len = sv->name_len;
+        }
+
+        v->rows_matching_facet_value += sv->rows_matching_facet_value;
+        v->final_facet_value_counter += sv->final_facet_value_counter;
+
+        if(sv->histogram) {
+            if(!v->histogram)
+                v->histogram = callocz(facets->histogram.slots, sizeof(*v->histogram));
+
+            for(uint32_t i = 0; i < facets->histogram.slots ;i++)
+                v->histogram[i] += sv->histogram[i];
+        }
+    }
+    foreach_value_in_key_done(sv);
+
+    // adding values to the index, marks them as used in the current row
+    facets_reset_key(k);
+}
+
+void facets_shard_merge(FACETS *facets, FACETS *shard) {
+    internal_fatal(shard->parent != facets, "FACETS: merging a shard to a FACETS that is not its parent");
+
+    FACET_KEY *sk;
+    foreach_key_in_facets(shard, sk) {
+        facets_shard_merge_key(facets, sk);
+    }
+    foreach_key_in_facets_done(sk);
+
+    if(!facets->histogram.key) {
+        FACET_KEY *k = FACETS_KEY_GET_FROM_INDEX(facets, facets->histogram.hash);
+        if(k && k->values.enabled && shard->histogram.key)
+            facets->histogram.key = k;
+    }
+
+    // move the rows of the shard, keeping only the ones we need
+    while(shard->base) {
+        FACET_ROW *row = shard->base;
+        DOUBLE_LINKED_LIST_REMOVE_ITEM_UNSAFE(shard->base, row, prev, next);
+        shard->items_to_return--;
+
+        if(row->bin_data.data) {
+            shard->operations.bin_data_inflight--;
+            facets->operations.bin_data_inflight++;
+        }
+
+        facets_row_keep(facets, row->usec, row);
+    }
+    shard->operations.last_added = NULL;
+
+    facets->operations.first += shard->operations.first;
+    facets->operations.forwards += shard->operations.forwards;
+    facets->operations.backwards += shard->operations.backwards;
+    facets->operations.skips_before += shard->operations.skips_before;
+    facets->operations.skips_after += shard->operations.skips_after;
+    facets->operations.prepends += shard->operations.prepends;
+    facets->operations.appends += shard->operations.appends;
+    facets->operations.shifts += shard->operations.shifts;
+
+    facets->operations.rows.evaluated += shard->operations.rows.evaluated;
+    facets->operations.rows.matched += shard->operations.rows.matched;
+    facets->operations.rows.unsampled += shard->operations.rows.unsampled;
+    facets->operations.rows.estimated += shard->operations.rows.estimated;
+    facets->operations.rows.created += shard->operations.rows.created;
+    facets->operations.rows.reused += shard->operations.rows.reused;
+
+    facets->operations.keys.registered += shard->operations.keys.registered;
+
+    facets->operations.values.registered += shard->operations.values.registered;
+    facets->operations.values.transformed += shard->operations.values.transformed;
+    facets->operations.values.dynamic += shard->operations.values.dynamic;
+    facets->operations.values.empty += shard->operations.values.empty;
+    facets->operations.values.unsampled += shard->operations.values.unsampled;
+    facets->operations.values.estimated += shard->operations.values.estimated;
+    facets->operations.values.indexed += shard->operations.values.indexed;
+    facets->operations.values.inserts += shard->operations.values.inserts;
+    facets->operations.values.conflicts += shard->operations.values.conflicts;
+
+    facets->operations.fts.searches += shard->operations.fts.searches;
+
+    facets_destroy(shard);
+}
+
 // ----------------------------------------------------------------------------
 // output
 
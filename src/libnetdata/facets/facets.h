@@ -153,4 +153,7 @@ void *facets_row_bin_data_get(FACETS *facets __maybe_unused, FACET_ROW *row);
 
 void facets_use_hashes_for_ids(FACETS *facets, bool set);
 
+FACETS *facets_shard_create(FACETS *parent);
+void facets_shard_merge(FACETS *parent, FACETS *shard);
+
 #endif
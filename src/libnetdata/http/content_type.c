@@ -38,6 +38,7 @@ static struct {
     { .format = "video/mp4",                    CT_VIDEO_MP4, false },
     { .format = "application/pdf",              CT_APPLICATION_PDF, false },
     { .format = "application/zip",              CT_APPLICATION_ZIP, false },
+    { .format = "application/vnd.netdata.columnar", CT_APPLICATION_NETDATA_COLUMNAR, false },
     { .format = "image/png",                    CT_IMAGE_PNG, false },
 
     // secondary - overlapping with primary
@@ -72,6 +73,34 @@ const char *content_type_id2string(HTTP_CONTENT_TYPE content_type) {
     return "text/plain";
 }
 
+bool content_type_is_compressible(HTTP_CONTENT_TYPE content_type) {
+    switch(content_type) {
+        case CT_APPLICATION_JSON:
+        case CT_TEXT_PLAIN:
+        case CT_TEXT_HTML:
+        case CT_APPLICATION_X_JAVASCRIPT:
+        case CT_TEXT_CSS:
+        case CT_TEXT_XML:
+        case CT_APPLICATION_XML:
+        case CT_TEXT_XSL:
+        case CT_APPLICATION_X_FONT_TRUETYPE:
+        case CT_APPLICATION_X_FONT_OPENTYPE:
+        case CT_APPLICATION_VND_MS_FONTOBJ:
+        case CT_IMAGE_SVG_XML:
+        case CT_IMAGE_XICON:
+        case CT_IMAGE_BMP:
+        case CT_PROMETHEUS:
+        case CT_TEXT_YAML:
+        case CT_APPLICATION_YAML:
+        case CT_APPLICATION_NETDATA_COLUMNAR:
+            return true;
+
+        default:
+            // already compressed (images, audio, video, woff fonts, archives) or unknown
+            return false;
+    }
+}
+
 void http_header_content_type(BUFFER *wb, HTTP_CONTENT_TYPE content_type) {
     buffer_strcat(wb, "Content-Type: ");
 
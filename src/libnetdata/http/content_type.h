@@ -34,6 +34,7 @@ typedef enum __attribute__ ((__packed__)) {
     CT_APPLICATION_ZIP,
     CT_TEXT_YAML,
     CT_APPLICATION_YAML,
+    CT_APPLICATION_NETDATA_COLUMNAR,
 } HTTP_CONTENT_TYPE;
 
 HTTP_CONTENT_TYPE content_type_string2id(const char *format);
@@ -42,5 +43,6 @@ const char *content_type_id2string(HTTP_CONTENT_TYPE content_type);
 #include "../libnetdata.h"
 
 void http_header_content_type(struct web_buffer *wb, HTTP_CONTENT_TYPE type);
+bool content_type_is_compressible(HTTP_CONTENT_TYPE content_type);
 
 #endif //NETDATA_CONTENT_TYPE_H
@@ -69,6 +69,25 @@ struct local_port;
 #define SIMPLE_HASHTABLE_NAME _LISTENING_PORT
 #include "libnetdata/simple_hashtable/simple_hashtable.h"
 
+// --------------------------------------------------------------------------------------------------------------------
+// hashtable for keeping the processes of the pid cache, across calls
+// key is XXH3_64bits hash of the pid
+
+struct local_sockets_cached_pid;
+#define SIMPLE_HASHTABLE_VALUE_TYPE struct local_sockets_cached_pid *
+#define SIMPLE_HASHTABLE_NAME _CACHED_PID
+#include "libnetdata/simple_hashtable/simple_hashtable.h"
+
+// --------------------------------------------------------------------------------------------------------------------
+// hashtable for keeping the sockets no process could be found for, across calls
+// key and value is the socket inode
+
+#define SIMPLE_HASHTABLE_KEY_TYPE uint64_t
+#define SIMPLE_HASHTABLE_VALUE_TYPE_IS_NOT_POINTER
+#define SIMPLE_HASHTABLE_VALUE_TYPE uint64_t
+#define SIMPLE_HASHTABLE_NAME _ORPHAN_SOCKET
+#include "libnetdata/simple_hashtable/simple_hashtable.h"
+
 // --------------------------------------------------------------------------------------------------------------------
 
 struct local_socket_state;
@@ -130,6 +149,10 @@ typedef struct local_socket_state {
         size_t pid_fds_opendir_failed;
         size_t pid_fds_readlink_failed;
         size_t pid_fds_parse_failed;
+        size_t pid_fds_cached;
+        size_t pid_fds_revalidated;
+        size_t pids_cached;
+        size_t pids_new;
         size_t errors_encountered;
 
         size_t sockets_added;
@@ -160,6 +183,10 @@ typedef struct local_socket_state {
     uint16_t tmp_protocol;
 #endif
 
+    bool pid_cache_is_mine;
+    uint32_t pid_cache_scan;
+    struct local_sockets_pid_cache *pid_cache;
+
     procfile *ff;
 
     ARAL *local_socket_aral;
@@ -193,12 +220,53 @@ typedef enum __attribute__((packed)) {
 struct pid_socket {
     uint64_t inode;
     pid_t pid;
+    int fd;
     uid_t uid;
     uint64_t net_ns_inode;
     char *cmdline;
     char comm[TASK_COMM_LEN];
 };
 
+// --------------------------------------------------------------------------------------------------------------------
+// the pid cache
+// it keeps the fds of all processes and the socket inodes they point to, so that repeated calls
+// need to readlink() only the fds that have been opened since the previous call.
+// a pid is trusted as long as its start time (field 22 of /proc/PID/stat) remains the same.
+
+// how frequently to re-read the uid, comm, cmdline and network namespace of cached processes
+#define LOCAL_SOCKETS_PID_CACHE_METADATA_TTL_UT (60 * USEC_PER_SEC)
+
+struct local_sockets_cached_fd {
+    int fd;
+    uint32_t checked;                   // the scan this fd was last read at
+    bool listed;                        // the socket has been found in /proc/net
+    uint64_t inode;                     // the socket inode, or zero when the fd is not a socket
+};
+
+struct local_sockets_cached_pid {
+    pid_t pid;
+    uint32_t seen;                      // the last scan this pid was found in /proc
+    uint64_t start_time;
+    usec_t metadata_ut;
+
+    uid_t uid;
+    uint64_t net_ns_inode;
+    char *cmdline;
+    char comm[TASK_COMM_LEN];
+
+    size_t fds_used;
+    size_t fds_size;
+    struct local_sockets_cached_fd *fds; // sorted by fd
+};
+
+typedef struct local_sockets_pid_cache {
+    netdata_mutex_t mutex;
+    uint32_t scan;
+
+    SIMPLE_HASHTABLE_CACHED_PID pids;
+    SIMPLE_HASHTABLE_ORPHAN_SOCKET orphans;
+} LS_PID_CACHE;
+
 struct local_port {
     uint16_t protocol;
     uint16_t family;
@@ -575,14 +643,223 @@ static inline bool local_sockets_is_path_a_pid(const char *s) {
     return true;
 }
 
+static inline LS_PID_CACHE *local_sockets_pid_cache_create(void) {
+    LS_PID_CACHE *cache = callocz(1, sizeof(*cache));
+    netdata_mutex_init(&cache->mutex);
+    simple_hashtable_init_CACHED_PID(&cache->pids, 4096);
+    simple_hashtable_init_ORPHAN_SOCKET(&cache->orphans, 1024);
+    return cache;
+}
+
+static inline void local_sockets_cached_pid_free(struct local_sockets_cached_pid *cp) {
+    freez(cp->fds);
+    freez(cp->cmdline);
+    freez(cp);
+}
+
+static inline void local_sockets_pid_cache_destroy(LS_PID_CACHE *cache) {
+    if(!cache) return;
+
+    for(SIMPLE_HASHTABLE_SLOT_CACHED_PID *sl = simple_hashtable_first_read_only_CACHED_PID(&cache->pids);
+         sl;
+         sl = simple_hashtable_next_read_only_CACHED_PID(&cache->pids, sl)) {
+        struct local_sockets_cached_pid *cp = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(cp) local_sockets_cached_pid_free(cp);
+    }
+
+    simple_hashtable_destroy_CACHED_PID(&cache->pids);
+    simple_hashtable_destroy_ORPHAN_SOCKET(&cache->orphans);
+    netdata_mutex_destroy(&cache->mutex);
+    freez(cache);
+}
+
+static inline uint64_t local_sockets_pid_start_time(const char *proc_filename, pid_t pid) {
+    char filename[FILENAME_MAX + 1];
+    char buf[1024];
+
+    snprintfz(filename, sizeof(filename), "%s/%d/stat", proc_filename, pid);
+    if(read_txt_file(filename, buf, sizeof(buf)))
+        return 0;
+
+    // comm may contain spaces and parenthesis, so start after the last ')'
+    char *s = strrchr(buf, ')');
+    if(!s) return 0;
+    s++;
+
+    // skip fields 3 to 21, to reach the start time (field 22)
+    for(size_t field = 3; field < 22 && *s ; field++) {
+        while(isspace(*s)) s++;
+        while(*s && !isspace(*s)) s++;
+    }
+
+    return strtoull(s, NULL, 10);
+}
+
+static inline void local_sockets_cached_pid_metadata(LS_STATE *ls, const char *proc_filename, struct local_sockets_cached_pid *cp, usec_t now_ut) {
+    char filename[FILENAME_MAX + 1];
+
+    if(!cp->metadata_ut || now_ut - cp->metadata_ut >= LOCAL_SOCKETS_PID_CACHE_METADATA_TTL_UT) {
+        // a process may exec() or change its uid without getting a new start time
+        cp->uid = UID_UNSET;
+        cp->net_ns_inode = 0;
+        cp->comm[0] = '\0';
+        freez(cp->cmdline);
+        cp->cmdline = NULL;
+        cp->metadata_ut = now_ut;
+    }
+
+    if(cp->uid == UID_UNSET && ls->config.uid) {
+        char status_buf[512];
+        snprintfz(filename, sizeof(filename), "%s/%d/status", proc_filename, cp->pid);
+        if (read_txt_file(filename, status_buf, sizeof(status_buf)))
+            local_sockets_log(ls, "cannot open file: %s\n", filename);
+        else {
+            char *u = strstr(status_buf, "Uid:");
+            if(u) {
+                u += 4;
+                while(isspace(*u)) u++;                     // skip spaces
+                while(*u >= '0' && *u <= '9') u++;          // skip the first number (real uid)
+                while(isspace(*u)) u++;                     // skip spaces again
+                cp->uid = strtol(u, NULL, 10);   // parse the 2nd number (effective uid)
+            }
+        }
+    }
+    if(!cp->comm[0] && ls->config.comm) {
+        snprintfz(filename, sizeof(filename), "%s/%d/comm", proc_filename, cp->pid);
+        if (read_txt_file(filename, cp->comm, sizeof(cp->comm)))
+            local_sockets_log(ls, "cannot open file: %s\n", filename);
+        else {
+            size_t clen = strlen(cp->comm);
+            if(clen && cp->comm[clen - 1] == '\n')
+                cp->comm[clen - 1] = '\0';
+        }
+    }
+    if(!cp->cmdline && ls->config.cmdline) {
+        char cmdline[8192];
+        snprintfz(filename, sizeof(filename), "%s/%d/cmdline", proc_filename, cp->pid);
+        if (read_proc_cmdline(filename, cmdline, sizeof(cmdline)))
+            local_sockets_log(ls, "cannot open file: %s\n", filename);
+        else {
+            local_sockets_fix_cmdline(cmdline);
+            const char *cmdline_trimmed = trim(cmdline);
+            if(cmdline_trimmed)
+                cp->cmdline = strdupz(cmdline_trimmed);
+        }
+    }
+    if(!cp->net_ns_inode && ls->config.namespaces) {
+        snprintfz(filename, sizeof(filename), "%s/%d/ns/net", proc_filename, cp->pid);
+        local_sockets_read_proc_inode_link(ls, filename, &cp->net_ns_inode, "net");
+    }
+
+    if(cp->net_ns_inode) {
+        XXH64_hash_t net_ns_inode_hash = XXH3_64bits(&cp->net_ns_inode, sizeof(cp->net_ns_inode));
+        SIMPLE_HASHTABLE_SLOT_NET_NS *sl_ns = simple_hashtable_get_slot_NET_NS(&ls->ns_hashtable, net_ns_inode_hash, &cp->net_ns_inode, true);
+        simple_hashtable_set_slot_NET_NS(&ls->ns_hashtable, sl_ns, cp->net_ns_inode, cp->net_ns_inode);
+    }
+}
+
+static inline int local_sockets_cached_fd_compar(const void *a, const void *b) {
+    const struct local_sockets_cached_fd *fa = a, *fb = b;
+    return (fa->fd > fb->fd) - (fa->fd < fb->fd);
+}
+
+static inline struct local_sockets_cached_fd *local_sockets_cached_pid_find_fd(struct local_sockets_cached_fd *fds, size_t used, int fd) {
+    if(!used) return NULL;
+    struct local_sockets_cached_fd key = { .fd = fd };
+    return bsearch(&key, fds, used, sizeof(*fds), local_sockets_cached_fd_compar);
+}
+
+static inline struct local_sockets_cached_pid *local_sockets_pid_cache_get(LS_PID_CACHE *cache, pid_t pid) {
+    XXH64_hash_t pid_hash = XXH3_64bits(&pid, sizeof(pid));
+    SIMPLE_HASHTABLE_SLOT_CACHED_PID *sl = simple_hashtable_get_slot_CACHED_PID(&cache->pids, pid_hash, &pid, false);
+    return SIMPLE_HASHTABLE_SLOT_DATA(sl);
+}
+
+// read again the socket a cached fd points to
+static inline uint64_t local_sockets_cached_fd_reread(LS_STATE *ls, const char *proc_filename, struct local_sockets_cached_pid *cp, struct local_sockets_cached_fd *cfd) {
+    char filename[FILENAME_MAX + 1];
+    snprintfz(filename, sizeof(filename), "%s/%d/fd/%d", proc_filename, cp->pid, cfd->fd);
+
+    uint64_t inode = 0;
+    local_sockets_read_proc_inode_link(ls, filename, &inode, "socket");
+    if(inode != cfd->inode)
+        cfd->listed = false;
+    cfd->inode = inode;
+    cfd->checked = ls->pid_cache_scan;
+    ls->stats.pid_fds_revalidated++;
+    return inode;
+}
+
+static inline void local_sockets_pid_socket_set(struct pid_socket *ps, struct local_sockets_cached_pid *cp, struct local_sockets_cached_fd *cfd) {
+    ps->inode = cfd->inode;
+    ps->pid = cp->pid;
+    ps->fd = cfd->fd;
+    ps->uid = cp->uid;
+    ps->net_ns_inode = cp->net_ns_inode;
+    strncpyz(ps->comm, cp->comm, sizeof(ps->comm) - 1);
+
+    if(ps->cmdline)
+        freez(ps->cmdline);
+
+    ps->cmdline = cp->cmdline ? strdupz(cp->cmdline) : NULL;
+}
+
+// sockets shared by many processes (e.g. inherited by fork()) are owned by the lowest pid, other than init
+static inline bool local_sockets_pid_socket_owner_is_better(pid_t pid, pid_t owner) {
+    if(owner == 1)
+        return pid != 1;
+
+    return pid != 1 && pid < owner;
+}
+
+// index the socket a cached fd points to.
+// the kernel reuses fd numbers all the time, so a cached fd may point to another socket by now.
+// when 2 processes claim the same socket, the claims coming from the cache are verified.
+static inline void local_sockets_index_pid_socket(LS_STATE *ls, const char *proc_filename, struct local_sockets_cached_pid *cp, struct local_sockets_cached_fd *cfd) {
+    uint64_t inode;
+    while((inode = cfd->inode)) {
+        // fprintf(stderr, "%d: PID %d is using socket inode %"PRIu64"\n", gettid_uncached(), cp->pid, inode);
+        XXH64_hash_t inode_hash = XXH3_64bits(&inode, sizeof(inode));
+        SIMPLE_HASHTABLE_SLOT_PID_SOCKET *sl = simple_hashtable_get_slot_PID_SOCKET(&ls->pid_sockets_hashtable, inode_hash, &inode, true);
+        struct pid_socket *ps = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(!ps) {
+            ps = aral_callocz(ls->pid_socket_aral);
+            local_sockets_pid_socket_set(ps, cp, cfd);
+            simple_hashtable_set_slot_PID_SOCKET(&ls->pid_sockets_hashtable, sl, inode_hash, ps);
+            // fprintf(stderr, "%d: PID %d indexed for using socket inode %"PRIu64"\n", gettid_uncached(), cp->pid, inode);
+            return;
+        }
+
+        if(ps->pid == cp->pid)
+            return;
+
+        if(cfd->checked < ls->pid_cache_scan && local_sockets_cached_fd_reread(ls, proc_filename, cp, cfd) != inode)
+            // our fd points to something else now, index that instead
+            continue;
+
+        struct local_sockets_cached_pid *owner = local_sockets_pid_cache_get(ls->pid_cache, ps->pid);
+        struct local_sockets_cached_fd *ofd = owner ? local_sockets_cached_pid_find_fd(owner->fds, owner->fds_used, ps->fd) : NULL;
+        if(ofd && ofd->checked < ls->pid_cache_scan && local_sockets_cached_fd_reread(ls, proc_filename, owner, ofd) != inode) {
+            // the fd of the current owner points to something else now, so the socket is ours
+            local_sockets_pid_socket_set(ps, cp, cfd);
+
+            // and the owner has to be indexed for whatever its fd points to now
+            local_sockets_index_pid_socket(ls, proc_filename, owner, ofd);
+            return;
+        }
+
+        if(local_sockets_pid_socket_owner_is_better(cp->pid, ps->pid))
+            local_sockets_pid_socket_set(ps, cp, cfd);
+
+        return;
+    }
+}
+
 static inline bool local_sockets_find_all_sockets_in_proc(LS_STATE *ls, const char *proc_filename) {
     DIR *proc_dir;
     struct dirent *proc_entry;
     char filename[FILENAME_MAX + 1];
-    char comm[TASK_COMM_LEN];
-    char cmdline[8192];
-    const char *cmdline_trimmed;
-    uint64_t net_ns_inode;
+    LS_PID_CACHE *cache = ls->pid_cache;
 
     proc_dir = opendir(proc_filename);
     if (proc_dir == NULL) {
@@ -591,6 +868,12 @@ static inline bool local_sockets_find_all_sockets_in_proc(LS_STATE *ls, const ch
         return false;
     }
 
+    netdata_mutex_lock(&cache->mutex);
+
+    uint32_t scan = ++cache->scan;
+    ls->pid_cache_scan = scan;
+    usec_t now_ut = now_monotonic_usec();
+
     while ((proc_entry = readdir(proc_dir)) != NULL) {
         if(proc_entry->d_type != DT_DIR)
             continue;
@@ -610,99 +893,118 @@ static inline bool local_sockets_find_all_sockets_in_proc(LS_STATE *ls, const ch
             continue;
         }
 
-        comm[0] = '\0';
-        cmdline[0] = '\0';
-        cmdline_trimmed = NULL;
         pid_t pid = (pid_t)strtoul(proc_entry->d_name, NULL, 10);
         if(!pid) {
             local_sockets_log(ls, "cannot parse pid of '%s'", proc_entry->d_name);
             closedir(fd_dir);
             continue;
         }
-        net_ns_inode = 0;
-        uid_t uid = UID_UNSET;
+
+        // find the process in the cache, and validate it is still the same process
+        // (a private cache is empty, so there is nothing to validate)
+        uint64_t start_time = ls->pid_cache_is_mine ? 0 : local_sockets_pid_start_time(proc_filename, pid);
+        XXH64_hash_t pid_hash = XXH3_64bits(&pid, sizeof(pid));
+        SIMPLE_HASHTABLE_SLOT_CACHED_PID *sl_cp = simple_hashtable_get_slot_CACHED_PID(&cache->pids, pid_hash, &pid, true);
+        struct local_sockets_cached_pid *cp = SIMPLE_HASHTABLE_SLOT_DATA(sl_cp);
+        if(cp && (!start_time || cp->start_time != start_time)) {
+            local_sockets_cached_pid_free(cp);
+            cp = NULL;
+        }
+
+        if(!cp) {
+            cp = callocz(1, sizeof(*cp));
+            cp->pid = pid;
+            cp->start_time = start_time;
+            cp->uid = UID_UNSET;
+            simple_hashtable_set_slot_CACHED_PID(&cache->pids, sl_cp, pid_hash, cp);
+            ls->stats.pids_new++;
+        }
+        else
+            ls->stats.pids_cached++;
+
+        cp->seen = scan;
+
+        // merge the fds of the process with the ones we already know
+        struct local_sockets_cached_fd *old_fds = cp->fds;
+        size_t old_used = cp->fds_used;
+        size_t fds_size = cp->fds_size ? cp->fds_size : 16;
+        struct local_sockets_cached_fd *fds = mallocz(fds_size * sizeof(*fds));
+        size_t fds_used = 0;
+        bool sorted = true;
+        bool metadata = false;
 
         struct dirent *fd_entry;
         while ((fd_entry = readdir(fd_dir)) != NULL) {
             if(fd_entry->d_type != DT_LNK)
                 continue;
 
-            snprintfz(filename, sizeof(filename), "%s/%s/fd/%s", proc_filename, proc_entry->d_name, fd_entry->d_name);
+            int fd = (int)str2i(fd_entry->d_name);
+
             uint64_t inode = 0;
-            if(!local_sockets_read_proc_inode_link(ls, filename, &inode, "socket"))
-                continue;
+            struct local_sockets_cached_fd *cfd = local_sockets_cached_pid_find_fd(old_fds, old_used, fd);
+            if(cfd) {
+                inode = cfd->inode;
+                ls->stats.pid_fds_cached++;
+            }
+            else {
+                snprintfz(filename, sizeof(filename), "%s/%s/fd/%s", proc_filename, proc_entry->d_name, fd_entry->d_name);
+                errno = 0;
+                if(!local_sockets_read_proc_inode_link(ls, filename, &inode, "socket") && errno)
+                    // readlink() failed, the fd has probably been closed - do not cache it
+                    continue;
+            }
 
-            // fprintf(stderr, "%d: PID %d is using socket inode %"PRIu64"\n", gettid_uncached(), pid, inode);
-            XXH64_hash_t inode_hash = XXH3_64bits(&inode, sizeof(inode));
-            SIMPLE_HASHTABLE_SLOT_PID_SOCKET *sl = simple_hashtable_get_slot_PID_SOCKET(&ls->pid_sockets_hashtable, inode_hash, &inode, true);
-            struct pid_socket *ps = SIMPLE_HASHTABLE_SLOT_DATA(sl);
-            if(!ps || (ps->pid == 1 && pid != 1)) {
-                if(uid == UID_UNSET && ls->config.uid) {
-                    char status_buf[512];
-                    snprintfz(filename, sizeof(filename), "%s/%s/status", proc_filename, proc_entry->d_name);
-                    if (read_txt_file(filename, status_buf, sizeof(status_buf)))
-                        local_sockets_log(ls, "cannot open file: %s\n", filename);
-                    else {
-                        char *u = strstr(status_buf, "Uid:");
-                        if(u) {
-                            u += 4;
-                            while(isspace(*u)) u++;                     // skip spaces
-                            while(*u >= '0' && *u <= '9') u++;          // skip the first number (real uid)
-                            while(isspace(*u)) u++;                     // skip spaces again
-                            uid = strtol(u, NULL, 10);   // parse the 2nd number (effective uid)
-                        }
-                    }
-                }
-                if(!comm[0] && ls->config.comm) {
-                    snprintfz(filename, sizeof(filename), "%s/%s/comm", proc_filename, proc_entry->d_name);
-                    if (read_txt_file(filename, comm, sizeof(comm)))
-                        local_sockets_log(ls, "cannot open file: %s\n", filename);
-                    else {
-                        size_t clen = strlen(comm);
-                        if(comm[clen - 1] == '\n')
-                            comm[clen - 1] = '\0';
-                    }
-                }
-                if(!cmdline[0] && ls->config.cmdline) {
-                    snprintfz(filename, sizeof(filename), "%s/%s/cmdline", proc_filename, proc_entry->d_name);
-                    if (read_proc_cmdline(filename, cmdline, sizeof(cmdline)))
-                        local_sockets_log(ls, "cannot open file: %s\n", filename);
-                    else {
-                        local_sockets_fix_cmdline(cmdline);
-                        cmdline_trimmed = trim(cmdline);
-                    }
-                }
-                if(!net_ns_inode && ls->config.namespaces) {
-                    snprintfz(filename, sizeof(filename), "%s/%s/ns/net", proc_filename, proc_entry->d_name);
-                    if(local_sockets_read_proc_inode_link(ls, filename, &net_ns_inode, "net")) {
-                        XXH64_hash_t net_ns_inode_hash = XXH3_64bits(&net_ns_inode, sizeof(net_ns_inode));
-                        SIMPLE_HASHTABLE_SLOT_NET_NS *sl_ns = simple_hashtable_get_slot_NET_NS(&ls->ns_hashtable, net_ns_inode_hash, &net_ns_inode, true);
-                        simple_hashtable_set_slot_NET_NS(&ls->ns_hashtable, sl_ns, net_ns_inode, net_ns_inode);
-                    }
-                }
+            if(fds_used == fds_size) {
+                fds_size *= 2;
+                fds = reallocz(fds, fds_size * sizeof(*fds));
+            }
 
-                if(!ps)
-                    ps = aral_callocz(ls->pid_socket_aral);
+            if(fds_used && fds[fds_used - 1].fd > fd)
+                sorted = false;
 
-                ps->inode = inode;
-                ps->pid = pid;
-                ps->uid = uid;
-                ps->net_ns_inode = net_ns_inode;
-                strncpyz(ps->comm, comm, sizeof(ps->comm) - 1);
+            fds[fds_used++] = (struct local_sockets_cached_fd) {
+                .fd = fd,
+                .checked = cfd ? cfd->checked : scan,
+                .listed = cfd ? cfd->listed : false,
+                .inode = inode,
+            };
 
-                if(ps->cmdline)
-                    freez(ps->cmdline);
+            if(!inode)
+                continue;
 
-                ps->cmdline = cmdline_trimmed ? strdupz(cmdline_trimmed) : NULL;
-                simple_hashtable_set_slot_PID_SOCKET(&ls->pid_sockets_hashtable, sl, inode_hash, ps);
-                // fprintf(stderr, "%d: PID %d indexed for using socket inode %"PRIu64"\n", gettid_uncached(), pid, inode);
+            if(!metadata) {
+                local_sockets_cached_pid_metadata(ls, proc_filename, cp, now_ut);
+                metadata = true;
             }
+
+            local_sockets_index_pid_socket(ls, proc_filename, cp, &fds[fds_used - 1]);
         }
 
         closedir(fd_dir);
+
+        if(!sorted)
+            qsort(fds, fds_used, sizeof(*fds), local_sockets_cached_fd_compar);
+
+        freez(old_fds);
+        cp->fds = fds;
+        cp->fds_used = fds_used;
+        cp->fds_size = fds_size;
     }
 
     closedir(proc_dir);
+
+    // expire the processes that have exited
+    for(SIMPLE_HASHTABLE_SLOT_CACHED_PID *sl = simple_hashtable_first_read_only_CACHED_PID(&cache->pids);
+         sl;
+         sl = simple_hashtable_next_read_only_CACHED_PID(&cache->pids, sl)) {
+        struct local_sockets_cached_pid *cp = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(!cp || cp->seen == scan) continue;
+
+        local_sockets_cached_pid_free(cp);
+        simple_hashtable_del_slot_CACHED_PID(&cache->pids, sl);
+    }
+
+    netdata_mutex_unlock(&cache->mutex);
     return true;
 }
 
@@ -722,6 +1024,29 @@ static inline void local_sockets_index_listening_port(LS_STATE *ls, LOCAL_SOCKET
     }
 }
 
+static inline bool local_sockets_find_socket_pid(LS_STATE *ls, LOCAL_SOCKET *n, XXH64_hash_t inode_hash) {
+    SIMPLE_HASHTABLE_SLOT_PID_SOCKET *sl_pid = simple_hashtable_get_slot_PID_SOCKET(&ls->pid_sockets_hashtable, inode_hash, &n->inode, false);
+    struct pid_socket *ps = SIMPLE_HASHTABLE_SLOT_DATA(sl_pid);
+    if(!ps) {
+        // fprintf(stderr, "%d: No PID found for inode %"PRIu64"\n", gettid_uncached(), n->inode);
+        return false;
+    }
+
+    n->net_ns_inode = ps->net_ns_inode;
+    n->pid = ps->pid;
+
+    if(ps->uid != UID_UNSET && n->uid == UID_UNSET)
+        n->uid = ps->uid;
+
+    if(ps->cmdline) {
+        if(n->cmdline) string_freez(n->cmdline);
+        n->cmdline = string_strdupz(ps->cmdline);
+    }
+
+    strncpyz(n->comm, ps->comm, sizeof(n->comm) - 1);
+    return true;
+}
+
 static inline bool local_sockets_add_socket(LS_STATE *ls, LOCAL_SOCKET *tmp) {
     if(!tmp->inode) return false;
 
@@ -750,24 +1075,7 @@ static inline bool local_sockets_add_socket(LS_STATE *ls, LOCAL_SOCKET *tmp) {
 
     // --- look up a pid for it -----------------------------------------------------------------------------------
 
-    SIMPLE_HASHTABLE_SLOT_PID_SOCKET *sl_pid = simple_hashtable_get_slot_PID_SOCKET(&ls->pid_sockets_hashtable, inode_hash, &n->inode, false);
-    struct pid_socket *ps = SIMPLE_HASHTABLE_SLOT_DATA(sl_pid);
-    if(ps) {
-        n->net_ns_inode = ps->net_ns_inode;
-        n->pid = ps->pid;
-
-        if(ps->uid != UID_UNSET && n->uid == UID_UNSET)
-            n->uid = ps->uid;
-
-        if(ps->cmdline) {
-            if(n->cmdline) string_freez(n->cmdline);
-            n->cmdline = string_strdupz(ps->cmdline);
-        }
-
-        strncpyz(n->comm, ps->comm, sizeof(n->comm) - 1);
-    }
-//    else
-//        fprintf(stderr, "%d: No PID found for inode %"PRIu64"\n", gettid_uncached(), n->inode);
+    local_sockets_find_socket_pid(ls, n, inode_hash);
 
     // --- index it -----------------------------------------------------------------------------------------------
 
@@ -1207,6 +1515,14 @@ static inline void local_sockets_init(LS_STATE *ls) {
     ls->tmp_protocol = 0;
 #endif
 
+    ls->pid_cache_scan = 0;
+    if(ls->pid_cache == NULL) {
+        ls->pid_cache = local_sockets_pid_cache_create();
+        ls->pid_cache_is_mine = true;
+    }
+    else
+        ls->pid_cache_is_mine = false;
+
 #if defined(LOCAL_SOCKETS_USE_SETNS)
     if(ls->config.namespaces && ls->spawn_server == NULL) {
         ls->spawn_server = spawn_server_create(SPAWN_SERVER_OPTION_CALLBACK, NULL, local_sockets_spawn_server_callback, 0, NULL);
@@ -1232,6 +1548,12 @@ static inline void local_sockets_cleanup(LS_STATE *ls) {
     }
 #endif
 
+    if(ls->pid_cache_is_mine) {
+        local_sockets_pid_cache_destroy(ls->pid_cache);
+        ls->pid_cache = NULL;
+        ls->pid_cache_is_mine = false;
+    }
+
     // free the sockets hashtable data
     for(SIMPLE_HASHTABLE_SLOT_LOCAL_SOCKET *sl = simple_hashtable_first_read_only_LOCAL_SOCKET(&ls->sockets_hashtable);
          sl;
@@ -1379,6 +1701,186 @@ static inline void local_sockets_read_all_system_sockets(LS_STATE *ls) {
     }
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// sockets found in /proc/net without a process may belong to fds we have cached from a previous
+// call, that have been closed and reopened since then - so, when there are such sockets, the cached
+// fds that may have been reopened are read again, and the owners of all sockets are found again.
+//
+// the fds are read again in stages, stopping as soon as all sockets have a process:
+// 1. the socket fds whose socket is no longer in /proc/net - they have certainly been closed
+// 2. the fds that were not sockets
+// 3. all the other fds - only after this, the sockets without a process are orphans
+
+typedef enum __attribute__((packed)) {
+    LS_REVALIDATE_GONE_SOCKETS = 0,
+    LS_REVALIDATE_NON_SOCKETS,
+    LS_REVALIDATE_ALL,
+} LS_REVALIDATE_STAGE;
+
+static inline bool local_sockets_is_socket_orphan(LS_PID_CACHE *cache, uint64_t inode) {
+    XXH64_hash_t inode_hash = XXH3_64bits(&inode, sizeof(inode));
+    SIMPLE_HASHTABLE_SLOT_ORPHAN_SOCKET *sl = simple_hashtable_get_slot_ORPHAN_SOCKET(&cache->orphans, inode_hash, &inode, false);
+    return SIMPLE_HASHTABLE_SLOT_DATA(sl) != 0;
+}
+
+static inline bool local_sockets_is_socket_listed(LS_STATE *ls, uint64_t inode) {
+    XXH64_hash_t inode_hash = XXH3_64bits(&inode, sizeof(inode));
+    SIMPLE_HASHTABLE_SLOT_LOCAL_SOCKET *sl = simple_hashtable_get_slot_LOCAL_SOCKET(&ls->sockets_hashtable, inode_hash, &inode, false);
+    return SIMPLE_HASHTABLE_SLOT_DATA(sl) != NULL;
+}
+
+// sockets without a process, that were also without a process after the last full revalidation,
+// do not need a revalidation (they may be kernel sockets, or sockets of exited processes)
+static inline size_t local_sockets_unresolved(LS_STATE *ls, LS_PID_CACHE *cache) {
+    size_t unresolved = 0;
+    for(SIMPLE_HASHTABLE_SLOT_LOCAL_SOCKET *sl = simple_hashtable_first_read_only_LOCAL_SOCKET(&ls->sockets_hashtable);
+         sl;
+         sl = simple_hashtable_next_read_only_LOCAL_SOCKET(&ls->sockets_hashtable, sl)) {
+        LOCAL_SOCKET *n = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(n && !n->pid && !local_sockets_is_socket_orphan(cache, n->inode))
+            unresolved++;
+    }
+
+    return unresolved;
+}
+
+static inline void local_sockets_pid_sockets_reset(LS_STATE *ls) {
+    for(SIMPLE_HASHTABLE_SLOT_PID_SOCKET *sl = simple_hashtable_first_read_only_PID_SOCKET(&ls->pid_sockets_hashtable);
+         sl;
+         sl = simple_hashtable_next_read_only_PID_SOCKET(&ls->pid_sockets_hashtable, sl)) {
+        struct pid_socket *ps = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(!ps) continue;
+
+        freez(ps->cmdline);
+        aral_freez(ls->pid_socket_aral, ps);
+    }
+
+    simple_hashtable_destroy_PID_SOCKET(&ls->pid_sockets_hashtable);
+    simple_hashtable_init_PID_SOCKET(&ls->pid_sockets_hashtable, 65535);
+}
+
+// read again the fds of the live processes that have not been read during this call and may
+// have been reopened, according to the stage - returns the number of fds read
+static inline size_t local_sockets_revalidate_fds(LS_STATE *ls, LS_PID_CACHE *cache, const char *path, LS_REVALIDATE_STAGE stage) {
+    size_t reread = 0;
+
+    for(SIMPLE_HASHTABLE_SLOT_CACHED_PID *sl = simple_hashtable_first_read_only_CACHED_PID(&cache->pids);
+         sl;
+         sl = simple_hashtable_next_read_only_CACHED_PID(&cache->pids, sl)) {
+        struct local_sockets_cached_pid *cp = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(!cp || cp->seen < ls->pid_cache_scan) continue;
+
+        for(size_t i = 0; i < cp->fds_used ; i++) {
+            struct local_sockets_cached_fd *cfd = &cp->fds[i];
+
+            if(stage == LS_REVALIDATE_GONE_SOCKETS && cfd->inode) {
+                // sockets not in /proc/net at all (e.g. unix sockets) are never listed,
+                // so that they are not mistaken for closed ones
+                if(local_sockets_is_socket_listed(ls, cfd->inode)) {
+                    cfd->listed = true;
+                    continue;
+                }
+
+                if(!cfd->listed)
+                    continue;
+            }
+            else if(stage == LS_REVALIDATE_NON_SOCKETS && cfd->inode)
+                continue;
+            else if(stage == LS_REVALIDATE_GONE_SOCKETS)
+                continue;
+
+            if(cfd->checked < ls->pid_cache_scan) {
+                local_sockets_cached_fd_reread(ls, path, cp, cfd);
+                reread++;
+            }
+        }
+    }
+
+    return reread;
+}
+
+// find again the owners of all the sockets, and update the sockets that got a different one
+static inline void local_sockets_revalidate_owners(LS_STATE *ls, LS_PID_CACHE *cache, const char *path, usec_t now_ut) {
+    local_sockets_pid_sockets_reset(ls);
+
+    for(SIMPLE_HASHTABLE_SLOT_CACHED_PID *sl = simple_hashtable_first_read_only_CACHED_PID(&cache->pids);
+         sl;
+         sl = simple_hashtable_next_read_only_CACHED_PID(&cache->pids, sl)) {
+        struct local_sockets_cached_pid *cp = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(!cp || cp->seen < ls->pid_cache_scan) continue;
+
+        bool metadata = false;
+        for(size_t i = 0; i < cp->fds_used ; i++) {
+            if(!cp->fds[i].inode)
+                continue;
+
+            if(!metadata) {
+                local_sockets_cached_pid_metadata(ls, path, cp, now_ut);
+                metadata = true;
+            }
+
+            local_sockets_index_pid_socket(ls, path, cp, &cp->fds[i]);
+        }
+    }
+
+    // update the sockets without a process, or with a process that does not own them anymore
+    for(SIMPLE_HASHTABLE_SLOT_LOCAL_SOCKET *sl = simple_hashtable_first_read_only_LOCAL_SOCKET(&ls->sockets_hashtable);
+         sl;
+         sl = simple_hashtable_next_read_only_LOCAL_SOCKET(&ls->sockets_hashtable, sl)) {
+        LOCAL_SOCKET *n = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(!n) continue;
+
+        XXH64_hash_t inode_hash = XXH3_64bits(&n->inode, sizeof(n->inode));
+        SIMPLE_HASHTABLE_SLOT_PID_SOCKET *sl_pid = simple_hashtable_get_slot_PID_SOCKET(&ls->pid_sockets_hashtable, inode_hash, &n->inode, false);
+        struct pid_socket *ps = SIMPLE_HASHTABLE_SLOT_DATA(sl_pid);
+        if(!ps || ps->pid == n->pid)
+            continue;
+
+        string_freez(n->cmdline);
+        n->cmdline = NULL;
+        n->comm[0] = '\0';
+        local_sockets_find_socket_pid(ls, n, inode_hash);
+    }
+}
+
+static inline void local_sockets_revalidate_pids(LS_STATE *ls) {
+    LS_PID_CACHE *cache = ls->pid_cache;
+    char path[FILENAME_MAX + 1];
+
+    netdata_mutex_lock(&cache->mutex);
+
+    if(local_sockets_unresolved(ls, cache)) {
+        snprintfz(path, sizeof(path), "%s/proc", ls->config.host_prefix);
+        usec_t now_ut = now_monotonic_usec();
+
+        for(LS_REVALIDATE_STAGE stage = LS_REVALIDATE_GONE_SOCKETS; stage <= LS_REVALIDATE_ALL ; stage++) {
+            if(local_sockets_revalidate_fds(ls, cache, path, stage))
+                local_sockets_revalidate_owners(ls, cache, path, now_ut);
+
+            if(!local_sockets_unresolved(ls, cache))
+                break;
+        }
+    }
+
+    // remember the sockets that are without a process.
+    // these are either the orphans of the last full revalidation that still exist,
+    // or the sockets no process has, after all the fds have been read again.
+    simple_hashtable_destroy_ORPHAN_SOCKET(&cache->orphans);
+    simple_hashtable_init_ORPHAN_SOCKET(&cache->orphans, 1024);
+    for(SIMPLE_HASHTABLE_SLOT_LOCAL_SOCKET *sl = simple_hashtable_first_read_only_LOCAL_SOCKET(&ls->sockets_hashtable);
+         sl;
+         sl = simple_hashtable_next_read_only_LOCAL_SOCKET(&ls->sockets_hashtable, sl)) {
+        LOCAL_SOCKET *n = SIMPLE_HASHTABLE_SLOT_DATA(sl);
+        if(!n || n->pid) continue;
+
+        XXH64_hash_t inode_hash = XXH3_64bits(&n->inode, sizeof(n->inode));
+        SIMPLE_HASHTABLE_SLOT_ORPHAN_SOCKET *sl_orphan = simple_hashtable_get_slot_ORPHAN_SOCKET(&cache->orphans, inode_hash, &n->inode, true);
+        simple_hashtable_set_slot_ORPHAN_SOCKET(&cache->orphans, sl_orphan, inode_hash, n->inode);
+    }
+
+    netdata_mutex_unlock(&cache->mutex);
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // switch namespaces to read namespace sockets
 
@@ -1805,6 +2307,12 @@ static inline void local_sockets_process(LS_STATE *ls) {
 #endif
     }
 
+    // find the processes of the sockets that appeared since the pid cache was refreshed
+    if(!ls->pid_cache_is_mine && ls->pid_cache_scan) {
+        local_sockets_track_time(ls, "proc_revalidate_pids");
+        local_sockets_revalidate_pids(ls);
+    }
+
     // detect the directions of the sockets
     if(ls->config.inbound || ls->config.outbound || ls->config.local) {
         local_sockets_track_time(ls, "detect_direction");
@@ -53,6 +53,148 @@ char *procfile_filename(procfile *ff) {
     return ff->filename;
 }
 
+// ----------------------------------------------------------------------------
+// file descriptors cache
+//
+// Pseudo-files regenerate their contents on every read from offset 0, so they
+// can be opened once and read with pread() forever after, saving the path lookup,
+// the open() and the close() of each iteration. The descriptors are shared among
+// all readers of the same filename, so they are never seeked.
+// A descriptor is closed when reading it fails (the file is gone) or when its
+// owner forgets it (e.g. the cgroup it belongs to has been removed).
+
+struct procfile_fd_cache_entry {
+    int fd;
+};
+
+static struct {
+    SPINLOCK spinlock;
+    DICTIONARY *dict;
+    size_t max_entries;
+} pf_fd_cache = {
+    .spinlock = SPINLOCK_INITIALIZER,
+};
+
+static void procfile_fd_cache_delete_cb(const DICTIONARY_ITEM *item __maybe_unused, void *value, void *data __maybe_unused) {
+    struct procfile_fd_cache_entry *e = value;
+    if(e->fd != -1)
+        close(e->fd);
+}
+
+static bool procfile_fd_cache_conflict_cb(const DICTIONARY_ITEM *item __maybe_unused, void *old_value __maybe_unused, void *new_value, void *data __maybe_unused) {
+    // another thread opened the same file concurrently - keep the first descriptor
+    struct procfile_fd_cache_entry *e = new_value;
+    close(e->fd);
+    return false;
+}
+
+static DICTIONARY *procfile_fd_cache_dict(void) {
+    DICTIONARY *dict = __atomic_load_n(&pf_fd_cache.dict, __ATOMIC_ACQUIRE);
+    if(likely(dict))
+        return dict;
+
+    spinlock_lock(&pf_fd_cache.spinlock);
+    dict = pf_fd_cache.dict;
+    if(!dict) {
+        // leave plenty of descriptors for everything else
+        pf_fd_cache.max_entries = (size_t)rlimit_nofile.rlim_cur / 4;
+        if(pf_fd_cache.max_entries < 64)
+            pf_fd_cache.max_entries = 64;
+
+        dict = dictionary_create_advanced(DICT_OPTION_DONT_OVERWRITE_VALUE | DICT_OPTION_FIXED_SIZE,
+                                          NULL, sizeof(struct procfile_fd_cache_entry));
+        dictionary_register_delete_callback(dict, procfile_fd_cache_delete_cb, NULL);
+        dictionary_register_conflict_callback(dict, procfile_fd_cache_conflict_cb, NULL);
+        __atomic_store_n(&pf_fd_cache.dict, dict, __ATOMIC_RELEASE);
+    }
+    spinlock_unlock(&pf_fd_cache.spinlock);
+
+    return dict;
+}
+
+const DICTIONARY_ITEM *procfile_fd_cache_acquire(const char *filename, int *fd) {
+    DICTIONARY *dict = procfile_fd_cache_dict();
+
+    const DICTIONARY_ITEM *item = dictionary_get_and_acquire_item(dict, filename);
+    if(!item) {
+        int new_fd = open(filename, procfile_open_flags, 0666);
+        if(unlikely(new_fd == -1)) {
+            *fd = -1;
+            return NULL;
+        }
+
+        if(unlikely(dictionary_entries(dict) >= pf_fd_cache.max_entries)) {
+            *fd = new_fd;
+            return NULL;
+        }
+
+        struct procfile_fd_cache_entry e = { .fd = new_fd };
+        item = dictionary_set_and_acquire_item(dict, filename, &e, sizeof(e));
+    }
+
+    struct procfile_fd_cache_entry *e = dictionary_acquired_item_value(item);
+    *fd = e->fd;
+    return item;
+}
+
+void procfile_fd_cache_release(const DICTIONARY_ITEM *item, bool failed) {
+    if(!item) return;
+
+    DICTIONARY *dict = pf_fd_cache.dict;
+
+    // delete this entry only - another reader may have already replaced it with a new descriptor
+    if(unlikely(failed))
+        dictionary_acquired_item_del(dict, item);
+
+    dictionary_acquired_item_release(dict, item);
+}
+
+void procfile_fd_cache_forget(const char *filename) {
+    DICTIONARY *dict = __atomic_load_n(&pf_fd_cache.dict, __ATOMIC_ACQUIRE);
+    if(!dict || !filename || !*filename) return;
+    dictionary_del(dict, filename);
+}
+
+int read_txt_file_cached(const char *filename, char *buffer, size_t size) {
+    if(unlikely(!size)) return 3;
+
+    int fd;
+    const DICTIONARY_ITEM *item = procfile_fd_cache_acquire(filename, &fd);
+    if(unlikely(fd == -1)) {
+        buffer[0] = '\0';
+        return 1;
+    }
+
+    ssize_t r = pread(fd, buffer, size - 1, 0); // leave space of the final zero
+
+    if(item)
+        procfile_fd_cache_release(item, r == -1);
+    else
+        close(fd);
+
+    if(unlikely(r == -1)) {
+        buffer[0] = '\0';
+        return 2;
+    }
+    buffer[r] = '\0';
+
+    return 0;
+}
+
+int read_single_number_file_cached(const char *filename, unsigned long long *result) {
+    char buffer[30 + 1];
+
+    int ret = read_txt_file_cached(filename, buffer, sizeof(buffer));
+    if(unlikely(ret)) {
+        *result = 0;
+        return ret;
+    }
+
+    buffer[30] = '\0';
+    *result = str2ull(buffer, NULL);
+    return 0;
+}
+
 // ----------------------------------------------------------------------------
 // An array of words
 
@@ -154,6 +296,27 @@ static inline void procfile_lines_free(pflines *fl) {
 // ----------------------------------------------------------------------------
 // The procfile
 
+static void procfile_close_fd(procfile *ff, bool failed) {
+    if(ff->fd_item)
+        procfile_fd_cache_release(ff->fd_item, failed);
+    else if(likely(ff->fd != -1))
+        close(ff->fd);
+
+    ff->fd_item = NULL;
+    ff->fd = -1;
+}
+
+static int procfile_open_fd(procfile *ff, const char *filename, uint32_t flags) {
+    ff->fd_item = NULL;
+
+    if(flags & PROCFILE_FLAG_CACHED_FD)
+        ff->fd_item = procfile_fd_cache_acquire(filename, &ff->fd);
+    else
+        ff->fd = open(filename, procfile_open_flags, 0666);
+
+    return ff->fd;
+}
+
 void procfile_close(procfile *ff) {
     if(unlikely(!ff)) return;
 
@@ -163,7 +326,7 @@ void procfile_close(procfile *ff) {
     procfile_lines_free(ff->lines);
     procfile_words_free(ff->words);
 
-    if(likely(ff->fd != -1)) close(ff->fd);
+    procfile_close_fd(ff, false);
     freez(ff);
 }
 
@@ -316,11 +479,15 @@ procfile *procfile_readall(procfile *ff) {
 
         // netdata_log_info("Reading file '%s', from position %zd with length %zd", procfile_filename(ff), s, (ssize_t)(ff->size - s));
         ff->stats.reads++;
-        r = read(ff->fd, &ff->data[s], ff->size - s);
+        if(ff->fd_item)
+            r = pread(ff->fd, &ff->data[s], ff->size - s, s);
+        else
+            r = read(ff->fd, &ff->data[s], ff->size - s);
         if(unlikely(r == -1)) {
             if(unlikely(!(ff->flags & PROCFILE_FLAG_NO_ERROR_ON_FILE_IO))) collector_error(PF_PREFIX ": Cannot read from file '%s' on fd %d", procfile_filename(ff), ff->fd);
             else if(unlikely(ff->flags & PROCFILE_FLAG_ERROR_ON_ERROR_LOG))
                 netdata_log_error(PF_PREFIX ": Cannot read from file '%s' on fd %d", procfile_filename(ff), ff->fd);
+            procfile_close_fd(ff, true);
             procfile_close(ff);
             return NULL;
         }
@@ -332,7 +499,8 @@ procfile *procfile_readall(procfile *ff) {
     }
 
     // netdata_log_debug(D_PROCFILE, "Rewinding file '%s'", ff->filename);
-    if(unlikely(lseek(ff->fd, 0, SEEK_SET) == -1)) {
+    // cached descriptors are shared and only read with pread(), so they are never rewound
+    if(unlikely(!ff->fd_item && lseek(ff->fd, 0, SEEK_SET) == -1)) {
         if(unlikely(!(ff->flags & PROCFILE_FLAG_NO_ERROR_ON_FILE_IO))) collector_error(PF_PREFIX ": Cannot rewind on file '%s'.", procfile_filename(ff));
         else if(unlikely(ff->flags & PROCFILE_FLAG_ERROR_ON_ERROR_LOG))
             netdata_log_error(PF_PREFIX ": Cannot rewind on file '%s'.", procfile_filename(ff));
@@ -441,7 +609,13 @@ void procfile_set_open_close(procfile *ff, const char *open, const char *close)
 procfile *procfile_open(const char *filename, const char *separators, uint32_t flags) {
     netdata_log_debug(D_PROCFILE, PF_PREFIX ": Opening file '%s'", filename);
 
-    int fd = open(filename, procfile_open_flags, 0666);
+    int fd;
+    const DICTIONARY_ITEM *fd_item = NULL;
+    if(flags & PROCFILE_FLAG_CACHED_FD)
+        fd_item = procfile_fd_cache_acquire(filename, &fd);
+    else
+        fd = open(filename, procfile_open_flags, 0666);
+
     if(unlikely(fd == -1)) {
         if (unlikely(flags & PROCFILE_FLAG_ERROR_ON_ERROR_LOG))
             netdata_log_error(PF_PREFIX ": Cannot open file '%s'", filename);
@@ -462,6 +636,7 @@ procfile *procfile_open(const char *filename, const char *separators, uint32_t f
     //strncpyz(ff->filename, filename, FILENAME_MAX);
     ff->filename = NULL;
     ff->fd = fd;
+    ff->fd_item = fd_item;
     ff->size = size;
     ff->len = 0;
     ff->flags = flags;
@@ -486,13 +661,10 @@ procfile *procfile_open(const char *filename, const char *separators, uint32_t f
 procfile *procfile_reopen(procfile *ff, const char *filename, const char *separators, uint32_t flags) {
     if(unlikely(!ff)) return procfile_open(filename, separators, flags);
 
-    if(likely(ff->fd != -1)) {
-        // netdata_log_info("PROCFILE: closing fd %d", ff->fd);
-        close(ff->fd);
-    }
+    // netdata_log_info("PROCFILE: closing fd %d", ff->fd);
+    procfile_close_fd(ff, false);
 
-    ff->fd = open(filename, procfile_open_flags, 0666);
-    if(unlikely(ff->fd == -1)) {
+    if(unlikely(procfile_open_fd(ff, filename, flags) == -1)) {
         procfile_close(ff);
         return NULL;
     }
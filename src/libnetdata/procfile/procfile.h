@@ -36,6 +36,7 @@ typedef struct {
 #define PROCFILE_FLAG_DEFAULT             0x00000000 // To store inside `collector.log`
 #define PROCFILE_FLAG_NO_ERROR_ON_FILE_IO 0x00000001 // Do not log anything
 #define PROCFILE_FLAG_ERROR_ON_ERROR_LOG  0x00000002 // Store inside `error.log`
+#define PROCFILE_FLAG_CACHED_FD           0x00000004 // Keep the file open in the file descriptors cache
 
 typedef enum __attribute__ ((__packed__)) procfile_separator {
     PF_CHAR_IS_SEPARATOR,
@@ -65,6 +66,7 @@ typedef struct procfile {
     char *filename;                 // not populated until procfile_filename() is called
     uint32_t flags;
     int fd;                         // the file descriptor
+    const struct dictionary_item *fd_item; // the file descriptors cache item owning fd, or NULL
     size_t len;                     // the bytes we have placed into data
     size_t size;                    // the bytes we have allocated for data
     pflines *lines;
@@ -103,6 +105,28 @@ extern int procfile_open_flags;
 // call this with true and the expected initial sizes to allow procfile learn the sizes needed
 void procfile_set_adaptive_allocation(bool enable, size_t bytes, size_t lines, size_t words);
 
+// ----------------------------------------------------------------------------
+// file descriptors cache
+// keeps pseudo-files (cgroupfs, procfs, sysfs) open and re-reads them with pread() from offset 0
+
+// acquire the cached descriptor of filename, opening it if it is not already open
+// returns the cache item (release it with procfile_fd_cache_release()) and sets *fd
+// when the cache is full, returns NULL and *fd is an uncached descriptor the caller has to close()
+// when the file cannot be opened, returns NULL and *fd is -1
+const struct dictionary_item *procfile_fd_cache_acquire(const char *filename, int *fd);
+
+// release an acquired descriptor - when failed is true, the descriptor is also removed from the cache
+void procfile_fd_cache_release(const struct dictionary_item *item, bool failed);
+
+// close the cached descriptor of filename, if any (e.g. when the cgroup it belongs to is removed)
+void procfile_fd_cache_forget(const char *filename);
+
+// the equivalents of read_txt_file() and read_single_number_file(), reading via the cache
+int read_txt_file_cached(const char *filename, char *buffer, size_t size);
+int read_single_number_file_cached(const char *filename, unsigned long long *result);
+
+// ----------------------------------------------------------------------------
+
 // return the number of lines present
 #define procfile_lines(ff) ((ff)->lines->len)
 
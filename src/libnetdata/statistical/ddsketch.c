@@ -0,0 +1,322 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "../libnetdata.h"
+
+#define DDSKETCH_INITIAL_BINS 64
+
+// --------------------------------------------------------------------------------------------------------------------
+// stores - dense arrays of bins, growing towards the indexes added
+// bins outside [min_index, max_index] are always zero
+
+static void ddsketch_store_free(DDSKETCH_STORE *st) {
+    freez(st->bins);
+    memset(st, 0, sizeof(*st));
+    st->empty = true;
+}
+
+static void ddsketch_store_reset(DDSKETCH_STORE *st) {
+    if(!st->empty)
+        memset(&st->bins[st->min_index - st->offset], 0, (st->max_index - st->min_index + 1) * sizeof(*st->bins));
+
+    st->empty = true;
+}
+
+// make [lo, hi] addressable, keeping the bins of [min_index, max_index], which have to be within [lo, hi]
+static void ddsketch_store_ensure(DDSKETCH_STORE *st, int32_t lo, int32_t hi, uint32_t max_bins) {
+    if(st->bins && lo >= st->offset && hi < st->offset + (int32_t)st->size)
+        return;
+
+    uint32_t needed = (uint32_t)(hi - lo + 1);
+    uint32_t size = st->size ? st->size : DDSKETCH_INITIAL_BINS;
+    while(size < needed)
+        size *= 2;
+
+    if(size > max_bins)
+        size = max_bins;
+
+    // leave the free bins on the side we are growing to
+    int32_t offset = (st->bins && lo < st->offset) ? hi - (int32_t)size + 1 : lo;
+
+    NETDATA_DOUBLE *bins = callocz(size, sizeof(*bins));
+    if(!st->empty)
+        memcpy(&bins[st->min_index - offset], &st->bins[st->min_index - st->offset],
+               (st->max_index - st->min_index + 1) * sizeof(*bins));
+
+    freez(st->bins);
+    st->bins = bins;
+    st->size = size;
+    st->offset = offset;
+}
+
+static void ddsketch_store_add(DDSKETCH_STORE *st, int32_t index, NETDATA_DOUBLE weight, uint32_t max_bins) {
+    if(unlikely(st->empty)) {
+        ddsketch_store_ensure(st, index, index, max_bins);
+        st->min_index = st->max_index = index;
+        st->empty = false;
+    }
+    else if(unlikely(index < st->min_index)) {
+        // too small for the bins we can have, count it in the lowest one
+        if(st->max_index - index >= (int32_t)max_bins)
+            index = st->max_index - (int32_t)max_bins + 1;
+
+        ddsketch_store_ensure(st, index, st->max_index, max_bins);
+        st->min_index = index;
+    }
+    else if(unlikely(index > st->max_index)) {
+        if(index - st->min_index >= (int32_t)max_bins) {
+            // collapse the lowest bins, to make room for this index
+            int32_t min_index = index - (int32_t)max_bins + 1;
+            int32_t last = MIN(min_index - 1, st->max_index);
+
+            NETDATA_DOUBLE collapsed = 0;
+            for(int32_t i = st->min_index; i <= last; i++) {
+                collapsed += st->bins[i - st->offset];
+                st->bins[i - st->offset] = 0;
+            }
+
+            if(min_index > st->max_index)
+                st->empty = true;
+            else
+                st->min_index = min_index;
+
+            ddsketch_store_ensure(st, min_index, index, max_bins);
+            st->bins[min_index - st->offset] += collapsed;
+
+            if(st->empty) {
+                st->min_index = min_index;
+                st->empty = false;
+            }
+        }
+        else
+            ddsketch_store_ensure(st, st->min_index, index, max_bins);
+
+        st->max_index = index;
+    }
+
+    st->bins[index - st->offset] += weight;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// logarithmic mapping of values to indexes
+
+static inline int32_t ddsketch_index(const DDSKETCH *s, NETDATA_DOUBLE magnitude) {
+    return (int32_t)ceil(log(magnitude) * s->multiplier);
+}
+
+// the value with the lowest relative error to all the values of the bin (gamma^(i-1), gamma^i]
+static inline NETDATA_DOUBLE ddsketch_value(const DDSKETCH *s, int32_t index) {
+    return 2.0 * pow(s->gamma, (NETDATA_DOUBLE)index) / (s->gamma + 1.0);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void ddsketch_init(DDSKETCH *s, NETDATA_DOUBLE relative_accuracy, uint32_t max_bins) {
+    if(!(relative_accuracy > 0 && relative_accuracy < 1))
+        relative_accuracy = DDSKETCH_DEFAULT_RELATIVE_ACCURACY;
+
+    if(max_bins < 2)
+        max_bins = DDSKETCH_DEFAULT_MAX_BINS;
+
+    memset(s, 0, sizeof(*s));
+    s->gamma = (1.0 + relative_accuracy) / (1.0 - relative_accuracy);
+    s->multiplier = 1.0 / log(s->gamma);
+    s->min_indexable = DBL_MIN * s->gamma;
+    s->max_bins = max_bins;
+    s->positive.empty = true;
+    s->negative.empty = true;
+    ddsketch_reset(s);
+}
+
+void ddsketch_destroy(DDSKETCH *s) {
+    ddsketch_store_free(&s->positive);
+    ddsketch_store_free(&s->negative);
+}
+
+void ddsketch_reset(DDSKETCH *s) {
+    ddsketch_store_reset(&s->positive);
+    ddsketch_store_reset(&s->negative);
+    s->zero_count = 0;
+    s->count = 0;
+    s->sum = 0;
+    s->min = NAN;
+    s->max = NAN;
+    s->mean = 0;
+    s->m2 = 0;
+}
+
+void ddsketch_add(DDSKETCH *s, NETDATA_DOUBLE value, NETDATA_DOUBLE weight) {
+    if(unlikely(!netdata_double_isnumber(value) || !(weight > 0)))
+        return;
+
+    if(value > s->min_indexable)
+        ddsketch_store_add(&s->positive, ddsketch_index(s, value), weight, s->max_bins);
+    else if(value < -s->min_indexable)
+        ddsketch_store_add(&s->negative, ddsketch_index(s, -value), weight, s->max_bins);
+    else
+        s->zero_count += weight;
+
+    if(unlikely(s->count == 0))
+        s->min = s->max = value;
+    else if(value < s->min)
+        s->min = value;
+    else if(value > s->max)
+        s->max = value;
+
+    s->count += weight;
+    s->sum += value * weight;
+
+    NETDATA_DOUBLE delta = value - s->mean;
+    s->mean += delta * weight / s->count;
+    s->m2 += weight * delta * (value - s->mean);
+}
+
+NETDATA_DOUBLE ddsketch_quantile(const DDSKETCH *s, NETDATA_DOUBLE q) {
+    if(unlikely(!(s->count > 0)))
+        return NAN;
+
+    if(q <= 0)
+        return s->min;
+
+    if(q >= 1)
+        return s->max;
+
+    NETDATA_DOUBLE rank = q * (s->count - 1);
+    NETDATA_DOUBLE value = s->max;
+    NETDATA_DOUBLE n = 0;
+
+    // from the most negative to the most positive value
+    if(!s->negative.empty) {
+        for(int32_t i = s->negative.max_index; i >= s->negative.min_index; i--) {
+            n += s->negative.bins[i - s->negative.offset];
+            if(n > rank) {
+                value = -ddsketch_value(s, i);
+                goto found;
+            }
+        }
+    }
+
+    n += s->zero_count;
+    if(n > rank) {
+        value = 0;
+        goto found;
+    }
+
+    if(!s->positive.empty) {
+        for(int32_t i = s->positive.min_index; i <= s->positive.max_index; i++) {
+            n += s->positive.bins[i - s->positive.offset];
+            if(n > rank) {
+                value = ddsketch_value(s, i);
+                goto found;
+            }
+        }
+    }
+
+found:
+    // the exact min and max are better than any bin
+    return fmax(s->min, fmin(s->max, value));
+}
+
+NETDATA_DOUBLE ddsketch_stddev(const DDSKETCH *s) {
+    if(unlikely(!(s->count > 0)))
+        return NAN;
+
+    return sqrtndd(s->m2 / s->count);
+}
+
+size_t ddsketch_memory(const DDSKETCH *s) {
+    return sizeof(*s) + (s->positive.size + s->negative.size) * sizeof(NETDATA_DOUBLE);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// unittest
+
+static int ddsketch_unittest_check(const char *name, NETDATA_DOUBLE expected, NETDATA_DOUBLE found, NETDATA_DOUBLE relative_error) {
+    NETDATA_DOUBLE error = (expected == 0) ? fabs(found) : fabs((found - expected) / expected);
+    if(error > relative_error || isnan(found)) {
+        fprintf(stderr, "DDSKETCH: %s expected " NETDATA_DOUBLE_FORMAT ", got " NETDATA_DOUBLE_FORMAT " (relative error %0.5f)\n",
+                name, expected, found, (double)error);
+        return 1;
+    }
+    return 0;
+}
+
+int ddsketch_unittest(void) {
+    int errors = 0;
+    DDSKETCH s;
+    ddsketch_init(&s, 0.01, DDSKETCH_DEFAULT_MAX_BINS);
+
+    fprintf(stderr, "\nDDSKETCH: testing quantiles of 1..100000\n");
+    {
+        size_t entries = 100000;
+        for(size_t i = 1; i <= entries; i++)
+            ddsketch_add(&s, (NETDATA_DOUBLE)i, 1.0);
+
+        NETDATA_DOUBLE *series = mallocz(entries * sizeof(NETDATA_DOUBLE));
+        for(size_t i = 0; i < entries; i++)
+            series[i] = (NETDATA_DOUBLE)(i + 1);
+
+        NETDATA_DOUBLE qs[] = { 0.0, 0.01, 0.25, 0.5, 0.75, 0.95, 0.99, 0.999, 1.0 };
+        for(size_t i = 0; i < _countof(qs); i++) {
+            char name[50];
+            snprintfz(name, sizeof(name), "quantile %0.3f", qs[i]);
+            errors += ddsketch_unittest_check(name, percentile_on_sorted_series(series, entries, qs[i]), ddsketch_quantile(&s, qs[i]), 0.011);
+        }
+
+        errors += ddsketch_unittest_check("min", 1, s.min, 0);
+        errors += ddsketch_unittest_check("max", (NETDATA_DOUBLE)entries, s.max, 0);
+        errors += ddsketch_unittest_check("average", average(series, entries), ddsketch_average(&s), 1e-9);
+        errors += ddsketch_unittest_check("stddev", standard_deviation(series, entries), ddsketch_stddev(&s), 1e-9);
+
+        if(s.positive.size > s.max_bins) {
+            fprintf(stderr, "DDSKETCH: %u bins allocated, more than the %u allowed\n", s.positive.size, s.max_bins);
+            errors++;
+        }
+
+        freez(series);
+    }
+
+    fprintf(stderr, "DDSKETCH: testing negative values, zeros and weights\n");
+    {
+        ddsketch_reset(&s);
+
+        // -100 x 10, 0 x 20, 100 x 70 (7 samples with sampling rate 0.1)
+        for(size_t i = 0; i < 10; i++)
+            ddsketch_add(&s, -100, 1.0);
+        for(size_t i = 0; i < 20; i++)
+            ddsketch_add(&s, 0, 1.0);
+        for(size_t i = 0; i < 7; i++)
+            ddsketch_add(&s, 100, 10.0);
+
+        errors += ddsketch_unittest_check("count", 100, s.count, 0);
+        errors += ddsketch_unittest_check("sum", 6000, s.sum, 0);
+        errors += ddsketch_unittest_check("quantile 0.05", -100, ddsketch_quantile(&s, 0.05), 0.01);
+        errors += ddsketch_unittest_check("quantile 0.2", 0, ddsketch_quantile(&s, 0.2), 0.01);
+        errors += ddsketch_unittest_check("quantile 0.5", 100, ddsketch_quantile(&s, 0.5), 0.01);
+    }
+
+    fprintf(stderr, "DDSKETCH: testing that memory is bounded\n");
+    {
+        DDSKETCH small;
+        ddsketch_init(&small, 0.01, 128);
+
+        // 1e-6 to 1e6 needs about 1400 bins
+        for(NETDATA_DOUBLE v = 1e-6; v < 1e6; v *= 1.001)
+            ddsketch_add(&small, v, 1.0);
+
+        if(small.positive.size > 128) {
+            fprintf(stderr, "DDSKETCH: %u bins allocated, more than the 128 allowed\n", small.positive.size);
+            errors++;
+        }
+
+        // the high quantiles are still accurate
+        errors += ddsketch_unittest_check("quantile 0.99 after collapsing", small.max * pow(1.001, -0.01 * (small.count - 1)), ddsketch_quantile(&small, 0.99), 0.02);
+        errors += ddsketch_unittest_check("max after collapsing", small.max, ddsketch_quantile(&small, 1.0), 0);
+
+        ddsketch_destroy(&small);
+    }
+
+    ddsketch_destroy(&s);
+
+    fprintf(stderr, "DDSKETCH: %d errors\n", errors);
+    return errors;
+}
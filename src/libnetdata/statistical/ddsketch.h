@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_DDSKETCH_H
+#define NETDATA_DDSKETCH_H 1
+
+#include "../libnetdata.h"
+
+// DDSketch - a quantile sketch with relative error guarantees
+// (Masson, Rim, Lee - VLDB 2019)
+//
+// Values are counted in logarithmically sized bins, so that any quantile
+// is returned with a relative error of at most `relative_accuracy`.
+// Adding a value is O(1) and memory is bounded by `max_bins` per sign.
+// When the range of values needs more bins than that, the bins of the
+// smallest magnitudes are collapsed together. With 1% accuracy, 2048 bins
+// cover more than 17 orders of magnitude, so this is rare.
+//
+// The sketch also keeps the exact count, sum, min, max and variance
+// of the values added. Values have weights, so that sampled values
+// can be counted as many times as they represent.
+
+#define DDSKETCH_DEFAULT_RELATIVE_ACCURACY 0.01
+#define DDSKETCH_DEFAULT_MAX_BINS 2048
+
+typedef struct ddsketch_store {
+    bool empty;
+    int32_t offset;                 // the index of bins[0]
+    int32_t min_index;              // the lowest index with a value
+    int32_t max_index;              // the highest index with a value
+    uint32_t size;                  // the number of allocated bins
+    NETDATA_DOUBLE *bins;
+} DDSKETCH_STORE;
+
+typedef struct ddsketch {
+    NETDATA_DOUBLE gamma;
+    NETDATA_DOUBLE multiplier;      // 1 / ln(gamma)
+    NETDATA_DOUBLE min_indexable;   // smaller magnitudes are counted as zero
+    uint32_t max_bins;
+
+    DDSKETCH_STORE positive;
+    DDSKETCH_STORE negative;        // indexed by the magnitude of the values
+    NETDATA_DOUBLE zero_count;
+
+    NETDATA_DOUBLE count;
+    NETDATA_DOUBLE sum;
+    NETDATA_DOUBLE min;
+    NETDATA_DOUBLE max;
+
+    // weighted Welford's algorithm
+    NETDATA_DOUBLE mean;
+    NETDATA_DOUBLE m2;
+} DDSKETCH;
+
+void ddsketch_init(DDSKETCH *s, NETDATA_DOUBLE relative_accuracy, uint32_t max_bins);
+void ddsketch_destroy(DDSKETCH *s);
+
+// forget all values, keeping the memory allocated
+void ddsketch_reset(DDSKETCH *s);
+
+void ddsketch_add(DDSKETCH *s, NETDATA_DOUBLE value, NETDATA_DOUBLE weight);
+
+// q is 0.0 to 1.0 - returns NAN when the sketch is empty
+NETDATA_DOUBLE ddsketch_quantile(const DDSKETCH *s, NETDATA_DOUBLE q);
+
+// population standard deviation - returns NAN when the sketch is empty
+NETDATA_DOUBLE ddsketch_stddev(const DDSKETCH *s);
+
+static inline NETDATA_DOUBLE ddsketch_average(const DDSKETCH *s) {
+    return (s->count > 0) ? s->sum / s->count : NAN;
+}
+
+size_t ddsketch_memory(const DDSKETCH *s);
+
+int ddsketch_unittest(void);
+
+#endif //NETDATA_DDSKETCH_H
@@ -123,5 +123,59 @@ typedef struct storage_point {
 #define storage_point_average_value(sp) \
     ((sp).count ? (sp).sum / (NETDATA_DOUBLE)((sp).count) : 0.0)
 
+// --------------------------------------------------------------------------------------------------------------------
+// a columnar batch of points, filled by the storage engines in one call
+
+#define STORAGE_POINTS_BATCH_SIZE 128
+
+typedef struct storage_points_batch {
+    uint32_t used;          // the number of points the storage engine filled
+    uint32_t position;      // the next point the caller will consume
+
+    time_t start_time_s[STORAGE_POINTS_BATCH_SIZE];
+    time_t end_time_s[STORAGE_POINTS_BATCH_SIZE];
+
+    NETDATA_DOUBLE min[STORAGE_POINTS_BATCH_SIZE];
+    NETDATA_DOUBLE max[STORAGE_POINTS_BATCH_SIZE];
+    NETDATA_DOUBLE sum[STORAGE_POINTS_BATCH_SIZE];
+
+    uint32_t count[STORAGE_POINTS_BATCH_SIZE];
+    uint32_t anomaly_count[STORAGE_POINTS_BATCH_SIZE];
+
+    SN_FLAGS flags[STORAGE_POINTS_BATCH_SIZE];
+} STORAGE_POINTS_BATCH;
+
+#define storage_points_batch_reset(b) do { (b)->used = (b)->position = 0; } while(0)
+#define storage_points_batch_is_empty(b) ((b)->position >= (b)->used)
+
+#define storage_points_batch_set(b, i, sp) do {         \
+    (b)->start_time_s[i] = (sp).start_time_s;           \
+    (b)->end_time_s[i] = (sp).end_time_s;               \
+    (b)->min[i] = (sp).min;                             \
+    (b)->max[i] = (sp).max;                             \
+    (b)->sum[i] = (sp).sum;                             \
+    (b)->count[i] = (sp).count;                         \
+    (b)->anomaly_count[i] = (sp).anomaly_count;         \
+    (b)->flags[i] = (sp).flags;                         \
+} while(0)
+
+#define storage_points_batch_set_empty(b, i) do {       \
+    (b)->min[i] = (b)->max[i] = (b)->sum[i] = NAN;      \
+    (b)->count[i] = 1;                                  \
+    (b)->anomaly_count[i] = 0;                          \
+    (b)->flags[i] = SN_FLAG_NONE;                       \
+} while(0)
+
+#define storage_points_batch_get(b, i, sp) do {         \
+    (sp).start_time_s = (b)->start_time_s[i];           \
+    (sp).end_time_s = (b)->end_time_s[i];               \
+    (sp).min = (b)->min[i];                             \
+    (sp).max = (b)->max[i];                             \
+    (sp).sum = (b)->sum[i];                             \
+    (sp).count = (b)->count[i];                         \
+    (sp).anomaly_count = (b)->anomaly_count[i];         \
+    (sp).flags = (b)->flags[i];                         \
+} while(0)
+
 
 #endif //NETDATA_STORAGE_POINT_H
@@ -169,3 +169,154 @@ __attribute__((constructor)) void initialize_lut(void) {
         unpack_storage_number_lut10x[3 * 8 + i] = pow(100, i);       // exp = 1
     }
 }
+
+// ----------------------------------------------------------------------------
+// bulk unpacking of storage numbers into columns
+// the results are identical to calling unpack_storage_number() for each value
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(NETDATA_WITH_LONG_DOUBLE)
+#define STORAGE_NUMBER_SIMD_X86_64 1
+#include <immintrin.h>
+#endif
+
+ALWAYS_INLINE_HOT
+static void storage_number_unpack_array_scalar(const storage_number *src, size_t entries, NETDATA_DOUBLE *values, SN_FLAGS *flags, uint32_t *anomaly_count) {
+    for(size_t i = 0; i < entries ;i++) {
+        storage_number n = src[i];
+        values[i] = unpack_storage_number(n);
+        flags[i] = (SN_FLAGS)(n & SN_USER_FLAGS);
+        anomaly_count[i] = is_storage_number_anomalous(n) ? 1 : 0;
+    }
+}
+
+ALWAYS_INLINE_HOT
+static void storage_number_tier1_unpack_array_scalar(const storage_number_tier1_t *src, size_t entries, NETDATA_DOUBLE *min, NETDATA_DOUBLE *max, NETDATA_DOUBLE *sum, uint32_t *count, uint32_t *anomaly_count, SN_FLAGS *flags) {
+    for(size_t i = 0; i < entries ;i++) {
+        storage_number_tier1_t n = src[i];
+        min[i] = n.min_value;
+        max[i] = n.max_value;
+        sum[i] = n.sum_value;
+        count[i] = n.count;
+        anomaly_count[i] = n.anomaly_count;
+        flags[i] = n.anomaly_count ? SN_FLAG_NONE : SN_FLAG_NOT_ANOMALOUS;
+    }
+}
+
+#ifdef STORAGE_NUMBER_SIMD_X86_64
+
+_Static_assert(sizeof(SN_FLAGS) == sizeof(uint32_t), "SN_FLAGS are stored as 32-bit lanes");
+_Static_assert(sizeof(storage_number_tier1_t) == 4 * sizeof(float), "tier1 points are loaded as 4 floats");
+
+// 4 storage numbers per iteration, the lookup table is gathered
+__attribute__((target("avx2")))
+static void storage_number_unpack_array_avx2(const storage_number *src, size_t entries, NETDATA_DOUBLE *values, SN_FLAGS *flags, uint32_t *anomaly_count) {
+    const __m128i empty = _mm_set1_epi32((int)SN_EMPTY_SLOT);
+    const __m128i value_mask = _mm_set1_epi32(0x00ffffff);
+    const __m128i exp_mul_mask = _mm_set1_epi32(0x0f);
+    const __m128i factor_mask = _mm_set1_epi32(0x10);
+    const __m128i user_flags = _mm_set1_epi32((int)SN_USER_FLAGS);
+    const __m128i not_anomalous = _mm_set1_epi32((int)SN_FLAG_NOT_ANOMALOUS);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m256d nan = _mm256_set1_pd(NAN);
+
+    size_t i = 0;
+    for(; i + 4 <= entries ; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&src[i]);
+        __m128i is_empty = _mm_cmpeq_epi32(v, empty);
+
+        // the lookup table index: factor (bit 26) * 16 + exp (bit 30) * 8 + mul (bits 27-29)
+        __m128i idx = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(v, 22), factor_mask),
+                                   _mm_and_si128(_mm_srli_epi32(v, 27), exp_mul_mask));
+
+        __m256d d = _mm256_mul_pd(_mm256_i32gather_pd(unpack_storage_number_lut10x, idx, sizeof(double)),
+                                  _mm256_cvtepi32_pd(_mm_and_si128(v, value_mask)));
+
+        // the sign bit of the storage number becomes the sign bit of the double
+        __m256i sign = _mm256_slli_epi64(_mm256_cvtepu32_epi64(_mm_srli_epi32(v, 31)), 63);
+        d = _mm256_xor_pd(d, _mm256_castsi256_pd(sign));
+
+        // empty slots are NAN
+        d = _mm256_blendv_pd(d, nan, _mm256_castsi256_pd(_mm256_cvtepi32_epi64(is_empty)));
+        _mm256_storeu_pd(&values[i], d);
+
+        _mm_storeu_si128((__m128i *)&flags[i], _mm_and_si128(v, user_flags));
+
+        // anomalous when it exists and it does not have SN_FLAG_NOT_ANOMALOUS
+        __m128i anomalous = _mm_andnot_si128(is_empty, _mm_cmpeq_epi32(_mm_and_si128(v, not_anomalous), _mm_setzero_si128()));
+        _mm_storeu_si128((__m128i *)&anomaly_count[i], _mm_and_si128(anomalous, one));
+    }
+
+    storage_number_unpack_array_scalar(&src[i], entries - i, &values[i], &flags[i], &anomaly_count[i]);
+}
+
+// 4 tier1 points per iteration, transposed from rows of 4 x 32-bit fields to columns
+// SSE2 is part of the x86_64 baseline, so this does not need runtime detection
+static void storage_number_tier1_unpack_array_sse2(const storage_number_tier1_t *src, size_t entries, NETDATA_DOUBLE *min, NETDATA_DOUBLE *max, NETDATA_DOUBLE *sum, uint32_t *count, uint32_t *anomaly_count, SN_FLAGS *flags) {
+    const __m128i count_mask = _mm_set1_epi32(0xffff);
+    const __m128i not_anomalous = _mm_set1_epi32((int)SN_FLAG_NOT_ANOMALOUS);
+
+    size_t i = 0;
+    for(; i + 4 <= entries ; i += 4) {
+        __m128 sums   = _mm_loadu_ps((const float *)&src[i + 0]);
+        __m128 mins   = _mm_loadu_ps((const float *)&src[i + 1]);
+        __m128 maxes  = _mm_loadu_ps((const float *)&src[i + 2]);
+        __m128 counts = _mm_loadu_ps((const float *)&src[i + 3]);
+        _MM_TRANSPOSE4_PS(sums, mins, maxes, counts);
+
+        _mm_storeu_pd(&sum[i + 0], _mm_cvtps_pd(sums));
+        _mm_storeu_pd(&sum[i + 2], _mm_cvtps_pd(_mm_movehl_ps(sums, sums)));
+        _mm_storeu_pd(&min[i + 0], _mm_cvtps_pd(mins));
+        _mm_storeu_pd(&min[i + 2], _mm_cvtps_pd(_mm_movehl_ps(mins, mins)));
+        _mm_storeu_pd(&max[i + 0], _mm_cvtps_pd(maxes));
+        _mm_storeu_pd(&max[i + 2], _mm_cvtps_pd(_mm_movehl_ps(maxes, maxes)));
+
+        // the 4th column has count in the low and anomaly_count in the high 16 bits
+        __m128i packed = _mm_castps_si128(counts);
+        __m128i anomalies = _mm_srli_epi32(packed, 16);
+        _mm_storeu_si128((__m128i *)&count[i], _mm_and_si128(packed, count_mask));
+        _mm_storeu_si128((__m128i *)&anomaly_count[i], anomalies);
+        _mm_storeu_si128((__m128i *)&flags[i], _mm_and_si128(_mm_cmpeq_epi32(anomalies, _mm_setzero_si128()), not_anomalous));
+    }
+
+    storage_number_tier1_unpack_array_scalar(&src[i], entries - i, &min[i], &max[i], &sum[i], &count[i], &anomaly_count[i], &flags[i]);
+}
+
+static bool storage_number_use_avx2 = false;
+
+__attribute__((constructor)) void storage_number_simd_detect(void) {
+    __builtin_cpu_init();
+    storage_number_use_avx2 = __builtin_cpu_supports("avx2");
+}
+
+#endif // STORAGE_NUMBER_SIMD_X86_64
+
+// the implementation of storage_number_unpack_array() - without AVX2 it is the scalar one
+const char *storage_number_unpack_implementation(void) {
+#ifdef STORAGE_NUMBER_SIMD_X86_64
+    if(storage_number_use_avx2)
+        return "avx2";
+#endif
+
+    return "scalar";
+}
+
+ALWAYS_INLINE_HOT
+void storage_number_unpack_array(const storage_number *src, size_t entries, NETDATA_DOUBLE *values, SN_FLAGS *flags, uint32_t *anomaly_count) {
+#ifdef STORAGE_NUMBER_SIMD_X86_64
+    if(likely(storage_number_use_avx2)) {
+        storage_number_unpack_array_avx2(src, entries, values, flags, anomaly_count);
+        return;
+    }
+#endif
+
+    storage_number_unpack_array_scalar(src, entries, values, flags, anomaly_count);
+}
+
+ALWAYS_INLINE_HOT
+void storage_number_tier1_unpack_array(const storage_number_tier1_t *src, size_t entries, NETDATA_DOUBLE *min, NETDATA_DOUBLE *max, NETDATA_DOUBLE *sum, uint32_t *count, uint32_t *anomaly_count, SN_FLAGS *flags) {
+#ifdef STORAGE_NUMBER_SIMD_X86_64
+    storage_number_tier1_unpack_array_sse2(src, entries, min, max, sum, count, anomaly_count, flags);
+#else
+    storage_number_tier1_unpack_array_scalar(src, entries, min, max, sum, count, anomaly_count, flags);
+#endif
+}
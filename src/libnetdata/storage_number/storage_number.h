@@ -168,6 +168,11 @@ static NETDATA_DOUBLE unpack_storage_number(storage_number value) {
     return sign * unpack_storage_number_lut10x[(factor * 16) + (exp * 8) + mul] * n;
 }
 
+// bulk unpacking into columns - SIMD accelerated when the CPU supports it
+void storage_number_unpack_array(const storage_number *src, size_t entries, NETDATA_DOUBLE *values, SN_FLAGS *flags, uint32_t *anomaly_count);
+void storage_number_tier1_unpack_array(const storage_number_tier1_t *src, size_t entries, NETDATA_DOUBLE *min, NETDATA_DOUBLE *max, NETDATA_DOUBLE *sum, uint32_t *count, uint32_t *anomaly_count, SN_FLAGS *flags);
+const char *storage_number_unpack_implementation(void);
+
 // all these prefixes should use characters that are not allowed in the numbers they represent
 #define HEX_PREFIX "0x"               // we check 2 characters when parsing
 #define IEEE754_UINT64_B64_PREFIX "#" // we check the 1st character during parsing
@@ -5,11 +5,27 @@
 
 // ----------------------------------------------------------------------------
 // STRING implementation - dedup all STRING
-
-#define STRING_PARTITION_SHIFTS (0)
-#define STRING_PARTITIONS (256 >> STRING_PARTITION_SHIFTS)
-#define string_partition_str(str) ((uint8_t)((str)[0]) >> STRING_PARTITION_SHIFTS)
-#define string_partition(string) (string_partition_str((string)->str))
+//
+// Strings are spread to partitions by their XXH3 hash. Each partition indexes
+// its strings in an open addressing hash table, which readers search without
+// locking. Readers only announce themselves to one of the two readers counters
+// of the partition (the one selected by its phase). Writers are serialized with
+// a spinlock, and before freeing a string or a table they have unlinked from the
+// index, they flip the phase and make sure the readers of the old phase have
+// finished.
+//
+// Deleted strings are not freed immediately. They are retired to the partition
+// and freed in batches: once enough of them are retired, the writer flips the
+// phase, and the retired strings are freed by a later writer that finds the
+// readers of the old phase gone. Only replacing the index waits for readers.
+
+#define string_partition_hash(hash) ((uint8_t)((hash) >> 24))
+#define string_partition(string) (string_partition_hash((string)->hash))
+
+#define STRING_TABLE_MIN_SLOTS 64
+#define STRING_TABLE_TOMBSTONE ((STRING *)1)
+
+#define STRING_RETIRED_BATCH 64
 
 struct netdata_string {
     uint32_t length;    // the string length including the terminating '\0'
@@ -17,7 +33,9 @@ struct netdata_string {
     REFCOUNT refcount;  // how many times this string is used
                         // We use a signed number to be able to detect duplicate frees of a string.
                         // If at any point this goes below zero, we have a duplicate free.
-                        
+
+    uint32_t hash;      // the XXH3 hash of the string - the partition and the slot in the index
+
 #ifdef FSANITIZE_ADDRESS
     STACKTRACE_ARRAY stacktraces;   // stack traces from all acquisition points
 #endif
@@ -25,17 +43,35 @@ struct netdata_string {
     const char str[];   // the string itself, is appended to this structure
 };
 
+struct string_table {
+    uint32_t mask;      // the number of slots - 1 (the slots are a power of 2)
+    uint32_t used;      // the slots that are not empty (entries and tombstones)
+    STRING *slots[];
+};
+
 static struct string_partition {
-    RW_SPINLOCK spinlock;       // the R/W spinlock to protect the Judy array
+    SPINLOCK spinlock;          // serializes the writers of the partition
 
-    Pvoid_t JudyHSArray;        // the Judy array - hashtable
+    struct string_table *table; // the index - readers search it without locking
+
+    uint32_t phase;             // the readers counter new readers should use
+    uint32_t readers[2];        // the readers currently searching the index
+
+    STRING **retired;           // strings deleted from the index, to be freed
+    uint32_t retired_used;
+    uint32_t retired_size;
+    uint32_t grace;             // the first retired strings, waiting for the readers of grace_phase
+    uint32_t grace_phase;
 
     size_t inserts;             // the number of successful inserts to the index
     size_t deletes;             // the number of successful deleted from the index
 
     long int entries;           // the number of entries in the index
     long int memory;            // the memory used
-    long int memory_index;      // JudyHS (accurate)
+    long int memory_index;      // the hash table (accurate)
+
+    size_t contention;          // the number of times a writer waited for another writer
+    size_t grace_waits;         // the number of times a writer waited for readers to finish
 
 #ifdef FSANITIZE_ADDRESS
     Pvoid_t JudyLPointers;      // JudyL array to keep track of all string pointers for traversal
@@ -96,19 +132,189 @@ void string_statistics(size_t *inserts, size_t *deletes, size_t *searches, size_
     }
 }
 
-static inline bool string_entry_check_and_acquire(STRING *se) {
-#ifdef NETDATA_INTERNAL_CHECKS
-    uint8_t partition = string_partition(se);
-#endif
+void string_partitions_statistics(STRING_PARTITION_STATISTICS *stats) {
+    for(size_t i = 0; i < STRING_PARTITIONS ;i++) {
+        stats[i].entries = (string_base[i].entries > 0) ? (size_t)string_base[i].entries : 0;
+        stats[i].contention = __atomic_load_n(&string_base[i].contention, __ATOMIC_RELAXED);
+        stats[i].grace_waits = __atomic_load_n(&string_base[i].grace_waits, __ATOMIC_RELAXED);
+    }
+}
 
-    if(!refcount_acquire(&se->refcount))
-        return false;
+// ----------------------------------------------------------------------------
+// partition readers and writers
 
-    // statistics
-    // string_base.active_references is altered at the in string_strdupz() and string_freez()
-    string_stats_atomic_increment(partition, duplications);
+static inline uint32_t string_hash(const char *str, size_t length) {
+    return (uint32_t)XXH3_64bits(str, length - 1);
+}
 
-    return true;
+// returns the phase the reader has been counted in
+static inline uint32_t string_partition_reader_enter(struct string_partition *sp) {
+    while(true) {
+        uint32_t phase = __atomic_load_n(&sp->phase, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&sp->readers[phase], 1, __ATOMIC_SEQ_CST);
+
+        // if the phase did not change while we were registering, the writer
+        // that will flip it next will wait for us
+        if(likely(__atomic_load_n(&sp->phase, __ATOMIC_SEQ_CST) == phase))
+            return phase;
+
+        __atomic_sub_fetch(&sp->readers[phase], 1, __ATOMIC_RELEASE);
+        string_internal_stats_add(sp - string_base, spins, 1);
+    }
+}
+
+static inline void string_partition_reader_exit(struct string_partition *sp, uint32_t phase) {
+    __atomic_sub_fetch(&sp->readers[phase], 1, __ATOMIC_RELEASE);
+}
+
+static inline void string_partition_writer_lock(struct string_partition *sp) {
+    if(unlikely(!spinlock_trylock(&sp->spinlock))) {
+        __atomic_add_fetch(&sp->contention, 1, __ATOMIC_RELAXED);
+        spinlock_lock(&sp->spinlock);
+    }
+}
+
+static inline void string_partition_writer_unlock(struct string_partition *sp) {
+    spinlock_unlock(&sp->spinlock);
+}
+
+static inline void string_partition_flip_phase(struct string_partition *sp) {
+    sp->grace_phase = sp->phase;
+    __atomic_store_n(&sp->phase, sp->phase ^ 1, __ATOMIC_SEQ_CST);
+}
+
+static void string_partition_wait_readers(struct string_partition *sp, uint32_t phase) {
+    if(__atomic_load_n(&sp->readers[phase], __ATOMIC_SEQ_CST)) {
+        __atomic_add_fetch(&sp->grace_waits, 1, __ATOMIC_RELAXED);
+
+        size_t spins = 0;
+        while(__atomic_load_n(&sp->readers[phase], __ATOMIC_ACQUIRE)) {
+            // readers do not block, so they finish quickly
+            if(++spins > 1000)
+                microsleep(1);
+        }
+    }
+}
+
+// free the first retired strings of the partition
+static void string_partition_free_retired(struct string_partition *sp, uint32_t count) {
+    for(uint32_t i = 0; i < count; i++)
+        freez(sp->retired[i]);
+
+    sp->retired_used -= count;
+    memmove(sp->retired, &sp->retired[count], sp->retired_used * sizeof(STRING *));
+}
+
+// Free the retired strings no reader can be using, without waiting for readers.
+// Must be called by the writer, with the partition locked.
+static void string_partition_reclaim(struct string_partition *sp) {
+    if(sp->grace) {
+        // readers may still be comparing against them
+        if(__atomic_load_n(&sp->readers[sp->grace_phase], __ATOMIC_SEQ_CST))
+            return;
+
+        string_partition_free_retired(sp, sp->grace);
+        sp->grace = 0;
+    }
+
+    // new readers will not find the retired strings, so once the
+    // readers of the current phase finish, they can be freed
+    if(sp->retired_used >= STRING_RETIRED_BATCH) {
+        sp->grace = sp->retired_used;
+        string_partition_flip_phase(sp);
+    }
+}
+
+// Wait until no reader can be using anything the writer has unlinked from the index.
+// Must be called by the writer, with the partition locked.
+static void string_partition_synchronize(struct string_partition *sp) {
+    // the readers of a grace period in progress have to finish before its phase is reused
+    if(sp->grace)
+        string_partition_wait_readers(sp, sp->grace_phase);
+
+    string_partition_flip_phase(sp);
+    string_partition_wait_readers(sp, sp->grace_phase);
+
+    string_partition_free_retired(sp, sp->retired_used);
+    sp->grace = 0;
+}
+
+// ----------------------------------------------------------------------------
+// the index of a partition
+
+static inline size_t string_table_size(uint32_t slots) {
+    return sizeof(struct string_table) + slots * sizeof(STRING *);
+}
+
+// add a string to a table, at the first slot that is empty or deleted
+// the table must have room for it
+static inline void string_table_add(struct string_table *t, STRING *string) {
+    for(uint32_t i = string->hash & t->mask; ; i = (i + 1) & t->mask) {
+        STRING *se = t->slots[i];
+        if(!se || se == STRING_TABLE_TOMBSTONE) {
+            if(!se)
+                t->used++;
+
+            __atomic_store_n(&t->slots[i], string, __ATOMIC_RELEASE);
+            return;
+        }
+    }
+}
+
+// Replace the index of a partition with a new one, sized for its entries.
+// This drops the tombstones, and it grows or shrinks the index as needed.
+// Must be called by the writer, with the partition locked.
+static struct string_table *string_partition_rehash(struct string_partition *sp) {
+    struct string_table *old = sp->table;
+
+    uint32_t slots = STRING_TABLE_MIN_SLOTS;
+    while(slots < (uint32_t)(sp->entries + 1) * 2)
+        slots <<= 1;
+
+    struct string_table *t = callocz(1, string_table_size(slots));
+    t->mask = slots - 1;
+
+    if(old) {
+        for(uint32_t i = 0; i <= old->mask; i++) {
+            STRING *se = old->slots[i];
+            if(se && se != STRING_TABLE_TOMBSTONE)
+                string_table_add(t, se);
+        }
+    }
+
+    __atomic_store_n(&sp->table, t, __ATOMIC_RELEASE);
+    sp->memory_index += (long)string_table_size(slots);
+
+    if(old) {
+        string_partition_synchronize(sp);
+        sp->memory_index -= (long)string_table_size(old->mask + 1);
+        freez(old);
+    }
+
+    return t;
+}
+
+// find and acquire a string in the index - entries being deleted are skipped
+static inline STRING *string_table_acquire(struct string_table *t, const char *str, size_t length, uint32_t hash, size_t *deleted) {
+    for(uint32_t i = hash & t->mask, probes = 0; probes <= t->mask; i = (i + 1) & t->mask, probes++) {
+        STRING *se = __atomic_load_n(&t->slots[i], __ATOMIC_ACQUIRE);
+
+        if(!se)
+            break;
+
+        if(se == STRING_TABLE_TOMBSTONE || se->hash != hash || se->length != length ||
+            memcmp(se->str, str, length - 1) != 0)
+            continue;
+
+        if(likely(refcount_acquire(&se->refcount)))
+            return se;
+
+        // this entry is about to be deleted by another thread
+        // do not touch it, let it go...
+        (*deleted)++;
+    }
+
+    return NULL;
 }
 
 STRING *string_dup(STRING *string) {
@@ -133,191 +339,165 @@ STRING *string_dup(STRING *string) {
 }
 
 // Search the index and return an ACQUIRED string entry, or NULL
-static inline STRING *string_index_search(const char *str, size_t length) {
-    STRING *string;
+static inline STRING *string_index_search(const char *str, size_t length, uint32_t hash) {
+    uint8_t partition = string_partition_hash(hash);
+    struct string_partition *sp = &string_base[partition];
 
-    uint8_t partition = string_partition_str(str);
+    STRING *string = NULL;
+    size_t deleted = 0;
 
-    // Find the string in the index
-    // With a read-lock so that multiple readers can use the index concurrently.
+    // Find the string in the index, without locking it.
+    uint32_t phase = string_partition_reader_enter(sp);
 
-    rw_spinlock_read_lock(&string_base[partition].spinlock);
+    struct string_table *t = __atomic_load_n(&sp->table, __ATOMIC_ACQUIRE);
+    if(likely(t))
+        string = string_table_acquire(t, str, length, hash, &deleted);
 
-    Pvoid_t *Rc;
-    Rc = JudyHSGet(string_base[partition].JudyHSArray, (void *)str, length - 1);
-    if(likely(Rc)) {
-        // found in the hash table
-        string = *Rc;
+    string_partition_reader_exit(sp, phase);
 
-        if(string_entry_check_and_acquire(string)) {
-            // we can use this entry
-            string_internal_stats_add(partition, found_available_on_search, 1);
-        }
-        else {
-            // this entry is about to be deleted by another thread
-            // do not touch it, let it go...
-            string = NULL;
-            string_internal_stats_add(partition, found_deleted_on_search, 1);
-        }
-    }
-    else {
-        // not found in the hash table
-        string = NULL;
+    // statistics
+    if(string) {
+        string_stats_atomic_increment(partition, duplications);
+        string_internal_stats_add(partition, found_available_on_search, 1);
     }
-
+    if(deleted)
+        string_internal_stats_add(partition, found_deleted_on_search, deleted);
     string_stats_atomic_increment(partition, searches);
-    rw_spinlock_read_unlock(&string_base[partition].spinlock);
 
     return string;
 }
 
-// Insert a string to the index and return an ACQUIRED string entry,
-// or NULL if the call needs to be retried (a deleted entry with the same key is still in the index)
+// Insert a string to the index and return an ACQUIRED string entry.
 // The returned entry is ACQUIRED, and it can either be:
 //   1. a new item inserted, or
 //   2. an item found in the index that is not currently deleted
-static inline STRING *string_index_insert(const char *str, size_t length) {
-    STRING *string;
-
-    uint8_t partition = string_partition_str(str);
+// Entries with the same string that are being deleted by other threads are left in
+// the index, for their threads to delete them.
+static inline STRING *string_index_insert(const char *str, size_t length, uint32_t hash) {
+    uint8_t partition = string_partition_hash(hash);
+    struct string_partition *sp = &string_base[partition];
 
-    rw_spinlock_write_lock(&string_base[partition].spinlock);
+    string_partition_writer_lock(sp);
 
-    int64_t judy_mem = 0;
-
-    STRING **ptr;
-    {
-        JError_t J_Error;
+    STRING *string = NULL;
+    size_t deleted = 0;
 
-        JudyAllocThreadPulseReset();
+    struct string_table *t = sp->table;
+    if(likely(t))
+        string = string_table_acquire(t, str, length, hash, &deleted);
 
-        Pvoid_t *Rc = JudyHSIns(&string_base[partition].JudyHSArray, (void *)str, length - 1, &J_Error);
+    if(deleted)
+        string_internal_stats_add(partition, found_deleted_on_insert, deleted);
 
-        judy_mem = JudyAllocThreadPulseGetAndReset();
-
-        if (unlikely(Rc == PJERR)) {
-            fatal(
-                "STRING: Cannot insert entry with name '%s' to JudyHS, JU_ERRNO_* == %u, ID == %d",
-                str,
-                JU_ERRNO(&J_Error),
-                JU_ERRID(&J_Error));
-        }
-        ptr = (STRING **)Rc;
+    if (unlikely(string)) {
+        // the item is already in the index
+        string_stats_atomic_increment(partition, duplications);
+        string_internal_stats_add(partition, found_available_on_insert, 1);
+        string_stats_atomic_increment(partition, searches);
     }
+    else {
+        // keep the index at most 75% full, including the tombstones
+        if(unlikely(!t || (t->used + 1) * 4 > (t->mask + 1) * 3))
+            t = string_partition_rehash(sp);
 
-    if (likely(*ptr == 0)) {
         // a new item added to the index
         long mem_size = (long)sizeof(STRING) + (long)length;
         string = mallocz(mem_size);
-        strcpy((char *)string->str, str);
+        memcpy((char *)string->str, str, length - 1);
+        ((char *)string->str)[length - 1] = '\0';
         string->length = length;
         string->refcount = 1;
-        
+        string->hash = hash;
+
 #ifdef FSANITIZE_ADDRESS
         // Initialize stacktrace tracking
         stacktrace_array_init(&string->stacktraces);
-        
+
         // Add to JudyL array for tracking strings by pointer
         Pvoid_t *PValue;
-        PValue = JudyLIns(&string_base[partition].JudyLPointers, (Word_t)string, PJE0);
+        PValue = JudyLIns(&sp->JudyLPointers, (Word_t)string, PJE0);
         if (PValue != PJERR)
             *PValue = (void *)1;  // Use a simple value of 1 for now
 #endif
-        
-        *ptr = string;
-        string_base[partition].inserts++;
-        string_base[partition].entries++;
-        string_base[partition].memory += mem_size;
-        string_base[partition].memory_index += judy_mem;
-    }
-    else {
-        // the item is already in the index
-        string = *ptr;
-
-        if(string_entry_check_and_acquire(string)) {
-            // we can use this entry
-            string_internal_stats_add(partition, found_available_on_insert, 1);
-        }
-        else {
-            // this entry is about to be deleted by another thread
-            // do not touch it, let it go...
-            string = NULL;
-            string_internal_stats_add(partition, found_deleted_on_insert, 1);
-        }
 
-        string_stats_atomic_increment(partition, searches);
+        string_table_add(t, string);
+        sp->inserts++;
+        sp->entries++;
+        sp->memory += mem_size;
     }
 
-    rw_spinlock_write_unlock(&string_base[partition].spinlock);
+    if(unlikely(sp->grace))
+        string_partition_reclaim(sp);
+
+    string_partition_writer_unlock(sp);
     return string;
 }
 
 // delete an entry from the index
 static inline void string_index_delete(STRING *string) {
     uint8_t partition = string_partition(string);
+    struct string_partition *sp = &string_base[partition];
 
-    rw_spinlock_write_lock(&string_base[partition].spinlock);
+    string_partition_writer_lock(sp);
 
     bool deleted = false;
-    int64_t judy_mem = 0;
-
-    if (likely(string_base[partition].JudyHSArray)) {
-        JError_t J_Error;
 
-        JudyAllocThreadPulseReset();
+    struct string_table *t = sp->table;
+    if (likely(t)) {
+        for(uint32_t i = string->hash & t->mask, probes = 0; probes <= t->mask; i = (i + 1) & t->mask, probes++) {
+            STRING *se = t->slots[i];
 
-        int ret = JudyHSDel(&string_base[partition].JudyHSArray, (void *)string->str, string->length - 1, &J_Error);
+            if(!se)
+                break;
 
-        judy_mem = JudyAllocThreadPulseGetAndReset();
-
-        if (unlikely(ret == JERR)) {
-            netdata_log_error(
-                "STRING: Cannot delete entry with name '%s' from JudyHS, JU_ERRNO_* == %u, ID == %d",
-                string->str,
-                JU_ERRNO(&J_Error),
-                JU_ERRID(&J_Error));
-        } else
-            deleted = true;
+            if(se == string) {
+                __atomic_store_n(&t->slots[i], STRING_TABLE_TOMBSTONE, __ATOMIC_RELEASE);
+                deleted = true;
+                break;
+            }
+        }
     }
 
     if (unlikely(!deleted))
         netdata_log_error("STRING: tried to delete '%s' that is not in the index. Ignoring it.", string->str);
     else {
         long mem_size = (long)sizeof(STRING) + (long)string->length;
-        string_base[partition].deletes++;
-        string_base[partition].entries--;
-        string_base[partition].memory -= mem_size;
-        string_base[partition].memory_index += judy_mem;
-        
+        sp->deletes++;
+        sp->entries--;
+        sp->memory -= mem_size;
+
 #ifdef FSANITIZE_ADDRESS
         // Remove from the JudyL array if it exists
-        if (string_base[partition].JudyLPointers)
-            JudyLDel(&string_base[partition].JudyLPointers, (Word_t)string, PJE0);
+        if (sp->JudyLPointers)
+            JudyLDel(&sp->JudyLPointers, (Word_t)string, PJE0);
 #endif
-        
-        freez(string);
+
+        // readers may still be comparing against it
+        if(sp->retired_used == sp->retired_size) {
+            sp->retired_size = sp->retired_size ? sp->retired_size * 2 : STRING_RETIRED_BATCH;
+            sp->retired = reallocz(sp->retired, sp->retired_size * sizeof(STRING *));
+        }
+        sp->retired[sp->retired_used++] = string;
+
+        string_partition_reclaim(sp);
     }
 
-    rw_spinlock_write_unlock(&string_base[partition].spinlock);
+    string_partition_writer_unlock(sp);
 }
 
 STRING *string_strdupz(const char *str) {
     if(unlikely(!str || !*str)) return NULL;
 
+    size_t length = strlen(str) + 1;
+    uint32_t hash = string_hash(str, length);
+
 #ifdef NETDATA_INTERNAL_CHECKS
-    uint8_t partition = string_partition_str(str);
+    uint8_t partition = string_partition_hash(hash);
 #endif
 
-    size_t length = strlen(str) + 1;
-    STRING *string = string_index_search(str, length);
-
-    while(!string) {
-        // The search above did not find anything,
-        // We loop here, because during insert we may find an entry that is being deleted by another thread.
-        // So, we have to let it go and retry to insert it again.
-
-        string = string_index_insert(str, length);
-    }
+    STRING *string = string_index_search(str, length, hash);
+    if(!string)
+        string = string_index_insert(str, length, hash);
 
     // statistics
     string_stats_atomic_increment(partition, active_references);
@@ -333,17 +513,19 @@ STRING *string_strdupz(const char *str) {
 STRING *string_strndupz(const char *str, size_t len) {
     if(unlikely(!str || !*str || !len)) return NULL;
 
-#ifdef NETDATA_INTERNAL_CHECKS
-    uint8_t partition = string_partition_str(str);
-#endif
-
     char buf[len + 1];
     memcpy(buf, str, len);
     buf[len] = '\0';
 
-    STRING *string = string_index_search(buf, len + 1);
-    while(!string)
-        string = string_index_insert(buf, len + 1);
+    uint32_t hash = string_hash(buf, len + 1);
+
+#ifdef NETDATA_INTERNAL_CHECKS
+    uint8_t partition = string_partition_hash(hash);
+#endif
+
+    STRING *string = string_index_search(buf, len + 1, hash);
+    if(!string)
+        string = string_index_insert(buf, len + 1, hash);
 
     string_stats_atomic_increment(partition, active_references);
 
@@ -517,7 +699,7 @@ size_t string_destroy(void) {
     // Traverse all partitions
     for (size_t partition = 0; partition < STRING_PARTITIONS; partition++) {
         // Lock the partition to prevent new entries while we're cleaning up
-        rw_spinlock_write_lock(&string_base[partition].spinlock);
+        spinlock_lock(&string_base[partition].spinlock);
 
 #ifdef FSANITIZE_ADDRESS
         // First, collect statistics about remaining strings
@@ -558,15 +740,19 @@ size_t string_destroy(void) {
         }
 #endif
 
-        // Since JudyHS doesn't have simple traversal functions,
-        // we'll free the entire array at once.
-        if (string_base[partition].JudyHSArray) {
-            // We'll count all entries as "referenced" since we can't check them individually
+        // The retired strings are not referenced, nothing can be using them anymore.
+        string_partition_free_retired(&string_base[partition], string_base[partition].retired_used);
+        freez(string_base[partition].retired);
+        string_base[partition].retired = NULL;
+        string_base[partition].retired_size = 0;
+        string_base[partition].grace = 0;
+
+        // The strings still in the index are referenced, but we only free the index.
+        if (string_base[partition].table) {
             referenced += string_base[partition].entries;
 
-            // Free the JudyHS array
-            JudyHSFreeArray(&string_base[partition].JudyHSArray, PJE0);
-            string_base[partition].JudyHSArray = NULL;
+            freez(string_base[partition].table);
+            string_base[partition].table = NULL;
         }
 
         // Reset partition statistics
@@ -575,6 +761,8 @@ size_t string_destroy(void) {
         string_base[partition].entries = 0;
         string_base[partition].memory = 0;
         string_base[partition].memory_index = 0;
+        string_base[partition].contention = 0;
+        string_base[partition].grace_waits = 0;
 
 #ifdef NETDATA_INTERNAL_CHECKS
         string_base[partition].atomic.searches = 0;
@@ -588,7 +776,7 @@ size_t string_destroy(void) {
         string_base[partition].spins = 0;
 #endif
 
-        rw_spinlock_write_unlock(&string_base[partition].spinlock);
+        spinlock_unlock(&string_base[partition].spinlock);
     }
 
 #ifdef FSANITIZE_ADDRESS
@@ -760,6 +948,27 @@ int string_unittest(size_t entries) {
         end_ut = now_realtime_usec();
         fprintf(stderr, "Created %zu strings in %"PRIu64" usecs\n", entries, end_ut - start_ut);
 
+        // the names share long prefixes, but they should be spread evenly to the partitions
+        {
+            STRING_PARTITION_STATISTICS stats[STRING_PARTITIONS];
+            string_partitions_statistics(stats);
+
+            size_t max = 0, total = 0;
+            for(size_t p = 0; p < STRING_PARTITIONS ;p++) {
+                total += stats[p].entries;
+                if(stats[p].entries > max)
+                    max = stats[p].entries;
+            }
+
+            if(entries >= 10 * STRING_PARTITIONS && max > 2 * total / STRING_PARTITIONS) {
+                errors++;
+                fprintf(stderr, "ERROR: strings are not evenly partitioned: the busiest partition has %zu of %zu strings\n",
+                        max, total);
+            }
+            else
+                fprintf(stderr, "OK: the busiest partition has %zu of %zu strings\n", max, total);
+        }
+
         start_ut = now_realtime_usec();
         for(size_t i = 0; i < entries ;i++) {
             strings[i] = string_dup(strings[i]);
@@ -915,7 +1124,7 @@ int string_unittest(size_t entries) {
 
 void string_init(void) {
     for (size_t i = 0; i != STRING_PARTITIONS; i++) {
-        rw_spinlock_init(&string_base[i].spinlock);
+        spinlock_init(&string_base[i].spinlock);
         
 #ifdef FSANITIZE_ADDRESS
         // Initialize the JudyL pointers array to NULL
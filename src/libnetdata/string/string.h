@@ -39,6 +39,17 @@ static inline int string_strncmp(STRING *string, const char *s, size_t n) {
 
 void string_statistics(size_t *inserts, size_t *deletes, size_t *searches, size_t *entries, size_t *references, size_t *memory, size_t *memory_index, size_t *duplications, size_t *releases);
 
+#define STRING_PARTITIONS 256
+
+typedef struct string_partition_statistics {
+    size_t entries;
+    size_t contention;      // writers that waited for other writers
+    size_t grace_waits;     // writers that waited for readers to finish
+} STRING_PARTITION_STATISTICS;
+
+// fills STRING_PARTITIONS entries
+void string_partitions_statistics(STRING_PARTITION_STATISTICS *stats);
+
 int string_unittest(size_t entries);
 
 void string_init(void);
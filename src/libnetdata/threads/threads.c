@@ -324,6 +324,7 @@ static void nd_thread_exit(void *pptr) {
     thread_cache_destroy();
     service_exits();
     worker_unregister();
+    aral_thread_magazines_free();
 
     nd_thread_status_set(nti, NETDATA_THREAD_STATUS_FINISHED);
 
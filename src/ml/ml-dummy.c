@@ -88,6 +88,13 @@ bool ml_dimension_is_anomalous(RRDDIM *rd, time_t curr_time, double value, bool
     return false;
 }
 
+void ml_dimensions_are_anomalous(RRDSET *rs, ML_DIMENSION_PREDICTION *predictions, size_t entries) {
+    UNUSED(rs);
+
+    for (size_t i = 0; i != entries; i++)
+        predictions[i].anomalous = false;
+}
+
 int ml_dimension_load_models(RRDDIM *rd, sqlite3_stmt **stmp __maybe_unused) {
     UNUSED(rd);
     return 0;
@@ -131,4 +138,11 @@ bool ml_model_received_from_child(RRDHOST *host, const char *json) {
     return false;
 }
 
+int ml_bench(int argc, char *argv[]) {
+    UNUSED(argc);
+    UNUSED(argv);
+    fprintf(stderr, "ML BENCH: netdata has been compiled without machine learning\n");
+    return 1;
+}
+
 #endif
@@ -79,27 +79,30 @@ ml_dimension_calculated_numbers(ml_worker_t *worker, ml_dimension_t *dim)
     memset(worker->training_cns, 0, sizeof(calculated_number_t) * max_n * (Cfg.lag_n + 1));
     calculated_number_t last_value = std::numeric_limits<calculated_number_t>::quiet_NaN();
 
+    STORAGE_POINTS_BATCH batch;
     while (!storage_engine_query_is_finished(&handle)) {
         if (idx == max_n)
             break;
 
-        STORAGE_POINT sp = storage_engine_query_next_metric(&handle);
+        size_t points = storage_engine_query_next_metric_batch(&handle, &batch);
 
-        time_t timestamp = sp.end_time_s;
-        calculated_number_t value = sp.sum / sp.count;
+        for (size_t i = 0; i < points && idx < max_n; i++) {
+            time_t timestamp = batch.end_time_s[i];
+            calculated_number_t value = batch.sum[i] / batch.count[i];
 
-        if (netdata_double_isnumber(value)) {
-            if (!training_response.db_after_t)
-                training_response.db_after_t = timestamp;
-            training_response.db_before_t = timestamp;
+            if (netdata_double_isnumber(value)) {
+                if (!training_response.db_after_t)
+                    training_response.db_after_t = timestamp;
+                training_response.db_before_t = timestamp;
 
-            worker->training_cns[idx] = value;
-            last_value = worker->training_cns[idx];
-            training_response.collected_values++;
-        } else
-            worker->training_cns[idx] = last_value;
+                worker->training_cns[idx] = value;
+                last_value = worker->training_cns[idx];
+                training_response.collected_values++;
+            } else
+                worker->training_cns[idx] = last_value;
 
-        idx++;
+            idx++;
+        }
     }
     storage_engine_query_finalize(&handle);
 
@@ -683,8 +686,10 @@ ml_dimension_train_model(ml_worker_t *worker, ml_dimension_t *dim)
     return worker_result;
 }
 
-bool
-ml_dimension_predict(ml_dimension_t *dim, calculated_number_t value, bool exists)
+// Saves the value and, when there are enough values for a sample,
+// extracts its features into dim->feature[0]
+static bool
+ml_dimension_predict_features(ml_dimension_t *dim, calculated_number_t value, bool exists, bool *same_value)
 {
     // Nothing to do if ML is disabled for this dimension
     if (dim->mls != MACHINE_LEARNING_STATUS_ENABLED)
@@ -704,10 +709,10 @@ ml_dimension_predict(ml_dimension_t *dim, calculated_number_t value, bool exists
     }
 
     // Push the value and check if it's different from the last one
-    bool same_value = true;
+    *same_value = true;
     std::rotate(std::begin(dim->cns), std::begin(dim->cns) + 1, std::end(dim->cns));
     if (dim->cns[n - 1] != value)
-        same_value = false;
+        *same_value = false;
     dim->cns[n - 1] = value;
 
     // Create the sample
@@ -728,9 +733,14 @@ ml_dimension_predict(ml_dimension_t *dim, calculated_number_t value, bool exists
     };
     ml_features_preprocess(&features);
 
-    /*
-     * Lock to predict
-    */
+    return true;
+}
+
+// Locks the dimension for prediction. On success, the caller has to consult
+// the models and call ml_dimension_predict_unlock().
+static bool
+ml_dimension_predict_lock(ml_dimension_t *dim, bool same_value)
+{
     if (spinlock_trylock(&dim->slock) == 0)
         return false;
 
@@ -745,6 +755,37 @@ ml_dimension_predict(ml_dimension_t *dim, calculated_number_t value, bool exists
     }
 
     dim->suppression_window_counter++;
+    return true;
+}
+
+// sum is the number of models that found the sample anomalous,
+// when all the models of the dimension did
+static bool
+ml_dimension_predict_unlock(ml_dimension_t *dim, size_t sum)
+{
+    dim->suppression_anomaly_counter += sum ? 1 : 0;
+
+    if ((dim->suppression_anomaly_counter >= Cfg.suppression_threshold) &&
+        (dim->suppression_window_counter >= Cfg.suppression_window)) {
+        dim->ts = TRAINING_STATUS_SILENCED;
+    }
+
+    spinlock_unlock(&dim->slock);
+    return sum;
+}
+
+bool
+ml_dimension_predict(ml_dimension_t *dim, calculated_number_t value, bool exists)
+{
+    bool same_value;
+    if (!ml_dimension_predict_features(dim, value, exists, &same_value))
+        return false;
+
+    /*
+     * Lock to predict
+    */
+    if (!ml_dimension_predict_lock(dim, same_value))
+        return false;
 
     /*
      * Use the KMeans models to check if the value is anomalous
@@ -756,7 +797,7 @@ ml_dimension_predict(ml_dimension_t *dim, calculated_number_t value, bool exists
     for (const auto &km_ctx : dim->km_contexts) {
         models_consulted++;
 
-        calculated_number_t anomaly_score = ml_kmeans_anomaly_score(&km_ctx, features.preprocessed_features[0]);
+        calculated_number_t anomaly_score = ml_kmeans_anomaly_score(&km_ctx, dim->feature[0]);
         if (anomaly_score == std::numeric_limits<calculated_number_t>::quiet_NaN())
             continue;
 
@@ -769,17 +810,111 @@ ml_dimension_predict(ml_dimension_t *dim, calculated_number_t value, bool exists
         sum += 1;
     }
 
-    dim->suppression_anomaly_counter += sum ? 1 : 0;
+    bool is_anomalous = ml_dimension_predict_unlock(dim, sum);
 
-    if ((dim->suppression_anomaly_counter >= Cfg.suppression_threshold) &&
-        (dim->suppression_window_counter >= Cfg.suppression_window)) {
-        dim->ts = TRAINING_STATUS_SILENCED;
+    pulse_ml_models_consulted(models_consulted);
+    return is_anomalous;
+}
+
+/*
+ * Batched prediction
+ *
+ * The dimensions of a chart collected in the same iteration are locked
+ * together and their models are consulted in rounds: round N scores the
+ * N-th model of every dimension that is still undecided, in one pass over
+ * a structure-of-arrays buffer. Like in ml_dimension_predict(), a dimension
+ * is normal as soon as one of its models finds the sample normal, and it
+ * is anomalous when all of them find it anomalous.
+*/
+
+struct ml_predict_batch_t {
+    std::vector<ml_dimension_t *> dims;
+    std::vector<size_t> items;
+    std::vector<size_t> sums;
+    std::vector<bool> normal;
+    std::vector<size_t> rows;
+
+    ml_kmeans_batch_t km;
+};
+
+// collector threads keep their batch, to avoid reallocating it for every chart
+static thread_local ml_predict_batch_t ml_predict_batch;
+
+void
+ml_dimensions_predict(ML_DIMENSION_PREDICTION *predictions, size_t entries)
+{
+    ml_predict_batch_t &batch = ml_predict_batch;
+    batch.dims.clear();
+    batch.items.clear();
+
+    for (size_t i = 0; i != entries; i++) {
+        ML_DIMENSION_PREDICTION *p = &predictions[i];
+        p->anomalous = false;
+
+        ml_dimension_t *dim = (ml_dimension_t *) p->rd->ml_dimension;
+        if (!dim)
+            continue;
+
+        bool same_value;
+        if (!ml_dimension_predict_features(dim, p->value, p->exists, &same_value))
+            continue;
+
+        if (!ml_dimension_predict_lock(dim, same_value))
+            continue;
+
+        batch.dims.push_back(dim);
+        batch.items.push_back(i);
     }
 
-    spinlock_unlock(&dim->slock);
+    size_t locked = batch.dims.size();
+    if (!locked)
+        return;
+
+    batch.sums.assign(locked, 0);
+    batch.normal.assign(locked, false);
+
+    size_t models_consulted = 0;
+    calculated_number_t threshold = 100 * Cfg.dimension_anomaly_score_threshold;
+
+    for (size_t model = 0; ; model++) {
+        batch.km.clear();
+        batch.rows.clear();
+
+        for (size_t j = 0; j != locked; j++) {
+            ml_dimension_t *dim = batch.dims[j];
+            if (batch.normal[j] || model >= dim->km_contexts.size())
+                continue;
+
+            batch.km.add(&dim->km_contexts[model], dim->feature[0]);
+            batch.rows.push_back(j);
+        }
+
+        if (batch.rows.empty())
+            break;
+
+        ml_kmeans_anomaly_score_batch(&batch.km);
+        models_consulted += batch.rows.size();
+
+        for (size_t r = 0; r != batch.rows.size(); r++) {
+            size_t j = batch.rows[r];
+
+            if (batch.km.scores[r] < threshold)
+                batch.normal[j] = true;
+            else
+                batch.sums[j]++;
+        }
+    }
+
+    for (size_t j = 0; j != locked; j++) {
+        ml_dimension_t *dim = batch.dims[j];
+
+        if (batch.normal[j])
+            spinlock_unlock(&dim->slock);
+        else
+            predictions[batch.items[j]].anomalous = ml_dimension_predict_unlock(dim, batch.sums[j]);
+    }
 
     pulse_ml_models_consulted(models_consulted);
-    return sum;
 }
 
 /*
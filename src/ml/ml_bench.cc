@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ml_private.h"
+
+#include <random>
+
+// Compares predicting one dimension at a time (ml_dimension_predict(), as the
+// plugins.d parser does), against predicting all the dimensions of a chart
+// together (ml_dimensions_predict(), as rrdset_done() does). Both paths are
+// fed the same values, and they have to agree on every prediction.
+
+#define ML_BENCH_DIMENSIONS 50000
+#define ML_BENCH_MODELS 2
+#define ML_BENCH_ITERATIONS 30
+
+struct ml_bench_set {
+    std::vector<RRDDIM *> rds;
+    std::vector<ml_dimension_t *> dims;
+};
+
+static void ml_bench_set_create(ml_bench_set *set, size_t dimensions)
+{
+    // same seed for every set, so that they all get the same models
+    std::mt19937 gen(1);
+    std::normal_distribution<calculated_number_t> center(0.0, 0.5);
+    std::uniform_real_distribution<calculated_number_t> max_dist(1.5, 4.0);
+
+    for (size_t i = 0; i != dimensions; i++) {
+        ml_dimension_t *dim = new ml_dimension_t();
+
+        dim->mt = METRIC_TYPE_VARIABLE;
+        dim->ts = TRAINING_STATUS_TRAINED;
+        dim->mls = MACHINE_LEARNING_STATUS_ENABLED;
+        dim->last_training_time = 0;
+        dim->suppression_anomaly_counter = 0;
+        dim->suppression_window_counter = 0;
+        spinlock_init(&dim->slock);
+
+        for (size_t m = 0; m != ML_BENCH_MODELS; m++) {
+            ml_kmeans_inlined_t km;
+
+            for (size_t k = 0; k != ML_KMEANS_BATCH_FEATURES; k++) {
+                km.cluster_centers[0](k) = center(gen);
+                km.cluster_centers[1](k) = center(gen);
+            }
+            km.min_dist = 0.5;
+            km.max_dist = max_dist(gen);
+
+            dim->km_contexts.push_back(km);
+        }
+
+        RRDDIM *rd = (RRDDIM *) callocz(1, sizeof(RRDDIM));
+        rd->ml_dimension = (rrd_ml_dimension_t *) dim;
+        dim->rd = rd;
+
+        set->rds.push_back(rd);
+        set->dims.push_back(dim);
+    }
+}
+
+static void ml_bench_set_destroy(ml_bench_set *set)
+{
+    for (size_t i = 0; i != set->dims.size(); i++) {
+        delete set->dims[i];
+        freez(set->rds[i]);
+    }
+
+    set->rds.clear();
+    set->dims.clear();
+}
+
+// noisy random walks, with a spike every now and then
+static void ml_bench_values(std::vector<calculated_number_t> &values, std::mt19937 &gen)
+{
+    std::normal_distribution<calculated_number_t> step(0.0, 1.0);
+    std::uniform_int_distribution<int> spike(0, 49);
+
+    for (auto &value : values) {
+        value += step(gen);
+
+        if (spike(gen) == 0)
+            value += 10.0;
+    }
+}
+
+int ml_bench(int argc __maybe_unused, char *argv[] __maybe_unused)
+{
+    ml_config_load(&Cfg);
+
+    // the bench keeps every dimension trained
+    Cfg.suppression_window = std::numeric_limits<size_t>::max();
+    Cfg.suppression_threshold = std::numeric_limits<size_t>::max();
+
+    size_t chart_sizes[] = { 1, 4, 16, 64, 256 };
+    size_t iterations = Cfg.diff_n + Cfg.smooth_n + Cfg.lag_n + ML_BENCH_ITERATIONS;
+
+    fprintf(stderr, "ML BENCH: %d dimensions, %d models per dimension, %zu iterations, batch scoring implementation: %s\n",
+            ML_BENCH_DIMENSIONS, ML_BENCH_MODELS, iterations, ml_kmeans_anomaly_score_batch_implementation());
+
+    fprintf(stderr, "%-16s %14s %14s %10s %10s\n",
+            "chart dimensions", "per-dim ns/dim", "batch ns/dim", "speedup", "anomalous");
+
+    int rc = 0;
+    for (size_t chart_size : chart_sizes) {
+        ml_bench_set per_dim, batched;
+        ml_bench_set_create(&per_dim, ML_BENCH_DIMENSIONS);
+        ml_bench_set_create(&batched, ML_BENCH_DIMENSIONS);
+
+        std::vector<ML_DIMENSION_PREDICTION> predictions(ML_BENCH_DIMENSIONS);
+        std::vector<bool> expected(ML_BENCH_DIMENSIONS);
+        std::vector<calculated_number_t> values(ML_BENCH_DIMENSIONS, 1000.0);
+        std::mt19937 gen(2);
+
+        usec_t per_dim_ut = 0, batch_ut = 0;
+        size_t anomalous = 0, mismatches = 0;
+
+        for (size_t it = 0; it != iterations; it++) {
+            ml_bench_values(values, gen);
+
+            usec_t started_ut = now_monotonic_usec();
+            for (size_t i = 0; i != ML_BENCH_DIMENSIONS; i++)
+                expected[i] = ml_dimension_predict(per_dim.dims[i], values[i], true);
+            per_dim_ut += now_monotonic_usec() - started_ut;
+
+            started_ut = now_monotonic_usec();
+            for (size_t first = 0; first < ML_BENCH_DIMENSIONS; first += chart_size) {
+                size_t entries = std::min(chart_size, (size_t) ML_BENCH_DIMENSIONS - first);
+
+                for (size_t i = first; i != first + entries; i++) {
+                    predictions[i].rd = batched.rds[i];
+                    predictions[i].value = values[i];
+                    predictions[i].exists = true;
+                }
+
+                ml_dimensions_predict(&predictions[first], entries);
+            }
+            batch_ut += now_monotonic_usec() - started_ut;
+
+            for (size_t i = 0; i != ML_BENCH_DIMENSIONS; i++) {
+                anomalous += expected[i];
+                mismatches += expected[i] != predictions[i].anomalous;
+            }
+        }
+
+        size_t predicted = ML_BENCH_DIMENSIONS * iterations;
+        fprintf(stderr, "%-16zu %14.2f %14.2f %9.2fx %9.2f%%\n",
+                chart_size,
+                (double) per_dim_ut * 1000.0 / (double) predicted,
+                (double) batch_ut * 1000.0 / (double) predicted,
+                batch_ut ? (double) per_dim_ut / (double) batch_ut : 0.0,
+                (double) anomalous * 100.0 / (double) predicted);
+
+        if (mismatches) {
+            fprintf(stderr, "ML BENCH: %zu predictions differ between the per-dimension and the batched path\n", mismatches);
+            rc = 1;
+        }
+
+        ml_bench_set_destroy(&per_dim);
+        ml_bench_set_destroy(&batched);
+    }
+
+    return rc;
+}
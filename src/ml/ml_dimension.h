@@ -31,6 +31,9 @@ struct ml_dimension_t {
 bool
 ml_dimension_predict(ml_dimension_t *dim, calculated_number_t value, bool exists);
 
+void
+ml_dimensions_predict(ML_DIMENSION_PREDICTION *predictions, size_t entries);
+
 bool ml_dimension_deserialize_kmeans(const char *json_str);
 
 class DimensionLookupInfo {
@@ -60,6 +60,156 @@ ml_kmeans_anomaly_score(const ml_kmeans_inlined_t *inlined_km, const DSample &DS
     return (anomaly_score > 100.0) ? 100.0 : anomaly_score;
 }
 
+/*
+ * Batched scoring
+*/
+
+static_assert(DSample::NR == ML_KMEANS_BATCH_FEATURES, "the batch has a column per sample coordinate");
+
+void
+ml_kmeans_batch_t::add(const ml_kmeans_inlined_t *inlined_km, const DSample &DS)
+{
+    size_t capacity = min_dist.size();
+    if (rows == capacity) {
+        capacity = capacity ? capacity * 2 : 256;
+
+        for (size_t k = 0; k != ML_KMEANS_BATCH_FEATURES; k++) {
+            features[k].resize(capacity);
+            centers[0][k].resize(capacity);
+            centers[1][k].resize(capacity);
+        }
+        min_dist.resize(capacity);
+        max_dist.resize(capacity);
+        scores.resize(capacity);
+    }
+
+    for (size_t k = 0; k != ML_KMEANS_BATCH_FEATURES; k++) {
+        features[k][rows] = DS(k);
+        centers[0][k][rows] = inlined_km->cluster_centers[0](k);
+        centers[1][k][rows] = inlined_km->cluster_centers[1](k);
+    }
+    min_dist[rows] = inlined_km->min_dist;
+    max_dist[rows] = inlined_km->max_dist;
+
+    rows++;
+}
+
+// same operations, in the same order, as ml_kmeans_anomaly_score()
+static void
+ml_kmeans_anomaly_score_batch_scalar(ml_kmeans_batch_t *batch, size_t from)
+{
+    for (size_t i = from; i < batch->rows; i++) {
+        calculated_number_t mean_dist = 0.0;
+
+        for (size_t c = 0; c != 2; c++) {
+            calculated_number_t sum = 0.0;
+
+            for (size_t k = 0; k != ML_KMEANS_BATCH_FEATURES; k++) {
+                calculated_number_t d = batch->centers[c][k][i] - batch->features[k][i];
+                sum += d * d;
+            }
+
+            mean_dist += std::sqrt(sum);
+        }
+
+        mean_dist /= 2;
+
+        calculated_number_t min_dist = batch->min_dist[i];
+        calculated_number_t max_dist = batch->max_dist[i];
+
+        if (max_dist == min_dist) {
+            batch->scores[i] = 0.0;
+            continue;
+        }
+
+        calculated_number_t anomaly_score = 100.0 * std::abs((mean_dist - min_dist) / (max_dist - min_dist));
+        batch->scores[i] = (anomaly_score > 100.0) ? 100.0 : anomaly_score;
+    }
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ML_KMEANS_SIMD_X86_64 1
+#include <immintrin.h>
+
+// 4 rows per iteration; explicit multiplies and additions, so that
+// the compiler cannot contract them and the scores stay bit-identical
+__attribute__((target("avx")))
+static void
+ml_kmeans_anomaly_score_batch_avx(ml_kmeans_batch_t *batch)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d hundred = _mm256_set1_pd(100.0);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+
+    size_t i = 0;
+    for (; i + 4 <= batch->rows; i += 4) {
+        __m256d mean_dist = zero;
+
+        for (size_t c = 0; c != 2; c++) {
+            __m256d sum = zero;
+
+            for (size_t k = 0; k != ML_KMEANS_BATCH_FEATURES; k++) {
+                __m256d d = _mm256_sub_pd(_mm256_loadu_pd(&batch->centers[c][k][i]),
+                                          _mm256_loadu_pd(&batch->features[k][i]));
+                sum = _mm256_add_pd(sum, _mm256_mul_pd(d, d));
+            }
+
+            mean_dist = _mm256_add_pd(mean_dist, _mm256_sqrt_pd(sum));
+        }
+
+        mean_dist = _mm256_div_pd(mean_dist, two);
+
+        __m256d min_dist = _mm256_loadu_pd(&batch->min_dist[i]);
+        __m256d max_dist = _mm256_loadu_pd(&batch->max_dist[i]);
+
+        __m256d score = _mm256_div_pd(_mm256_sub_pd(mean_dist, min_dist), _mm256_sub_pd(max_dist, min_dist));
+        score = _mm256_mul_pd(hundred, _mm256_andnot_pd(sign, score));
+
+        // NAN scores are not clamped, like in the scalar version
+        score = _mm256_blendv_pd(score, hundred, _mm256_cmp_pd(score, hundred, _CMP_GT_OQ));
+        score = _mm256_blendv_pd(score, zero, _mm256_cmp_pd(max_dist, min_dist, _CMP_EQ_OQ));
+
+        _mm256_storeu_pd(&batch->scores[i], score);
+    }
+
+    ml_kmeans_anomaly_score_batch_scalar(batch, i);
+}
+
+static bool ml_kmeans_use_avx = false;
+
+__attribute__((constructor)) static void ml_kmeans_simd_detect(void)
+{
+    __builtin_cpu_init();
+    ml_kmeans_use_avx = __builtin_cpu_supports("avx");
+}
+
+#endif // ML_KMEANS_SIMD_X86_64
+
+void
+ml_kmeans_anomaly_score_batch(ml_kmeans_batch_t *batch)
+{
+#ifdef ML_KMEANS_SIMD_X86_64
+    if (ml_kmeans_use_avx) {
+        ml_kmeans_anomaly_score_batch_avx(batch);
+        return;
+    }
+#endif
+
+    ml_kmeans_anomaly_score_batch_scalar(batch, 0);
+}
+
+const char *
+ml_kmeans_anomaly_score_batch_implementation()
+{
+#ifdef ML_KMEANS_SIMD_X86_64
+    if (ml_kmeans_use_avx)
+        return "avx";
+#endif
+
+    return "scalar";
+}
+
 static void ml_buffer_json_member_add_double(BUFFER *wb, const char *key, calculated_number_t cn) {
     if (!isnan(cn) && !isinf(cn)) {
         buffer_json_member_add_double(wb, key, cn);
@@ -96,6 +96,42 @@ void ml_kmeans_train(ml_kmeans_t *kmeans, const ml_features_t *features, unsigne
 
 calculated_number_t ml_kmeans_anomaly_score(const ml_kmeans_inlined_t *kmeans, const DSample &DS);
 
+/*
+ * Structure-of-arrays buffer for scoring many samples in a single pass,
+ * each one against its own model. Row i is a sample and its model, and
+ * every coordinate of the samples and of the cluster centers is a column.
+*/
+
+#define ML_KMEANS_BATCH_FEATURES 6
+
+struct ml_kmeans_batch_t {
+    size_t rows;
+
+    std::vector<calculated_number_t> features[ML_KMEANS_BATCH_FEATURES];
+    std::vector<calculated_number_t> centers[2][ML_KMEANS_BATCH_FEATURES];
+    std::vector<calculated_number_t> min_dist;
+    std::vector<calculated_number_t> max_dist;
+
+    // the output of ml_kmeans_anomaly_score_batch()
+    std::vector<calculated_number_t> scores;
+
+    ml_kmeans_batch_t() : rows(0)
+    {
+    }
+
+    void clear()
+    {
+        rows = 0;
+    }
+
+    void add(const ml_kmeans_inlined_t *inlined_km, const DSample &DS);
+};
+
+// the scores are identical to calling ml_kmeans_anomaly_score() for each row
+void ml_kmeans_anomaly_score_batch(ml_kmeans_batch_t *batch);
+
+const char *ml_kmeans_anomaly_score_batch_implementation();
+
 void ml_kmeans_serialize(const ml_kmeans_inlined_t *inlined_km, BUFFER *wb);
 
 bool ml_kmeans_deserialize(ml_kmeans_inlined_t *inlined_km, struct json_object *root);
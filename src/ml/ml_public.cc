@@ -356,6 +356,25 @@ bool ml_dimension_is_anomalous(RRDDIM *rd, time_t curr_time, double value, bool
     return is_anomalous;
 }
 
+void ml_dimensions_are_anomalous(RRDSET *rs, ML_DIMENSION_PREDICTION *predictions, size_t entries)
+{
+    ml_host_t *host = (ml_host_t *) rs->rrdhost->ml_host;
+    if (!host || !host->ml_running) {
+        for (size_t i = 0; i != entries; i++)
+            predictions[i].anomalous = false;
+        return;
+    }
+
+    ml_dimensions_predict(predictions, entries);
+
+    ml_chart_t *chart = (ml_chart_t *) rs->ml_chart;
+    for (size_t i = 0; i != entries; i++) {
+        ml_dimension_t *dim = (ml_dimension_t *) predictions[i].rd->ml_dimension;
+        if (dim)
+            ml_chart_update_dimension(chart, dim, predictions[i].anomalous);
+    }
+}
+
 void ml_init()
 {
     // Read config values
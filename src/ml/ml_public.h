@@ -36,9 +36,19 @@ void ml_chart_delete(RRDSET *rs);
 bool ml_chart_update_begin(RRDSET *rs);
 void ml_chart_update_end(RRDSET *rs);
 
+// the dimensions of a chart collected in the same iteration,
+// for ml_dimensions_are_anomalous()
+typedef struct ml_dimension_prediction {
+    RRDDIM *rd;
+    double value;
+    bool exists;
+    bool anomalous;
+} ML_DIMENSION_PREDICTION;
+
 void ml_dimension_new(RRDDIM *rd);
 void ml_dimension_delete(RRDDIM *rd);
 bool ml_dimension_is_anomalous(RRDDIM *rd, time_t curr_time, double value, bool exists);
+void ml_dimensions_are_anomalous(RRDSET *rs, ML_DIMENSION_PREDICTION *predictions, size_t entries);
 void ml_dimension_received_anomaly(RRDDIM *rd, bool is_anomalous);
 
 int ml_dimension_load_models(RRDDIM *rd, sqlite3_stmt **stmt);
@@ -58,6 +68,8 @@ uint64_t sqlite_get_ml_space(void);
 
 bool ml_model_received_from_child(RRDHOST *host, const char *json);
 
+int ml_bench(int argc, char *argv[]);
+
 #ifdef __cplusplus
 };
 #endif
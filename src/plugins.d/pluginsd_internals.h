@@ -358,4 +358,33 @@ static inline SN_FLAGS pluginsd_parse_storage_number_flags(const char *flags_str
     return flags;
 }
 
+// ----------------------------------------------------------------------------
+// decoding binary frames - see streaming/protocol/commands.h for their format
+
+struct binary_frame_reader {
+    const uint8_t *pos;
+    const uint8_t *end;
+};
+
+static ALWAYS_INLINE bool binary_frame_get(struct binary_frame_reader *r, void *dst, size_t size) {
+    if(unlikely((size_t)(r->end - r->pos) < size))
+        return false;
+
+    memcpy(dst, r->pos, size);
+    r->pos += size;
+    return true;
+}
+
+static ALWAYS_INLINE bool binary_frame_get_string(struct binary_frame_reader *r, char *dst, size_t dst_size) {
+    uint16_t len;
+    if(unlikely(!binary_frame_get(r, &len, sizeof(len)) || len >= dst_size))
+        return false;
+
+    if(unlikely(!binary_frame_get(r, dst, len)))
+        return false;
+
+    dst[len] = '\0';
+    return true;
+}
+
 #endif //NETDATA_PLUGINSD_INTERNALS_H
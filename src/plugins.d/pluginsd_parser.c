@@ -708,20 +708,16 @@ static inline PARSER_RC pluginsd_clabel_commit(char **words __maybe_unused, size
     return PARSER_RC_OK;
 }
 
-static ALWAYS_INLINE PARSER_RC pluginsd_begin_v2(char **words, size_t num_words, PARSER *parser) {
-    timing_init();
-
-    int idx = 1;
-    ssize_t slot = pluginsd_parse_rrd_slot(words, num_words);
-    if(slot >= 0) idx++;
-
-    char *id = get_word(words, num_words, idx++);
-    char *update_every_str = get_word(words, num_words, idx++);
-    char *end_time_str = get_word(words, num_words, idx++);
-    char *wall_clock_time_str = get_word(words, num_words, idx++);
+// the *_str parameters are the original text of the values (when they are received as text),
+// and frame is the original binary samples frame (when they are received in binary),
+// used to propagate them without encoding them again
+static ALWAYS_INLINE PARSER_RC pluginsd_begin_v2_internal(
+    PARSER *parser, ssize_t slot, const char *id,
+    time_t update_every, time_t end_time, time_t wall_clock_time,
+    const char *update_every_str, const char *end_time_str, const char *wall_clock_time_str,
+    const char *frame, size_t frame_size) {
 
-    if(unlikely(!id || !update_every_str || !end_time_str || !wall_clock_time_str))
-        return PLUGINSD_DISABLE_PLUGIN(parser, PLUGINSD_KEYWORD_BEGIN_V2, "missing parameters");
+    timing_init();
 
     RRDHOST *host = pluginsd_require_scope_host(parser, PLUGINSD_KEYWORD_BEGIN_V2);
     if(unlikely(!host)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
@@ -740,18 +736,6 @@ static ALWAYS_INLINE PARSER_RC pluginsd_begin_v2(char **words, size_t num_words,
 
     timing_step(TIMING_STEP_BEGIN2_FIND_CHART);
 
-    // ------------------------------------------------------------------------
-    // parse the parameters
-
-    time_t update_every = (time_t) str2ull_encoded(update_every_str);
-    time_t end_time = (time_t) str2ull_encoded(end_time_str);
-
-    time_t wall_clock_time;
-    if(likely(*wall_clock_time_str == '#'))
-        wall_clock_time = end_time;
-    else
-        wall_clock_time = (time_t) str2ull_encoded(wall_clock_time_str);
-
     if (unlikely(update_every != st->update_every))
         rrdset_set_update_every_s(st, update_every);
 
@@ -775,9 +759,15 @@ static ALWAYS_INLINE PARSER_RC pluginsd_begin_v2(char **words, size_t num_words,
     if(!parser->user.v2.stream_buffer.wb && rrdhost_has_stream_sender_enabled(st->rrdhost))
         parser->user.v2.stream_buffer = stream_send_metrics_init(parser->user.st, wall_clock_time);
 
-    if(parser->user.v2.stream_buffer.v2 && parser->user.v2.stream_buffer.wb) {
+    // binary frames are copied as-is when our parent receives binary frames too,
+    // the dimensions will only update their slots and flags in the copy
+    bool relayed = frame && parser->user.v2.stream_buffer.binary &&
+                   stream_send_rrdset_metrics_relay_binary_frame(&parser->user.v2.stream_buffer, st, frame, frame_size, end_time);
+
+    if(!relayed && parser->user.v2.stream_buffer.v2 && parser->user.v2.stream_buffer.wb) {
         // check receiver capabilities
-        bool can_copy = stream_has_capability(&parser->user, STREAM_CAP_IEEE754) == stream_has_capability(&parser->user.v2.stream_buffer, STREAM_CAP_IEEE754);
+        bool can_copy = update_every_str &&
+                        stream_has_capability(&parser->user, STREAM_CAP_IEEE754) == stream_has_capability(&parser->user.v2.stream_buffer, STREAM_CAP_IEEE754);
 
         // check sender capabilities
         bool with_slots = stream_has_capability(&parser->user.v2.stream_buffer, STREAM_CAP_SLOTS) ? true : false;
@@ -848,20 +838,38 @@ static ALWAYS_INLINE PARSER_RC pluginsd_begin_v2(char **words, size_t num_words,
     return PARSER_RC_OK;
 }
 
-static ALWAYS_INLINE PARSER_RC pluginsd_set_v2(char **words, size_t num_words, PARSER *parser) {
-    timing_init();
-
+static ALWAYS_INLINE PARSER_RC pluginsd_begin_v2(char **words, size_t num_words, PARSER *parser) {
     int idx = 1;
     ssize_t slot = pluginsd_parse_rrd_slot(words, num_words);
     if(slot >= 0) idx++;
 
-    char *dimension = get_word(words, num_words, idx++);
-    char *collected_str = get_word(words, num_words, idx++);
-    char *value_str = get_word(words, num_words, idx++);
-    char *flags_str = get_word(words, num_words, idx++);
+    char *id = get_word(words, num_words, idx++);
+    char *update_every_str = get_word(words, num_words, idx++);
+    char *end_time_str = get_word(words, num_words, idx++);
+    char *wall_clock_time_str = get_word(words, num_words, idx++);
 
-    if(unlikely(!dimension || !collected_str || !value_str || !flags_str))
-        return PLUGINSD_DISABLE_PLUGIN(parser, PLUGINSD_KEYWORD_SET_V2, "missing parameters");
+    if(unlikely(!id || !update_every_str || !end_time_str || !wall_clock_time_str))
+        return PLUGINSD_DISABLE_PLUGIN(parser, PLUGINSD_KEYWORD_BEGIN_V2, "missing parameters");
+
+    time_t update_every = (time_t) str2ull_encoded(update_every_str);
+    time_t end_time = (time_t) str2ull_encoded(end_time_str);
+
+    time_t wall_clock_time;
+    if(likely(*wall_clock_time_str == '#'))
+        wall_clock_time = end_time;
+    else
+        wall_clock_time = (time_t) str2ull_encoded(wall_clock_time_str);
+
+    return pluginsd_begin_v2_internal(parser, slot, id, update_every, end_time, wall_clock_time,
+                                      update_every_str, end_time_str, wall_clock_time_str, NULL, 0);
+}
+
+static ALWAYS_INLINE PARSER_RC pluginsd_set_v2_internal(
+    PARSER *parser, ssize_t slot, const char *dimension,
+    collected_number collected_value, NETDATA_DOUBLE value, SN_FLAGS flags,
+    const char *collected_str, const char *value_str) {
+
+    timing_init();
 
     RRDHOST *host = pluginsd_require_scope_host(parser, PLUGINSD_KEYWORD_SET_V2);
     if(unlikely(!host)) return PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
@@ -881,19 +889,6 @@ static ALWAYS_INLINE PARSER_RC pluginsd_set_v2(char **words, size_t num_words, P
 
     timing_step(TIMING_STEP_SET2_LOOKUP_DIMENSION);
 
-    // ------------------------------------------------------------------------
-    // parse the parameters
-
-    collected_number collected_value = (collected_number) str2ll_encoded(collected_str);
-
-    NETDATA_DOUBLE value;
-    if(*value_str == '#')
-        value = (NETDATA_DOUBLE)collected_value;
-    else
-        value = str2ndd_encoded(value_str, NULL);
-
-    SN_FLAGS flags = pluginsd_parse_storage_number_flags(flags_str);
-
     timing_step(TIMING_STEP_SET2_PARSE);
 
     // ------------------------------------------------------------------------
@@ -933,9 +928,13 @@ static ALWAYS_INLINE PARSER_RC pluginsd_set_v2(char **words, size_t num_words, P
     // ------------------------------------------------------------------------
     // propagate it forward in v2
 
-    if(parser->user.v2.stream_buffer.v2 && parser->user.v2.stream_buffer.begin_v2_added && parser->user.v2.stream_buffer.wb) {
+    if(parser->user.v2.stream_buffer.binary_frame_relayed)
+        stream_send_rrddim_metrics_relayed(&parser->user.v2.stream_buffer, rd, flags);
+
+    else if(parser->user.v2.stream_buffer.v2 && parser->user.v2.stream_buffer.begin_v2_added && parser->user.v2.stream_buffer.wb) {
         // check if receiver and sender have the same number parsing capabilities
-        bool can_copy = stream_has_capability(&parser->user, STREAM_CAP_IEEE754) == stream_has_capability(&parser->user.v2.stream_buffer, STREAM_CAP_IEEE754);
+        bool can_copy = collected_str && value_str &&
+                        stream_has_capability(&parser->user, STREAM_CAP_IEEE754) == stream_has_capability(&parser->user.v2.stream_buffer, STREAM_CAP_IEEE754);
 
         // check the sender capabilities
         bool with_slots = stream_has_capability(&parser->user.v2.stream_buffer, STREAM_CAP_SLOTS) ? true : false;
@@ -987,6 +986,32 @@ static ALWAYS_INLINE PARSER_RC pluginsd_set_v2(char **words, size_t num_words, P
     return PARSER_RC_OK;
 }
 
+static ALWAYS_INLINE PARSER_RC pluginsd_set_v2(char **words, size_t num_words, PARSER *parser) {
+    int idx = 1;
+    ssize_t slot = pluginsd_parse_rrd_slot(words, num_words);
+    if(slot >= 0) idx++;
+
+    char *dimension = get_word(words, num_words, idx++);
+    char *collected_str = get_word(words, num_words, idx++);
+    char *value_str = get_word(words, num_words, idx++);
+    char *flags_str = get_word(words, num_words, idx++);
+
+    if(unlikely(!dimension || !collected_str || !value_str || !flags_str))
+        return PLUGINSD_DISABLE_PLUGIN(parser, PLUGINSD_KEYWORD_SET_V2, "missing parameters");
+
+    collected_number collected_value = (collected_number) str2ll_encoded(collected_str);
+
+    NETDATA_DOUBLE value;
+    if(*value_str == '#')
+        value = (NETDATA_DOUBLE)collected_value;
+    else
+        value = str2ndd_encoded(value_str, NULL);
+
+    SN_FLAGS flags = pluginsd_parse_storage_number_flags(flags_str);
+
+    return pluginsd_set_v2_internal(parser, slot, dimension, collected_value, value, flags, collected_str, value_str);
+}
+
 static ALWAYS_INLINE PARSER_RC pluginsd_end_v2(char **words __maybe_unused, size_t num_words __maybe_unused, PARSER *parser) {
     timing_init();
 
@@ -1060,6 +1085,89 @@ static ALWAYS_INLINE PARSER_RC pluginsd_end_v2(char **words __maybe_unused, size
     return PARSER_RC_OK;
 }
 
+// ----------------------------------------------------------------------------
+// binary samples frames (STREAM_CAP_BINARY_SAMPLES) - see streaming/protocol/commands.h
+
+// process a complete frame, including its header
+// returns non-zero on failure, like parser_action()
+int pluginsd_binary_samples_frame(PARSER *parser, const char *frame, size_t size) {
+    parser->line.count++;
+
+    struct binary_frame_reader r = {
+        .pos = (const uint8_t *)frame,
+        .end = (const uint8_t *)frame + size,
+    };
+
+    uint8_t marker, frame_flags;
+    uint32_t payload_size;
+    if(unlikely(!binary_frame_get(&r, &marker, sizeof(marker)) ||
+                !binary_frame_get(&r, &frame_flags, sizeof(frame_flags)) ||
+                !binary_frame_get(&r, &payload_size, sizeof(payload_size)) ||
+                marker != STREAM_BINARY_FRAME_MARKER ||
+                payload_size != (size_t)(r.end - r.pos)))
+        goto malformed;
+
+    uint32_t chart_slot, update_every, dimensions;
+    int64_t end_time, wall_clock_time;
+    char id[RRD_ID_LENGTH_MAX + 1];
+
+    if(unlikely(!binary_frame_get(&r, &chart_slot, sizeof(chart_slot)) ||
+                !binary_frame_get_string(&r, id, sizeof(id)) ||
+                !binary_frame_get(&r, &update_every, sizeof(update_every)) ||
+                !binary_frame_get(&r, &end_time, sizeof(end_time)) ||
+                !binary_frame_get(&r, &wall_clock_time, sizeof(wall_clock_time)) ||
+                !binary_frame_get(&r, &dimensions, sizeof(dimensions))))
+        goto malformed;
+
+    if(pluginsd_begin_v2_internal(parser, chart_slot ? (ssize_t)chart_slot : -1, id,
+                                  (time_t)update_every, (time_t)end_time, (time_t)wall_clock_time,
+                                  NULL, NULL, NULL, frame, size) != PARSER_RC_OK)
+        return 1;
+
+    for(uint32_t d = 0; d < dimensions ; d++) {
+        uint32_t dim_slot;
+        uint8_t dim_flags;
+        int64_t collected;
+
+        if(unlikely(!binary_frame_get(&r, &dim_slot, sizeof(dim_slot)) ||
+                    !binary_frame_get_string(&r, id, sizeof(id)) ||
+                    !binary_frame_get(&r, &dim_flags, sizeof(dim_flags)) ||
+                    !binary_frame_get(&r, &collected, sizeof(collected))))
+            goto malformed;
+
+        NETDATA_DOUBLE value;
+        if(dim_flags & STREAM_BINARY_DIM_VALUE_IS_COLLECTED)
+            value = (NETDATA_DOUBLE)collected;
+        else {
+            double v;
+            if(unlikely(!binary_frame_get(&r, &v, sizeof(v))))
+                goto malformed;
+            value = (NETDATA_DOUBLE)v;
+        }
+
+        SN_FLAGS flags = binary_frame_sn_flags(dim_flags);
+
+        if(pluginsd_set_v2_internal(parser, dim_slot ? (ssize_t)dim_slot : -1, id,
+                                    (collected_number)collected, value, flags, NULL, NULL) != PARSER_RC_OK)
+            return 1;
+    }
+
+    if(unlikely(r.pos != r.end))
+        goto malformed;
+
+    if(frame_flags & STREAM_BINARY_FRAME_FLAG_OPEN)
+        // text lines follow for this chart, ending with END2
+        return 0;
+
+    return pluginsd_end_v2(NULL, 0, parser) != PARSER_RC_OK;
+
+malformed:
+    nd_log(NDLS_DAEMON, NDLP_ERR,
+           "PLUGINSD: received a malformed binary samples frame of %zu bytes, on line %zu",
+           size, parser->line.count);
+    return 1;
+}
+
 static inline PARSER_RC pluginsd_exit(char **words __maybe_unused, size_t num_words __maybe_unused, PARSER *parser __maybe_unused) {
     netdata_log_info("PLUGINSD: plugin called EXIT.");
     return PARSER_RC_STOP;
@@ -175,6 +175,9 @@ bool parser_reconstruct_node(BUFFER *wb, void *ptr);
 bool parser_reconstruct_instance(BUFFER *wb, void *ptr);
 bool parser_reconstruct_context(BUFFER *wb, void *ptr);
 
+int pluginsd_binary_samples_frame(PARSER *parser, const char *frame, size_t size);
+int pluginsd_replay_bulk_frame(PARSER *parser, const char *frame, size_t size);
+
 static inline int parser_action(PARSER *parser, char *input) {
 #ifdef NETDATA_LOG_STREAM_RECEIVER
     char line[1024];
@@ -109,6 +109,41 @@ PARSER_RC pluginsd_chart_definition_end(char **words, size_t num_words, PARSER *
     return ok ? PARSER_RC_OK : PARSER_RC_ERROR;
 }
 
+// set the chart and the parser state for storing the points of the replicated
+// time-range, the last of which is start_time to end_time
+static ALWAYS_INLINE void pluginsd_replay_points_begin(PARSER *parser, RRDSET *st, time_t start_time, time_t end_time, time_t wall_clock_time, size_t points) {
+    if (unlikely(end_time - start_time != st->update_every))
+        rrdset_set_update_every_s(st, end_time - start_time);
+
+    st->last_collected_time.tv_sec = end_time;
+    st->last_collected_time.tv_usec = 0;
+
+    st->last_updated.tv_sec = end_time;
+    st->last_updated.tv_usec = 0;
+
+    st->counter += points;
+    st->counter_done += points;
+
+    // these are only needed for db mode RAM, ALLOC
+    st->db.current_entry = (st->db.current_entry + points) % st->db.entries;
+
+    parser->user.replay.start_time = start_time;
+    parser->user.replay.end_time = end_time;
+    parser->user.replay.start_time_ut = (usec_t) start_time * USEC_PER_SEC;
+    parser->user.replay.end_time_ut = (usec_t) end_time * USEC_PER_SEC;
+    parser->user.replay.wall_clock_time = wall_clock_time;
+    parser->user.replay.rset_enabled = true;
+}
+
+static ALWAYS_INLINE void pluginsd_replay_points_disable(PARSER *parser) {
+    parser->user.replay.start_time = 0;
+    parser->user.replay.end_time = 0;
+    parser->user.replay.start_time_ut = 0;
+    parser->user.replay.end_time_ut = 0;
+    parser->user.replay.wall_clock_time = 0;
+    parser->user.replay.rset_enabled = false;
+}
+
 ALWAYS_INLINE PARSER_RC pluginsd_replay_begin(char **words, size_t num_words, PARSER *parser) {
     int idx = 1;
     ssize_t slot = pluginsd_parse_rrd_slot(words, num_words);
@@ -166,30 +201,7 @@ ALWAYS_INLINE PARSER_RC pluginsd_replay_begin(char **words, size_t num_words, PA
 #endif
 
         if(start_time && end_time && start_time < wall_clock_time + tolerance && end_time < wall_clock_time + tolerance && start_time < end_time) {
-            if (unlikely(end_time - start_time != st->update_every))
-                rrdset_set_update_every_s(st, end_time - start_time);
-
-            st->last_collected_time.tv_sec = end_time;
-            st->last_collected_time.tv_usec = 0;
-
-            st->last_updated.tv_sec = end_time;
-            st->last_updated.tv_usec = 0;
-
-            st->counter++;
-            st->counter_done++;
-
-            // these are only needed for db mode RAM, ALLOC
-            st->db.current_entry++;
-            if(st->db.current_entry >= st->db.entries)
-                st->db.current_entry -= st->db.entries;
-
-            parser->user.replay.start_time = start_time;
-            parser->user.replay.end_time = end_time;
-            parser->user.replay.start_time_ut = (usec_t) start_time * USEC_PER_SEC;
-            parser->user.replay.end_time_ut = (usec_t) end_time * USEC_PER_SEC;
-            parser->user.replay.wall_clock_time = wall_clock_time;
-            parser->user.replay.rset_enabled = true;
-
+            pluginsd_replay_points_begin(parser, st, start_time, end_time, wall_clock_time, 1);
             return PARSER_RC_OK;
         }
 
@@ -205,12 +217,7 @@ ALWAYS_INLINE PARSER_RC pluginsd_replay_begin(char **words, size_t num_words, PA
     // the child sends an RBEGIN without any parameters initially
     // setting rset_enabled to false, means the RSET should not store any metrics
     // to store metrics, the RBEGIN needs to have timestamps
-    parser->user.replay.start_time = 0;
-    parser->user.replay.end_time = 0;
-    parser->user.replay.start_time_ut = 0;
-    parser->user.replay.end_time_ut = 0;
-    parser->user.replay.wall_clock_time = 0;
-    parser->user.replay.rset_enabled = false;
+    pluginsd_replay_points_disable(parser);
     return PARSER_RC_OK;
 }
 
@@ -290,6 +297,141 @@ ALWAYS_INLINE PARSER_RC pluginsd_replay_set(char **words, size_t num_words, PARS
     return PARSER_RC_OK;
 }
 
+// process a complete bulk replication frame, including its header
+// it is equivalent to an RBEGIN with its RSETs for every point of the frame
+// returns non-zero on failure, like parser_action()
+int pluginsd_replay_bulk_frame(PARSER *parser, const char *frame, size_t size) {
+    parser->line.count++;
+
+    struct binary_frame_reader r = {
+        .pos = (const uint8_t *)frame,
+        .end = (const uint8_t *)frame + size,
+    };
+
+    uint8_t marker, frame_flags;
+    uint32_t payload_size;
+    if(unlikely(!binary_frame_get(&r, &marker, sizeof(marker)) ||
+                !binary_frame_get(&r, &frame_flags, sizeof(frame_flags)) ||
+                !binary_frame_get(&r, &payload_size, sizeof(payload_size)) ||
+                marker != STREAM_REPLAY_FRAME_MARKER ||
+                payload_size != (size_t)(r.end - r.pos)))
+        goto malformed;
+
+    uint32_t chart_slot, update_every, points, dimensions;
+    int64_t first_end_time, wall_clock_time;
+    char id[RRD_ID_LENGTH_MAX + 1];
+
+    if(unlikely(!binary_frame_get(&r, &chart_slot, sizeof(chart_slot)) ||
+                !binary_frame_get_string(&r, id, sizeof(id)) ||
+                !binary_frame_get(&r, &first_end_time, sizeof(first_end_time)) ||
+                !binary_frame_get(&r, &update_every, sizeof(update_every)) ||
+                !binary_frame_get(&r, &points, sizeof(points)) ||
+                !binary_frame_get(&r, &wall_clock_time, sizeof(wall_clock_time)) ||
+                !binary_frame_get(&r, &dimensions, sizeof(dimensions)) ||
+                !points || !update_every))
+        goto malformed;
+
+    RRDHOST *host = pluginsd_require_scope_host(parser, PLUGINSD_KEYWORD_REPLAY_BEGIN);
+    if(unlikely(!host)) { PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL); return 1; }
+
+    RRDSET *st = pluginsd_rrdset_cache_get_from_slot(parser, host, id, chart_slot ? (ssize_t)chart_slot : -1, PLUGINSD_KEYWORD_REPLAY_BEGIN);
+    if(unlikely(!st || !pluginsd_set_scope_chart(parser, st, PLUGINSD_KEYWORD_REPLAY_BEGIN))) {
+        PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL);
+        return 1;
+    }
+
+    time_t first_start_time = (time_t)first_end_time - (time_t)update_every;
+    time_t last_end_time = (time_t)first_end_time + (time_t)(points - 1) * (time_t)update_every;
+
+    time_t tolerance = st->update_every + 1;
+    if(wall_clock_time <= 0) {
+        wall_clock_time = now_realtime_sec();
+        tolerance = st->update_every + 5;
+    }
+
+    if(unlikely(first_start_time <= 0 || last_end_time >= wall_clock_time + tolerance)) {
+        nd_log(NDLS_DAEMON, NDLP_ERR,
+               "PLUGINSD REPLAY ERROR: 'host:%s/chart:%s' got a bulk replication frame "
+               "from %ld to %ld, but timestamps are invalid (now is %ld, tolerance %ld). Ignoring its points.",
+               rrdhost_hostname(st->rrdhost), rrdset_id(st), first_start_time, last_end_time,
+               (time_t)wall_clock_time, tolerance);
+
+        pluginsd_replay_points_disable(parser);
+        return 0;
+    }
+
+    pluginsd_replay_points_begin(parser, st, last_end_time - (time_t)update_every, last_end_time, (time_t)wall_clock_time, points);
+
+    // store the points dimension by dimension
+    usec_t first_end_time_ut = (usec_t)first_end_time * USEC_PER_SEC;
+    usec_t update_every_ut = (usec_t)update_every * USEC_PER_SEC;
+
+    for(uint32_t d = 0; d < dimensions ; d++) {
+        uint32_t dim_slot;
+        if(unlikely(!binary_frame_get(&r, &dim_slot, sizeof(dim_slot)) ||
+                    !binary_frame_get_string(&r, id, sizeof(id)) ||
+                    (size_t)(r.end - r.pos) < (size_t)points * (sizeof(double) + sizeof(uint8_t))))
+            goto malformed;
+
+        const uint8_t *values = r.pos;
+        const uint8_t *flags = r.pos + (size_t)points * sizeof(double);
+        r.pos = flags + points;
+
+        RRDDIM *rd = pluginsd_acquire_dimension(host, st, id, dim_slot ? (ssize_t)dim_slot : -1, PLUGINSD_KEYWORD_REPLAY_SET);
+        if(unlikely(!rd)) { PLUGINSD_DISABLE_PLUGIN(parser, NULL, NULL); return 1; }
+
+        st->pluginsd.set = true;
+
+        if(unlikely(rrddim_flag_check(rd, RRDDIM_FLAG_ARCHIVED))) {
+            nd_log_limit_static_global_var(erl, 1, 0);
+            nd_log_limit(&erl, NDLS_COLLECTORS, NDLP_WARNING,
+                         "PLUGINSD REPLAY ERROR: 'host:%s/chart:%s/dim:%s' has the ARCHIVED flag set, but it is replicated. "
+                         "Ignoring data.",
+                         rrdhost_hostname(st->rrdhost), rrdset_id(st), rrddim_name(rd));
+            continue;
+        }
+
+        size_t stored = 0;
+        usec_t last_stored_ut = 0;
+        for(uint32_t p = 0; p < points ; p++) {
+            if(unlikely(flags[p] & STREAM_REPLAY_POINT_MISSING))
+                continue;
+
+            double v;
+            memcpy(&v, &values[p * sizeof(double)], sizeof(v));
+
+            NETDATA_DOUBLE value = (NETDATA_DOUBLE)v;
+            SN_FLAGS sn_flags = binary_frame_sn_flags(flags[p]);
+
+            if (!netdata_double_isnumber(value) || (sn_flags == SN_EMPTY_SLOT)) {
+                value = NAN;
+                sn_flags = SN_EMPTY_SLOT;
+            }
+
+            last_stored_ut = first_end_time_ut + p * update_every_ut;
+            rrddim_store_metric(rd, last_stored_ut, value, sn_flags);
+            stored++;
+        }
+
+        if(stored) {
+            rd->collector.last_collected_time.tv_sec = (time_t)(last_stored_ut / USEC_PER_SEC);
+            rd->collector.last_collected_time.tv_usec = 0;
+            rd->collector.counter += stored;
+        }
+    }
+
+    if(unlikely(r.pos != r.end))
+        goto malformed;
+
+    return 0;
+
+malformed:
+    nd_log(NDLS_DAEMON, NDLP_ERR,
+           "PLUGINSD: received a malformed bulk replication frame of %zu bytes, on line %zu",
+           size, parser->line.count);
+    return 1;
+}
+
 ALWAYS_INLINE PARSER_RC pluginsd_replay_rrddim_collection_state(char **words, size_t num_words, PARSER *parser) {
     if(parser->user.replay.rset_enabled == false)
         return PARSER_RC_OK;
@@ -71,6 +71,7 @@ ALWAYS_INLINE RRDSET_STREAM_BUFFER stream_send_metrics_init(RRDSET *st, time_t w
     return (RRDSET_STREAM_BUFFER) {
         .capabilities = host->sender->capabilities,
         .v2 = stream_has_capability(host->sender, STREAM_CAP_INTERPOLATED),
+        .binary = stream_has_capability(host->sender, STREAM_CAP_BINARY_SAMPLES),
         .rrdset_flags = rrdset_flags,
         .wb = preferred_sender_buffer(host),
         .wall_clock_time = wall_clock_time,
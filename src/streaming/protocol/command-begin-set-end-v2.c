@@ -4,10 +4,162 @@
 #include "../stream-sender-internals.h"
 #include "plugins.d/pluginsd_internals.h"
 
+// ----------------------------------------------------------------------------
+// binary samples frames - see commands.h for the format
+
+static void binary_frame_begin(RRDSET_STREAM_BUFFER *rsb, RRDSET *st, time_t point_end_time_s) {
+    BUFFER *wb = rsb->wb;
+    buffer_need_bytes(wb, STREAM_BINARY_FRAME_HEADER_SIZE + 4 + 2 + string_strlen(st->id) + 4 + 8 + 8 + 4 + 1);
+
+    rsb->binary_frame_pos = wb->len;
+    binary_frame_put_u8(wb, STREAM_BINARY_FRAME_MARKER);
+    binary_frame_put_u8(wb, 0);                 // flags, set when the frame is closed
+    binary_frame_put_u32(wb, 0);                // payload size, set when the frame is closed
+
+    binary_frame_put_u32(wb, (uint32_t)st->stream.snd.chart_slot);
+    binary_frame_put_string(wb, st->id);
+    binary_frame_put_u32(wb, (uint32_t)st->update_every);
+    binary_frame_put_i64(wb, point_end_time_s);
+    binary_frame_put_i64(wb, rsb->wall_clock_time);
+
+    rsb->binary_frame_dims_pos = wb->len;
+    binary_frame_put_u32(wb, 0);                // number of dimensions, set when the frame is closed
+
+    wb->buffer[wb->len] = '\0';
+
+    rsb->binary_frame_dims = 0;
+    rsb->binary_frame_open = true;
+}
+
+static void binary_frame_close(RRDSET_STREAM_BUFFER *rsb, bool keep_chart_open) {
+    BUFFER *wb = rsb->wb;
+
+    uint8_t flags = keep_chart_open ? STREAM_BINARY_FRAME_FLAG_OPEN : 0;
+    uint32_t payload_size = (uint32_t)(wb->len - rsb->binary_frame_pos - STREAM_BINARY_FRAME_HEADER_SIZE);
+
+    memcpy(&wb->buffer[rsb->binary_frame_pos + 1], &flags, sizeof(flags));
+    memcpy(&wb->buffer[rsb->binary_frame_pos + 2], &payload_size, sizeof(payload_size));
+    memcpy(&wb->buffer[rsb->binary_frame_dims_pos], &rsb->binary_frame_dims, sizeof(rsb->binary_frame_dims));
+
+    rsb->binary_frame_open = false;
+}
+
+static void stream_send_rrddim_metrics_binary(RRDSET_STREAM_BUFFER *rsb, RRDDIM *rd, time_t point_end_time_s, NETDATA_DOUBLE n, SN_FLAGS flags) {
+    BUFFER *wb = rsb->wb;
+
+    if(unlikely(rsb->last_point_end_time_s != point_end_time_s || !rsb->binary_frame_open)) {
+        if(rsb->binary_frame_open)
+            binary_frame_close(rsb, false);
+
+        binary_frame_begin(rsb, rd->rrdset, point_end_time_s);
+
+        rsb->last_point_end_time_s = point_end_time_s;
+        rsb->begin_v2_added = true;
+    }
+
+    uint8_t dim_flags = binary_frame_dim_flags(flags);
+
+    bool value_is_collected = ((NETDATA_DOUBLE)rd->collector.last_collected_value == n);
+    if(value_is_collected)
+        dim_flags |= STREAM_BINARY_DIM_VALUE_IS_COLLECTED;
+
+    buffer_need_bytes(wb, 4 + 2 + string_strlen(rd->id) + 1 + 8 + 8 + 1);
+
+    binary_frame_put_u32(wb, (uint32_t)rd->stream.snd.dim_slot);
+    binary_frame_put_string(wb, rd->id);
+    binary_frame_put_u8(wb, dim_flags);
+    binary_frame_put_i64(wb, rd->collector.last_collected_value);
+    if(!value_is_collected)
+        binary_frame_put_f64(wb, n);
+
+    wb->buffer[wb->len] = '\0';
+    rsb->binary_frame_dims++;
+}
+
+// ----------------------------------------------------------------------------
+// relaying received binary frames upstream
+
+// copy a complete received frame (header included) to the upstream buffer
+// returns false when the frame cannot be relayed (the caller has to encode the samples)
+bool stream_send_rrdset_metrics_relay_binary_frame(RRDSET_STREAM_BUFFER *rsb, RRDSET *st, const char *frame, size_t size, time_t point_end_time_s) {
+    if(!rsb->wb || !rsb->v2 || !rsb->binary || rsb->begin_v2_added)
+        return false;
+
+    // the fixed part of the payload, up to the chart id length
+    if(unlikely(size < STREAM_BINARY_FRAME_HEADER_SIZE + 4 + 2))
+        return false;
+
+    uint16_t id_len;
+    memcpy(&id_len, &frame[STREAM_BINARY_FRAME_HEADER_SIZE + 4], sizeof(id_len));
+
+    size_t dims_pos = STREAM_BINARY_FRAME_HEADER_SIZE + 4 + 2 + id_len + 4 + 8 + 8;
+    if(unlikely(size < dims_pos + 4))
+        return false;
+
+    BUFFER *wb = rsb->wb;
+    buffer_need_bytes(wb, size + 1);
+
+    rsb->binary_frame_pos = wb->len;
+    rsb->binary_frame_dims_pos = wb->len + dims_pos;
+    rsb->binary_frame_relay_pos = wb->len + dims_pos + 4;
+    memcpy(&rsb->binary_frame_dims, &frame[dims_pos], sizeof(rsb->binary_frame_dims));
+
+    binary_frame_put(wb, frame, size);
+    wb->buffer[wb->len] = '\0';
+
+    // the chart slot of our parent
+    uint32_t chart_slot = (uint32_t)st->stream.snd.chart_slot;
+    memcpy(&wb->buffer[rsb->binary_frame_pos + STREAM_BINARY_FRAME_HEADER_SIZE], &chart_slot, sizeof(chart_slot));
+
+    rsb->last_point_end_time_s = point_end_time_s;
+    rsb->begin_v2_added = true;
+    rsb->binary_frame_open = true;
+    rsb->binary_frame_relayed = true;
+    return true;
+}
+
+// update the next dimension of a relayed frame, with the slot of our parent and our flags
+void stream_send_rrddim_metrics_relayed(RRDSET_STREAM_BUFFER *rsb, RRDDIM *rd, SN_FLAGS flags) {
+    BUFFER *wb = rsb->wb;
+    size_t pos = rsb->binary_frame_relay_pos;
+
+    // the dimensions have been validated by the parser before they reach us
+    if(unlikely(pos + 4 + 2 > wb->len))
+        return;
+
+    uint32_t dim_slot = (uint32_t)rd->stream.snd.dim_slot;
+    memcpy(&wb->buffer[pos], &dim_slot, sizeof(dim_slot));
+    pos += 4;
+
+    uint16_t id_len;
+    memcpy(&id_len, &wb->buffer[pos], sizeof(id_len));
+    pos += 2 + id_len;
+
+    if(unlikely(pos + 1 + 8 > wb->len))
+        return;
+
+    uint8_t dim_flags = (uint8_t)wb->buffer[pos];
+    dim_flags = (dim_flags & STREAM_BINARY_DIM_VALUE_IS_COLLECTED) | binary_frame_dim_flags(flags);
+    wb->buffer[pos] = (char)dim_flags;
+    pos += 1 + 8;
+
+    if(!(dim_flags & STREAM_BINARY_DIM_VALUE_IS_COLLECTED))
+        pos += 8;
+
+    rsb->binary_frame_relay_pos = pos;
+}
+
+// ----------------------------------------------------------------------------
+
 void stream_send_rrddim_metrics_v2(RRDSET_STREAM_BUFFER *rsb, RRDDIM *rd, usec_t point_end_time_ut, NETDATA_DOUBLE n, SN_FLAGS flags) {
     if(!rsb->wb || !rsb->v2 || !netdata_double_isnumber(n) || !does_storage_number_exist(flags))
         return;
 
+    if(rsb->binary) {
+        stream_send_rrddim_metrics_binary(rsb, rd, (time_t)(point_end_time_ut / USEC_PER_SEC), n, flags);
+        return;
+    }
+
     bool with_slots = stream_has_capability(rsb, STREAM_CAP_SLOTS) ? true : false;
     NUMBER_ENCODING integer_encoding = stream_has_capability(rsb, STREAM_CAP_IEEE754) ? NUMBER_ENCODING_BASE64 : NUMBER_ENCODING_HEX;
     NUMBER_ENCODING doubles_encoding = stream_has_capability(rsb, STREAM_CAP_IEEE754) ? NUMBER_ENCODING_BASE64 : NUMBER_ENCODING_DECIMAL;
@@ -70,10 +222,23 @@ ALWAYS_INLINE void stream_send_rrdset_metrics_finished(RRDSET_STREAM_BUFFER *rsb
         return;
 
     if(rsb->v2 && rsb->begin_v2_added) {
-        if(unlikely(rsb->rrdset_flags & RRDSET_FLAG_UPSTREAM_SEND_VARIABLES))
-            rrdvar_print_to_streaming_custom_chart_variables(st, rsb->wb);
+        bool send_variables = (rsb->rrdset_flags & RRDSET_FLAG_UPSTREAM_SEND_VARIABLES);
+
+        if(rsb->binary_frame_open) {
+            // the chart variables are text, so the chart has to remain in scope for them
+            binary_frame_close(rsb, send_variables);
 
-        buffer_fast_strcat(rsb->wb, PLUGINSD_KEYWORD_END_V2 "\n", sizeof(PLUGINSD_KEYWORD_END_V2) - 1 + 1);
+            if(unlikely(send_variables)) {
+                rrdvar_print_to_streaming_custom_chart_variables(st, rsb->wb);
+                buffer_fast_strcat(rsb->wb, PLUGINSD_KEYWORD_END_V2 "\n", sizeof(PLUGINSD_KEYWORD_END_V2) - 1 + 1);
+            }
+        }
+        else {
+            if(unlikely(send_variables))
+                rrdvar_print_to_streaming_custom_chart_variables(st, rsb->wb);
+
+            buffer_fast_strcat(rsb->wb, PLUGINSD_KEYWORD_END_V2 "\n", sizeof(PLUGINSD_KEYWORD_END_V2) - 1 + 1);
+        }
     }
 
     sender_commit(st->rrdhost->sender, rsb->wb, STREAM_TRAFFIC_TYPE_DATA);
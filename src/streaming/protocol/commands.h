@@ -6,13 +6,129 @@
 #include "database/rrd.h"
 #include "../stream.h"
 
+// ----------------------------------------------------------------------------
+// binary samples frames (STREAM_CAP_BINARY_SAMPLES)
+//
+// A frame replaces a BEGIN2 / SET2 ... / END2 block of text lines.
+// It starts with a byte that never starts a text line, so that the receiver
+// can tell frames and lines apart without scanning for newlines.
+// All integers are little endian, doubles are IEEE754.
+//
+// header:      u8 marker, u8 flags, u32 payload size
+// payload:     u32 chart slot, u16 chart id length, chart id,
+//              u32 update every, i64 end time, i64 wall clock time,
+//              u32 number of dimensions, followed by the dimensions
+// dimension:   u32 slot, u16 id length, id, u8 flags, i64 collected value,
+//              f64 value (only when it is not the collected value)
+//
+// When the frame has STREAM_BINARY_FRAME_FLAG_OPEN, the chart stays in scope
+// after the frame (text lines follow, ending with END2).
+//
+// Parents relay the frames they receive to their own parent as-is, when both
+// connections use binary frames. Only the slots and the dimension flags
+// (which may be changed by ML on the parent) are updated in place.
+
+#define STREAM_BINARY_FRAME_MARKER          0x02
+#define STREAM_BINARY_FRAME_HEADER_SIZE     (1 + 1 + 4)
+#define STREAM_BINARY_FRAME_MAX_SIZE        (16 * 1024 * 1024)
+
+#define STREAM_BINARY_FRAME_FLAG_OPEN       (1 << 0)
+
+#define STREAM_BINARY_DIM_NOT_ANOMALOUS     (1 << 0)
+#define STREAM_BINARY_DIM_RESET             (1 << 1)
+#define STREAM_BINARY_DIM_EMPTY             (1 << 2)
+#define STREAM_BINARY_DIM_VALUE_IS_COLLECTED (1 << 7)
+
+// ----------------------------------------------------------------------------
+// bulk replication frames (STREAM_CAP_BULK_REPLAY)
+//
+// A frame replaces a run of RBEGIN / RSET ... lines of one chart, for points
+// that are consecutive and aligned across all dimensions. It has the same
+// header with the binary samples frames, with its own marker.
+// The points of each dimension are consecutive, so that the parent stores
+// them dimension by dimension, filling its pages sequentially.
+//
+// payload:     u32 chart slot, u16 chart id length, chart id,
+//              i64 end time of the first point, u32 update every,
+//              u32 number of points, i64 wall clock time,
+//              u32 number of dimensions, followed by the dimensions
+// dimension:   u32 slot, u16 id length, id,
+//              f64 values (one per point), u8 flags (one per point)
+//
+// The flags of the points are STREAM_BINARY_DIM_*, or STREAM_REPLAY_POINT_MISSING
+// for points the dimension does not have (like a missing RSET).
+// After a frame, the chart is in scope like after the RBEGIN of its last point.
+
+#define STREAM_REPLAY_FRAME_MARKER          0x03
+#define STREAM_REPLAY_FRAME_MAX_POINTS      1024
+#define STREAM_REPLAY_FRAME_MAX_VALUES      (512 * 1024) // points x dimensions in a frame
+
+#define STREAM_REPLAY_POINT_MISSING         (1 << 6)
+
+// ----------------------------------------------------------------------------
+// encoding frames
+
+static ALWAYS_INLINE void binary_frame_put(BUFFER *wb, const void *data, size_t size) {
+    memcpy(&wb->buffer[wb->len], data, size);
+    wb->len += size;
+}
+
+static ALWAYS_INLINE void binary_frame_put_u8(BUFFER *wb, uint8_t v) { binary_frame_put(wb, &v, sizeof(v)); }
+static ALWAYS_INLINE void binary_frame_put_u16(BUFFER *wb, uint16_t v) { binary_frame_put(wb, &v, sizeof(v)); }
+static ALWAYS_INLINE void binary_frame_put_u32(BUFFER *wb, uint32_t v) { binary_frame_put(wb, &v, sizeof(v)); }
+static ALWAYS_INLINE void binary_frame_put_i64(BUFFER *wb, int64_t v) { binary_frame_put(wb, &v, sizeof(v)); }
+static ALWAYS_INLINE void binary_frame_put_f64(BUFFER *wb, NETDATA_DOUBLE v) { double d = (double)v; binary_frame_put(wb, &d, sizeof(d)); }
+
+static ALWAYS_INLINE void binary_frame_put_string(BUFFER *wb, STRING *s) {
+    size_t len = string_strlen(s);
+    if(unlikely(len > UINT16_MAX))
+        len = UINT16_MAX;
+
+    binary_frame_put_u16(wb, (uint16_t)len);
+    binary_frame_put(wb, string2str(s), len);
+}
+
+static ALWAYS_INLINE uint8_t binary_frame_dim_flags(SN_FLAGS flags) {
+    uint8_t dim_flags = 0;
+    if(unlikely(flags == SN_EMPTY_SLOT))
+        dim_flags |= STREAM_BINARY_DIM_EMPTY;
+    else {
+        if(flags & SN_FLAG_NOT_ANOMALOUS)
+            dim_flags |= STREAM_BINARY_DIM_NOT_ANOMALOUS;
+        if(flags & SN_FLAG_RESET)
+            dim_flags |= STREAM_BINARY_DIM_RESET;
+    }
+
+    return dim_flags;
+}
+
+static ALWAYS_INLINE SN_FLAGS binary_frame_sn_flags(uint8_t dim_flags) {
+    if(unlikely(dim_flags & STREAM_BINARY_DIM_EMPTY))
+        return SN_EMPTY_SLOT;
+
+    SN_FLAGS flags = SN_FLAG_NONE;
+    if(dim_flags & STREAM_BINARY_DIM_NOT_ANOMALOUS)
+        flags |= SN_FLAG_NOT_ANOMALOUS;
+    if(dim_flags & STREAM_BINARY_DIM_RESET)
+        flags |= SN_FLAG_RESET;
+
+    return flags;
+}
+
 typedef struct rrdset_stream_buffer {
     STREAM_CAPABILITIES capabilities;
     bool v2;
     bool begin_v2_added;
+    bool binary;                    // binary samples frames are negotiated
+    bool binary_frame_open;         // a frame has been started in wb
+    bool binary_frame_relayed;      // the frame in wb is a copy of a received frame
     time_t wall_clock_time;
     RRDSET_FLAGS rrdset_flags;
     time_t last_point_end_time_s;
+    uint32_t binary_frame_dims;
+    size_t binary_frame_pos;        // the offset of the frame header in wb
+    size_t binary_frame_dims_pos;   // the offset of the number of dimensions in wb
+    size_t binary_frame_relay_pos;  // the offset of the next relayed dimension in wb
     BUFFER *wb;
 } RRDSET_STREAM_BUFFER;
 
@@ -38,4 +154,7 @@ void stream_send_rrdset_metrics_v1(RRDSET_STREAM_BUFFER *rsb, RRDSET *st);
 void stream_send_rrddim_metrics_v2(RRDSET_STREAM_BUFFER *rsb, RRDDIM *rd, usec_t point_end_time_ut, NETDATA_DOUBLE n, SN_FLAGS flags);
 void stream_send_rrdset_metrics_finished(RRDSET_STREAM_BUFFER *rsb, RRDSET *st);
 
+bool stream_send_rrdset_metrics_relay_binary_frame(RRDSET_STREAM_BUFFER *rsb, RRDSET *st, const char *frame, size_t size, time_t point_end_time_s);
+void stream_send_rrddim_metrics_relayed(RRDSET_STREAM_BUFFER *rsb, RRDDIM *rd, SN_FLAGS flags);
+
 #endif //NETDATA_STREAMING_PROTCOL_COMMANDS_H
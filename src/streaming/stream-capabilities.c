@@ -36,6 +36,9 @@ static struct {
     {STREAM_CAP_PROGRESS,     "PROGRESS" },
     {STREAM_CAP_NODE_ID,      "NODEID" },
     {STREAM_CAP_PATHS,        "PATHS" },
+    {STREAM_CAP_BINARY_SAMPLES, "BSAMPLES" },
+    {STREAM_CAP_BULK_REPLAY,  "BREPLAY" },
+    {STREAM_CAP_ZSTD_DICT,    "ZSTDDICT" },
 
     // terminator
     {0 , NULL },
@@ -139,6 +142,9 @@ STREAM_CAPABILITIES stream_our_capabilities(RRDHOST *host, bool sender) {
             STREAM_CAP_PATHS |
             STREAM_CAP_IEEE754 |
             STREAM_CAP_ML_MODELS |
+            STREAM_CAP_BINARY_SAMPLES |
+            STREAM_CAP_BULK_REPLAY |
+            STREAM_CAP_ZSTD_DICT_AVAILABLE |
             0) & ~disabled_capabilities;
 }
 
@@ -167,6 +173,20 @@ STREAM_CAPABILITIES convert_stream_version_to_capabilities(int32_t version, RRDH
         // DATA WITH ML requires INTERPOLATED
         common_caps &= ~(STREAM_CAP_ML_MODELS);
 
+    if((common_caps & (STREAM_CAP_INTERPOLATED | STREAM_CAP_SLOTS | STREAM_CAP_IEEE754)) !=
+        (STREAM_CAP_INTERPOLATED | STREAM_CAP_SLOTS | STREAM_CAP_IEEE754))
+        // binary samples are sent in place of v2 text, carry slots and raw doubles
+        common_caps &= ~(STREAM_CAP_BINARY_SAMPLES);
+
+    if((common_caps & (STREAM_CAP_BINARY_SAMPLES | STREAM_CAP_REPLICATION)) !=
+        (STREAM_CAP_BINARY_SAMPLES | STREAM_CAP_REPLICATION))
+        // bulk replication frames are binary frames carrying replication points
+        common_caps &= ~(STREAM_CAP_BULK_REPLAY);
+
+    if(!(common_caps & STREAM_CAP_ZSTD))
+        // the dictionary is used only with ZSTD
+        common_caps &= ~(STREAM_CAP_ZSTD_DICT);
+
     return common_caps;
 }
 
@@ -182,4 +202,14 @@ void check_local_streaming_capabilities(void) {
         globally_disabled_capabilities |= STREAM_CAP_IEEE754;
     else
         globally_disabled_capabilities &= ~STREAM_CAP_IEEE754;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if(!ieee754_doubles)
+        globally_disabled_capabilities |= STREAM_CAP_BINARY_SAMPLES;
+    else
+        globally_disabled_capabilities &= ~STREAM_CAP_BINARY_SAMPLES;
+#else
+    // binary samples frames are little endian
+    globally_disabled_capabilities |= STREAM_CAP_BINARY_SAMPLES;
+#endif
 }
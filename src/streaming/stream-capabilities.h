@@ -49,6 +49,9 @@ typedef enum {
     STREAM_CAP_NODE_ID          = (1 << 24), // support for sending NODE_ID back to the child
     STREAM_CAP_PATHS            = (1 << 25), // support for sending PATHS upstream and downstream
     STREAM_CAP_ML_MODELS        = (1 << 26), // support for sending MODELS upstream
+    STREAM_CAP_BINARY_SAMPLES   = (1 << 27), // support for binary frames of metric samples (requires SLOTS and IEEE754)
+    STREAM_CAP_ZSTD_DICT        = (1 << 28), // ZSTD compression with a dictionary sent by the parent during the handshake
+    STREAM_CAP_BULK_REPLAY      = (1 << 29), // replication sends runs of points in binary frames (requires BINARY_SAMPLES)
 
     STREAM_CAP_INVALID          = (1 << 30), // used as an invalid value for capabilities when this is set
     // this must be signed int, so don't use the last bit
@@ -65,8 +68,10 @@ typedef enum {
 
 #ifdef ENABLE_ZSTD
 #define STREAM_CAP_ZSTD_AVAILABLE STREAM_CAP_ZSTD
+#define STREAM_CAP_ZSTD_DICT_AVAILABLE STREAM_CAP_ZSTD_DICT
 #else
 #define STREAM_CAP_ZSTD_AVAILABLE 0
+#define STREAM_CAP_ZSTD_DICT_AVAILABLE 0
 #endif  // ENABLE_ZSTD
 
 #ifdef ENABLE_BROTLI
@@ -15,6 +15,8 @@
 #include "zstd.h"
 #endif
 
+#include "zstd-dictionary.h"
+
 #ifdef ENABLE_BROTLI
 #include "brotli.h"
 #endif
@@ -84,6 +86,10 @@ void stream_select_receiver_compression_algorithm(struct receiver_state *rpt) {
             }
         }
     }
+
+    // a dictionary is offered only with zstd, and only when we have trained one
+    if(!stream_has_capability(rpt, STREAM_CAP_ZSTD) || !stream_zstd_dictionary_get())
+        rpt->capabilities &= ~STREAM_CAP_ZSTD_DICT;
 }
 
 bool stream_compression_initialize(struct sender_state *s) {
@@ -103,6 +109,10 @@ bool stream_compression_initialize(struct sender_state *s) {
     else
         s->thread.compressor.algorithm = COMPRESSION_ALGORITHM_NONE;
 
+    s->thread.compressor.dictionary =
+        (s->thread.compressor.algorithm == COMPRESSION_ALGORITHM_ZSTD && stream_has_capability(s, STREAM_CAP_ZSTD_DICT)) ?
+            s->thread.zstd_dictionary : NULL;
+
     if(s->thread.compressor.algorithm != COMPRESSION_ALGORITHM_NONE) {
         s->thread.compressor.level = stream_send.compression.levels[s->thread.compressor.algorithm];
         stream_compressor_init(&s->thread.compressor);
@@ -129,6 +139,11 @@ bool stream_decompression_initialize(struct receiver_state *rpt) {
     else
         rpt->thread.compressed.decompressor.algorithm = COMPRESSION_ALGORITHM_NONE;
 
+    // the dictionary never changes once trained, so it is the one we advertised to the child
+    rpt->thread.compressed.decompressor.dictionary =
+        (rpt->thread.compressed.decompressor.algorithm == COMPRESSION_ALGORITHM_ZSTD && stream_has_capability(rpt, STREAM_CAP_ZSTD_DICT)) ?
+            stream_zstd_dictionary_get() : NULL;
+
     if(rpt->thread.compressed.decompressor.algorithm != COMPRESSION_ALGORITHM_NONE) {
         stream_decompressor_init(&rpt->thread.compressed.decompressor);
         return true;
@@ -165,7 +180,7 @@ void stream_compression_deactivate(struct sender_state *s) {
         case COMPRESSION_ALGORITHM_ZSTD:
             netdata_log_error("STREAM_COMPRESSION: ZSTD compression error on 'host:%s'. Disabling ZSTD for this node.",
                     rrdhost_hostname(s->host));
-            s->disabled_capabilities |= STREAM_CAP_ZSTD;
+            s->disabled_capabilities |= STREAM_CAP_ZSTD | STREAM_CAP_ZSTD_DICT;
             break;
 
         case COMPRESSION_ALGORITHM_BROTLI:
@@ -473,16 +488,18 @@ void unittest_generate_message(BUFFER *wb, time_t now_s, size_t counter) {
     buffer_fast_strcat(wb, PLUGINSD_KEYWORD_END_V2 "\n", sizeof(PLUGINSD_KEYWORD_END_V2) - 1 + 1);
 }
 
-int unittest_stream_compression_speed(compression_algorithm_t algorithm, const char *name) {
+int unittest_stream_compression_speed(compression_algorithm_t algorithm, const char *name, const STREAM_ZSTD_DICTIONARY *dictionary) {
     fprintf(stderr, "\nTesting streaming compression speed with %s\n", name);
 
     struct compressor_state cctx =  {
             .initialized = false,
             .algorithm = algorithm,
+            .dictionary = dictionary,
     };
     struct decompressor_state dctx = {
             .initialized = false,
             .algorithm = algorithm,
+            .dictionary = dictionary,
     };
 
     stream_compressor_init(&cctx);
@@ -681,6 +698,27 @@ cleanup:
     return errors;
 }
 
+#ifdef ENABLE_ZSTD
+static STREAM_ZSTD_DICTIONARY *unittest_stream_train_zstd_dictionary(void) {
+    size_t count = 2000;
+    size_t *sizes = mallocz(count * sizeof(*sizes));
+
+    BUFFER *wb = buffer_create(COMPRESSION_MAX_MSG_SIZE, NULL);
+    time_t now_s = now_realtime_sec();
+    for(size_t i = 0; i < count ;i++) {
+        size_t before = buffer_strlen(wb);
+        unittest_generate_message(wb, now_s, i);
+        sizes[i] = buffer_strlen(wb) - before;
+    }
+
+    STREAM_ZSTD_DICTIONARY *dict = stream_zstd_dictionary_train(buffer_tostring(wb), sizes, count, 16 * 1024);
+
+    buffer_free(wb);
+    freez(sizes);
+    return dict;
+}
+#endif
+
 int unittest_stream_compressions(void) {
     int ret = 0;
 
@@ -689,10 +727,22 @@ int unittest_stream_compressions(void) {
     ret += unittest_stream_compression(COMPRESSION_ALGORITHM_BROTLI, "BROTLI");
     ret += unittest_stream_compression(COMPRESSION_ALGORITHM_GZIP, "GZIP");
 
-    ret += unittest_stream_compression_speed(COMPRESSION_ALGORITHM_ZSTD, "ZSTD");
-    ret += unittest_stream_compression_speed(COMPRESSION_ALGORITHM_LZ4, "LZ4");
-    ret += unittest_stream_compression_speed(COMPRESSION_ALGORITHM_BROTLI, "BROTLI");
-    ret += unittest_stream_compression_speed(COMPRESSION_ALGORITHM_GZIP, "GZIP");
+    ret += unittest_stream_compression_speed(COMPRESSION_ALGORITHM_ZSTD, "ZSTD", NULL);
+    ret += unittest_stream_compression_speed(COMPRESSION_ALGORITHM_LZ4, "LZ4", NULL);
+    ret += unittest_stream_compression_speed(COMPRESSION_ALGORITHM_BROTLI, "BROTLI", NULL);
+    ret += unittest_stream_compression_speed(COMPRESSION_ALGORITHM_GZIP, "GZIP", NULL);
+
+#ifdef ENABLE_ZSTD
+    STREAM_ZSTD_DICTIONARY *dict = unittest_stream_train_zstd_dictionary();
+    if(!dict) {
+        fprintf(stderr, "\nCannot train a ZSTD dictionary\n");
+        ret++;
+    }
+    else {
+        ret += unittest_stream_compression_speed(COMPRESSION_ALGORITHM_ZSTD, "ZSTD with dictionary", dict);
+        stream_zstd_dictionary_free(dict);
+    }
+#endif
 
     return ret;
 }
@@ -76,6 +76,8 @@ static inline void simple_ring_buffer_destroy(SIMPLE_RING_BUFFER *b) {
 
 // ----------------------------------------------------------------------------
 
+struct stream_zstd_dictionary;
+
 struct compressor_state {
     bool initialized;
     compression_algorithm_t algorithm;
@@ -86,6 +88,8 @@ struct compressor_state {
     int level;
     void *stream;
 
+    const struct stream_zstd_dictionary *dictionary;    // zstd only, owned by the sender
+
     struct {
         size_t total_compressed;
         size_t total_uncompressed;
@@ -111,6 +115,8 @@ struct decompressor_state {
     SIMPLE_RING_BUFFER output;
 
     void *stream;
+
+    const struct stream_zstd_dictionary *dictionary;    // zstd only, shared by all receivers
 };
 
 void stream_decompressor_destroy(struct decompressor_state *state);
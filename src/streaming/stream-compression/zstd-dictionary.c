@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "zstd-dictionary.h"
+#include "daemon/common.h"
+
+#ifdef ENABLE_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+
+#define STREAM_ZSTD_DICTIONARY_FILENAME "stream-zstd.dict"
+
+// we train on this many times the dictionary size of samples
+#define STREAM_ZSTD_DICTIONARY_SAMPLES_MULTIPLIER 64
+
+// and on at least this many samples
+#define STREAM_ZSTD_DICTIONARY_MIN_SAMPLES 128
+
+typedef enum {
+    ZSTD_DICT_UNINITIALIZED = 0,
+    ZSTD_DICT_COLLECTING,           // receivers feed samples
+    ZSTD_DICT_TRAINING,             // the training thread owns the samples
+    ZSTD_DICT_READY,                // the dictionary is available
+    ZSTD_DICT_DISABLED,
+} ZSTD_DICT_STATE;
+
+static struct {
+    SPINLOCK spinlock;
+    ZSTD_DICT_STATE state;
+    size_t dictionary_size;
+    STREAM_ZSTD_DICTIONARY *dictionary;     // written once, never freed while we run
+
+    struct {
+        char *data;
+        size_t used;
+        size_t size;
+
+        size_t *sizes;
+        size_t count;
+        size_t allocated;
+    } samples;
+} zstd_dict_globals = {
+    .spinlock = SPINLOCK_INITIALIZER,
+    .state = ZSTD_DICT_UNINITIALIZED,
+    .dictionary_size = STREAM_ZSTD_DICTIONARY_DEFAULT_SIZE,
+};
+
+static void zstd_dictionary_filename(char *dst, size_t size) {
+    snprintfz(dst, size, "%s/" STREAM_ZSTD_DICTIONARY_FILENAME, netdata_configured_cache_dir);
+}
+
+static STREAM_ZSTD_DICTIONARY *zstd_dictionary_digest(const void *data, size_t size) {
+    uint32_t id = ZSTD_getDictID_fromDict(data, size);
+    STREAM_ZSTD_DICTIONARY *dict = stream_zstd_dictionary_create(id, data, size);
+    if(!dict)
+        return NULL;
+
+    dict->ddict = ZSTD_createDDict(dict->data, dict->size);
+    if(!dict->ddict) {
+        stream_zstd_dictionary_free(dict);
+        return NULL;
+    }
+
+    return dict;
+}
+
+
+static bool zstd_dictionary_load(void) {
+    char filename[FILENAME_MAX + 1];
+    zstd_dictionary_filename(filename, sizeof(filename));
+
+    FILE *fp = fopen(filename, "r");
+    if(!fp)
+        return false;
+
+    STREAM_ZSTD_DICTIONARY *dict = NULL;
+    void *data = mallocz(STREAM_ZSTD_DICTIONARY_MAX_SIZE);
+    size_t size = fread(data, 1, STREAM_ZSTD_DICTIONARY_MAX_SIZE, fp);
+    if(size && !ferror(fp) && feof(fp))
+        dict = zstd_dictionary_digest(data, size);
+
+    freez(data);
+    fclose(fp);
+
+    if(!dict) {
+        nd_log(NDLS_DAEMON, NDLP_WARNING,
+               "STREAM ZSTD DICTIONARY: ignoring invalid dictionary file '%s'", filename);
+        return false;
+    }
+
+    nd_log(NDLS_DAEMON, NDLP_INFO,
+           "STREAM ZSTD DICTIONARY: loaded dictionary with id %u, of %zu bytes, from '%s'",
+           dict->id, dict->size, filename);
+
+    __atomic_store_n(&zstd_dict_globals.dictionary, dict, __ATOMIC_RELEASE);
+    __atomic_store_n(&zstd_dict_globals.state, ZSTD_DICT_READY, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void zstd_dictionary_save(const void *data, size_t size) {
+    char filename[FILENAME_MAX + 1];
+    char tmp[FILENAME_MAX + 1];
+    zstd_dictionary_filename(filename, sizeof(filename));
+    snprintfz(tmp, sizeof(tmp), "%s.new", filename);
+
+    FILE *fp = fopen(tmp, "w");
+    if(!fp) {
+        nd_log(NDLS_DAEMON, NDLP_ERR, "STREAM ZSTD DICTIONARY: cannot create file '%s'", tmp);
+        return;
+    }
+
+    bool ok = fwrite(data, 1, size, fp) == size;
+    ok = (fclose(fp) == 0) && ok;
+
+    if(!ok || rename(tmp, filename) != 0) {
+        nd_log(NDLS_DAEMON, NDLP_ERR, "STREAM ZSTD DICTIONARY: cannot save file '%s'", filename);
+        unlink(tmp);
+    }
+}
+
+static void zstd_dictionary_initialize(void) {
+    spinlock_lock(&zstd_dict_globals.spinlock);
+
+    if(zstd_dict_globals.state == ZSTD_DICT_UNINITIALIZED) {
+        if(!zstd_dict_globals.dictionary_size)
+            __atomic_store_n(&zstd_dict_globals.state, ZSTD_DICT_DISABLED, __ATOMIC_RELEASE);
+        else if(!zstd_dictionary_load())
+            __atomic_store_n(&zstd_dict_globals.state, ZSTD_DICT_COLLECTING, __ATOMIC_RELEASE);
+    }
+
+    spinlock_unlock(&zstd_dict_globals.spinlock);
+}
+
+static void zstd_dictionary_samples_free(void) {
+    freez(zstd_dict_globals.samples.data);
+    freez(zstd_dict_globals.samples.sizes);
+    memset(&zstd_dict_globals.samples, 0, sizeof(zstd_dict_globals.samples));
+}
+
+STREAM_ZSTD_DICTIONARY *stream_zstd_dictionary_train(const void *samples, const size_t *sizes, size_t count, size_t size) {
+    void *data = mallocz(size);
+
+    usec_t started_ut = now_monotonic_usec();
+    size_t ret = ZDICT_trainFromBuffer(data, size, samples, sizes, (unsigned)count);
+    usec_t ended_ut = now_monotonic_usec();
+
+    STREAM_ZSTD_DICTIONARY *dict = NULL;
+    if(ZDICT_isError(ret))
+        nd_log(NDLS_DAEMON, NDLP_ERR,
+               "STREAM ZSTD DICTIONARY: training on %zu samples failed: %s",
+               count, ZDICT_getErrorName(ret));
+    else {
+        dict = zstd_dictionary_digest(data, ret);
+
+        nd_log(NDLS_DAEMON, NDLP_INFO,
+               "STREAM ZSTD DICTIONARY: trained a dictionary of %zu bytes from %zu samples in %"PRIu64" ms",
+               ret, count, (ended_ut - started_ut) / USEC_PER_MS);
+    }
+
+    freez(data);
+    return dict;
+}
+
+static void *zstd_dictionary_train_thread(void *ptr __maybe_unused) {
+    // while we are TRAINING, nobody else touches the samples
+    STREAM_ZSTD_DICTIONARY *dict = stream_zstd_dictionary_train(
+        zstd_dict_globals.samples.data, zstd_dict_globals.samples.sizes,
+        zstd_dict_globals.samples.count, zstd_dict_globals.dictionary_size);
+
+    spinlock_lock(&zstd_dict_globals.spinlock);
+
+    zstd_dictionary_samples_free();
+
+    if(dict) {
+        __atomic_store_n(&zstd_dict_globals.dictionary, dict, __ATOMIC_RELEASE);
+        __atomic_store_n(&zstd_dict_globals.state, ZSTD_DICT_READY, __ATOMIC_RELEASE);
+    }
+    else
+        __atomic_store_n(&zstd_dict_globals.state, ZSTD_DICT_DISABLED, __ATOMIC_RELEASE);
+
+    spinlock_unlock(&zstd_dict_globals.spinlock);
+
+    if(dict)
+        zstd_dictionary_save(dict->data, dict->size);
+
+    return NULL;
+}
+
+void stream_zstd_dictionary_configure(size_t size) {
+    if(size && size < 1024)
+        size = 1024;
+
+    if(size > STREAM_ZSTD_DICTIONARY_MAX_SIZE)
+        size = STREAM_ZSTD_DICTIONARY_MAX_SIZE;
+
+    spinlock_lock(&zstd_dict_globals.spinlock);
+    if(zstd_dict_globals.state == ZSTD_DICT_UNINITIALIZED)
+        zstd_dict_globals.dictionary_size = size;
+    spinlock_unlock(&zstd_dict_globals.spinlock);
+}
+
+const STREAM_ZSTD_DICTIONARY *stream_zstd_dictionary_get(void) {
+    if(unlikely(__atomic_load_n(&zstd_dict_globals.state, __ATOMIC_ACQUIRE) == ZSTD_DICT_UNINITIALIZED))
+        zstd_dictionary_initialize();
+
+    return __atomic_load_n(&zstd_dict_globals.dictionary, __ATOMIC_ACQUIRE);
+}
+
+void stream_zstd_dictionary_sample(const char *data, size_t size) {
+    ZSTD_DICT_STATE state = __atomic_load_n(&zstd_dict_globals.state, __ATOMIC_ACQUIRE);
+    if(likely(state != ZSTD_DICT_COLLECTING)) {
+        if(likely(state != ZSTD_DICT_UNINITIALIZED))
+            return;
+
+        zstd_dictionary_initialize();
+    }
+
+    if(unlikely(!data || !size))
+        return;
+
+    bool train = false;
+
+    spinlock_lock(&zstd_dict_globals.spinlock);
+
+    if(zstd_dict_globals.state == ZSTD_DICT_COLLECTING) {
+        if(!zstd_dict_globals.samples.data) {
+            zstd_dict_globals.samples.size = zstd_dict_globals.dictionary_size * STREAM_ZSTD_DICTIONARY_SAMPLES_MULTIPLIER;
+            zstd_dict_globals.samples.data = mallocz(zstd_dict_globals.samples.size);
+        }
+
+        if(zstd_dict_globals.samples.count == zstd_dict_globals.samples.allocated) {
+            zstd_dict_globals.samples.allocated = zstd_dict_globals.samples.allocated ? zstd_dict_globals.samples.allocated * 2 : 1024;
+            zstd_dict_globals.samples.sizes = reallocz(zstd_dict_globals.samples.sizes,
+                                                       zstd_dict_globals.samples.allocated * sizeof(size_t));
+        }
+
+        // limit the size of each sample, so that we get enough of them
+        size_t bytes = MIN(size, zstd_dict_globals.samples.size / STREAM_ZSTD_DICTIONARY_MIN_SAMPLES);
+        bytes = MIN(bytes, zstd_dict_globals.samples.size - zstd_dict_globals.samples.used);
+
+        memcpy(&zstd_dict_globals.samples.data[zstd_dict_globals.samples.used], data, bytes);
+        zstd_dict_globals.samples.used += bytes;
+        zstd_dict_globals.samples.sizes[zstd_dict_globals.samples.count++] = bytes;
+
+        if(zstd_dict_globals.samples.used == zstd_dict_globals.samples.size) {
+            __atomic_store_n(&zstd_dict_globals.state, ZSTD_DICT_TRAINING, __ATOMIC_RELEASE);
+            train = true;
+        }
+    }
+
+    spinlock_unlock(&zstd_dict_globals.spinlock);
+
+    if(train && !nd_thread_create("STRDICT", NETDATA_THREAD_OPTION_DONT_LOG, zstd_dictionary_train_thread, NULL)) {
+        spinlock_lock(&zstd_dict_globals.spinlock);
+        zstd_dictionary_samples_free();
+        __atomic_store_n(&zstd_dict_globals.state, ZSTD_DICT_DISABLED, __ATOMIC_RELEASE);
+        spinlock_unlock(&zstd_dict_globals.spinlock);
+    }
+}
+
+#else // !ENABLE_ZSTD
+
+STREAM_ZSTD_DICTIONARY *stream_zstd_dictionary_train(const void *samples __maybe_unused, const size_t *sizes __maybe_unused, size_t count __maybe_unused, size_t size __maybe_unused) { return NULL; }
+void stream_zstd_dictionary_configure(size_t size __maybe_unused) { ; }
+const STREAM_ZSTD_DICTIONARY *stream_zstd_dictionary_get(void) { return NULL; }
+void stream_zstd_dictionary_sample(const char *data __maybe_unused, size_t size __maybe_unused) { ; }
+
+#endif // ENABLE_ZSTD
+
+STREAM_ZSTD_DICTIONARY *stream_zstd_dictionary_create(uint32_t id, const void *data, size_t size) {
+    if(!id || !data || !size || size > STREAM_ZSTD_DICTIONARY_MAX_SIZE)
+        return NULL;
+
+#ifdef ENABLE_ZSTD
+    if(ZSTD_getDictID_fromDict(data, size) != id)
+        return NULL;
+#endif
+
+    STREAM_ZSTD_DICTIONARY *dict = mallocz(sizeof(*dict) + size);
+    dict->id = id;
+    dict->size = size;
+    dict->ddict = NULL;
+    memcpy(dict->data, data, size);
+    return dict;
+}
+
+void stream_zstd_dictionary_free(STREAM_ZSTD_DICTIONARY *dict) {
+    if(!dict)
+        return;
+
+#ifdef ENABLE_ZSTD
+    if(dict->ddict)
+        ZSTD_freeDDict(dict->ddict);
+#endif
+
+    freez(dict);
+}
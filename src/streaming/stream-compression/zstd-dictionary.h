@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_STREAMING_COMPRESSION_ZSTD_DICTIONARY_H
+#define NETDATA_STREAMING_COMPRESSION_ZSTD_DICTIONARY_H
+
+#include "libnetdata/libnetdata.h"
+
+// Shared ZSTD dictionaries for streaming.
+//
+// A parent samples the uncompressed traffic it receives from its children,
+// and once it has enough samples, it trains a dictionary from them (once,
+// in the background). The dictionary is saved in the cache directory, so
+// that it survives restarts and keeps the same id.
+//
+// Children supporting STREAM_CAP_ZSTD_DICT receive the dictionary during the
+// handshake, right after the parent's response:
+//
+//    <START_STREAMING_PROMPT_VN><capabilities>\n
+//    zstd-dictionary=<id>,<size>\n
+//    <size bytes of dictionary>
+//
+// and both ends prime their ZSTD contexts with it.
+
+#define STREAM_ZSTD_DICTIONARY_PROMPT "zstd-dictionary="
+#define STREAM_ZSTD_DICTIONARY_MAX_SIZE (1024 * 1024)
+#define STREAM_ZSTD_DICTIONARY_DEFAULT_SIZE (64 * 1024)
+
+typedef struct stream_zstd_dictionary {
+    uint32_t id;
+    size_t size;
+    void *ddict;            // parent only: the digested dictionary, shared by all receivers
+    uint8_t data[];
+} STREAM_ZSTD_DICTIONARY;
+
+// parent
+void stream_zstd_dictionary_configure(size_t size);
+const STREAM_ZSTD_DICTIONARY *stream_zstd_dictionary_get(void);
+void stream_zstd_dictionary_sample(const char *data, size_t size);
+STREAM_ZSTD_DICTIONARY *stream_zstd_dictionary_train(const void *samples, const size_t *sizes, size_t count, size_t size);
+
+// child
+STREAM_ZSTD_DICTIONARY *stream_zstd_dictionary_create(uint32_t id, const void *data, size_t size);
+void stream_zstd_dictionary_free(STREAM_ZSTD_DICTIONARY *dict);
+
+#endif //NETDATA_STREAMING_COMPRESSION_ZSTD_DICTIONARY_H
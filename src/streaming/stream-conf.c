@@ -4,6 +4,7 @@
 #include "stream-receiver-internals.h"
 #include "stream-sender-internals.h"
 #include "stream-replication-sender.h"
+#include "stream-compression/zstd-dictionary.h"
 
 static struct config stream_config = APPCONFIG_INITIALIZER;
 
@@ -207,6 +208,11 @@ void stream_conf_load() {
         &stream_config, CONFIG_SECTION_STREAM, "gzip compression level",
         stream_send.compression.levels[COMPRESSION_ALGORITHM_GZIP]);
 
+    // parents train a zstd dictionary from the traffic they receive and offer it to their children
+    stream_zstd_dictionary_configure((size_t)inicfg_get_size_bytes(
+        &stream_config, CONFIG_SECTION_STREAM, "zstd dictionary size",
+        STREAM_ZSTD_DICTIONARY_DEFAULT_SIZE));
+
     stream_send.parents.h2o = inicfg_get_boolean(
         &stream_config, CONFIG_SECTION_STREAM, "parent using h2o",
         stream_send.parents.h2o);
@@ -255,6 +255,88 @@ stream_connect_validate_first_response(RRDHOST *host, struct sender_state *s, ch
     return false;
 }
 
+// buf has the bytes we received after the response line of the parent (used of them),
+// and space for buf_size bytes. When the newline of the response has not been received
+// yet, eol_pending is true. The parent sends the "zstd-dictionary=" line, followed by
+// the dictionary, but any of them may arrive in pieces.
+static bool stream_connect_receive_zstd_dictionary(struct sender_state *s, char *buf, size_t used, size_t buf_size, bool eol_pending, time_t timeout) {
+    stream_zstd_dictionary_free(s->thread.zstd_dictionary);
+    s->thread.zstd_dictionary = NULL;
+
+    if(!stream_has_capability(s, STREAM_CAP_ZSTD_DICT))
+        return true;
+
+    // receive until the header line is complete
+    char *eol = NULL;
+    while(true) {
+        if(eol_pending && used) {
+            if(buf[0] != '\n')
+                goto failed;
+
+            memmove(buf, buf + 1, --used);
+            eol_pending = false;
+        }
+
+        if(!eol_pending && (eol = memchr(buf, '\n', used)))
+            break;
+
+        if(used >= buf_size - 1)
+            goto failed;
+
+        ssize_t bytes = nd_sock_recv_timeout(&s->sock, buf + used, buf_size - 1 - used, 0, timeout);
+        if(bytes <= 0)
+            goto failed;
+
+        used += bytes;
+    }
+
+    if(strncmp(buf, STREAM_ZSTD_DICTIONARY_PROMPT, sizeof(STREAM_ZSTD_DICTIONARY_PROMPT) - 1) != 0)
+        goto failed;
+
+    *eol = '\0';
+
+    const char *id_str = buf + sizeof(STREAM_ZSTD_DICTIONARY_PROMPT) - 1;
+    const char *size_str = strchr(id_str, ',');
+    if(!size_str)
+        goto failed;
+
+    uint32_t id = str2u(id_str);
+    size_t size = str2u(size_str + 1);
+    if(!id || !size || size > STREAM_ZSTD_DICTIONARY_MAX_SIZE)
+        goto failed;
+
+    char *data = mallocz(size);
+    size_t received = MIN((size_t)(buf + used - (eol + 1)), size);
+    memcpy(data, eol + 1, received);
+
+    while(received < size) {
+        ssize_t bytes = nd_sock_recv_timeout(&s->sock, data + received, size - received, 0, timeout);
+        if(bytes <= 0)
+            break;
+
+        received += bytes;
+    }
+
+    if(received == size)
+        s->thread.zstd_dictionary = stream_zstd_dictionary_create(id, data, size);
+
+    freez(data);
+
+    if(!s->thread.zstd_dictionary)
+        goto failed;
+
+    return true;
+
+failed:
+    nd_log(NDLS_DAEMON, NDLP_ERR,
+           "STREAM CONNECT '%s' [to %s]: cannot receive the zstd dictionary of the parent - "
+           "disabling zstd dictionaries for this node.",
+           rrdhost_hostname(s->host), s->remote_ip);
+
+    s->disabled_capabilities |= STREAM_CAP_ZSTD_DICT;
+    return false;
+}
+
 bool stream_connect(struct sender_state *s, uint16_t default_port, time_t timeout) {
     worker_is_busy(WORKER_SENDER_CONNECTOR_JOB_CONNECTING);
 
@@ -358,8 +440,26 @@ bool stream_connect(struct sender_state *s, uint16_t default_port, time_t timeou
     }
     response[bytes] = '\0';
 
-    if(!stream_connect_validate_first_response(host, s, response, bytes)) {
+    // the response is a single line - the parent may follow it with a zstd dictionary
+    char *eol = strchr(response, '\n');
+    size_t response_length = (size_t)bytes;
+    if(eol) {
+        response_length = eol - response;
+        *eol = '\0';
+    }
+
+    if(!stream_connect_validate_first_response(host, s, response, response_length)) {
+        nd_sock_close(&s->sock);
+        return false;
+    }
+
+    char *after_response = eol ? eol + 1 : &response[bytes];
+    if(!stream_connect_receive_zstd_dictionary(
+            s, after_response, &response[bytes] - after_response, sizeof(response) - (after_response - response),
+            !eol, timeout)) {
+        worker_is_busy(WORKER_SENDER_CONNECTOR_JOB_DISCONNECT_BAD_HANDSHAKE);
         nd_sock_close(&s->sock);
+        stream_parent_set_host_connect_failure_reason(host, STREAM_HANDSHAKE_CONNECT_HANDSHAKE_FAILED, 5);
         return false;
     }
 
@@ -5,6 +5,7 @@
 #include "stream-receiver-internals.h"
 #include "web/server/h2o/http_server.h"
 #include "stream-replication-sender.h"
+#include "stream-compression/zstd-dictionary.h"
 
 // --------------------------------------------------------------------------------------------------------------------
 
@@ -248,9 +249,17 @@ static bool stream_receiver_send_first_response(struct receiver_state *rpt) {
     {
         // netdata_log_info("STREAM RCV %s [from [%s]:%s]: initializing communication...", rrdhost_hostname(rpt->host), rpt->client_ip, rpt->client_port);
         char initial_response[HTTP_HEADER_SIZE];
+        const STREAM_ZSTD_DICTIONARY *dictionary = NULL;
         if (stream_has_capability(rpt, STREAM_CAP_VCAPS)) {
             log_receiver_capabilities(rpt);
             sprintf(initial_response, "%s%u", START_STREAMING_PROMPT_VN, rpt->capabilities);
+
+            if(stream_has_capability(rpt, STREAM_CAP_ZSTD_DICT)) {
+                dictionary = stream_zstd_dictionary_get();
+                size_t len = strlen(initial_response);
+                snprintfz(&initial_response[len], sizeof(initial_response) - len,
+                          "\n" STREAM_ZSTD_DICTIONARY_PROMPT "%u,%zu\n", dictionary->id, dictionary->size);
+            }
         }
         else if (stream_has_capability(rpt, STREAM_CAP_VN)) {
             log_receiver_capabilities(rpt);
@@ -291,10 +300,16 @@ static bool stream_receiver_send_first_response(struct receiver_state *rpt) {
 #ifdef ENABLE_H2O
         if (is_h2o_rrdpush(rpt)) {
             h2o_stream_write(rpt->h2o_ctx, initial_response, strlen(initial_response));
+            if(dictionary)
+                h2o_stream_write(rpt->h2o_ctx, (const char *)dictionary->data, dictionary->size);
         } else {
 #endif
             ssize_t bytes_sent = nd_sock_send_timeout(&rpt->sock, initial_response, strlen(initial_response), 0, 60);
 
+            if(bytes_sent == (ssize_t)strlen(initial_response) && dictionary &&
+                nd_sock_send_timeout(&rpt->sock, (void *)dictionary->data, dictionary->size, 0, 60) != (ssize_t)dictionary->size)
+                bytes_sent = -1;
+
             if(bytes_sent != (ssize_t)strlen(initial_response)) {
                 internal_error(true, "Cannot send response, got %zd bytes, expecting %zu bytes", bytes_sent, strlen(initial_response));
                 stream_receiver_log_status(
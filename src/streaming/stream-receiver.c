@@ -4,6 +4,7 @@
 #include "stream-thread.h"
 #include "stream-receiver-internals.h"
 #include "web/server/h2o/http_server.h"
+#include "stream-compression/zstd-dictionary.h"
 
 #ifdef NETDATA_LOG_STREAM_RECEIVER
 void stream_receiver_log_payload(struct receiver_state *rpt, const char *payload, STREAM_TRAFFIC_TYPE type __maybe_unused, bool inbound) {
@@ -174,6 +175,8 @@ static ssize_t receiver_read_uncompressed(struct receiver_state *r) {
         worker_set_metric(WORKER_RECEIVER_JOB_BYTES_READ, (NETDATA_DOUBLE)bytes);
         worker_set_metric(WORKER_RECEIVER_JOB_BYTES_UNCOMPRESSED, (NETDATA_DOUBLE)bytes);
 
+        stream_zstd_dictionary_sample(r->thread.uncompressed.read_buffer + r->thread.uncompressed.read_len, bytes);
+
         r->thread.uncompressed.read_len += bytes;
         r->thread.uncompressed.read_buffer[r->thread.uncompressed.read_len] = '\0';
         pulse_stream_received_bytes(bytes);
@@ -272,6 +275,8 @@ static decompressor_status_t receiver_get_decompressed(struct receiver_state *r)
             return DECOMPRESS_FAILED;
         }
 
+        stream_zstd_dictionary_sample(r->thread.uncompressed.read_buffer + r->thread.uncompressed.read_len, len);
+
         r->thread.uncompressed.read_len += (int)len;
         r->thread.uncompressed.read_buffer[r->thread.uncompressed.read_len] = '\0';
     }
@@ -615,6 +620,92 @@ static bool stream_receiver_dequeue_senders(struct stream_thread *sth, struct re
     return true;
 }
 
+static ALWAYS_INLINE bool receiver_is_frame_marker(uint8_t c, bool frames, bool replay_frames) {
+    return (frames && c == STREAM_BINARY_FRAME_MARKER) || (replay_frames && c == STREAM_REPLAY_FRAME_MARKER);
+}
+
+// like buffered_reader_next_line(), but when the input is at a binary samples or bulk replication frame,
+// it collects the whole frame into dst, instead of a line
+static inline bool receiver_next_line_or_frame(struct buffered_reader *reader, BUFFER *dst, bool frames, bool replay_frames, bool *is_frame) {
+    *is_frame = (dst->len && receiver_is_frame_marker((uint8_t)dst->buffer[0], frames, replay_frames)) ||
+                (!dst->len && reader->pos < reader->read_len && receiver_is_frame_marker((uint8_t)reader->read_buffer[reader->pos], frames, replay_frames));
+
+    if(likely(!*is_frame))
+        return buffered_reader_next_line(reader, dst);
+
+    size_t wanted = STREAM_BINARY_FRAME_HEADER_SIZE;
+    while(true) {
+        if(dst->len >= STREAM_BINARY_FRAME_HEADER_SIZE) {
+            uint32_t payload_size;
+            memcpy(&payload_size, &dst->buffer[2], sizeof(payload_size));
+
+            // a frame that is too big is passed as-is, so that the parser will reject it
+            if(payload_size <= STREAM_BINARY_FRAME_MAX_SIZE)
+                wanted = STREAM_BINARY_FRAME_HEADER_SIZE + payload_size;
+            else
+                wanted = dst->len;
+        }
+
+        size_t available = (size_t)(reader->read_len - reader->pos);
+        size_t needed = wanted - dst->len;
+        size_t bytes = MIN(available, needed);
+
+        if(bytes) {
+            buffer_need_bytes(dst, bytes + 1);
+            memcpy(&dst->buffer[dst->len], &reader->read_buffer[reader->pos], bytes);
+            dst->len += bytes;
+            dst->buffer[dst->len] = '\0';
+            reader->pos += (ssize_t)bytes;
+        }
+
+        if(reader->pos >= reader->read_len) {
+            reader->pos = 0;
+            reader->read_len = 0;
+            reader->read_buffer[0] = '\0';
+        }
+
+        if(dst->len == wanted) {
+            if(wanted == STREAM_BINARY_FRAME_HEADER_SIZE) {
+                // we just completed the header, now get the payload
+                uint32_t payload_size;
+                memcpy(&payload_size, &dst->buffer[2], sizeof(payload_size));
+                if(payload_size && payload_size <= STREAM_BINARY_FRAME_MAX_SIZE)
+                    continue;
+            }
+            return true;
+        }
+
+        // we need more data
+        return false;
+    }
+}
+
+static inline bool stream_receiver_parse_input(struct receiver_state *rpt, PARSER *parser) {
+    bool frames = stream_has_capability(rpt, STREAM_CAP_BINARY_SAMPLES);
+    bool replay_frames = stream_has_capability(rpt, STREAM_CAP_BULK_REPLAY);
+    bool is_frame;
+
+    while(receiver_next_line_or_frame(&rpt->thread.uncompressed, rpt->thread.line_buffer, frames, replay_frames, &is_frame)) {
+        BUFFER *line = rpt->thread.line_buffer;
+        int rc;
+
+        if(!is_frame)
+            rc = parser_action(parser, line->buffer);
+        else if((uint8_t)line->buffer[0] == STREAM_REPLAY_FRAME_MARKER)
+            rc = pluginsd_replay_bulk_frame(parser, line->buffer, line->len);
+        else
+            rc = pluginsd_binary_samples_frame(parser, line->buffer, line->len);
+
+        if(unlikely(rc))
+            return false;
+
+        rpt->thread.line_buffer->len = 0;
+        rpt->thread.line_buffer->buffer[0] = '\0';
+    }
+
+    return true;
+}
+
 static ssize_t
 stream_receive_and_process(struct stream_thread *sth, struct receiver_state *rpt, PARSER *parser, usec_t now_ut __maybe_unused, bool *removed) {
     internal_fatal(sth->tid != gettid_cached(), "Function %s() should only be used by the dispatcher thread", __FUNCTION__);
@@ -638,17 +729,12 @@ stream_receive_and_process(struct stream_thread *sth, struct receiver_state *rpt
                     decompressor_status_t decompress_rc = receiver_get_decompressed(rpt);
 
                     if (likely(decompress_rc == DECOMPRESS_OK)) {
-                        // loop through all the complete lines found in the uncompressed buffer
+                        // loop through all the complete lines and frames found in the uncompressed buffer
 
-                        while (buffered_reader_next_line(&rpt->thread.uncompressed, rpt->thread.line_buffer)) {
-                            if (unlikely(parser_action(parser, rpt->thread.line_buffer->buffer))) {
-                                stream_receiver_remove(sth, rpt, STREAM_HANDSHAKE_RCV_DISCONNECT_PARSER_FAILED);
-                                *removed = true;
-                                return -1;
-                            }
-
-                            rpt->thread.line_buffer->len = 0;
-                            rpt->thread.line_buffer->buffer[0] = '\0';
+                        if (unlikely(!stream_receiver_parse_input(rpt, parser))) {
+                            stream_receiver_remove(sth, rpt, STREAM_HANDSHAKE_RCV_DISCONNECT_PARSER_FAILED);
+                            *removed = true;
+                            return -1;
                         }
                     }
                     else if (decompress_rc == DECOMPRESS_NEED_MORE_DATA)
@@ -681,15 +767,10 @@ stream_receive_and_process(struct stream_thread *sth, struct receiver_state *rpt
         if(rc <= 0)
             return rc;
 
-        while(buffered_reader_next_line(&rpt->thread.uncompressed, rpt->thread.line_buffer)) {
-            if(unlikely(parser_action(parser, rpt->thread.line_buffer->buffer))) {
-                stream_receiver_remove(sth, rpt, STREAM_HANDSHAKE_RCV_DISCONNECT_PARSER_FAILED);
-                *removed = true;
-                return -1;
-            }
-
-            rpt->thread.line_buffer->len = 0;
-            rpt->thread.line_buffer->buffer[0] = '\0';
+        if(unlikely(!stream_receiver_parse_input(rpt, parser))) {
+            stream_receiver_remove(sth, rpt, STREAM_HANDSHAKE_RCV_DISCONNECT_PARSER_FAILED);
+            *removed = true;
+            return -1;
         }
     }
 
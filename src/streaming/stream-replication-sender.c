@@ -322,6 +322,135 @@ static void replication_query_align_to_optimal_before(struct replication_query *
         q->query.before = expanded_before;
 }
 
+// ----------------------------------------------------------------------------
+// bulk replication frames - see streaming/protocol/commands.h for the format
+
+struct replication_bulk {
+    size_t max_points;
+    size_t points;
+    time_t first_end_time;
+    time_t update_every;
+    NETDATA_DOUBLE *values;     // dimension major, max_points per dimension
+    uint8_t *flags;             // dimension major, max_points per dimension
+};
+
+static void replication_bulk_init(struct replication_bulk *b, size_t dimensions) {
+    b->max_points = MIN(STREAM_REPLAY_FRAME_MAX_POINTS, MAX(1, STREAM_REPLAY_FRAME_MAX_VALUES / dimensions));
+    b->points = 0;
+    b->values = mallocz(dimensions * b->max_points * sizeof(*b->values));
+    b->flags = mallocz(dimensions * b->max_points * sizeof(*b->flags));
+    __atomic_add_fetch(&replication_buffers_allocated, dimensions * b->max_points * (sizeof(*b->values) + sizeof(*b->flags)), __ATOMIC_RELAXED);
+}
+
+static void replication_bulk_free(struct replication_bulk *b, size_t dimensions) {
+    if(!b->values)
+        return;
+
+    freez(b->values);
+    freez(b->flags);
+    __atomic_sub_fetch(&replication_buffers_allocated, dimensions * b->max_points * (sizeof(*b->values) + sizeof(*b->flags)), __ATOMIC_RELAXED);
+    b->values = NULL;
+    b->flags = NULL;
+}
+
+// the bytes the points collected so far will need when flushed
+static inline size_t replication_bulk_bytes(struct replication_bulk *b, size_t dimensions) {
+    return b->points * dimensions * (sizeof(double) + sizeof(uint8_t));
+}
+
+static void replication_bulk_flush(BUFFER *wb, struct replication_query *q, struct replication_bulk *b) {
+    if(!b->points)
+        return;
+
+    RRDSET *st = q->st;
+    size_t points = b->points;
+
+    buffer_need_bytes(wb, STREAM_BINARY_FRAME_HEADER_SIZE + 4 + 2 + string_strlen(st->id) + 8 + 4 + 4 + 8 + 4 + 1);
+
+    size_t frame_pos = wb->len;
+    binary_frame_put_u8(wb, STREAM_REPLAY_FRAME_MARKER);
+    binary_frame_put_u8(wb, 0);                 // flags
+    binary_frame_put_u32(wb, 0);                // payload size, set when the frame is complete
+
+    binary_frame_put_u32(wb, (uint32_t)st->stream.snd.chart_slot);
+    binary_frame_put_string(wb, st->id);
+    binary_frame_put_i64(wb, b->first_end_time);
+    binary_frame_put_u32(wb, (uint32_t)b->update_every);
+    binary_frame_put_u32(wb, (uint32_t)points);
+    binary_frame_put_i64(wb, q->wall_clock_time);
+
+    size_t dims_pos = wb->len;
+    binary_frame_put_u32(wb, 0);                // number of dimensions, set when the frame is complete
+
+    uint32_t dims = 0;
+    for (size_t i = 0; i < q->dimensions; i++) {
+        struct replication_dimension *d = &q->data[i];
+        if (unlikely(!d->enabled)) continue;
+
+        buffer_need_bytes(wb, 4 + 2 + string_strlen(d->rd->id) + points * (sizeof(double) + sizeof(uint8_t)) + 1);
+
+        binary_frame_put_u32(wb, (uint32_t)d->rd->stream.snd.dim_slot);
+        binary_frame_put_string(wb, d->rd->id);
+
+        NETDATA_DOUBLE *values = &b->values[i * b->max_points];
+        for(size_t p = 0; p < points ; p++)
+            binary_frame_put_f64(wb, values[p]);
+
+        binary_frame_put(wb, &b->flags[i * b->max_points], points);
+        dims++;
+    }
+
+    uint32_t payload_size = (uint32_t)(wb->len - frame_pos - STREAM_BINARY_FRAME_HEADER_SIZE);
+    memcpy(&wb->buffer[frame_pos + 2], &payload_size, sizeof(payload_size));
+    memcpy(&wb->buffer[dims_pos], &dims, sizeof(dims));
+    wb->buffer[wb->len] = '\0';
+
+    b->points = 0;
+}
+
+// add the point ending at end_time to the frame, flushing the frame when the point does not continue it
+// returns the number of dimensions that have a value for this point
+static size_t replication_bulk_add_point(BUFFER *wb, struct replication_query *q, struct replication_bulk *b, time_t start_time, time_t end_time) {
+    time_t update_every = end_time - start_time;
+
+    if(b->points &&
+        (b->points >= b->max_points ||
+         update_every != b->update_every ||
+         end_time != b->first_end_time + (time_t)b->points * b->update_every))
+        replication_bulk_flush(wb, q, b);
+
+    if(!b->points) {
+        b->first_end_time = end_time;
+        b->update_every = update_every;
+    }
+
+    size_t generated = 0;
+    for (size_t i = 0; i < q->dimensions; i++) {
+        struct replication_dimension *d = &q->data[i];
+        if (unlikely(!d->enabled)) continue;
+
+        size_t slot = i * b->max_points + b->points;
+
+        if (likely( d->sp.start_time_s <= end_time &&
+                    d->sp.end_time_s >= end_time &&
+                    !storage_point_is_unset(d->sp) &&
+                    !storage_point_is_gap(d->sp))) {
+            b->values[slot] = d->sp.sum;
+            b->flags[slot] = binary_frame_dim_flags(d->sp.flags);
+            generated++;
+        }
+        else {
+            b->values[slot] = NAN;
+            b->flags[slot] = STREAM_REPLAY_POINT_MISSING;
+        }
+    }
+
+    b->points++;
+    return generated;
+}
+
+// ----------------------------------------------------------------------------
+
 static bool replication_query_execute(BUFFER *wb, struct replication_query *q, size_t max_msg_size) {
     replication_query_align_to_optimal_before(q);
 
@@ -335,6 +464,10 @@ static bool replication_query_execute(BUFFER *wb, struct replication_query *q, s
     bool finished_with_gap = false;
     size_t points_read = 0, points_generated = 0;
 
+    struct replication_bulk bulk = { 0 };
+    if(q->query.capabilities & STREAM_CAP_BULK_REPLAY)
+        replication_bulk_init(&bulk, dimensions);
+
 #ifdef NETDATA_LOG_REPLICATION_REQUESTS
     time_t actual_after = 0, actual_before = 0;
 #endif
@@ -440,7 +573,7 @@ static bool replication_query_execute(BUFFER *wb, struct replication_query *q, s
             actual_before = min_end_time;
 #endif
 
-            if(buffer_strlen(wb) > max_msg_size && last_end_time_in_buffer) {
+            if(buffer_strlen(wb) + replication_bulk_bytes(&bulk, dimensions) > max_msg_size && last_end_time_in_buffer) {
                 q->query.before = last_end_time_in_buffer;
                 q->query.enable_streaming = false;
 
@@ -459,6 +592,12 @@ static bool replication_query_execute(BUFFER *wb, struct replication_query *q, s
             }
             last_end_time_in_buffer = min_end_time;
 
+            if(bulk.values) {
+                points_generated += replication_bulk_add_point(wb, q, &bulk, min_start_time, min_end_time);
+                now = min_end_time + 1;
+                continue;
+            }
+
             buffer_fast_strcat(wb, PLUGINSD_KEYWORD_REPLAY_BEGIN, sizeof(PLUGINSD_KEYWORD_REPLAY_BEGIN) - 1);
 
             if(with_slots) {
@@ -520,6 +659,9 @@ static bool replication_query_execute(BUFFER *wb, struct replication_query *q, s
         }
     }
 
+    replication_bulk_flush(wb, q, &bulk);
+    replication_bulk_free(&bulk, dimensions);
+
 #ifdef NETDATA_LOG_REPLICATION_REQUESTS
     if(actual_after) {
         char actual_after_buf[LOG_DATE_LENGTH + 1], actual_before_buf[LOG_DATE_LENGTH + 1];
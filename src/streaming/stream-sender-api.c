@@ -83,6 +83,8 @@ void stream_sender_structures_free(struct rrdhost *host) {
     host->sender->scb = NULL;
     waitq_destroy(&host->sender->waitq);
     stream_compressor_destroy(&host->sender->thread.compressor);
+    stream_zstd_dictionary_free(host->sender->thread.zstd_dictionary);
+    host->sender->thread.zstd_dictionary = NULL;
 
     replication_sender_cleanup(host->sender);
 
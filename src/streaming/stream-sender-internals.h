@@ -25,6 +25,7 @@
 #define CONNECTED_TO_SIZE 100
 
 #include "stream-compression/compression.h"
+#include "stream-compression/zstd-dictionary.h"
 #include "stream-conf.h"
 
 typedef void (*stream_defer_action_t)(struct sender_state *s, void *data);
@@ -52,6 +53,7 @@ struct sender_state {
         uint32_t msg_slot;      // ensures a opcode queue that can never get full
 
         struct compressor_state compressor;
+        STREAM_ZSTD_DICTIONARY *zstd_dictionary;    // received from the parent during the handshake
 
         struct {
             size_t size;
@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "columnar.h"
+
+// The binary layout is documented in README.md, next to this file.
+// Values are stored in the byte order of the agent, announced in the header,
+// so that the encoder copies the RRDR arrays without any per-value conversion
+// other than the narrowing of NETDATA_DOUBLE to IEEE 754 double.
+
+typedef enum __attribute__((packed)) {
+    COLUMNAR_TIME = 0,
+    COLUMNAR_VALUE,
+    COLUMNAR_ANOMALY_RATE,
+    COLUMNAR_ANNOTATIONS,
+    COLUMNAR_COUNT,
+    COLUMNAR_HIDDEN,
+
+    // terminator
+    COLUMNAR_MAX,
+} COLUMNAR_COLUMN;
+
+static struct {
+    const char *name;
+    const char *type;
+    size_t size;
+    bool per_dimension;
+} columnar_columns[COLUMNAR_MAX] = {
+    [COLUMNAR_TIME]         = { .name = "time",   .type = "int64",   .size = sizeof(int64_t),  .per_dimension = false },
+    [COLUMNAR_VALUE]        = { .name = "value",  .type = "float64", .size = sizeof(double),   .per_dimension = true },
+    [COLUMNAR_ANOMALY_RATE] = { .name = "arp",    .type = "float64", .size = sizeof(double),   .per_dimension = true },
+    [COLUMNAR_ANNOTATIONS]  = { .name = "pa",     .type = "uint8",   .size = sizeof(uint8_t),  .per_dimension = true },
+    [COLUMNAR_COUNT]        = { .name = "count",  .type = "uint32",  .size = sizeof(uint32_t), .per_dimension = true },
+    [COLUMNAR_HIDDEN]       = { .name = "hidden", .type = "float64", .size = sizeof(double),   .per_dimension = true },
+};
+
+static inline size_t columnar_padding(size_t len) {
+    return (COLUMNAR_ALIGNMENT - (len % COLUMNAR_ALIGNMENT)) % COLUMNAR_ALIGNMENT;
+}
+
+static inline void columnar_pad(BUFFER *wb, size_t base) {
+    size_t padding = columnar_padding(wb->len - base);
+    if(padding) {
+        buffer_need_bytes(wb, padding);
+        memset(&wb->buffer[wb->len], 0, padding);
+        wb->len += padding;
+    }
+}
+
+// reserve the space of a column and return a pointer to it
+// the column starts aligned relative to the beginning of the response
+static inline uint8_t *columnar_column_reserve(BUFFER *wb, size_t base, size_t bytes) {
+    columnar_pad(wb, base);
+    buffer_need_bytes(wb, bytes);
+    uint8_t *p = (uint8_t *)&wb->buffer[wb->len];
+    wb->len += bytes;
+    return p;
+}
+
+#define columnar_store(p, type, value) do { type _v = (type)(value); memcpy(p, &_v, sizeof(_v)); (p) += sizeof(_v); } while(0)
+
+void rrdr2columnar(RRDR *r, BUFFER *wb, wrapper_begin_t wrapper_begin, wrapper_end_t wrapper_end) {
+    QUERY_TARGET *qt = r->internal.qt;
+    RRDR_OPTIONS options = qt->window.options;
+
+    bool send_count = query_target_aggregatable(qt);
+    bool send_hidden = send_count && r->vh && query_has_group_by_aggregation_percentage(qt);
+
+    const size_t used = r->d;
+    const size_t rows = rrdr_rows(r);
+
+    size_t *dims = mallocz((used ? used : 1) * sizeof(*dims));
+    size_t exposed = 0;
+    for(size_t d = 0; d < used ; d++) {
+        if(rrdr_dimension_should_be_exposed(r->od[d], options))
+            dims[exposed++] = d;
+    }
+
+    bool enabled[COLUMNAR_MAX] = {
+        [COLUMNAR_TIME] = true,
+        [COLUMNAR_VALUE] = true,
+        [COLUMNAR_ANOMALY_RATE] = true,
+        [COLUMNAR_ANNOTATIONS] = true,
+        [COLUMNAR_COUNT] = send_count,
+        [COLUMNAR_HIDDEN] = send_hidden,
+    };
+
+    // the header length is always little endian, to be readable before the header itself
+    size_t base = wb->len;
+    buffer_memcat(wb, COLUMNAR_MAGIC, COLUMNAR_MAGIC_LEN);
+    size_t header_length_pos = wb->len;
+    buffer_memcat(wb, "\0\0\0\0", 4);
+    size_t header_pos = wb->len;
+
+    wrapper_begin(r, wb);
+
+    buffer_json_member_add_object(wb, "result");
+    {
+        buffer_json_member_add_array(wb, "labels");
+        buffer_json_add_array_item_string(wb, "time");
+        for(size_t i = 0; i < exposed ; i++)
+            buffer_json_add_array_item_string(wb, string2str(r->di[dims[i]]));
+        buffer_json_array_close(wb); // labels
+
+        buffer_json_member_add_uint64(wb, "rows", rows);
+        buffer_json_member_add_uint64(wb, "dimensions", exposed);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        buffer_json_member_add_string(wb, "byte_order", "big");
+#else
+        buffer_json_member_add_string(wb, "byte_order", "little");
+#endif
+
+        buffer_json_member_add_array(wb, "columns");
+        size_t offset = 0;
+        for(COLUMNAR_COLUMN c = 0; c < COLUMNAR_MAX ; c++) {
+            if(!enabled[c])
+                continue;
+
+            size_t bytes = columnar_columns[c].size * rows * (columnar_columns[c].per_dimension ? exposed : 1);
+
+            buffer_json_add_array_item_object(wb);
+            buffer_json_member_add_string(wb, "name", columnar_columns[c].name);
+            buffer_json_member_add_string(wb, "type", columnar_columns[c].type);
+            if(c == COLUMNAR_TIME)
+                buffer_json_member_add_string(wb, "units", (options & RRDR_OPTION_MILLISECONDS) ? "ms" : "s");
+            buffer_json_member_add_boolean(wb, "per_dimension", columnar_columns[c].per_dimension);
+            buffer_json_member_add_uint64(wb, "offset", offset);
+            buffer_json_member_add_uint64(wb, "length", bytes);
+            buffer_json_object_close(wb);
+
+            offset += bytes + columnar_padding(bytes);
+        }
+        buffer_json_array_close(wb); // columns
+    }
+    buffer_json_object_close(wb); // result
+
+    wrapper_end(r, wb);
+
+    size_t header_length = wb->len - header_pos;
+    uint8_t *hl = (uint8_t *)&wb->buffer[header_length_pos];
+    hl[0] = (uint8_t)(header_length & 0xff);
+    hl[1] = (uint8_t)((header_length >> 8) & 0xff);
+    hl[2] = (uint8_t)((header_length >> 16) & 0xff);
+    hl[3] = (uint8_t)((header_length >> 24) & 0xff);
+
+    // the order of the rows is the same with json2: newest first, unless reversed
+    long start = 0, end = (long)rows, step = 1;
+    if (!(options & RRDR_OPTION_REVERSED)) {
+        start = (long)rows - 1;
+        end = -1;
+        step = -1;
+    }
+
+    // the data section starts aligned, right after the header
+    columnar_pad(wb, base);
+    size_t data_pos = wb->len;
+
+    for(COLUMNAR_COLUMN c = 0; c < COLUMNAR_MAX ; c++) {
+        if(!enabled[c])
+            continue;
+
+        size_t bytes = columnar_columns[c].size * rows * (columnar_columns[c].per_dimension ? exposed : 1);
+        uint8_t *p = columnar_column_reserve(wb, data_pos, bytes);
+
+        if(c == COLUMNAR_TIME) {
+            for(long i = start; i != end ; i += step) {
+                if(options & RRDR_OPTION_MILLISECONDS)
+                    columnar_store(p, int64_t, (int64_t)r->t[i] * MSEC_PER_SEC);
+                else
+                    columnar_store(p, int64_t, r->t[i]);
+            }
+            continue;
+        }
+
+        // per dimension columns are dimension major: all the rows of a dimension are consecutive
+        for(size_t x = 0; x < exposed ; x++) {
+            size_t d = dims[x];
+
+            switch(c) {
+                case COLUMNAR_VALUE: {
+                    double empty = (options & RRDR_OPTION_NULL2ZERO) ? 0.0 : NAN;
+                    for(long i = start; i != end ; i += step) {
+                        size_t slot = i * r->d + d;
+                        if(r->o[slot] & RRDR_VALUE_EMPTY)
+                            columnar_store(p, double, empty);
+                        else
+                            columnar_store(p, double, r->v[slot]);
+                    }
+                    break;
+                }
+
+                case COLUMNAR_ANOMALY_RATE:
+                    for(long i = start; i != end ; i += step)
+                        columnar_store(p, double, r->ar[i * r->d + d]);
+                    break;
+
+                case COLUMNAR_ANNOTATIONS:
+                    for(long i = start; i != end ; i += step)
+                        *p++ = (uint8_t)r->o[i * r->d + d];
+                    break;
+
+                case COLUMNAR_COUNT:
+                    for(long i = start; i != end ; i += step)
+                        columnar_store(p, uint32_t, r->gbc[i * r->d + d]);
+                    break;
+
+                case COLUMNAR_HIDDEN:
+                    for(long i = start; i != end ; i += step)
+                        columnar_store(p, double, r->vh[i * r->d + d]);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    freez(dims);
+
+    // the json wrapper resets the content type, so it has to be set after it
+    wb->content_type = CT_APPLICATION_NETDATA_COLUMNAR;
+}
@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_API_FORMATTER_COLUMNAR_H
+#define NETDATA_API_FORMATTER_COLUMNAR_H
+
+#include "../rrd2json.h"
+
+#define COLUMNAR_MAGIC "NDCOLS01"
+#define COLUMNAR_MAGIC_LEN (sizeof(COLUMNAR_MAGIC) - 1)
+#define COLUMNAR_ALIGNMENT 8
+
+// the media type clients send in their Accept: header to negotiate this format
+#define COLUMNAR_MEDIA_TYPE "application/vnd.netdata.columnar"
+
+void rrdr2columnar(RRDR *r, BUFFER *wb, wrapper_begin_t wrapper_begin, wrapper_end_t wrapper_end);
+
+#endif //NETDATA_API_FORMATTER_COLUMNAR_H
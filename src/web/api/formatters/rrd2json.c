@@ -346,6 +346,10 @@ int data_query_execute(ONEWAYALLOC *owa, BUFFER *wb, QUERY_TARGET *qt, time_t *l
         rrdr2json_v2(r, wb);
         wrapper_end(r, wb);
         break;
+
+    case DATASOURCE_COLUMNAR:
+        rrdr2columnar(r, wb, wrapper_begin, wrapper_end);
+        break;
     }
 
     rrdr_free(owa, r);
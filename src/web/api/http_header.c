@@ -90,9 +90,47 @@ static void http_header_host(struct web_client *w, const char *v, size_t len) {
     w->server_host = strdupz(buffer);
 }
 
+// check if an Accept: or Accept-Encoding: value lists the token, without q=0
+static bool http_header_accepts_token(const char *v, const char *token) {
+    size_t len = strlen(token);
+
+    for(const char *s = v; (s = strcasestr(s, token)) ; s += len) {
+        if(s != v && s[-1] != ',' && !isspace((uint8_t)s[-1]))
+            continue;
+
+        const char *e = &s[len];
+        while(isspace((uint8_t)*e)) e++;
+
+        if(!*e || *e == ',')
+            return true;
+
+        if(*e != ';')
+            continue;
+
+        e++;
+        while(isspace((uint8_t)*e)) e++;
+        if((*e == 'q' || *e == 'Q') && e[1] == '=')
+            return str2ndd(&e[2], NULL) > 0.0;
+
+        return true;
+    }
+
+    return false;
+}
+
 static void http_header_accept_encoding(struct web_client *w, const char *v, size_t len __maybe_unused) {
+#ifdef ENABLE_BROTLI
+    if(web_enable_brotli && http_header_accepts_token(v, "br"))
+        web_client_flag_set(w, WEB_CLIENT_ENCODING_BROTLI);
+#endif
+
+#ifdef ENABLE_ZSTD
+    if(web_enable_zstd && http_header_accepts_token(v, "zstd"))
+        web_client_flag_set(w, WEB_CLIENT_ENCODING_ZSTD);
+#endif
+
     if(web_enable_gzip) {
-        if(strcasestr(v, "gzip"))
+        if(http_header_accepts_token(v, "gzip"))
             web_client_enable_deflate(w, true);
 
         // does not seem to work
@@ -101,6 +139,16 @@ static void http_header_accept_encoding(struct web_client *w, const char *v, siz
     }
 }
 
+static void http_header_accept(struct web_client *w, const char *v, size_t len __maybe_unused) {
+    if(http_header_accepts_token(v, COLUMNAR_MEDIA_TYPE))
+        web_client_flag_set(w, WEB_CLIENT_FLAG_ACCEPTS_COLUMNAR);
+}
+
+static void http_header_if_none_match(struct web_client *w, const char *v, size_t len __maybe_unused) {
+    freez(w->if_none_match);
+    w->if_none_match = strdupz(v);
+}
+
 static void http_header_x_forwarded_host(struct web_client *w, const char *v, size_t len) {
     char buffer[NI_MAXHOST];
     strncpyz(buffer, v, (len < sizeof(buffer) - 1 ? len : sizeof(buffer) - 1));
@@ -186,7 +234,9 @@ struct {
     { .hash = 0, .key = "User-Agent",            .cb = http_header_user_agent},
     { .hash = 0, .key = "X-Auth-Token",          .cb = http_header_x_auth_token },
     { .hash = 0, .key = "Host",                  .cb = http_header_host },
+    { .hash = 0, .key = "Accept",                .cb = http_header_accept },
     { .hash = 0, .key = "Accept-Encoding",       .cb = http_header_accept_encoding },
+    { .hash = 0, .key = "If-None-Match",         .cb = http_header_if_none_match },
     { .hash = 0, .key = "X-Forwarded-Host",      .cb = http_header_x_forwarded_host },
     { .hash = 0, .key = "X-Forwarded-For",       .cb = http_header_x_forwarded_for },
     { .hash = 0, .key = "X-Transaction-Id",      .cb = http_header_x_transaction_id },
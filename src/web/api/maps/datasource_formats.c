@@ -42,6 +42,7 @@ static struct {
     , {"datasource"    , 0 , DATASOURCE_DATATABLE_JSONP}
     , {"json"          , 0 , DATASOURCE_JSON}
     , {"json2"         , 0 , DATASOURCE_JSON2}
+    , {"columnar"      , 0 , DATASOURCE_COLUMNAR}
     , {"jsonp"         , 0 , DATASOURCE_JSONP}
     , {"ssv"           , 0 , DATASOURCE_SSV}
     , {"csv"           , 0 , DATASOURCE_CSV}
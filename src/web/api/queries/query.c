@@ -1190,6 +1190,7 @@ typedef struct query_engine_ops {
     size_t tier;
     struct query_metric_tier *tier_ptr;
     struct storage_engine_query_handle *seqh;
+    STORAGE_POINTS_BATCH *batch;        // the points read-ahead from seqh, in columns
 
     // aggregating points over time
     size_t group_points_non_zero;
@@ -1313,6 +1314,10 @@ static void query_planer_activate_plan(QUERY_ENGINE_OPS *ops, size_t plan_id, ti
     ops->seqh = &ops->plans[plan_id].handle;
     ops->current_plan = plan_id;
 
+    // points read-ahead from the previous plan are not needed anymore
+    if(ops->batch)
+        storage_points_batch_reset(ops->batch);
+
     if(plan_id + 1 < qm->plan.used && qm->plan.array[plan_id + 1].after < qm->plan.array[plan_id].before)
         ops->current_plan_expire_time = qm->plan.array[plan_id + 1].after;
     else
@@ -1353,6 +1358,26 @@ static bool query_planer_next_plan(QUERY_ENGINE_OPS *ops, time_t now, time_t las
     return true;
 }
 
+// ----------------------------------------------------------------------------
+// reading points from the storage engine, in batches
+
+ALWAYS_INLINE_HOT static bool query_ops_is_finished(QUERY_ENGINE_OPS *ops) {
+    return storage_points_batch_is_empty(ops->batch) && storage_engine_query_is_finished(ops->seqh);
+}
+
+ALWAYS_INLINE_HOT static STORAGE_POINT query_ops_next_point(QUERY_ENGINE_OPS *ops) {
+    STORAGE_POINTS_BATCH *batch = ops->batch;
+
+    if(unlikely(storage_points_batch_is_empty(batch)))
+        storage_engine_query_next_metric_batch(ops->seqh, batch);
+
+    STORAGE_POINT sp;
+    storage_points_batch_get(batch, batch->position, sp);
+    batch->position++;
+
+    return sp;
+}
+
 static int compare_query_plan_entries_on_start_time(const void *a, const void *b) {
     QUERY_PLAN_ENTRY *p1 = (QUERY_PLAN_ENTRY *)a;
     QUERY_PLAN_ENTRY *p2 = (QUERY_PLAN_ENTRY *)b;
@@ -1585,6 +1610,10 @@ NOT_INLINE_HOT static void rrd2rrdr_query_execute(RRDR *r, size_t dim_id_in_rrdr
 
     const RRDR_TIME_GROUPING add_flush = r->time_grouping.add_flush;
 
+    STORAGE_POINTS_BATCH batch;
+    storage_points_batch_reset(&batch);
+    ops->batch = &batch;
+
     ops->group_point = STORAGE_POINT_UNSET;
     ops->query_point = STORAGE_POINT_UNSET;
 
@@ -1637,7 +1666,7 @@ NOT_INLINE_HOT static void rrd2rrdr_query_execute(RRDR *r, size_t dim_id_in_rrdr
                 last1_point = new_point;
             }
 
-            if(unlikely(storage_engine_query_is_finished(ops->seqh))) {
+            if(unlikely(query_ops_is_finished(ops))) {
                 query_is_finished_counter++;
 
                 if(count_same_end_time != 0) {
@@ -1660,7 +1689,7 @@ NOT_INLINE_HOT static void rrd2rrdr_query_execute(RRDR *r, size_t dim_id_in_rrdr
                 STORAGE_POINT sp;
                 if(likely(storage_point_is_unset(next1_point))) {
                     db_points_read_since_plan_switch++;
-                    sp = storage_engine_query_next_metric(ops->seqh);
+                    sp = query_ops_next_point(ops);
                     ops->db_points_read_per_tier[ops->tier]++;
                     ops->db_total_points_read++;
 
@@ -1686,7 +1715,7 @@ NOT_INLINE_HOT static void rrd2rrdr_query_execute(RRDR *r, size_t dim_id_in_rrdr
                     // A. the entire point of the previous plan is to the future of point from the next plan
                     // B. part of the point of the previous plan overlaps with the point from the next plan
 
-                    STORAGE_POINT sp2 = storage_engine_query_next_metric(ops->seqh);
+                    STORAGE_POINT sp2 = query_ops_next_point(ops);
                     ops->db_points_read_per_tier[ops->tier]++;
                     ops->db_total_points_read++;
 
@@ -1937,6 +1966,7 @@ NOT_INLINE_HOT static void rrd2rrdr_query_execute(RRDR *r, size_t dim_id_in_rrdr
         now_end_time -= ops->view_update_every;
     }
     query_planer_finalize_remaining_plans(ops);
+    ops->batch = NULL;
 
     qm->query_points = ops->query_point;
 
@@ -2435,6 +2465,22 @@ static void rrd2rrdr_set_timestamps(RRDR *r) {
                    before_wanted, r->t[points_wanted - 1]);
 }
 
+static void query_group_by_label_values_to_buffer(BUFFER *key, QUERY_TARGET *qt, size_t group_by_id, QUERY_INSTANCE *qi, const char *separator, bool always_separate) {
+    // instances of contexts with a labels index have their values looked up already
+    STRING **values = rrdinstance_acquired_labels_values(qi->ria, qt->group_by[group_by_id].label_values);
+    RRDLABELS *labels = values ? NULL : rrdinstance_acquired_labels(qi->ria);
+
+    for (size_t l = 0; l < qt->group_by[group_by_id].used; l++) {
+        if (always_separate || buffer_strlen(key) != 0)
+            buffer_fast_strcat(key, separator, 1);
+
+        if (values)
+            buffer_strcat(key, values[l] ? string2str(values[l]) : "[unset]");
+        else
+            rrdlabels_get_value_to_buffer_or_unset(labels, key, qt->group_by[group_by_id].label_keys[l], "[unset]");
+    }
+}
+
 static void query_group_by_make_dimension_key(BUFFER *key, RRDR_GROUP_BY group_by, size_t group_by_id, QUERY_TARGET *qt, QUERY_NODE *qn, QUERY_CONTEXT *qc, QUERY_INSTANCE *qi, QUERY_DIMENSION *qd __maybe_unused, QUERY_METRIC *qm, bool query_has_percentage_of_group) {
     buffer_flush(key);
     if(unlikely(!query_has_percentage_of_group && qm->status & RRDR_DIMENSION_HIDDEN)) {
@@ -2454,13 +2500,8 @@ static void query_group_by_make_dimension_key(BUFFER *key, RRDR_GROUP_BY group_b
             buffer_strcat(key, string2str(query_instance_id_fqdn(qi, qt->request.version)));
         }
 
-        if (group_by & RRDR_GROUP_BY_LABEL) {
-            RRDLABELS *labels = rrdinstance_acquired_labels(qi->ria);
-            for (size_t l = 0; l < qt->group_by[group_by_id].used; l++) {
-                buffer_fast_strcat(key, "|", 1);
-                rrdlabels_get_value_to_buffer_or_unset(labels, key, qt->group_by[group_by_id].label_keys[l], "[unset]");
-            }
-        }
+        if (group_by & RRDR_GROUP_BY_LABEL)
+            query_group_by_label_values_to_buffer(key, qt, group_by_id, qi, "|", true);
 
         if (group_by & RRDR_GROUP_BY_NODE) {
             buffer_fast_strcat(key, "|", 1);
@@ -2502,14 +2543,8 @@ static void query_group_by_make_dimension_id(BUFFER *key, RRDR_GROUP_BY group_by
                 buffer_strcat(key, string2str(query_instance_id_fqdn(qi, qt->request.version)));
         }
 
-        if (group_by & RRDR_GROUP_BY_LABEL) {
-            RRDLABELS *labels = rrdinstance_acquired_labels(qi->ria);
-            for (size_t l = 0; l < qt->group_by[group_by_id].used; l++) {
-                if (buffer_strlen(key) != 0)
-                    buffer_fast_strcat(key, ",", 1);
-                rrdlabels_get_value_to_buffer_or_unset(labels, key, qt->group_by[group_by_id].label_keys[l], "[unset]");
-            }
-        }
+        if (group_by & RRDR_GROUP_BY_LABEL)
+            query_group_by_label_values_to_buffer(key, qt, group_by_id, qi, ",", false);
 
         if (group_by & RRDR_GROUP_BY_NODE) {
             if (buffer_strlen(key) != 0)
@@ -2557,14 +2592,8 @@ static void query_group_by_make_dimension_name(BUFFER *key, RRDR_GROUP_BY group_
                 buffer_strcat(key, string2str(query_instance_name_fqdn(qi, qt->request.version)));
         }
 
-        if (group_by & RRDR_GROUP_BY_LABEL) {
-            RRDLABELS *labels = rrdinstance_acquired_labels(qi->ria);
-            for (size_t l = 0; l < qt->group_by[group_by_id].used; l++) {
-                if (buffer_strlen(key) != 0)
-                    buffer_fast_strcat(key, ",", 1);
-                rrdlabels_get_value_to_buffer_or_unset(labels, key, qt->group_by[group_by_id].label_keys[l], "[unset]");
-            }
-        }
+        if (group_by & RRDR_GROUP_BY_LABEL)
+            query_group_by_label_values_to_buffer(key, qt, group_by_id, qi, ",", false);
 
         if (group_by & RRDR_GROUP_BY_NODE) {
             if (buffer_strlen(key) != 0)
@@ -2710,6 +2739,12 @@ static RRDR *rrd2rrdr_group_by_initialize(ONEWAYALLOC *owa, QUERY_TARGET *qt) {
         if (final_grouping && (options & RRDR_OPTION_GROUP_BY_LABELS))
             label_keys = dictionary_create_advanced(DICT_OPTION_SINGLE_THREADED | DICT_OPTION_DONT_OVERWRITE_VALUE, NULL, 0);
 
+        if (group_by & RRDR_GROUP_BY_LABEL) {
+            for (size_t c = 0; c < qt->contexts.used; c++)
+                rrdcontext_acquired_labels_values(query_context(qt, c)->rca, qt->group_by[g].label_keys,
+                                                  qt->group_by[g].used, &qt->group_by[g].label_values);
+        }
+
         QUERY_INSTANCE *last_qi = NULL;
         size_t priority = 0;
         time_t update_every_max = 0;
@@ -2941,6 +2976,9 @@ cleanup:
         first_r = last_r = r_tmp = NULL;
     }
 
+    for(size_t g = 0; g < MAX_QUERY_GROUP_BY_PASSES ;g++)
+        rrdcontext_labels_values_free(&qt->group_by[g].label_values, qt->group_by[g].used);
+
     buffer_free(key);
     onewayalloc_freez(owa, entries);
     dictionary_destroy(groups);
@@ -50,7 +50,8 @@ int api_v2_data(RRDHOST *host __maybe_unused, struct web_client *w, char *url) {
     char *tier_str = NULL;
     size_t tier = 0;
     RRDR_TIME_GROUPING time_group = RRDR_GROUPING_AVERAGE;
-    DATASOURCE_FORMAT format = DATASOURCE_JSON2;
+    // clients may negotiate the binary columnar format with their Accept: header - format= overrides it
+    DATASOURCE_FORMAT format = web_client_flag_check(w, WEB_CLIENT_FLAG_ACCEPTS_COLUMNAR) ? DATASOURCE_COLUMNAR : DATASOURCE_JSON2;
     RRDR_OPTIONS options = RRDR_OPTION_VIRTUAL_POINTS | RRDR_OPTION_JSON_WRAP | RRDR_OPTION_RETURN_JWAR;
 
     struct group_by_pass group_by[MAX_QUERY_GROUP_BY_PASSES] = {
@@ -244,6 +245,9 @@ int api_v2_data(RRDHOST *host __maybe_unused, struct web_client *w, char *url) {
         goto cleanup;
     }
 
+    // the default format depends on the Accept: header
+    buffer_strcat(w->response.header, "Vary: Accept\r\n");
+
     if(outFileName && *outFileName) {
         buffer_sprintf(w->response.header, "Content-Disposition: attachment; filename=\"%s\"\r\n", outFileName);
         netdata_log_debug(D_WEB_CLIENT, "%llu: generating outfilename header: '%s'", w->id, outFileName);
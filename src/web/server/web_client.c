@@ -9,6 +9,8 @@ int respect_web_browser_do_not_track_policy = 0;
 const char *web_x_frame_options = NULL;
 
 int web_enable_gzip = 1, web_gzip_level = 3, web_gzip_strategy = Z_DEFAULT_STRATEGY;
+int web_enable_brotli = 1, web_brotli_level = 4;
+int web_enable_zstd = 1, web_zstd_level = 3;
 
 void web_client_set_conn_tcp(struct web_client *w) {
     web_client_flags_clear_conn(w);
@@ -127,6 +129,9 @@ static void web_client_reset_allocations(struct web_client *w, bool free_all) {
 
         buffer_free(w->payload);
         w->payload = NULL;
+
+        buffer_free(w->response.encoded);
+        w->response.encoded = NULL;
     }
     else {
         // the web client is to be re-used
@@ -139,6 +144,9 @@ static void web_client_reset_allocations(struct web_client *w, bool free_all) {
         buffer_reset(w->response.header);
         buffer_reset(w->response.data);
 
+        if(w->response.encoded)
+            buffer_reset(w->response.encoded);
+
         if(w->payload)
             buffer_reset(w->payload);
 
@@ -164,6 +172,13 @@ static void web_client_reset_allocations(struct web_client *w, bool free_all) {
     freez(w->auth_bearer_token);
     w->auth_bearer_token = NULL;
 
+    freez(w->if_none_match);
+    w->if_none_match = NULL;
+
+    // if the response was sent from the static files cache, release it
+    web_static_cache_release(w->response.zerocopy.item);
+    memset(&w->response.zerocopy, 0, sizeof(w->response.zerocopy));
+
     // if we had enabled compression, release it
     if(w->response.zinitialized) {
         deflateEnd(&w->response.zstream);
@@ -181,7 +196,7 @@ static void web_client_reset_allocations(struct web_client *w, bool free_all) {
     memset(&w->auth, 0, sizeof(w->auth));
 
     web_client_reset_permissions(w);
-    web_client_flag_clear(w, WEB_CLIENT_ENCODING_GZIP|WEB_CLIENT_ENCODING_DEFLATE);
+    web_client_flag_clear(w, WEB_CLIENT_ENCODING_GZIP|WEB_CLIENT_ENCODING_DEFLATE|WEB_CLIENT_ENCODING_BROTLI|WEB_CLIENT_ENCODING_ZSTD|WEB_CLIENT_FLAG_ACCEPTS_COLUMNAR);
     web_client_reset_path_flags(w);
 }
 
@@ -191,6 +206,10 @@ void web_client_log_completed_request(struct web_client *w, bool update_web_stat
 
     size_t size = w->response.data->len;
     size_t sent = w->response.zoutput ? (size_t)w->response.zstream.total_out : size;
+    if(w->response.zerocopy.data) {
+        size = w->response.zerocopy.raw_len;
+        sent = w->response.zerocopy.len;
+    }
 
     usec_t prep_ut = w->timings.tv_ready.tv_sec ? dt_usec(&w->timings.tv_ready, &w->timings.tv_in) : 0;
     usec_t sent_ut = w->timings.tv_ready.tv_sec ? dt_usec(&tv, &w->timings.tv_ready) : 0;
@@ -464,6 +483,11 @@ static int web_server_static_file(struct web_client *w, char *filename) {
     if(is_dir && !web_client_flag_check(w, WEB_CLIENT_FLAG_PATH_HAS_TRAILING_SLASH))
         return append_slash_to_url_and_redirect(w);
 
+    HTTP_CONTENT_TYPE content_type = contenttype_for_filename(web_filename);
+    int code = web_static_cache_serve(w, web_filename, &statbuf, content_type);
+    if(code)
+        goto done;
+
     buffer_flush(w->response.data);
     buffer_need_bytes(w->response.data, (size_t)statbuf.st_size);
     w->response.data->len = (size_t)statbuf.st_size;
@@ -502,7 +526,10 @@ static int web_server_static_file(struct web_client *w, char *filename) {
     else
         close(fd);
 
-    w->response.data->content_type = contenttype_for_filename(web_filename);
+    code = HTTP_RESP_OK;
+
+done:
+    w->response.data->content_type = content_type;
     netdata_log_debug(D_WEB_CLIENT_ACCESS, "%llu: Sending file '%s' (%"PRId64" bytes, fd %d).", w->id, web_filename, (int64_t)statbuf.st_size, w->fd);
 
     w->mode = HTTP_REQUEST_MODE_GET;
@@ -518,7 +545,7 @@ static int web_server_static_file(struct web_client *w, char *filename) {
 
     buffer_cacheable(w->response.data);
 
-    return HTTP_RESP_OK;
+    return code;
 }
 #endif
 
@@ -795,8 +822,18 @@ static inline ssize_t web_client_send_data(struct web_client *w,const void *buf,
     } while(true);
 }
 
+static inline const char *web_client_response_body(struct web_client *w, size_t *len) {
+    if(w->response.zerocopy.data) {
+        *len = w->response.zerocopy.len;
+        return w->response.zerocopy.data;
+    }
+
+    *len = w->response.data->len;
+    return w->response.data->buffer;
+}
+
 void web_client_build_http_header(struct web_client *w) {
-    if(unlikely(w->response.code != HTTP_RESP_OK))
+    if(unlikely(w->response.code != HTTP_RESP_OK && w->response.code != HTTP_RESP_NOT_MODIFIED))
         buffer_no_cacheable(w->response.data);
 
     if(unlikely(!w->response.data->date))
@@ -885,13 +922,27 @@ void web_client_build_http_header(struct web_client *w) {
     // headers related to the transfer method
     if(likely(w->response.zoutput))
         buffer_strcat(w->response.header_output, "Content-Encoding: gzip\r\n");
+    else if(w->response.zerocopy.encoding)
+        buffer_sprintf(w->response.header_output, "Content-Encoding: %s\r\n", w->response.zerocopy.encoding);
+
+    // the encoding has been negotiated with Accept-Encoding, so caches have to key on it
+    // (the static files cache adds it to all its responses, compressed or not)
+    if((w->response.zoutput || w->response.zerocopy.encoding) && !w->response.zerocopy.item)
+        buffer_strcat(w->response.header_output, "Vary: Accept-Encoding\r\n");
+
+    size_t body_len;
+    web_client_response_body(w, &body_len);
 
     if(likely(w->flags & WEB_CLIENT_CHUNKED_TRANSFER))
         buffer_strcat(w->response.header_output, "Transfer-Encoding: chunked\r\n");
     else {
-        if(likely(w->response.data->len)) {
+        if(likely(body_len)) {
             // we know the content length, put it
-            buffer_sprintf(w->response.header_output, "Content-Length: %zu\r\n", (size_t)w->response.data->len);
+            buffer_sprintf(w->response.header_output, "Content-Length: %zu\r\n", body_len);
+        }
+        else if(w->response.code == HTTP_RESP_NOT_MODIFIED) {
+            // there is no body, keep-alive can be maintained
+            ;
         }
         else {
             // we don't know the content length, disable keep-alive
@@ -908,7 +959,56 @@ void web_client_build_http_header(struct web_client *w) {
     buffer_strcat(w->response.header_output, "\r\n");
 }
 
+// compress complete responses with brotli or zstd, when the client accepts them
+// gzip is applied while sending (web_client_send_deflate()), so it remains the fallback
+static void web_client_encode_response(struct web_client *w) {
+    if(!web_client_flag_check(w, WEB_CLIENT_ENCODING_BROTLI | WEB_CLIENT_ENCODING_ZSTD) ||
+        w->response.zerocopy.data ||
+        w->response.data->len < NETDATA_WEB_RESPONSE_ENCODE_MIN_SIZE ||
+        (!web_client_check_conn_tcp(w) && !web_client_check_conn_unix(w)) ||
+        !content_type_is_compressible(w->response.data->content_type))
+        return;
+
+    switch(w->mode) {
+        case HTTP_REQUEST_MODE_GET:
+        case HTTP_REQUEST_MODE_POST:
+        case HTTP_REQUEST_MODE_PUT:
+        case HTTP_REQUEST_MODE_DELETE:
+            break;
+
+        default:
+            return;
+    }
+
+    WEB_ENCODING encoding = WEB_ENCODING_BROTLI;
+    int level = web_brotli_level;
+    if(web_client_flag_check(w, WEB_CLIENT_ENCODING_ZSTD)) {
+        // zstd is a lot faster at similar ratios
+        encoding = WEB_ENCODING_ZSTD;
+        level = web_zstd_level;
+    }
+
+    if(!w->response.encoded)
+        w->response.encoded = buffer_create(w->response.data->len / 2, w->statistics.memory_accounting);
+    else
+        buffer_flush(w->response.encoded);
+
+    if(!web_encoding_compress(encoding, level, w->response.data->buffer, w->response.data->len, w->response.encoded) ||
+        w->response.encoded->len >= w->response.data->len)
+        return;
+
+    w->response.zerocopy.data = w->response.encoded->buffer;
+    w->response.zerocopy.len = w->response.encoded->len;
+    w->response.zerocopy.raw_len = w->response.data->len;
+    w->response.zerocopy.encoding = web_encoding_name(encoding);
+
+    // the response is complete, the streaming compressor is not needed
+    w->response.zoutput = false;
+    web_client_flag_clear(w, WEB_CLIENT_CHUNKED_TRANSFER);
+}
+
 static inline void web_client_send_http_header(struct web_client *w) {
+    web_client_encode_response(w);
     web_client_build_http_header(w);
 
     // sent the HTTP header
@@ -1451,7 +1551,9 @@ void web_client_process_request_from_web_server(struct web_client *w) {
     web_client_send_http_header(w);
 
     // enable sending immediately if we have data
-    if(w->response.data->len) web_client_enable_wait_send(w);
+    size_t body_len;
+    web_client_response_body(w, &body_len);
+    if(body_len || w->response.code == HTTP_RESP_NOT_MODIFIED) web_client_enable_wait_send(w);
     else web_client_disable_wait_send(w);
 
     switch(w->mode) {
@@ -1665,7 +1767,10 @@ ssize_t web_client_send(struct web_client *w) {
 
     ssize_t bytes;
 
-    if(unlikely(w->response.data->len - w->response.sent == 0)) {
+    size_t body_len;
+    const char *body = web_client_response_body(w, &body_len);
+
+    if(unlikely(body_len - w->response.sent == 0)) {
         // there is nothing to send
 
         netdata_log_debug(D_WEB_CLIENT, "%llu: Out of output data.", w->id);
@@ -1685,7 +1790,7 @@ ssize_t web_client_send(struct web_client *w) {
         return 0;
     }
 
-    bytes = web_client_send_data(w,&w->response.data->buffer[w->response.sent], w->response.data->len - w->response.sent, MSG_DONTWAIT);
+    bytes = web_client_send_data(w, &body[w->response.sent], body_len - w->response.sent, MSG_DONTWAIT);
     if(likely(bytes > 0)) {
         w->statistics.sent_bytes += bytes;
         w->response.sent += bytes;
@@ -4,10 +4,13 @@
 #define NETDATA_WEB_CLIENT_H 1
 
 #include "libnetdata/libnetdata.h"
+#include "web_static_cache.h"
 
 struct web_client;
 
 extern int web_enable_gzip, web_gzip_level, web_gzip_strategy;
+extern int web_enable_brotli, web_brotli_level;
+extern int web_enable_zstd, web_zstd_level;
 
 #define HTTP_REQ_MAX_HEADER_FETCH_TRIES 100
 
@@ -66,6 +69,13 @@ typedef enum __attribute__((packed)) {
 
     // transient settings
     WEB_CLIENT_FLAG_PROGRESS_TRACKING       = (1 << 25), // flag to avoid redoing progress work
+
+    // compression accepted by the client (complete responses)
+    WEB_CLIENT_ENCODING_BROTLI              = (1 << 26),
+    WEB_CLIENT_ENCODING_ZSTD                = (1 << 27),
+
+    // content negotiation
+    WEB_CLIENT_FLAG_ACCEPTS_COLUMNAR        = (1 << 28), // the client accepts the binary columnar data format
 } WEB_CLIENT_FLAGS;
 
 #define WEB_CLIENT_FLAG_PATH_WITH_VERSION (WEB_CLIENT_FLAG_PATH_IS_V0|WEB_CLIENT_FLAG_PATH_IS_V1|WEB_CLIENT_FLAG_PATH_IS_V2|WEB_CLIENT_FLAG_PATH_IS_V3)
@@ -128,6 +138,9 @@ void web_client_set_conn_webrtc(struct web_client *w);
 
 #define NETDATA_WEB_RESPONSE_ZLIB_CHUNK_SIZE 16384
 
+// smaller responses are sent uncompressed with brotli or zstd
+#define NETDATA_WEB_RESPONSE_ENCODE_MIN_SIZE 1024
+
 #define NETDATA_WEB_RESPONSE_HEADER_INITIAL_SIZE 4096
 #define NETDATA_WEB_RESPONSE_INITIAL_SIZE 8192
 #define NETDATA_WEB_REQUEST_INITIAL_SIZE 8192
@@ -149,6 +162,15 @@ struct response {
     size_t zsent;                                        // the compressed bytes we have sent to the client
     size_t zhave;                                        // the compressed bytes that we have received from zlib
     Bytef zbuffer[NETDATA_WEB_RESPONSE_ZLIB_CHUNK_SIZE]; // temporary buffer for storing compressed output
+
+    struct {
+        const char *data;                   // when set, the body is sent from here instead of from data
+        size_t len;                         // the bytes of the body
+        size_t raw_len;                     // the bytes of the body before compression
+        const char *encoding;               // the Content-Encoding of the body, or NULL
+        const DICTIONARY_ITEM *item;        // the static files cache item the body belongs to
+    } zerocopy;
+    BUFFER *encoded;                        // the response data, compressed with brotli or zstd
 };
 
 struct web_client;
@@ -186,6 +208,7 @@ struct web_client {
     char *forwarded_for;                // the X-Forwarded-For: header
     char *origin;                       // the Origin: header
     char *user_agent;                   // the User-Agent: header
+    char *if_none_match;                // the If-None-Match: header
 
     BUFFER *payload;                    // when this request is a POST, this has the payload
 
@@ -0,0 +1,448 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "web_client.h"
+
+#ifdef ENABLE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#ifdef ENABLE_ZSTD
+#include <zstd.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// one-shot compression of complete responses
+
+static const char *web_encoding_names[WEB_ENCODING_MAX] = {
+    [WEB_ENCODING_IDENTITY] = "identity",
+    [WEB_ENCODING_GZIP] = "gzip",
+    [WEB_ENCODING_BROTLI] = "br",
+    [WEB_ENCODING_ZSTD] = "zstd",
+};
+
+const char *web_encoding_name(WEB_ENCODING encoding) {
+    if(encoding >= WEB_ENCODING_MAX)
+        return "identity";
+
+    return web_encoding_names[encoding];
+}
+
+static bool web_encoding_compress_gzip(int level, const char *src, size_t src_len, BUFFER *dst) {
+    if(level < 1) level = 1;
+    if(level > 9) level = 9;
+
+    z_stream zs = { 0 };
+    if(deflateInit2(&zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+
+    size_t bound = deflateBound(&zs, src_len);
+    buffer_need_bytes(dst, bound);
+
+    zs.next_in = (Bytef *)src;
+    zs.avail_in = (uInt)src_len;
+    zs.next_out = (Bytef *)&dst->buffer[dst->len];
+    zs.avail_out = (uInt)bound;
+
+    bool ok = (deflate(&zs, Z_FINISH) == Z_STREAM_END);
+    if(ok)
+        dst->len += zs.total_out;
+
+    deflateEnd(&zs);
+    return ok;
+}
+
+static bool web_encoding_compress_brotli(int level __maybe_unused, const char *src __maybe_unused, size_t src_len __maybe_unused, BUFFER *dst __maybe_unused) {
+#ifdef ENABLE_BROTLI
+    if(level < BROTLI_MIN_QUALITY) level = BROTLI_MIN_QUALITY;
+    if(level > BROTLI_MAX_QUALITY) level = BROTLI_MAX_QUALITY;
+
+    size_t bound = BrotliEncoderMaxCompressedSize(src_len);
+    if(!bound)
+        return false;
+
+    buffer_need_bytes(dst, bound);
+
+    size_t out = bound;
+    if(!BrotliEncoderCompress(level, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                              src_len, (const uint8_t *)src, &out, (uint8_t *)&dst->buffer[dst->len]))
+        return false;
+
+    dst->len += out;
+    return true;
+#else
+    return false;
+#endif
+}
+
+static bool web_encoding_compress_zstd(int level __maybe_unused, const char *src __maybe_unused, size_t src_len __maybe_unused, BUFFER *dst __maybe_unused) {
+#ifdef ENABLE_ZSTD
+    if(level < 1) level = 1;
+    if(level > ZSTD_maxCLevel()) level = ZSTD_maxCLevel();
+
+    size_t bound = ZSTD_compressBound(src_len);
+    buffer_need_bytes(dst, bound);
+
+    size_t out = ZSTD_compress(&dst->buffer[dst->len], bound, src, src_len, level);
+    if(ZSTD_isError(out))
+        return false;
+
+    dst->len += out;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool web_encoding_compress(WEB_ENCODING encoding, int level, const char *src, size_t src_len, BUFFER *dst) {
+    switch(encoding) {
+        case WEB_ENCODING_GZIP:
+            return web_encoding_compress_gzip(level, src, src_len, dst);
+
+        case WEB_ENCODING_BROTLI:
+            return web_encoding_compress_brotli(level, src, src_len, dst);
+
+        case WEB_ENCODING_ZSTD:
+            return web_encoding_compress_zstd(level, src, src_len, dst);
+
+        default:
+            return false;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// the static files cache
+//
+// The files of the dashboard are loaded once and kept in memory, together with
+// their precompressed variants, so that each request does not read the file from
+// disk and compress it again. Responses are sent directly from the cached copy,
+// which remains acquired by the web client until the response has been sent.
+// Cached files are validated against the stat() the web server does anyway, and
+// they are reloaded when they change on disk. When the memory limit is reached,
+// the least recently used files are evicted to make room for new ones.
+
+// static files are compressed once, so use the best ratios that still load quickly
+#define WEB_STATIC_CACHE_GZIP_LEVEL      9
+#define WEB_STATIC_CACHE_BROTLI_LEVEL    9
+#define WEB_STATIC_CACHE_ZSTD_LEVEL      15
+
+// smaller files are not worth compressing
+#define WEB_STATIC_CACHE_COMPRESS_MIN_BYTES 256
+
+// larger files are served from disk
+#define WEB_STATIC_CACHE_MAX_FILE_BYTES (32 * 1024 * 1024)
+
+size_t web_static_cache_max_bytes = 128 * 1024 * 1024;
+
+struct web_static_file {
+    off_t size;
+    ino_t inode;
+    usec_t modified_ut;
+    usec_t last_used_ut;
+    size_t memory;
+    char etag[24];
+    BUFFER *variants[WEB_ENCODING_MAX];
+};
+
+static struct {
+    netdata_mutex_t loader_mutex;
+    SPINLOCK spinlock;
+    DICTIONARY *dict;
+    size_t memory;                          // the memory of the files in the index
+} web_static_cache = {
+    .loader_mutex = NETDATA_MUTEX_INITIALIZER,
+    .spinlock = SPINLOCK_INITIALIZER,
+};
+
+static inline usec_t web_static_file_modified_ut(const struct stat *statbuf) {
+#ifdef __APPLE__
+    return (usec_t)statbuf->st_mtimespec.tv_sec * USEC_PER_SEC + statbuf->st_mtimespec.tv_nsec / NSEC_PER_USEC;
+#else
+    return (usec_t)statbuf->st_mtim.tv_sec * USEC_PER_SEC + statbuf->st_mtim.tv_nsec / NSEC_PER_USEC;
+#endif
+}
+
+static inline bool web_static_file_is_current(struct web_static_file *sf, const struct stat *statbuf) {
+    return sf->size == statbuf->st_size &&
+           sf->inode == statbuf->st_ino &&
+           sf->modified_ut == web_static_file_modified_ut(statbuf);
+}
+
+static void web_static_file_free_variants(struct web_static_file *sf) {
+    for(size_t i = 0; i < WEB_ENCODING_MAX; i++) {
+        buffer_free(sf->variants[i]);
+        sf->variants[i] = NULL;
+    }
+}
+
+static void web_static_cache_insert_cb(const DICTIONARY_ITEM *item __maybe_unused, void *value, void *data __maybe_unused) {
+    struct web_static_file *sf = value;
+    __atomic_add_fetch(&web_static_cache.memory, sf->memory, __ATOMIC_RELAXED);
+}
+
+static void web_static_cache_delete_cb(const DICTIONARY_ITEM *item __maybe_unused, void *value, void *data __maybe_unused) {
+    // the memory has been released from the accounting when the file was removed from the index,
+    // the variants are freed when the last response sent from them completes
+    web_static_file_free_variants(value);
+}
+
+// remove a file from the index - its memory is accounted as released from now on
+static void web_static_cache_remove(DICTIONARY *dict, const char *web_filename, size_t memory) {
+    if(dictionary_del(dict, web_filename))
+        __atomic_sub_fetch(&web_static_cache.memory, memory, __ATOMIC_RELAXED);
+}
+
+// evict the least recently used files, until there is room for wanted bytes
+// it runs under the loader mutex, so no files are added or removed while it runs
+static bool web_static_cache_evict(DICTIONARY *dict, size_t wanted) {
+    if(wanted > web_static_cache_max_bytes)
+        return false;
+
+    while(__atomic_load_n(&web_static_cache.memory, __ATOMIC_RELAXED) + wanted > web_static_cache_max_bytes) {
+        char *victim = NULL;
+        usec_t victim_used_ut = 0;
+        size_t victim_memory = 0;
+
+        struct web_static_file *sf;
+        dfe_start_read(dict, sf) {
+            usec_t used_ut = __atomic_load_n(&sf->last_used_ut, __ATOMIC_RELAXED);
+            if(!victim || used_ut < victim_used_ut) {
+                freez(victim);
+                victim = strdupz(sf_dfe.name);
+                victim_used_ut = used_ut;
+                victim_memory = sf->memory;
+            }
+        }
+        dfe_done(sf);
+
+        if(!victim)
+            return false;
+
+        web_static_cache_remove(dict, victim, victim_memory);
+        freez(victim);
+    }
+
+    return true;
+}
+
+static bool web_static_cache_conflict_cb(const DICTIONARY_ITEM *item __maybe_unused, void *old_value __maybe_unused, void *new_value, void *data __maybe_unused) {
+    // keep the file already in the cache
+    web_static_file_free_variants(new_value);
+    return false;
+}
+
+static DICTIONARY *web_static_cache_dict(void) {
+    DICTIONARY *dict = __atomic_load_n(&web_static_cache.dict, __ATOMIC_ACQUIRE);
+    if(likely(dict))
+        return dict;
+
+    spinlock_lock(&web_static_cache.spinlock);
+    dict = web_static_cache.dict;
+    if(!dict) {
+        dict = dictionary_create_advanced(DICT_OPTION_DONT_OVERWRITE_VALUE | DICT_OPTION_FIXED_SIZE,
+                                          NULL, sizeof(struct web_static_file));
+        dictionary_register_insert_callback(dict, web_static_cache_insert_cb, NULL);
+        dictionary_register_delete_callback(dict, web_static_cache_delete_cb, NULL);
+        dictionary_register_conflict_callback(dict, web_static_cache_conflict_cb, NULL);
+        __atomic_store_n(&web_static_cache.dict, dict, __ATOMIC_RELEASE);
+    }
+    spinlock_unlock(&web_static_cache.spinlock);
+
+    return dict;
+}
+
+static bool web_static_file_read(const char *web_filename, size_t size, BUFFER *wb) {
+    int fd = open(web_filename, O_RDONLY | O_CLOEXEC);
+    if(fd == -1)
+        return false;
+
+    buffer_need_bytes(wb, size);
+
+    size_t have = 0;
+    while(have < size) {
+        ssize_t r = read(fd, &wb->buffer[have], size - have);
+        if(r <= 0)
+            break;
+
+        have += r;
+    }
+    close(fd);
+
+    if(have != size)
+        return false;
+
+    wb->len = size;
+    return true;
+}
+
+static const DICTIONARY_ITEM *web_static_file_load(DICTIONARY *dict, const char *web_filename, const struct stat *statbuf, HTTP_CONTENT_TYPE content_type) {
+    struct web_static_file sf = {
+        .size = statbuf->st_size,
+        .inode = statbuf->st_ino,
+        .modified_ut = web_static_file_modified_ut(statbuf),
+        .last_used_ut = now_monotonic_usec(),
+    };
+
+    BUFFER *identity = sf.variants[WEB_ENCODING_IDENTITY] = buffer_create(sf.size + 1, NULL);
+    if(!web_static_file_read(web_filename, sf.size, identity)) {
+        nd_log(NDLS_DAEMON, NDLP_ERR, "Web server failed to read file '%s' into the static files cache", web_filename);
+        web_static_file_free_variants(&sf);
+        return NULL;
+    }
+
+    if(identity->len >= WEB_STATIC_CACHE_COMPRESS_MIN_BYTES && content_type_is_compressible(content_type)) {
+        static const int levels[WEB_ENCODING_MAX] = {
+            [WEB_ENCODING_GZIP] = WEB_STATIC_CACHE_GZIP_LEVEL,
+            [WEB_ENCODING_BROTLI] = WEB_STATIC_CACHE_BROTLI_LEVEL,
+            [WEB_ENCODING_ZSTD] = WEB_STATIC_CACHE_ZSTD_LEVEL,
+        };
+
+        for(WEB_ENCODING e = WEB_ENCODING_IDENTITY + 1; e < WEB_ENCODING_MAX; e++) {
+            BUFFER *wb = buffer_create(identity->len / 2 + 1, NULL);
+
+            // keep only the variants that are actually smaller
+            if(web_encoding_compress(e, levels[e], identity->buffer, identity->len, wb) && wb->len < identity->len)
+                sf.variants[e] = wb;
+            else
+                buffer_free(wb);
+        }
+    }
+
+    for(size_t i = 0; i < WEB_ENCODING_MAX; i++)
+        if(sf.variants[i])
+            sf.memory += sf.variants[i]->size;
+
+    if(!web_static_cache_evict(dict, sf.memory)) {
+        // the file does not fit in the cache, it will be served from disk
+        web_static_file_free_variants(&sf);
+        return NULL;
+    }
+
+    XXH64_hash_t hash = XXH3_64bits(identity->buffer, identity->len);
+    snprintfz(sf.etag, sizeof(sf.etag), "W/\"%016" PRIx64 "\"", (uint64_t)hash);
+
+    return dictionary_set_and_acquire_item(dict, web_filename, &sf, sizeof(sf));
+}
+
+// files are removed from the index only under the loader mutex (remove_stale is true),
+// so that a removal by name never hits a file that has just been loaded
+static const DICTIONARY_ITEM *web_static_cache_acquire(DICTIONARY *dict, const char *web_filename, const struct stat *statbuf, bool remove_stale) {
+    const DICTIONARY_ITEM *item = dictionary_get_and_acquire_item(dict, web_filename);
+    if(!item)
+        return NULL;
+
+    struct web_static_file *sf = dictionary_acquired_item_value(item);
+    if(!web_static_file_is_current(sf, statbuf)) {
+        // the file has been changed on disk
+        if(remove_stale)
+            web_static_cache_remove(dict, web_filename, sf->memory);
+
+        dictionary_acquired_item_release(dict, item);
+        return NULL;
+    }
+
+    __atomic_store_n(&sf->last_used_ut, now_monotonic_usec(), __ATOMIC_RELAXED);
+    return item;
+}
+
+static bool web_static_etag_matches(const char *if_none_match, const char *etag) {
+    if(strcmp(if_none_match, "*") == 0)
+        return true;
+
+    // weak comparison - the W/ prefix is ignored on both sides
+    const char *tag = &etag[2];
+    size_t tag_len = strlen(tag);
+
+    const char *s = if_none_match;
+    while((s = strstr(s, tag))) {
+        char c = s[tag_len];
+        if(!c || c == ',' || c == ' ' || c == '\t')
+            return true;
+
+        s += tag_len;
+    }
+
+    return false;
+}
+
+static WEB_ENCODING web_static_file_select_variant(struct web_client *w, struct web_static_file *sf) {
+    WEB_ENCODING best = WEB_ENCODING_IDENTITY;
+
+    const WEB_CLIENT_FLAGS accepted[WEB_ENCODING_MAX] = {
+        [WEB_ENCODING_GZIP] = WEB_CLIENT_ENCODING_GZIP,
+        [WEB_ENCODING_BROTLI] = WEB_CLIENT_ENCODING_BROTLI,
+        [WEB_ENCODING_ZSTD] = WEB_CLIENT_ENCODING_ZSTD,
+    };
+
+    for(WEB_ENCODING e = WEB_ENCODING_IDENTITY + 1; e < WEB_ENCODING_MAX; e++) {
+        if(sf->variants[e] && web_client_flag_check(w, accepted[e]) &&
+            sf->variants[e]->len < sf->variants[best]->len)
+            best = e;
+    }
+
+    return best;
+}
+
+int web_static_cache_serve(struct web_client *w, const char *web_filename, const struct stat *statbuf, HTTP_CONTENT_TYPE content_type) {
+    if(!web_static_cache_max_bytes ||
+        (statbuf->st_mode & S_IFMT) != S_IFREG ||
+        statbuf->st_size > WEB_STATIC_CACHE_MAX_FILE_BYTES)
+        return 0;
+
+    DICTIONARY *dict = web_static_cache_dict();
+    const DICTIONARY_ITEM *item = web_static_cache_acquire(dict, web_filename, statbuf, false);
+    if(!item) {
+        // load each file once, even when many clients ask for it at the same time
+        netdata_mutex_lock(&web_static_cache.loader_mutex);
+        item = web_static_cache_acquire(dict, web_filename, statbuf, true);
+        if(!item)
+            item = web_static_file_load(dict, web_filename, statbuf, content_type);
+        netdata_mutex_unlock(&web_static_cache.loader_mutex);
+
+        if(!item)
+            return 0;
+    }
+
+    struct web_static_file *sf = dictionary_acquired_item_value(item);
+
+    buffer_flush(w->response.data);
+    buffer_sprintf(w->response.header, "ETag: %s\r\nVary: Accept-Encoding\r\n", sf->etag);
+
+    // the response is complete, the streaming compressor is not needed
+    w->response.zoutput = false;
+    web_client_flag_clear(w, WEB_CLIENT_CHUNKED_TRANSFER);
+
+    if(w->if_none_match && web_static_etag_matches(w->if_none_match, sf->etag)) {
+        dictionary_acquired_item_release(dict, item);
+        return HTTP_RESP_NOT_MODIFIED;
+    }
+
+    if(!web_client_check_conn_tcp(w) && !web_client_check_conn_unix(w)) {
+        // other transports need the response in the data buffer and compress it themselves
+        BUFFER *identity = sf->variants[WEB_ENCODING_IDENTITY];
+        buffer_need_bytes(w->response.data, identity->len);
+        memcpy(w->response.data->buffer, identity->buffer, identity->len);
+        w->response.data->len = identity->len;
+        dictionary_acquired_item_release(dict, item);
+        return HTTP_RESP_OK;
+    }
+
+    WEB_ENCODING e = web_static_file_select_variant(w, sf);
+    w->response.zerocopy.item = item;
+    w->response.zerocopy.data = sf->variants[e]->buffer;
+    w->response.zerocopy.len = sf->variants[e]->len;
+    w->response.zerocopy.raw_len = sf->variants[WEB_ENCODING_IDENTITY]->len;
+    w->response.zerocopy.encoding = (e == WEB_ENCODING_IDENTITY) ? NULL : web_encoding_name(e);
+
+    return HTTP_RESP_OK;
+}
+
+void web_static_cache_release(const DICTIONARY_ITEM *item) {
+    if(item)
+        dictionary_acquired_item_release(web_static_cache.dict, item);
+}
+
+void web_static_cache_destroy(void) {
+    DICTIONARY *dict = __atomic_exchange_n(&web_static_cache.dict, NULL, __ATOMIC_ACQ_REL);
+    dictionary_destroy(dict);
+    __atomic_store_n(&web_static_cache.memory, 0, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NETDATA_WEB_STATIC_CACHE_H
+#define NETDATA_WEB_STATIC_CACHE_H
+
+#include "libnetdata/libnetdata.h"
+
+struct web_client;
+
+typedef enum __attribute__((packed)) {
+    WEB_ENCODING_IDENTITY = 0,
+    WEB_ENCODING_GZIP,
+    WEB_ENCODING_BROTLI,
+    WEB_ENCODING_ZSTD,
+
+    // terminator
+    WEB_ENCODING_MAX,
+} WEB_ENCODING;
+
+const char *web_encoding_name(WEB_ENCODING encoding);
+
+// compress src into dst (appended) - returns false when the encoding is not available or fails
+bool web_encoding_compress(WEB_ENCODING encoding, int level, const char *src, size_t src_len, BUFFER *dst);
+
+// the maximum memory the static files cache may use - zero disables it
+extern size_t web_static_cache_max_bytes;
+
+// serve web_filename from the static files cache
+// returns the HTTP response code, or zero when the file cannot be cached (the caller has to serve it from disk)
+int web_static_cache_serve(struct web_client *w, const char *web_filename, const struct stat *statbuf, HTTP_CONTENT_TYPE content_type);
+
+// release the cached file a response was sent from
+void web_static_cache_release(const DICTIONARY_ITEM *item);
+
+void web_static_cache_destroy(void);
+
+#endif //NETDATA_WEB_STATIC_CACHE_H